@@ -1,13 +1,25 @@
 #include "Particle.hlsli"
 
-struct ParticleForGPU
+// 1粒分のインスタンスデータ（32バイト、C++側のParticleInstanceと同じ並び）
+struct ParticleInstance
 {
-    float32_t4x4 WVP;
-    float32_t4x4 World;
-    float32_t4 color;
+    float32_t3 position;
+    float32_t size;
+    float32_t rotation;
+    uint32_t color; // RGBA8（Rが最下位バイト）
+    float32_t2 padding;
 };
 
-StructuredBuffer<ParticleForGPU> gPatricle : register(t0);
+// フレーム定数（C++側のParticleFrameConstantsと同じ並び）
+struct ParticleFrame
+{
+    float32_t4x4 viewProjection;
+    float32_t3 cameraRight;
+    float32_t3 cameraUp;
+};
+
+StructuredBuffer<ParticleInstance> gParticle : register(t0);
+ConstantBuffer<ParticleFrame> gFrame : register(b2);
 
 struct VertexShaderInput
 {
@@ -16,12 +28,26 @@ struct VertexShaderInput
     float32_t3 normal : NORMAL0;
 };
 
+// RGBA8を0～1の色に戻す
+float32_t4 UnpackColor(uint32_t color)
+{
+    return float32_t4(color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF, color >> 24) / 255.0f;
+}
+
 VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
 {
+    ParticleInstance particle = gParticle[instanceId];
+
+    // スケール -> Z軸回転 -> ビルボード -> 平行移動（C++側のExpandParticleVertexと同じ計算）
+    float32_t s, c;
+    sincos(particle.rotation, s, c);
+    float32_t2 corner = input.position.xy * particle.size;
+    float32_t2 rotated = float32_t2(corner.x * c - corner.y * s, corner.x * s + corner.y * c);
+    float32_t3 world = particle.position + gFrame.cameraRight * rotated.x + gFrame.cameraUp * rotated.y;
+
     VertexShaderOutput output;
-    output.position = mul(input.position, gPatricle[instanceId].WVP);
+    output.position = mul(float32_t4(world, 1.0f), gFrame.viewProjection);
     output.texcoord = input.texcoord;
-    //output.normal = normalize(mul(input.normal, (float32_t3x3) gTransformationMatrices[instanceId].World));
-    output.color = gPatricle[instanceId].color;
+    output.color = UnpackColor(particle.color);
     return output;
 }
\ No newline at end of file
@@ -0,0 +1,528 @@
+#include "CollisionBenchmark.h"
+
+// STLのインクルード
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <sstream>
+
+namespace {
+    // 経過時間（ミリ秒）
+    using Clock = std::chrono::steady_clock;
+    double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // 最適化でコールバックが消されないための書き込み先
+    volatile uint64_t g_callbackSink = 0;
+}
+
+CollisionBenchmark::CollisionBenchmark(const Settings& settings)
+    : settings_(settings) {
+}
+
+const char* CollisionBenchmark::GetScenarioName(Scenario scenario) {
+    switch (scenario) {
+    case Scenario::UniformSpheres: return "uniform_spheres";
+    case Scenario::ClusteredCrowd: return "clustered_crowd";
+    case Scenario::BulletHell:     return "bullet_hell";
+    case Scenario::MixedCapsules:  return "mixed_capsules";
+    }
+    return "unknown";
+}
+
+bool CollisionBenchmark::ParseScenario(const std::string& name, Scenario& scenario) {
+    const Scenario all[] = {
+        Scenario::UniformSpheres, Scenario::ClusteredCrowd,
+        Scenario::BulletHell, Scenario::MixedCapsules
+    };
+    for (Scenario candidate : all) {
+        if (name == GetScenarioName(candidate)) {
+            scenario = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+float CollisionBenchmark::Random(float min, float max) {
+    std::uniform_real_distribution<float> dist(min, max);
+    return dist(randomEngine_);
+}
+
+void CollisionBenchmark::Generate(Scenario scenario, uint32_t colliderCount) {
+    // シナリオとサイズごとに同じ配置になるようシードを決める
+    randomEngine_.seed(settings_.seed + colliderCount * 31u + static_cast<uint32_t>(scenario));
+
+    bodies_.clear();
+    bodies_.reserve(colliderCount);
+
+    // 1辺あたりの個数から密度が一定になるようにワールドの大きさを決める
+    worldExtent_ = std::cbrt(static_cast<float>(colliderCount)) * 2.0f;
+
+    auto makeSphere = [](const Vector3& center, float radius, const Vector3& velocity) {
+        Body body{};
+        body.isCapsule = false;
+        body.sphere = Collision::Sphere(center, radius);
+        body.velocity = velocity;
+        return body;
+    };
+
+    switch (scenario) {
+    case Scenario::UniformSpheres:
+        // 静止した球を一様に配置
+        for (uint32_t i = 0; i < colliderCount; ++i) {
+            Vector3 center = { Random(-worldExtent_, worldExtent_), Random(-worldExtent_, worldExtent_), Random(-worldExtent_, worldExtent_) };
+            bodies_.push_back(makeSphere(center, 0.5f, { 0.0f, 0.0f, 0.0f }));
+        }
+        break;
+
+    case Scenario::ClusteredCrowd: {
+        // 地面付近の数か所に密集してゆっくり動く群衆
+        uint32_t clusterCount = std::max(1u, colliderCount / 200u);
+        float groundExtent = std::sqrt(static_cast<float>(colliderCount)) * 2.0f;
+        worldExtent_ = groundExtent;
+        std::vector<Vector3> clusterCenters;
+        for (uint32_t i = 0; i < clusterCount; ++i) {
+            clusterCenters.push_back({ Random(-groundExtent, groundExtent), 0.0f, Random(-groundExtent, groundExtent) });
+        }
+        std::normal_distribution<float> spread(0.0f, 3.0f);
+        for (uint32_t i = 0; i < colliderCount; ++i) {
+            const Vector3& c = clusterCenters[i % clusterCount];
+            Vector3 center = { c.x + spread(randomEngine_), Random(0.0f, 1.0f), c.z + spread(randomEngine_) };
+            Vector3 velocity = { Random(-1.0f, 1.0f), 0.0f, Random(-1.0f, 1.0f) };
+            bodies_.push_back(makeSphere(center, 0.4f, velocity));
+        }
+        break;
+    }
+
+    case Scenario::BulletHell: {
+        // 1%の的と99%の小さく高速な弾
+        uint32_t targetCount = std::max(1u, colliderCount / 100u);
+        for (uint32_t i = 0; i < colliderCount; ++i) {
+            Vector3 center = { Random(-worldExtent_, worldExtent_), Random(-worldExtent_, worldExtent_), Random(-worldExtent_, worldExtent_) };
+            if (i < targetCount) {
+                bodies_.push_back(makeSphere(center, 1.5f, { 0.0f, 0.0f, 0.0f }));
+            }
+            else {
+                Vector3 velocity = { Random(-30.0f, 30.0f), Random(-30.0f, 30.0f), Random(-30.0f, 30.0f) };
+                bodies_.push_back(makeSphere(center, 0.1f, velocity));
+            }
+        }
+        break;
+    }
+
+    case Scenario::MixedCapsules:
+        // 半数はランダムな向きのカプセル
+        for (uint32_t i = 0; i < colliderCount; ++i) {
+            Vector3 center = { Random(-worldExtent_, worldExtent_), Random(-worldExtent_, worldExtent_), Random(-worldExtent_, worldExtent_) };
+            if (i % 2 == 0) {
+                bodies_.push_back(makeSphere(center, 0.5f, { 0.0f, 0.0f, 0.0f }));
+            }
+            else {
+                Vector3 axis = Collision::Utility::Normalize({ Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) });
+                Vector3 half = Collision::Utility::Multiply(axis, 0.75f);
+                Body body{};
+                body.isCapsule = true;
+                body.capsule = Collision::Capsule(
+                    Collision::Utility::Subtract(center, half),
+                    Collision::Utility::Add(center, half), 0.3f);
+                body.velocity = { 0.0f, 0.0f, 0.0f };
+                bodies_.push_back(body);
+            }
+        }
+        break;
+    }
+}
+
+void CollisionBenchmark::Step(float deltaTime) {
+    // ワールドの外に出たら反対側へ折り返す
+    auto wrap = [this](float& value) {
+        if (value > worldExtent_) value -= 2.0f * worldExtent_;
+        else if (value < -worldExtent_) value += 2.0f * worldExtent_;
+    };
+
+    for (Body& body : bodies_) {
+        if (body.isCapsule) continue;
+        Vector3& center = body.sphere.center;
+        center = Collision::Utility::Add(center, Collision::Utility::Multiply(body.velocity, deltaTime));
+        wrap(center.x);
+        wrap(center.y);
+        wrap(center.z);
+    }
+}
+
+void CollisionBenchmark::Broadphase(float deltaTime) {
+    bounds_.clear();
+    bounds_.reserve(bodies_.size());
+
+    // 移動量を含めた境界を計算
+    for (uint32_t i = 0; i < bodies_.size(); ++i) {
+        const Body& body = bodies_[i];
+        Bounds b;
+        if (body.isCapsule) {
+            const Collision::Capsule& c = body.capsule;
+            b.min = { std::min(c.segment.start.x, c.segment.end.x) - c.radius,
+                      std::min(c.segment.start.y, c.segment.end.y) - c.radius,
+                      std::min(c.segment.start.z, c.segment.end.z) - c.radius };
+            b.max = { std::max(c.segment.start.x, c.segment.end.x) + c.radius,
+                      std::max(c.segment.start.y, c.segment.end.y) + c.radius,
+                      std::max(c.segment.start.z, c.segment.end.z) + c.radius };
+        }
+        else {
+            const Collision::Sphere& s = body.sphere;
+            Vector3 end = Collision::Utility::Add(s.center, Collision::Utility::Multiply(body.velocity, deltaTime));
+            b.min = { std::min(s.center.x, end.x) - s.radius, std::min(s.center.y, end.y) - s.radius, std::min(s.center.z, end.z) - s.radius };
+            b.max = { std::max(s.center.x, end.x) + s.radius, std::max(s.center.y, end.y) + s.radius, std::max(s.center.z, end.z) + s.radius };
+        }
+        b.body = i;
+        bounds_.push_back(b);
+    }
+
+    // X軸でソートしてスイープ
+    std::sort(bounds_.begin(), bounds_.end(), [](const Bounds& a, const Bounds& b) {
+        return a.min.x < b.min.x;
+    });
+
+    candidates_.clear();
+    for (size_t i = 0; i < bounds_.size(); ++i) {
+        const Bounds& a = bounds_[i];
+        for (size_t j = i + 1; j < bounds_.size(); ++j) {
+            const Bounds& b = bounds_[j];
+            if (b.min.x > a.max.x) break;
+            if (b.min.y > a.max.y || b.max.y < a.min.y || b.min.z > a.max.z || b.max.z < a.min.z) continue;
+            candidates_.emplace_back(std::min(a.body, b.body), std::max(a.body, b.body));
+        }
+    }
+}
+
+Collision::CollisionResult CollisionBenchmark::CheckBodies(const Body& a, const Body& b, float deltaTime) const {
+    using namespace Collision;
+
+    float speedA = Utility::Length(a.velocity);
+    float speedB = Utility::Length(b.velocity);
+
+    // 動いている球があればスウィープテスト（CollisionManagerと同じ選び方）
+    if (speedA > 0.0001f || speedB > 0.0001f) {
+        const Body& moving = speedA > speedB ? a : b;
+        const Body& other = speedA > speedB ? b : a;
+        if (!moving.isCapsule) {
+            CollisionResult result = other.isCapsule
+                ? CollisionDetector::CheckSphereSweepToCapsule(moving.sphere, moving.velocity, other.capsule, deltaTime)
+                : CollisionDetector::CheckSphereSweepToSphere(moving.sphere, moving.velocity, other.sphere, deltaTime);
+            if (result.isColliding && &moving == &b) {
+                result.normal = Utility::Multiply(result.normal, -1.0f);
+            }
+            return result;
+        }
+    }
+
+    // 通常の判定
+    if (!a.isCapsule && !b.isCapsule) {
+        return CollisionDetector::CheckSphereToSphere(a.sphere, b.sphere);
+    }
+    if (!a.isCapsule && b.isCapsule) {
+        return CollisionDetector::CheckSphereToCapusle(a.sphere, b.capsule);
+    }
+    if (a.isCapsule && !b.isCapsule) {
+        CollisionResult result = CollisionDetector::CheckSphereToCapusle(b.sphere, a.capsule);
+        if (result.isColliding) {
+            result.normal = Utility::Multiply(result.normal, -1.0f);
+        }
+        return result;
+    }
+    return CollisionDetector::CheckCapsuleToCapsule(a.capsule, b.capsule);
+}
+
+void CollisionBenchmark::Narrowphase(float deltaTime) {
+    hits_.clear();
+    for (const auto& [i, j] : candidates_) {
+        Collision::CollisionResult result = CheckBodies(bodies_[i], bodies_[j], deltaTime);
+        if (result.isColliding) {
+            hits_.emplace_back(i, result);
+        }
+    }
+}
+
+void CollisionBenchmark::MeasureManager(Result& result, float deltaTime) {
+    using namespace Collision;
+
+    if (bodies_.size() < 2) {
+        return;
+    }
+
+    CollisionManager* manager = CollisionManager::GetInstance();
+    manager->ClearColliders();
+    manager->SetContactOutputMode(settings_.contactBuffer ? ContactOutputMode::Buffer : ContactOutputMode::Callbacks);
+
+    // 剛体に対応するコライダーを登録
+    std::vector<std::shared_ptr<SphereCollider>> spheres(bodies_.size());
+    uint64_t callbackCount = 0;
+    for (size_t i = 0; i < bodies_.size(); ++i) {
+        const Body& body = bodies_[i];
+        std::shared_ptr<CollisionObject> collider;
+        if (body.isCapsule) {
+            collider = std::make_shared<CapsuleCollider>(body.capsule.segment.start, body.capsule.segment.end, body.capsule.radius);
+        }
+        else {
+            spheres[i] = std::make_shared<SphereCollider>(body.sphere.center, body.sphere.radius);
+            collider = spheres[i];
+        }
+        collider->SetVelocity(body.velocity);
+        collider->onCollisionEnter = [&callbackCount](CollisionObject*, const CollisionResult&) {
+            ++callbackCount;
+        };
+        manager->AddCollider(collider);
+    }
+
+    double totalMs = 0.0;
+    uint64_t pairCount = 0;
+    uint32_t measuredFrames = 0;
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        // 現在の位置を反映（動いていないコライダーは触らずペアキャッシュを効かせる）
+        for (size_t i = 0; i < bodies_.size(); ++i) {
+            if (spheres[i] && Utility::LengthSquared(bodies_[i].velocity) > 0.0f) {
+                spheres[i]->SetCenter(bodies_[i].sphere.center);
+            }
+        }
+
+        Clock::time_point start = Clock::now();
+        manager->Update(deltaTime);
+        if (settings_.contactBuffer) {
+            // コールバックと同じく両側の分を数える処理を、バッファを一括で走査して行う
+            for (const CollisionContact& contact : manager->GetContacts()) {
+                callbackCount += contact.result.isColliding ? 2 : 0;
+            }
+        }
+        totalMs += ElapsedMs(start, Clock::now());
+        ++measuredFrames;
+
+        // マネージャー自身の計測値を集計
+        const CollisionStats& stats = manager->GetStats();
+        pairCount += stats.narrowphaseTests;
+        result.managerBroadphaseMs += stats.broadphaseMs;
+        result.managerNarrowphaseMs += stats.narrowphaseMs;
+        result.managerCallbackMs += stats.callbackMs;
+        result.managerCacheHitRate += stats.GetPairCacheHitRate();
+
+        Step(deltaTime);
+
+        // 1フレームの判定ペア数が上限を超える配置では残りのフレームを省略
+        if (stats.narrowphaseTests > settings_.maxManagerPairs) break;
+    }
+
+    // ワールド全体の保存と復元（ロールバック1回分）
+    // 1回目で出力先を確保してから計測する
+    std::vector<uint8_t> snapshot;
+    manager->SaveSnapshot(snapshot);
+    Clock::time_point saveStart = Clock::now();
+    manager->SaveSnapshot(snapshot);
+    Clock::time_point restoreStart = Clock::now();
+    manager->RestoreSnapshot(snapshot);
+    Clock::time_point restoreEnd = Clock::now();
+    result.managerSnapshotBytes = snapshot.size();
+    result.managerSaveUs = ElapsedMs(saveStart, restoreStart) * 1000.0;
+    result.managerRestoreUs = ElapsedMs(restoreStart, restoreEnd) * 1000.0;
+    result.managerSnapshotRoundTrip = CheckSnapshotRoundTrip(spheres, deltaTime);
+
+    manager->ClearColliders();
+    manager->SetContactOutputMode(ContactOutputMode::Callbacks);
+
+    result.managerMeasured = true;
+    result.managerPairs = pairCount;
+    result.managerHits = callbackCount;
+    result.managerUpdateMs = totalMs / measuredFrames;
+    result.managerBroadphaseMs /= measuredFrames;
+    result.managerNarrowphaseMs /= measuredFrames;
+    result.managerCallbackMs /= measuredFrames;
+    result.managerCacheHitRate /= measuredFrames;
+    result.managerPairsPerSec = totalMs > 0.0 ? result.managerPairs / (totalMs / 1000.0) : 0.0;
+}
+
+bool CollisionBenchmark::CheckSnapshotRoundTrip(const std::vector<std::shared_ptr<Collision::SphereCollider>>& spheres, float deltaTime) {
+    using namespace Collision;
+
+    CollisionManager* manager = CollisionManager::GetInstance();
+    const ContactOutputMode outputMode = manager->GetContactOutputMode();
+    manager->SetContactOutputMode(ContactOutputMode::Buffer);
+
+    // 接触をコライダーのIDの順に並べて写す（判定結果は全メンバーをそのまま比較する）
+    auto copyContacts = [manager]() {
+        std::vector<CollisionContact> contacts = manager->GetContacts();
+        std::sort(contacts.begin(), contacts.end(), [](const CollisionContact& a, const CollisionContact& b) {
+            return a.collider1->GetID() != b.collider1->GetID() ? a.collider1->GetID() < b.collider1->GetID()
+                : a.collider2->GetID() < b.collider2->GetID();
+        });
+        return contacts;
+    };
+    auto sameContacts = [](const std::vector<CollisionContact>& a, const std::vector<CollisionContact>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            const CollisionResult& ra = a[i].result;
+            const CollisionResult& rb = b[i].result;
+            if (a[i].collider1 != b[i].collider1 || a[i].collider2 != b[i].collider2 || ra.isColliding != rb.isColliding ||
+                ra.collisionPoint.x != rb.collisionPoint.x || ra.collisionPoint.y != rb.collisionPoint.y || ra.collisionPoint.z != rb.collisionPoint.z ||
+                ra.normal.x != rb.normal.x || ra.normal.y != rb.normal.y || ra.normal.z != rb.normal.z || ra.penetration != rb.penetration) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // 保存した状態から1回更新したときの接触を基準にする
+    std::vector<uint8_t> saved;
+    manager->SaveSnapshot(saved);
+    manager->Update(deltaTime);
+    const std::vector<CollisionContact> expected = copyContacts();
+    bool passed = manager->RestoreSnapshot(saved);
+
+    // 球の姿勢を崩して更新し、別の状態に進めてから戻す
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+    for (const auto& sphere : spheres) {
+        if (sphere) {
+            const Vector3 center = sphere->GetSphere().center;
+            sphere->SetCenter({ center.x + offset(randomEngine_), center.y + offset(randomEngine_), center.z + offset(randomEngine_) });
+        }
+    }
+    manager->Update(deltaTime);
+    passed = manager->RestoreSnapshot(saved) && passed;
+
+    // 戻した状態のバイト列と、次の更新の接触が保存時点と一致すること
+    std::vector<uint8_t> restored;
+    manager->SaveSnapshot(restored);
+    passed = passed && restored == saved;
+    manager->Update(deltaTime);
+    passed = passed && sameContacts(expected, copyContacts());
+
+    // 保存後の削除・追加で並びが変わっても、IDで対応を取って戻せること
+    // （削除した球は動かしてから外し、戻す前に登録し直す。追加した球は戻す前に外す）
+    manager->SaveSnapshot(saved);
+    manager->Update(deltaTime);
+    const std::vector<CollisionContact> expectedAfterSpawn = copyContacts();
+    passed = manager->RestoreSnapshot(saved) && passed;
+
+    std::vector<std::shared_ptr<SphereCollider>> despawned;
+    for (size_t i = 0; i < spheres.size(); i += 3) {
+        if (spheres[i]) {
+            spheres[i]->SetCenter({ offset(randomEngine_), offset(randomEngine_), offset(randomEngine_) });
+            manager->RemoveCollider(spheres[i]);
+            despawned.push_back(spheres[i]);
+        }
+    }
+    std::shared_ptr<SphereCollider> spawned;
+    if (!spheres.empty() && spheres[0]) {
+        spawned = std::make_shared<SphereCollider>(spheres[0]->GetSphere().center, spheres[0]->GetSphere().radius);
+        manager->AddCollider(spawned);
+    }
+    manager->Update(deltaTime);
+
+    for (const auto& sphere : despawned) {
+        manager->AddCollider(sphere);
+    }
+    if (spawned) {
+        manager->RemoveCollider(spawned);
+    }
+    passed = manager->RestoreSnapshot(saved) && passed;
+    manager->Update(deltaTime);
+    passed = passed && sameContacts(expectedAfterSpawn, copyContacts());
+
+    manager->SetContactOutputMode(outputMode);
+    return passed;
+}
+
+CollisionBenchmark::Result CollisionBenchmark::Run(Scenario scenario, uint32_t colliderCount) {
+    const float kDeltaTime = 1.0f / 60.0f;
+
+    Result result;
+    result.scenario = GetScenarioName(scenario);
+    result.colliders = colliderCount;
+    result.frames = settings_.frames;
+
+    // コールバック（CollisionManagerと同じく両側に通知し、2つ目は法線を反転したコピー）
+    std::function<void(uint32_t, const Collision::CollisionResult&)> onHit =
+        [](uint32_t other, const Collision::CollisionResult& hit) {
+            g_callbackSink = g_callbackSink + other + (hit.penetration > 0.0f ? 1u : 0u);
+        };
+
+    Generate(scenario, colliderCount);
+
+    double broadphaseMs = 0.0;
+    double narrowphaseMs = 0.0;
+    double callbackMs = 0.0;
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        Clock::time_point t0 = Clock::now();
+        Broadphase(kDeltaTime);
+        Clock::time_point t1 = Clock::now();
+        Narrowphase(kDeltaTime);
+        Clock::time_point t2 = Clock::now();
+        for (const auto& [body, hit] : hits_) {
+            onHit(body, hit);
+            Collision::CollisionResult reversed = hit;
+            reversed.normal = Collision::Utility::Multiply(hit.normal, -1.0f);
+            onHit(body, reversed);
+        }
+        Clock::time_point t3 = Clock::now();
+
+        broadphaseMs += ElapsedMs(t0, t1);
+        narrowphaseMs += ElapsedMs(t1, t2);
+        callbackMs += ElapsedMs(t2, t3);
+        result.candidatePairs += candidates_.size();
+        result.hits += hits_.size();
+
+        Step(kDeltaTime);
+    }
+
+    result.broadphaseMs = broadphaseMs / settings_.frames;
+    result.narrowphaseMs = narrowphaseMs / settings_.frames;
+    result.callbackMs = callbackMs / settings_.frames;
+    result.pairsTestedPerSec = narrowphaseMs > 0.0 ? result.candidatePairs / (narrowphaseMs / 1000.0) : 0.0;
+
+    // 同じ初期配置でCollisionManagerを計測
+    Generate(scenario, colliderCount);
+    MeasureManager(result, kDeltaTime);
+
+    return result;
+}
+
+std::string CollisionBenchmark::ToJson(const std::vector<Result>& results, const Settings& settings) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"benchmark\": \"collision\",\n";
+    json << "  \"frames\": " << settings.frames << ",\n";
+    json << "  \"seed\": " << settings.seed << ",\n";
+    json << "  \"contact_buffer\": " << (settings.contactBuffer ? "true" : "false") << ",\n";
+    json << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        json << "    {"
+             << "\"scenario\": \"" << r.scenario << "\", "
+             << "\"colliders\": " << r.colliders << ", "
+             << "\"candidate_pairs\": " << r.candidatePairs << ", "
+             << "\"hits\": " << r.hits << ", "
+             << "\"broadphase_ms\": " << r.broadphaseMs << ", "
+             << "\"narrowphase_ms\": " << r.narrowphaseMs << ", "
+             << "\"callback_ms\": " << r.callbackMs << ", "
+             << "\"pairs_tested_per_sec\": " << r.pairsTestedPerSec << ", "
+             << "\"manager_measured\": " << (r.managerMeasured ? "true" : "false");
+        if (r.managerMeasured) {
+            json << ", \"manager_pairs\": " << r.managerPairs
+                 << ", \"manager_hits\": " << r.managerHits
+                 << ", \"manager_update_ms\": " << r.managerUpdateMs
+                 << ", \"manager_broadphase_ms\": " << r.managerBroadphaseMs
+                 << ", \"manager_narrowphase_ms\": " << r.managerNarrowphaseMs
+                 << ", \"manager_callback_ms\": " << r.managerCallbackMs
+                 << ", \"manager_pairs_per_sec\": " << r.managerPairsPerSec
+                 << ", \"manager_cache_hit_rate\": " << r.managerCacheHitRate
+                 << ", \"manager_snapshot_bytes\": " << r.managerSnapshotBytes
+                 << ", \"manager_save_us\": " << r.managerSaveUs
+                 << ", \"manager_restore_us\": " << r.managerRestoreUs
+                 << ", \"manager_snapshot_round_trip\": " << (r.managerSnapshotRoundTrip ? "true" : "false");
+        }
+        json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n";
+    json << "}\n";
+    return json.str();
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+// 衝突判定ベンチマーク
+// Collisionモジュールのみに依存するため、DirectXのないLinux環境でもビルドできる
+// ビルド例（リポジトリのルートで実行）:
+//   g++ -std=c++20 -O2 -Isrc/Engine/Math -Isrc/Engine/Collision
+//       src/CollisionBenchmark.cpp src/CollisionBenchmarkMain.cpp
+//       src/Engine/Collision/Collision.cpp src/Engine/Collision/CollisionManager.cpp
+//       src/Engine/Collision/CollisionDebugLines.cpp src/Engine/Collision/ConvexHull.cpp
+//       src/Engine/Collision/ConvexCollision.cpp src/Engine/Collision/Heightfield.cpp
+//       -o collision_benchmark
+// 実行例:
+//   ./collision_benchmark --sizes 100,1000,10000,100000 --frames 10 --json result.json
+
+#include "CollisionManager.h"
+
+// STLのインクルード
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 衝突判定ベンチマーククラス
+class CollisionBenchmark {
+public:
+    // シナリオ
+    enum class Scenario {
+        UniformSpheres,  // 一様分布の球
+        ClusteredCrowd,  // 群衆のように密集した球
+        BulletHell,      // 小さく高速な多数の弾と少数の的
+        MixedCapsules    // 球とカプセルの混在
+    };
+
+    // 実行設定
+    struct Settings {
+        uint32_t frames = 10;                    // 計測フレーム数
+        uint32_t seed = 12345;                   // 乱数シード（同じ値なら同じ配置になる）
+        uint64_t maxManagerPairs = 50000000;     // CollisionManagerの1フレームの判定ペア数がこれを超えたら計測を打ち切る
+        bool contactBuffer = false;              // CollisionManagerをコールバックではなく接触バッファ出力で計測する
+    };
+
+    // 計測結果（時間は1フレームあたりの平均）
+    struct Result {
+        std::string scenario;
+        uint32_t colliders = 0;
+        uint32_t frames = 0;
+
+        // ブロードフェーズ→ナローフェーズ→コールバックの段階別計測
+        uint64_t candidatePairs = 0;     // ブロードフェーズを通過したペア数（全フレーム合計）
+        uint64_t hits = 0;               // 衝突したペア数（全フレーム合計）
+        double broadphaseMs = 0.0;
+        double narrowphaseMs = 0.0;
+        double callbackMs = 0.0;
+        double pairsTestedPerSec = 0.0;  // ナローフェーズのペア判定数/秒
+
+        // CollisionManager::Updateの計測（段階別の時間はGetStatsの値）
+        bool managerMeasured = false;
+        uint64_t managerPairs = 0;       // 詳細判定したペア数（計測フレーム合計）
+        uint64_t managerHits = 0;        // コールバック呼び出し数（計測フレーム合計）
+        double managerUpdateMs = 0.0;
+        double managerBroadphaseMs = 0.0;
+        double managerNarrowphaseMs = 0.0;
+        double managerCallbackMs = 0.0;
+        double managerPairsPerSec = 0.0;
+        double managerCacheHitRate = 0.0; // ペアキャッシュで判定を省略した割合（計測フレーム平均）
+        uint64_t managerSnapshotBytes = 0; // 計測後のワールドのスナップショットの大きさ
+        double managerSaveUs = 0.0;        // SaveSnapshotの時間（マイクロ秒）
+        double managerRestoreUs = 0.0;     // RestoreSnapshotの時間（マイクロ秒）
+        // 保存→姿勢を変えて更新→復元→再保存で、バイト列と次のUpdateの接触が保存時点と一致したか
+        bool managerSnapshotRoundTrip = false;
+    };
+
+    // コンストラクタ
+    explicit CollisionBenchmark(const Settings& settings);
+
+    // シナリオを指定数のコライダーで実行
+    Result Run(Scenario scenario, uint32_t colliderCount);
+
+    // シナリオ名の取得・解析
+    static const char* GetScenarioName(Scenario scenario);
+    static bool ParseScenario(const std::string& name, Scenario& scenario);
+
+    // 結果をJSON文字列に変換
+    static std::string ToJson(const std::vector<Result>& results, const Settings& settings);
+
+private:
+    // ベンチマーク内部の剛体表現
+    struct Body {
+        bool isCapsule;
+        Collision::Sphere sphere;
+        Collision::Capsule capsule;
+        Vector3 velocity;
+    };
+
+    // ブロードフェーズ用の境界
+    struct Bounds {
+        Vector3 min;
+        Vector3 max;
+        uint32_t body;
+    };
+
+    // 設定
+    Settings settings_;
+
+    // 乱数生成器
+    std::mt19937 randomEngine_;
+
+    // ワールドの半径（この範囲で位置を折り返す）
+    float worldExtent_ = 0.0f;
+
+    // 剛体リスト
+    std::vector<Body> bodies_;
+
+    // 作業用配列（フレーム間で再利用）
+    std::vector<Bounds> bounds_;
+    std::vector<std::pair<uint32_t, uint32_t>> candidates_;
+    std::vector<std::pair<uint32_t, Collision::CollisionResult>> hits_;
+
+    // シナリオの配置を生成
+    void Generate(Scenario scenario, uint32_t colliderCount);
+
+    // 全剛体を移動
+    void Step(float deltaTime);
+
+    // ブロードフェーズ（スイープ＆プルーン）
+    void Broadphase(float deltaTime);
+
+    // ナローフェーズ（CollisionManagerと同じ判定関数の選び方をする）
+    void Narrowphase(float deltaTime);
+
+    // 2つの剛体の判定
+    Collision::CollisionResult CheckBodies(const Body& a, const Body& b, float deltaTime) const;
+
+    // CollisionManagerでの計測
+    void MeasureManager(Result& result, float deltaTime);
+
+    // スナップショットの往復の確認（保存後に球を削除・追加した場合を含む。接触バッファ出力で比較し、終了時に出力方式を戻す）
+    bool CheckSnapshotRoundTrip(const std::vector<std::shared_ptr<Collision::SphereCollider>>& spheres, float deltaTime);
+
+    // 範囲指定の乱数
+    float Random(float min, float max);
+};
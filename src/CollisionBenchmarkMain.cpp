@@ -0,0 +1,151 @@
+#include "CollisionBenchmark.h"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 使い方の表示
+void PrintUsage() {
+    std::cout << "Usage: collision_benchmark [options]\n"
+              << "  --sizes 100,1000,10000,100000   コライダー数のリスト\n"
+              << "  --scenarios uniform_spheres,clustered_crowd,bullet_hell,mixed_capsules\n"
+              << "  --frames N                      計測フレーム数\n"
+              << "  --seed N                        乱数シード\n"
+              << "  --max-manager-pairs N           CollisionManagerの計測を打ち切る1フレームの判定ペア数\n"
+              << "  --contact-buffer                CollisionManagerを接触バッファ出力モードで計測\n"
+              << "  --json PATH                     JSONの出力先（-で標準出力）\n";
+}
+
+// カンマ区切りの文字列を分割
+std::vector<std::string> Split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// メイン関数
+int main(int argc, char** argv) {
+    CollisionBenchmark::Settings settings;
+    std::vector<uint32_t> sizes = { 100, 1000, 10000, 100000 };
+    std::vector<CollisionBenchmark::Scenario> scenarios = {
+        CollisionBenchmark::Scenario::UniformSpheres,
+        CollisionBenchmark::Scenario::ClusteredCrowd,
+        CollisionBenchmark::Scenario::BulletHell,
+        CollisionBenchmark::Scenario::MixedCapsules
+    };
+    std::string jsonPath = "collision_benchmark.json";
+
+    // 引数の解析
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            sizes.clear();
+            for (const std::string& size : Split(argv[++i])) {
+                sizes.push_back(static_cast<uint32_t>(std::strtoul(size.c_str(), nullptr, 10)));
+            }
+        }
+        else if (arg == "--scenarios" && hasValue) {
+            scenarios.clear();
+            for (const std::string& name : Split(argv[++i])) {
+                CollisionBenchmark::Scenario scenario;
+                if (!CollisionBenchmark::ParseScenario(name, scenario)) {
+                    std::cerr << "Unknown scenario: " << name << std::endl;
+                    return 1;
+                }
+                scenarios.push_back(scenario);
+            }
+        }
+        else if (arg == "--frames" && hasValue) {
+            settings.frames = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--max-manager-pairs" && hasValue) {
+            settings.maxManagerPairs = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--contact-buffer") {
+            settings.contactBuffer = true;
+        }
+        else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        }
+        else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    // ベンチマークの実行
+    CollisionBenchmark benchmark(settings);
+    std::vector<CollisionBenchmark::Result> results;
+
+    std::cerr << std::left << std::setw(18) << "scenario" << std::right
+              << std::setw(9) << "count" << std::setw(12) << "pairs/f"
+              << std::setw(11) << "broad ms" << std::setw(11) << "narrow ms"
+              << std::setw(11) << "cb ms" << std::setw(14) << "pairs/sec"
+              << std::setw(12) << "manager ms" << std::setw(11) << "cache hit"
+              << std::setw(11) << "save us" << std::setw(11) << "restore us" << std::setw(10) << "snapshot" << std::endl;
+
+    // スナップショットの往復が一致しなかった計測があれば失敗
+    bool failed = false;
+
+    for (CollisionBenchmark::Scenario scenario : scenarios) {
+        for (uint32_t size : sizes) {
+            CollisionBenchmark::Result r = benchmark.Run(scenario, size);
+            results.push_back(r);
+
+            std::cerr << std::left << std::setw(18) << r.scenario << std::right
+                      << std::setw(9) << r.colliders
+                      << std::setw(12) << r.candidatePairs / r.frames
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(11) << r.broadphaseMs
+                      << std::setw(11) << r.narrowphaseMs
+                      << std::setw(11) << r.callbackMs
+                      << std::scientific << std::setprecision(2)
+                      << std::setw(14) << r.pairsTestedPerSec
+                      << std::fixed << std::setprecision(3);
+            if (r.managerMeasured) {
+                std::cerr << std::setw(12) << r.managerUpdateMs
+                          << std::setw(10) << std::setprecision(1) << r.managerCacheHitRate * 100.0 << "%"
+                          << std::setw(11) << r.managerSaveUs
+                          << std::setw(11) << r.managerRestoreUs
+                          << std::setw(10) << (r.managerSnapshotRoundTrip ? "ok" : "FAILED");
+                failed |= !r.managerSnapshotRoundTrip;
+            }
+            else {
+                std::cerr << std::setw(12) << "skipped";
+            }
+            std::cerr << std::defaultfloat << std::endl;
+        }
+    }
+
+    // JSONの出力
+    std::string json = CollisionBenchmark::ToJson(results, settings);
+    if (jsonPath == "-") {
+        std::cout << json;
+    }
+    else {
+        std::ofstream file(jsonPath);
+        if (!file) {
+            std::cerr << "Failed to open " << jsonPath << std::endl;
+            return 1;
+        }
+        file << json;
+        std::cerr << "Wrote " << jsonPath << std::endl;
+    }
+
+    if (failed) {
+        std::cerr << "Snapshot round trip FAILED" << std::endl;
+        return 1;
+    }
+    return 0;
+}
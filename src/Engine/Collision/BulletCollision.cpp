@@ -115,32 +115,7 @@ namespace Collision {
         obj->setCollisionShape(collisionShapes.back().get());
         
         // 位置と回転を設定
-        btTransform transform;
-        transform.setIdentity();
-
-        // カプセルの中心位置
-        Vector3 center;
-        center.x = (capsule.segment.start.x + capsule.segment.end.x) * 0.5f;
-        center.y = (capsule.segment.start.y + capsule.segment.end.y) * 0.5f;
-        center.z = (capsule.segment.start.z + capsule.segment.end.z) * 0.5f;
-        transform.setOrigin(Vector3ToBt(center));
-
-        // カプセルの向きを設定（デフォルトはY軸方向）
-        if (height > 0.001f) {
-            Vector3 normalizedDir = Utility::Multiply(direction, (1.0f / height));
-            Vector3 yAxis = {0.0f, 1.0f, 0.0f};
-            
-            Vector3 rotationAxis = Utility::Cross(yAxis, normalizedDir);
-            float rotationAngle = std::acos(Utility::Dot(yAxis, normalizedDir));
-            
-            if (Utility::Length(rotationAxis) > 0.001f) {
-                rotationAxis = Utility::Normalize(rotationAxis);
-                btQuaternion rotation(btVector3(rotationAxis.x, rotationAxis.y, rotationAxis.z), rotationAngle);
-                transform.setRotation(rotation);
-            }
-        }
-        
-        obj->setWorldTransform(transform);
+        obj->setWorldTransform(MakeCapsuleTransform(capsule));
 
         // ユーザーデータの設定
         obj->setUserPointer(userData);
@@ -182,6 +157,103 @@ namespace Collision {
         return objPtr;
     }
 
+    // 球のコリジョン更新
+    void BulletCollisionSystem::UpdateSphere(void* collisionObject, const Sphere& sphere) {
+        if (!collisionObject) return;
+        btCollisionObject* obj = static_cast<btCollisionObject*>(collisionObject);
+
+        // 半径は形状をそのまま書き換える
+        static_cast<btSphereShape*>(obj->getCollisionShape())->setUnscaledRadius(sphere.radius);
+
+        btTransform transform;
+        transform.setIdentity();
+        transform.setOrigin(Vector3ToBt(sphere.center));
+        obj->setWorldTransform(transform);
+        collisionWorld->updateSingleAabb(obj);
+    }
+
+    // カプセルのコリジョン更新
+    void BulletCollisionSystem::UpdateCapsule(void* collisionObject, const Capsule& capsule) {
+        if (!collisionObject) return;
+        btCollisionObject* obj = static_cast<btCollisionObject*>(collisionObject);
+
+        // 半径か長さが変わったときだけ形状を作り直す
+        float height = Utility::Length(Utility::Subtract(capsule.segment.end, capsule.segment.start));
+        const btCapsuleShape* shape = static_cast<const btCapsuleShape*>(obj->getCollisionShape());
+        if (shape->getRadius() != capsule.radius || shape->getHalfHeight() * 2.0f != height) {
+            ReplaceShape(obj, std::make_unique<btCapsuleShape>(capsule.radius, height));
+        }
+
+        obj->setWorldTransform(MakeCapsuleTransform(capsule));
+        collisionWorld->updateSingleAabb(obj);
+    }
+
+    // ボックスのコリジョン更新
+    void BulletCollisionSystem::UpdateBox(void* collisionObject, const Vector3& halfExtents, const Vector3& position) {
+        if (!collisionObject) return;
+        btCollisionObject* obj = static_cast<btCollisionObject*>(collisionObject);
+
+        // 大きさが変わったときだけ形状を作り直す
+        const btBoxShape* shape = static_cast<const btBoxShape*>(obj->getCollisionShape());
+        if (shape->getHalfExtentsWithMargin() != Vector3ToBt(halfExtents)) {
+            ReplaceShape(obj, std::make_unique<btBoxShape>(Vector3ToBt(halfExtents)));
+        }
+
+        btTransform transform;
+        transform.setIdentity();
+        transform.setOrigin(Vector3ToBt(position));
+        obj->setWorldTransform(transform);
+        collisionWorld->updateSingleAabb(obj);
+    }
+
+    // オブジェクトの形状を差し替え、古い形状を破棄する
+    void BulletCollisionSystem::ReplaceShape(btCollisionObject* object, std::unique_ptr<btCollisionShape> shape) {
+        btCollisionShape* oldShape = object->getCollisionShape();
+        object->setCollisionShape(shape.get());
+
+        auto it = std::find_if(collisionShapes.begin(), collisionShapes.end(),
+            [oldShape](const std::unique_ptr<btCollisionShape>& s) {
+                return s.get() == oldShape;
+            });
+        if (it != collisionShapes.end()) {
+            *it = std::move(shape);
+        } else {
+            collisionShapes.push_back(std::move(shape));
+        }
+    }
+
+    // カプセルの中心と向きからトランスフォームを作る
+    btTransform BulletCollisionSystem::MakeCapsuleTransform(const Capsule& capsule) {
+        Vector3 direction = Utility::Subtract(capsule.segment.end, capsule.segment.start);
+        float height = Utility::Length(direction);
+
+        btTransform transform;
+        transform.setIdentity();
+
+        // カプセルの中心位置
+        Vector3 center;
+        center.x = (capsule.segment.start.x + capsule.segment.end.x) * 0.5f;
+        center.y = (capsule.segment.start.y + capsule.segment.end.y) * 0.5f;
+        center.z = (capsule.segment.start.z + capsule.segment.end.z) * 0.5f;
+        transform.setOrigin(Vector3ToBt(center));
+
+        // カプセルの向きを設定（デフォルトはY軸方向）
+        if (height > 0.001f) {
+            Vector3 normalizedDir = Utility::Multiply(direction, (1.0f / height));
+            Vector3 yAxis = {0.0f, 1.0f, 0.0f};
+
+            Vector3 rotationAxis = Utility::Cross(yAxis, normalizedDir);
+            float rotationAngle = std::acos(Utility::Dot(yAxis, normalizedDir));
+
+            if (Utility::Length(rotationAxis) > 0.001f) {
+                rotationAxis = Utility::Normalize(rotationAxis);
+                btQuaternion rotation(btVector3(rotationAxis.x, rotationAxis.y, rotationAxis.z), rotationAngle);
+                transform.setRotation(rotation);
+            }
+        }
+        return transform;
+    }
+
     // コリジョンオブジェクト削除
     void BulletCollisionSystem::RemoveCollisionObject(void* collisionObject) {
         // オブジェクトを見つける
@@ -249,4 +321,270 @@ namespace Collision {
     }
 
 } // namespace Collision
-#endif // USE_BULLET_PHYSICS
\ No newline at end of file
+#else
+namespace Collision {
+
+    // コンストラクタ
+    BulletCollisionSystem::BulletCollisionSystem() {
+    }
+
+    // デストラクタ
+    BulletCollisionSystem::~BulletCollisionSystem() {
+        // コリジョンオブジェクトをクリア
+        collisionObjects.clear();
+        sweepEntries.clear();
+    }
+
+    // コリジョンワールドの更新と衝突検出
+    void BulletCollisionSystem::Update() {
+        // 境界ボックスを連続配列に詰める
+        sweepEntries.clear();
+        sweepEntries.reserve(collisionObjects.size());
+        for (const auto& object : collisionObjects) {
+            SweepEntry entry;
+            ComputeBounds(*object, entry.min, entry.max);
+            entry.object = object.get();
+            sweepEntries.push_back(entry);
+        }
+
+        // X軸の最小値でソートしてスイープ
+        std::sort(sweepEntries.begin(), sweepEntries.end(),
+            [](const SweepEntry& a, const SweepEntry& b) {
+                return a.min.x < b.min.x;
+            });
+
+        for (size_t i = 0; i < sweepEntries.size(); ++i) {
+            const SweepEntry& entryA = sweepEntries[i];
+
+            for (size_t j = i + 1; j < sweepEntries.size(); ++j) {
+                const SweepEntry& entryB = sweepEntries[j];
+
+                // X軸で離れたらこれ以降のオブジェクトとは重ならない
+                if (entryB.min.x > entryA.max.x) break;
+
+                // Y軸・Z軸の境界が重ならなければスキップ
+                if (entryB.min.y > entryA.max.y || entryB.max.y < entryA.min.y ||
+                    entryB.min.z > entryA.max.z || entryB.max.z < entryA.min.z) {
+                    continue;
+                }
+
+                // 詳細判定
+                CollisionResult result = CheckObjects(*entryA.object, *entryB.object);
+                if (result.isColliding && collisionCallback) {
+                    // 衝突情報を構築
+                    CollisionInfo info;
+                    info.objectA = entryA.object->userData;
+                    info.objectB = entryB.object->userData;
+                    info.collisionPoint = result.collisionPoint;
+                    info.normal = result.normal;
+                    info.penetration = result.penetration;
+
+                    // コールバック呼び出し
+                    collisionCallback(info);
+                }
+            }
+        }
+    }
+
+    // 球のコリジョン追加
+    void* BulletCollisionSystem::AddSphere(const Sphere& sphere, void* userData) {
+        auto object = std::make_unique<NativeObject>();
+        object->type = ShapeType::Sphere;
+        object->sphere = sphere;
+        object->userData = userData;
+        return AddObject(std::move(object));
+    }
+
+    // カプセルのコリジョン追加
+    void* BulletCollisionSystem::AddCapsule(const Capsule& capsule, void* userData) {
+        auto object = std::make_unique<NativeObject>();
+        object->type = ShapeType::Capsule;
+        object->capsule = capsule;
+        object->userData = userData;
+        return AddObject(std::move(object));
+    }
+
+    // ボックスのコリジョン追加
+    void* BulletCollisionSystem::AddBox(const Vector3& halfExtents, const Vector3& position, void* userData) {
+        auto object = std::make_unique<NativeObject>();
+        object->type = ShapeType::Box;
+        object->box.min = Utility::Subtract(position, halfExtents);
+        object->box.max = Utility::Add(position, halfExtents);
+        object->userData = userData;
+        return AddObject(std::move(object));
+    }
+
+    // オブジェクトの追加
+    void* BulletCollisionSystem::AddObject(std::unique_ptr<NativeObject> object) {
+        object->index = static_cast<uint32_t>(collisionObjects.size());
+        void* objPtr = object.get();
+        collisionObjects.push_back(std::move(object));
+        return objPtr;
+    }
+
+    // 球のコリジョン更新
+    void BulletCollisionSystem::UpdateSphere(void* collisionObject, const Sphere& sphere) {
+        if (!collisionObject) return;
+        NativeObject* object = static_cast<NativeObject*>(collisionObject);
+        if (object->type != ShapeType::Sphere) return;
+        object->sphere = sphere;
+    }
+
+    // カプセルのコリジョン更新
+    void BulletCollisionSystem::UpdateCapsule(void* collisionObject, const Capsule& capsule) {
+        if (!collisionObject) return;
+        NativeObject* object = static_cast<NativeObject*>(collisionObject);
+        if (object->type != ShapeType::Capsule) return;
+        object->capsule = capsule;
+    }
+
+    // ボックスのコリジョン更新
+    void BulletCollisionSystem::UpdateBox(void* collisionObject, const Vector3& halfExtents, const Vector3& position) {
+        if (!collisionObject) return;
+        NativeObject* object = static_cast<NativeObject*>(collisionObject);
+        if (object->type != ShapeType::Box) return;
+        object->box.min = Utility::Subtract(position, halfExtents);
+        object->box.max = Utility::Add(position, halfExtents);
+    }
+
+    // コリジョンオブジェクト削除
+    void BulletCollisionSystem::RemoveCollisionObject(void* collisionObject) {
+        if (!collisionObject) return;
+
+        // ハンドルが保持しているインデックスから位置を特定
+        const NativeObject* object = static_cast<const NativeObject*>(collisionObject);
+        uint32_t index = object->index;
+        if (index >= collisionObjects.size() || collisionObjects[index].get() != object) {
+            return;
+        }
+
+        // 末尾の要素と入れ替えて削除
+        if (index + 1 != collisionObjects.size()) {
+            std::swap(collisionObjects[index], collisionObjects.back());
+            collisionObjects[index]->index = index;
+        }
+        collisionObjects.pop_back();
+    }
+
+    // 衝突検出時のコールバック設定
+    void BulletCollisionSystem::SetCollisionCallback(const CollisionCallback& callback) {
+        collisionCallback = callback;
+    }
+
+    // 登録されている全オブジェクトに対してレイキャスト
+    CollisionResult BulletCollisionSystem::RayCast(const Vector3& rayFrom, const Vector3& rayTo) const {
+        CollisionResult closest;
+        Segment ray(rayFrom, rayTo);
+
+        for (const auto& object : collisionObjects) {
+            CollisionResult result;
+            switch (object->type) {
+            case ShapeType::Sphere:
+                result = CollisionDetector::RayCastSphere(ray, object->sphere);
+                break;
+            case ShapeType::Capsule:
+                result = CollisionDetector::RayCastCapsule(ray, object->capsule);
+                break;
+            case ShapeType::Box:
+                result = CollisionDetector::RayCastAABB(ray, object->box);
+                break;
+            }
+
+            // 残り距離が最も長い＝始点に最も近い衝突を採用
+            if (result.isColliding && (!closest.isColliding || result.penetration > closest.penetration)) {
+                closest = result;
+            }
+        }
+
+        return closest;
+    }
+
+    // 境界ボックスの計算
+    void BulletCollisionSystem::ComputeBounds(const NativeObject& object, Vector3& min, Vector3& max) {
+        switch (object.type) {
+        case ShapeType::Sphere: {
+            const Sphere& sphere = object.sphere;
+            Vector3 extent = { sphere.radius, sphere.radius, sphere.radius };
+            min = Utility::Subtract(sphere.center, extent);
+            max = Utility::Add(sphere.center, extent);
+            break;
+        }
+        case ShapeType::Capsule: {
+            const Capsule& capsule = object.capsule;
+            Vector3 extent = { capsule.radius, capsule.radius, capsule.radius };
+            Vector3 segMin = {
+                std::min(capsule.segment.start.x, capsule.segment.end.x),
+                std::min(capsule.segment.start.y, capsule.segment.end.y),
+                std::min(capsule.segment.start.z, capsule.segment.end.z)
+            };
+            Vector3 segMax = {
+                std::max(capsule.segment.start.x, capsule.segment.end.x),
+                std::max(capsule.segment.start.y, capsule.segment.end.y),
+                std::max(capsule.segment.start.z, capsule.segment.end.z)
+            };
+            min = Utility::Subtract(segMin, extent);
+            max = Utility::Add(segMax, extent);
+            break;
+        }
+        case ShapeType::Box:
+            min = object.box.min;
+            max = object.box.max;
+            break;
+        }
+    }
+
+    // 2つのオブジェクトの衝突判定（法線はBからAへ向かう＝Bulletのm_normalWorldOnBと同じ向き）
+    CollisionResult BulletCollisionSystem::CheckObjects(const NativeObject& a, const NativeObject& b) {
+        CollisionResult result;
+        bool flip = false;
+
+        switch (a.type) {
+        case ShapeType::Sphere:
+            if (b.type == ShapeType::Sphere) {
+                result = CollisionDetector::CheckSphereToSphere(a.sphere, b.sphere);
+                flip = true;
+            }
+            else if (b.type == ShapeType::Capsule) {
+                result = CollisionDetector::CheckSphereToCapusle(a.sphere, b.capsule);
+            }
+            else {
+                result = CollisionDetector::CheckSphereToAABB(a.sphere, b.box);
+            }
+            break;
+        case ShapeType::Capsule:
+            if (b.type == ShapeType::Sphere) {
+                result = CollisionDetector::CheckSphereToCapusle(b.sphere, a.capsule);
+                flip = true;
+            }
+            else if (b.type == ShapeType::Capsule) {
+                result = CollisionDetector::CheckCapsuleToCapsule(a.capsule, b.capsule);
+                flip = true;
+            }
+            else {
+                result = CollisionDetector::CheckCapsuleToAABB(a.capsule, b.box);
+            }
+            break;
+        case ShapeType::Box:
+            if (b.type == ShapeType::Sphere) {
+                result = CollisionDetector::CheckSphereToAABB(b.sphere, a.box);
+            }
+            else if (b.type == ShapeType::Capsule) {
+                result = CollisionDetector::CheckCapsuleToAABB(b.capsule, a.box);
+            }
+            else {
+                result = CollisionDetector::CheckAABBToAABB(a.box, b.box);
+            }
+            flip = true;
+            break;
+        }
+
+        // 法線の向きを反転
+        if (flip && result.isColliding) {
+            result.normal = Utility::Multiply(result.normal, -1.0f);
+        }
+
+        return result;
+    }
+
+} // namespace Collision
+#endif // USE_BULLET_PHYSICS
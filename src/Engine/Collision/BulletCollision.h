@@ -43,6 +43,12 @@ namespace Collision {
         // コールバック関数
         CollisionCallback collisionCallback;
 
+        // カプセルの中心と向きからトランスフォームを作る（Bulletのカプセルの軸はY軸方向）
+        static btTransform MakeCapsuleTransform(const Capsule& capsule);
+
+        // オブジェクトの形状を差し替え、古い形状を破棄する
+        void ReplaceShape(btCollisionObject* object, std::unique_ptr<btCollisionShape> shape);
+
     public:
         // コンストラクタ・デストラクタ
         BulletCollisionSystem();
@@ -60,7 +66,16 @@ namespace Collision {
         // ボックスのコリジョン追加
         void* AddBox(const Vector3& halfExtents, const Vector3& position, void* userData = nullptr);
 
-        // コリジョンオブジェクト削除
+        // 球のコリジョン更新（AddSphereで追加したハンドルに対して呼ぶ）
+        void UpdateSphere(void* collisionObject, const Sphere& sphere);
+
+        // カプセルのコリジョン更新（AddCapsuleで追加したハンドルに対して呼ぶ）
+        void UpdateCapsule(void* collisionObject, const Capsule& capsule);
+
+        // ボックスのコリジョン更新（AddBoxで追加したハンドルに対して呼ぶ）
+        void UpdateBox(void* collisionObject, const Vector3& halfExtents, const Vector3& position);
+
+        // コリジョンオブジェクト削除（Update中の衝突コールバックからは呼ばないこと）
         void RemoveCollisionObject(void* collisionObject);
 
         // 衝突検出時のコールバック設定
@@ -75,6 +90,88 @@ namespace Collision {
         // ゲームの座標系からBulletの座標系への変換
         static btVector3 Vector3ToBt(const Vector3& vec);
     };
+#else
+    // Bullet3を使用しない場合のネイティブ実装
+    // CollisionDetectorの判定関数とX軸スイープによるブロードフェーズで同じAPIを提供する
+    class BulletCollisionSystem {
+    private:
+        // 形状の種類
+        enum class ShapeType {
+            Sphere,
+            Capsule,
+            Box
+        };
+
+        // コリジョンオブジェクト（ハンドルとしてアドレスを外部に返す）
+        struct NativeObject {
+            ShapeType type;
+            Sphere sphere;
+            Capsule capsule;
+            AABB box;
+            void* userData;
+            uint32_t index; // objects内の位置（削除をO(1)にするため）
+        };
+
+        // ブロードフェーズ用の境界（毎フレーム連続配列に詰め直す）
+        struct SweepEntry {
+            Vector3 min;
+            Vector3 max;
+            const NativeObject* object;
+        };
+
+        // オブジェクトの管理
+        std::vector<std::unique_ptr<NativeObject>> collisionObjects;
+
+        // ブロードフェーズ用の作業配列（フレーム間で再利用）
+        std::vector<SweepEntry> sweepEntries;
+
+        // コールバック関数
+        CollisionCallback collisionCallback;
+
+        // オブジェクトの追加
+        void* AddObject(std::unique_ptr<NativeObject> object);
+
+        // 境界ボックスの計算
+        static void ComputeBounds(const NativeObject& object, Vector3& min, Vector3& max);
+
+        // 2つのオブジェクトの衝突判定（法線はBからAへ向かう）
+        static CollisionResult CheckObjects(const NativeObject& a, const NativeObject& b);
+
+    public:
+        // コンストラクタ・デストラクタ
+        BulletCollisionSystem();
+        ~BulletCollisionSystem();
+
+        // コリジョンワールドの更新
+        void Update();
+
+        // 球のコリジョン追加
+        void* AddSphere(const Sphere& sphere, void* userData = nullptr);
+
+        // カプセルのコリジョン追加
+        void* AddCapsule(const Capsule& capsule, void* userData = nullptr);
+
+        // ボックスのコリジョン追加
+        void* AddBox(const Vector3& halfExtents, const Vector3& position, void* userData = nullptr);
+
+        // 球のコリジョン更新（AddSphereで追加したハンドルに対して呼ぶ）
+        void UpdateSphere(void* collisionObject, const Sphere& sphere);
+
+        // カプセルのコリジョン更新（AddCapsuleで追加したハンドルに対して呼ぶ）
+        void UpdateCapsule(void* collisionObject, const Capsule& capsule);
+
+        // ボックスのコリジョン更新（AddBoxで追加したハンドルに対して呼ぶ）
+        void UpdateBox(void* collisionObject, const Vector3& halfExtents, const Vector3& position);
+
+        // コリジョンオブジェクト削除（Update中の衝突コールバックからは呼ばないこと）
+        void RemoveCollisionObject(void* collisionObject);
+
+        // 衝突検出時のコールバック設定
+        void SetCollisionCallback(const CollisionCallback& callback);
+
+        // 登録されている全オブジェクトに対してレイキャスト
+        CollisionResult RayCast(const Vector3& rayFrom, const Vector3& rayTo) const;
+    };
 #endif // USE_BULLET_PHYSICS
 
 } // namespace Collision
\ No newline at end of file
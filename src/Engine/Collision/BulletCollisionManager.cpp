@@ -40,81 +40,128 @@ namespace Collision {
     // デストラクタ
     BulletCollisionManager::~BulletCollisionManager() {
         // コリジョンオブジェクトとハンドラをクリア
-        collisionObjectToUserData.clear();
-        collisionHandlers.clear();
-        lastFrameCollisions.clear();
+        collisionObjectToUserData.Clear();
+        collisionHandlers.Clear();
+        lastFrameCollisions.Clear();
+        currentFrameCollisions.Clear();
+        pendingUnregistrations.clear();
     }
 
     // 更新処理
     void BulletCollisionManager::Update() {
         // 現在フレームの衝突情報をクリア
-        std::vector<CollisionPair> currentFrameCollisions;
-        
+        currentFrameCollisions.Clear();
+
+        // 衝突検出とExitイベントの間は、ハンドラーからの削除を遅らせる
+        // （検出中の作業配列はオブジェクトを直接指し、Exitイベントは衝突ペアのマップを走査しているため）
+        isUpdating = true;
+
         // Bullet3の衝突検出を実行（この中でOnCollisionコールバックが呼ばれる）
         bulletSystem->Update();
-        
+
         // 今回のフレームで衝突しなかったペアに対してExitイベントを発火
-        for (const auto& lastPair : lastFrameCollisions) {
-            // 現在のフレームで衝突していないか確認
-            auto it = std::find(currentFrameCollisions.begin(), currentFrameCollisions.end(), lastPair);
-            if (it == currentFrameCollisions.end()) {
-                // Exitイベントを発火する処理を追加できます
-                // ここでは単純化のため省略
+        lastFrameCollisions.ForEach([this](const CollisionPair& pair, const CollisionInfo& info) {
+            if (!currentFrameCollisions.Contains(pair)) {
+                DispatchHandlers(pair, info, &CollisionHandlers::onExit);
             }
-        }
-        
+        });
+
         // 次のフレーム用に現在の衝突情報を保存
-        lastFrameCollisions = std::move(currentFrameCollisions);
+        std::swap(lastFrameCollisions, currentFrameCollisions);
+        isUpdating = false;
+
+        // ハンドラーから要求された削除を反映
+        for (void* collisionObject : pendingUnregistrations) {
+            RemoveCollisionObjectNow(collisionObject);
+        }
+        pendingUnregistrations.clear();
     }
 
     // 球コリジョン登録
     void* BulletCollisionManager::RegisterSphere(const Sphere& sphere, void* userData) {
         void* collisionObject = bulletSystem->AddSphere(sphere, userData);
-        collisionObjectToUserData[collisionObject] = userData;
+        collisionObjectToUserData.InsertOrAssign(collisionObject, userData);
         return collisionObject;
     }
 
     // カプセルコリジョン登録
     void* BulletCollisionManager::RegisterCapsule(const Capsule& capsule, void* userData) {
         void* collisionObject = bulletSystem->AddCapsule(capsule, userData);
-        collisionObjectToUserData[collisionObject] = userData;
+        collisionObjectToUserData.InsertOrAssign(collisionObject, userData);
         return collisionObject;
     }
 
     // ボックスコリジョン登録
     void* BulletCollisionManager::RegisterBox(const Vector3& halfExtents, const Vector3& position, void* userData) {
         void* collisionObject = bulletSystem->AddBox(halfExtents, position, userData);
-        collisionObjectToUserData[collisionObject] = userData;
+        collisionObjectToUserData.InsertOrAssign(collisionObject, userData);
         return collisionObject;
     }
 
+    // 球コリジョン更新
+    void BulletCollisionManager::UpdateSphere(void* collisionObject, const Sphere& sphere) {
+        bulletSystem->UpdateSphere(collisionObject, sphere);
+    }
+
+    // カプセルコリジョン更新
+    void BulletCollisionManager::UpdateCapsule(void* collisionObject, const Capsule& capsule) {
+        bulletSystem->UpdateCapsule(collisionObject, capsule);
+    }
+
+    // ボックスコリジョン更新
+    void BulletCollisionManager::UpdateBox(void* collisionObject, const Vector3& halfExtents, const Vector3& position) {
+        bulletSystem->UpdateBox(collisionObject, halfExtents, position);
+    }
+
     // コリジョンオブジェクト削除
     void BulletCollisionManager::UnregisterCollisionObject(void* collisionObject) {
-        if (collisionObject) {
-            // ユーザーデータのマッピングを削除
-            collisionObjectToUserData.erase(collisionObject);
-            
-            // Bulletのコリジョンオブジェクトを削除
-            bulletSystem->RemoveCollisionObject(collisionObject);
-            
-            // このオブジェクトが関連するハンドラーを削除
-            // （本来はもう少し効率的な方法を使うべきですが、例として単純化）
-            auto it = collisionHandlers.begin();
-            while (it != collisionHandlers.end()) {
-                if (it->first.objectA == collisionObject || it->first.objectB == collisionObject) {
-                    it = collisionHandlers.erase(it);
-                } else {
-                    ++it;
-                }
+        if (!collisionObject) return;
+
+        // Update中はExitイベントの後まで遅らせる（同じオブジェクトが複数回要求されても1回だけ削除する）
+        if (isUpdating) {
+            if (std::find(pendingUnregistrations.begin(), pendingUnregistrations.end(), collisionObject) == pendingUnregistrations.end()) {
+                pendingUnregistrations.push_back(collisionObject);
             }
+            return;
         }
+        RemoveCollisionObjectNow(collisionObject);
     }
 
-    // 衝突イベントハンドラー登録
-    void BulletCollisionManager::RegisterCollisionHandler(void* objectA, void* objectB, 
-                                                        std::function<void(const CollisionInfo&)> handler) {
+    // コリジョンオブジェクトをすぐに削除する
+    void BulletCollisionManager::RemoveCollisionObjectNow(void* collisionObject) {
+        // ハンドラーと衝突ペアはユーザーデータで登録されているので、削除前に取り出しておく
+        void* userData = nullptr;
+        if (void** found = collisionObjectToUserData.Find(collisionObject)) {
+            userData = *found;
+        }
+
+        // ユーザーデータのマッピングを削除
+        collisionObjectToUserData.Erase(collisionObject);
+
+        // Bulletのコリジョンオブジェクトを削除
+        bulletSystem->RemoveCollisionObject(collisionObject);
+
+        if (!userData) return;
+
+        // 同じユーザーデータで登録された別のオブジェクトが残っていればハンドラーは残す
+        bool shared = false;
+        collisionObjectToUserData.ForEach([userData, &shared](void*, void* otherUserData) {
+            if (otherUserData == userData) shared = true;
+        });
+        if (shared) return;
+
+        // このユーザーデータが関連するハンドラーと衝突ペアを削除
+        auto containsUserData = [userData](const CollisionPair& pair, const auto&) {
+            return pair.objectA == userData || pair.objectB == userData;
+        };
+        collisionHandlers.EraseIf(containsUserData);
+        lastFrameCollisions.EraseIf(containsUserData);
+        currentFrameCollisions.EraseIf(containsUserData);
+    }
+
+    // ポインタ値の小さい方をobjectAにしたペアを作る
+    BulletCollisionManager::CollisionPair BulletCollisionManager::MakePair(void* objectA, void* objectB) {
         CollisionPair pair;
-        // objectAとobjectBの順序を一貫させるためにポインタ値で比較して小さい方をobjectAに
         if (objectA < objectB) {
             pair.objectA = objectA;
             pair.objectB = objectB;
@@ -122,23 +169,35 @@ namespace Collision {
             pair.objectA = objectB;
             pair.objectB = objectA;
         }
-        
-        collisionHandlers[pair] = handler;
+        return pair;
+    }
+
+    // 衝突イベントハンドラー登録
+    void BulletCollisionManager::RegisterCollisionHandler(void* objectA, void* objectB,
+                                                        std::function<void(const CollisionInfo&)> handler) {
+        collisionHandlers[MakePair(objectA, objectB)].onCollision = std::move(handler);
+    }
+
+    // 衝突開始イベントハンドラー登録
+    void BulletCollisionManager::RegisterCollisionEnterHandler(void* objectA, void* objectB,
+                                                             std::function<void(const CollisionInfo&)> handler) {
+        collisionHandlers[MakePair(objectA, objectB)].onEnter = std::move(handler);
+    }
+
+    // 衝突終了イベントハンドラー登録
+    void BulletCollisionManager::RegisterCollisionExitHandler(void* objectA, void* objectB,
+                                                            std::function<void(const CollisionInfo&)> handler) {
+        collisionHandlers[MakePair(objectA, objectB)].onExit = std::move(handler);
     }
 
     // 衝突イベントハンドラー削除
     void BulletCollisionManager::UnregisterCollisionHandler(void* objectA, void* objectB) {
-        CollisionPair pair;
-        // RegisterCollisionHandlerと同じロジックでペアを構築
-        if (objectA < objectB) {
-            pair.objectA = objectA;
-            pair.objectB = objectB;
-        } else {
-            pair.objectA = objectB;
-            pair.objectB = objectA;
-        }
-        
-        collisionHandlers.erase(pair);
+        collisionHandlers.Erase(MakePair(objectA, objectB));
+    }
+
+    // 前回の更新で2つのオブジェクトが衝突していたか
+    bool BulletCollisionManager::IsColliding(void* objectA, void* objectB) const {
+        return lastFrameCollisions.Contains(MakePair(objectA, objectB));
     }
 
     // レイキャスト実行
@@ -148,29 +207,43 @@ namespace Collision {
 
     // Bullet衝突イベントのコールバック
     void BulletCollisionManager::OnCollision(const CollisionInfo& info) {
-        // 衝突したオブジェクトのユーザーデータを取得
-        void* userDataA = info.objectA;
-        void* userDataB = info.objectB;
-        
-        // ハンドラーを呼び出すためのペアを作成
-        CollisionPair pair;
-        if (userDataA < userDataB) {
-            pair.objectA = userDataA;
-            pair.objectB = userDataB;
-        } else {
-            pair.objectA = userDataB;
-            pair.objectB = userDataA;
-        }
-        
-        // 該当するハンドラーがあれば呼び出す
-        auto it = collisionHandlers.find(pair);
-        if (it != collisionHandlers.end()) {
-            it->second(info);
+        // 衝突したオブジェクトのユーザーデータからペアを作成
+        CollisionPair pair = MakePair(info.objectA, info.objectB);
+
+        // 同じペアの衝突が複数報告された場合は最初の1件のみ扱う
+        if (currentFrameCollisions.Contains(pair)) {
+            return;
         }
-        
+
         // 現在フレームの衝突リストに追加（Enter/Exitイベント用）
-        // この行は実際のExitイベント実装時にコメントを外す
-        // lastFrameCollisions.push_back(pair);
+        currentFrameCollisions.InsertOrAssign(pair, info);
+
+        // 前フレームで衝突していなければEnterイベント
+        if (!lastFrameCollisions.Contains(pair)) {
+            DispatchHandlers(pair, info, &CollisionHandlers::onEnter);
+        }
+
+        // 衝突中イベント
+        DispatchHandlers(pair, info, &CollisionHandlers::onCollision);
+    }
+
+    // ペアに対応するハンドラーを呼び出す
+    void BulletCollisionManager::DispatchHandlers(const CollisionPair& pair, const CollisionInfo& info,
+                                                  std::function<void(const CollisionInfo&)> CollisionHandlers::* event) {
+        // 完全一致のハンドラー
+        if (const CollisionHandlers* handlers = collisionHandlers.Find(pair)) {
+            if (handlers->*event) (handlers->*event)(info);
+        }
+
+        // 相手を問わないハンドラー（nullptrとのペアで登録されたもの）
+        if (pair.objectA && pair.objectB) {
+            if (const CollisionHandlers* handlers = collisionHandlers.Find(MakePair(pair.objectA, nullptr))) {
+                if (handlers->*event) (handlers->*event)(info);
+            }
+            if (const CollisionHandlers* handlers = collisionHandlers.Find(MakePair(pair.objectB, nullptr))) {
+                if (handlers->*event) (handlers->*event)(info);
+            }
+        }
     }
 
-} // namespace Collision
\ No newline at end of file
+} // namespace Collision
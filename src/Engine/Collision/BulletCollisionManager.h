@@ -1,87 +1,139 @@
 #pragma once
 #include "BulletCollision.h"
 #include "CollisionManager.h"
+#include "FlatHashMap.h"
 #include <memory>
-#include <map>
 #include <vector>
 
-#ifdef USE_BULLET_PHYSICS
 namespace Collision {
 
     // BulletPhysicsを使用した衝突管理クラス
+    // USE_BULLET_PHYSICSが未定義の場合はエンジン内蔵の判定で同じAPIを提供する
     class BulletCollisionManager {
     private:
         // Bullet3の衝突システム
         std::unique_ptr<BulletCollisionSystem> bulletSystem;
-        
-        // 衝突イベントハンドラーを登録するためのマップ
+
+        // 衝突イベントハンドラーを登録するためのキー
         struct CollisionPair {
             void* objectA;
             void* objectB;
-            
-            // 比較演算子のオーバーロード
-            bool operator<(const CollisionPair& other) const {
-                if (objectA != other.objectA) return objectA < other.objectA;
-                return objectB < other.objectB;
-            }
-            
+
             // 等価演算子のオーバーロード
             bool operator==(const CollisionPair& other) const {
                 return (objectA == other.objectA && objectB == other.objectB) ||
                        (objectA == other.objectB && objectB == other.objectA);
             }
         };
-        
-        std::map<CollisionPair, std::function<void(const CollisionInfo&)>> collisionHandlers;
-        
+
+        // CollisionPair用のハッシュ関数
+        struct CollisionPairHash {
+            size_t operator()(const CollisionPair& pair) const {
+                size_t a = std::hash<void*>()(pair.objectA);
+                size_t b = std::hash<void*>()(pair.objectB);
+                return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+            }
+        };
+
+        // ペアごとのハンドラー
+        struct CollisionHandlers {
+            std::function<void(const CollisionInfo&)> onCollision; // 衝突中は毎フレーム
+            std::function<void(const CollisionInfo&)> onEnter;     // 衝突開始時
+            std::function<void(const CollisionInfo&)> onExit;      // 衝突終了時
+        };
+
+        // ポインタ値の小さい方をobjectAにしたペアを作る
+        static CollisionPair MakePair(void* objectA, void* objectB);
+
+        // 衝突イベントハンドラーのマップ（nullptrは任意の相手を表す）
+        FlatHashMap<CollisionPair, CollisionHandlers, CollisionPairHash> collisionHandlers;
+
         // 登録されたコリジョンオブジェクトとそのユーザーデータのマッピング
-        std::map<void*, void*> collisionObjectToUserData;
-        
-        // 前回のフレームで衝突したペアを記録（Enter/Exitイベント用）
-        std::vector<CollisionPair> lastFrameCollisions;
-        
+        FlatHashMap<void*, void*> collisionObjectToUserData;
+
+        // 前回のフレームで衝突したペアと最後の衝突情報（Enter/Exitイベント用）
+        FlatHashMap<CollisionPair, CollisionInfo, CollisionPairHash> lastFrameCollisions;
+
+        // 今回のフレームで衝突したペア
+        FlatHashMap<CollisionPair, CollisionInfo, CollisionPairHash> currentFrameCollisions;
+
+        // Update中か（ハンドラーからの削除を遅らせるため）
+        bool isUpdating = false;
+
+        // Update中に削除を要求されたコリジョンオブジェクト（Exitイベントの後にまとめて削除する）
+        std::vector<void*> pendingUnregistrations;
+
         // シングルトンインスタンス
         static BulletCollisionManager* instance;
-        
+
     public:
         // コンストラクタ・デストラクタ
         BulletCollisionManager();
         ~BulletCollisionManager();
-        
+
         // シングルトンアクセサ
         static BulletCollisionManager* GetInstance();
         static void Create();
         static void Destroy();
-        
+
         // 更新処理
         void Update();
-        
+
         // 球コリジョン登録
         void* RegisterSphere(const Sphere& sphere, void* userData = nullptr);
-        
+
         // カプセルコリジョン登録
         void* RegisterCapsule(const Capsule& capsule, void* userData = nullptr);
-        
+
         // ボックスコリジョン登録
         void* RegisterBox(const Vector3& halfExtents, const Vector3& position, void* userData = nullptr);
-        
+
+        // 球コリジョン更新（移動するオブジェクトは登録し直さずにこちらで位置と大きさを更新する）
+        void UpdateSphere(void* collisionObject, const Sphere& sphere);
+
+        // カプセルコリジョン更新
+        void UpdateCapsule(void* collisionObject, const Capsule& capsule);
+
+        // ボックスコリジョン更新
+        void UpdateBox(void* collisionObject, const Vector3& halfExtents, const Vector3& position);
+
         // コリジョンオブジェクト削除
+        // ハンドラー内（Update中）から呼んだ場合はUpdateの最後（Exitイベントの後）に削除する
+        // それまでは削除したオブジェクトの衝突も同じUpdate内で通知される
         void UnregisterCollisionObject(void* collisionObject);
-        
-        // 衝突イベントハンドラー登録
-        void RegisterCollisionHandler(void* objectA, void* objectB, 
+
+        // 衝突イベントハンドラー登録（衝突中は毎フレーム呼ばれる）
+        // ※ハンドラー内からのハンドラー登録・削除は行わないこと
+        void RegisterCollisionHandler(void* objectA, void* objectB,
+            std::function<void(const CollisionInfo&)> handler);
+
+        // 衝突開始イベントハンドラー登録
+        void RegisterCollisionEnterHandler(void* objectA, void* objectB,
+            std::function<void(const CollisionInfo&)> handler);
+
+        // 衝突終了イベントハンドラー登録（最後に衝突したフレームの情報が渡される）
+        void RegisterCollisionExitHandler(void* objectA, void* objectB,
             std::function<void(const CollisionInfo&)> handler);
-        
+
         // 衝突イベントハンドラー削除
         void UnregisterCollisionHandler(void* objectA, void* objectB);
-        
+
+        // 前回の更新で2つのオブジェクトが衝突していたか
+        bool IsColliding(void* objectA, void* objectB) const;
+
         // レイキャスト実行
         CollisionResult RayCast(const Vector3& rayFrom, const Vector3& rayTo) const;
-        
+
     private:
+        // コリジョンオブジェクトをすぐに削除する
+        void RemoveCollisionObjectNow(void* collisionObject);
+
         // Bullet衝突イベントのコールバック
         void OnCollision(const CollisionInfo& info);
+
+        // ペアに対応するハンドラーを呼び出す
+        void DispatchHandlers(const CollisionPair& pair, const CollisionInfo& info,
+            std::function<void(const CollisionInfo&)> CollisionHandlers::* event);
     };
 
 } // namespace Collision
-#endif // USE_BULLET_PHYSICS
\ No newline at end of file
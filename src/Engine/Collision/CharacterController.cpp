@@ -0,0 +1,269 @@
+#include "CharacterController.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Collision {
+
+    namespace {
+        const Vector3 kUp = { 0.0f, 1.0f, 0.0f };
+    }
+
+    CharacterController::CharacterController(const Vector3& position, float radius, float height)
+        : position_(position), radius_(radius), height_(std::max(height, radius * 2.0f)) {
+    }
+
+    void CharacterController::SetSlopeLimit(float radians) {
+        slopeLimitCos_ = std::cos(radians);
+    }
+
+    Capsule CharacterController::MakeCapsule(const Vector3& position) const {
+        Vector3 start = { position.x, position.y + radius_, position.z };
+        Vector3 end = { position.x, position.y + height_ - radius_, position.z };
+        return Capsule({ start, end }, radius_);
+    }
+
+    CollisionResult CharacterController::CheckOverlap(const Capsule& capsule, const CollisionObject& collider) {
+        CollisionResult result;
+        switch (collider.GetShapeType()) {
+        case CollisionObject::ShapeType::Sphere:
+            // 法線がカプセルから球へ向かうので反転する
+            result = CollisionDetector::CheckSphereToCapusle(static_cast<const SphereCollider&>(collider).GetSphere(), capsule);
+            result.normal = Utility::Multiply(result.normal, -1.0f);
+            break;
+        case CollisionObject::ShapeType::Capsule:
+            result = CollisionDetector::CheckCapsuleToCapsule(static_cast<const CapsuleCollider&>(collider).GetCapsule(), capsule);
+            break;
+        case CollisionObject::ShapeType::ConvexHull:
+            result = CollisionDetector::CheckCapsuleToConvex(capsule, static_cast<const ConvexHullCollider&>(collider).GetConvexShape());
+            break;
+        case CollisionObject::ShapeType::Heightfield:
+            result = static_cast<const HeightfieldCollider&>(collider).GetHeightfield().CheckCapsule(capsule);
+            break;
+        }
+        return result;
+    }
+
+    uint32_t CharacterController::Move(const Vector3& displacement) {
+        lastSweepCount_ = 0;
+        bool wasGrounded = isGrounded_;
+        isGrounded_ = false;
+
+        // 移動範囲（段差の昇降を含む）と重なるコライダーを1回だけ問い合わせる
+        float reach = Utility::Length(displacement) + stepOffset_ * 2.0f + skinWidth_ + radius_;
+        AABB bounds;
+        bounds.min = { position_.x - reach, position_.y - reach, position_.z - reach };
+        bounds.max = { position_.x + reach, position_.y + height_ + reach, position_.z + reach };
+        // トリガーは通り抜けられるので除外する
+        CollisionManager::GetInstance()->QueryColliders(bounds, candidates_);
+        candidates_.erase(std::remove_if(candidates_.begin(), candidates_.end(),
+            [this](const CollisionObject* collider) {
+                return collider->IsTrigger() || (hasIgnoreID_ && collider->GetID() == ignoreID_);
+            }),
+            candidates_.end());
+
+        // 他のオブジェクトが動いてめり込んでいる場合は先に押し出す
+        Depenetrate();
+
+        uint32_t flags = kNone;
+        Vector3 horizontal = { displacement.x, 0.0f, displacement.z };
+        bool hasHorizontal = Utility::LengthSquared(horizontal) > 1e-12f;
+
+        // 1. 接地していて水平に動くなら段差の高さだけ持ち上げる
+        float stepUp = 0.0f;
+        Vector3 beforeStep = position_;
+        if (wasGrounded && hasHorizontal && stepOffset_ > 0.0f) {
+            SweepHit hit = Sweep(Utility::Multiply(kUp, stepOffset_));
+            stepUp = stepOffset_ * hit.fraction;
+            position_.y += stepUp;
+        }
+
+        // 2. 水平移動（急な斜面は壁として扱い、登らないようにする）
+        uint32_t horizontalFlags = kNone;
+        if (hasHorizontal) {
+            horizontalFlags = SlideMove(horizontal, true);
+            flags |= horizontalFlags;
+        }
+
+        // 3. 垂直移動（持ち上げた分を戻す）
+        Vector3 vertical = { 0.0f, displacement.y - stepUp, 0.0f };
+        if (stepUp > 0.0f && !(horizontalFlags & kSides) && vertical.y < 0.0f) {
+            // 持ち上げた高さで壁に当たらずに進めた場合は段差の上にいるので、
+            // 段差の角（斜めの法線）に乗っても滑り落ちずにそこで止まる
+            SweepHit hit = Sweep(vertical);
+            position_.y += vertical.y * hit.fraction;
+            float contactHeight = position_.y + radius_ * (1.0f - hit.normal.y);
+            if (hit.hit && hit.normal.y > 0.0f && contactHeight <= beforeStep.y + stepOffset_ + skinWidth_) {
+                groundNormal_ = hit.normal;
+                flags |= kBelow;
+            }
+            else if (hit.hit) {
+                // 段差より高い所に乗ろうとした場合は持ち上げをやめて移動し直す
+                position_ = beforeStep;
+                flags = SlideMove(horizontal, true);
+                flags |= SlideMove({ 0.0f, displacement.y, 0.0f }, false);
+            }
+        }
+        else if (std::abs(vertical.y) > 1e-6f) {
+            flags |= SlideMove(vertical, false);
+        }
+
+        // 4. 接地していたのに地面から離れた場合は段差の高さまで地面に吸着する（階段を降りる）
+        if (wasGrounded && !(flags & kBelow) && displacement.y <= 0.0f && stepOffset_ > 0.0f) {
+            SweepHit hit = Sweep(Utility::Multiply(kUp, -stepOffset_));
+            if (hit.hit && ClassifyNormal(hit.normal) == kBelow) {
+                position_.y -= stepOffset_ * hit.fraction;
+                groundNormal_ = hit.normal;
+                flags |= kBelow;
+            }
+        }
+
+        isGrounded_ = (flags & kBelow) != 0;
+        return flags;
+    }
+
+    CharacterController::SweepHit CharacterController::Sweep(const Vector3& displacement) {
+        SweepHit best;
+        ++lastSweepCount_;
+
+        float length = Utility::Length(displacement);
+        if (length < 1e-6f) return best;
+
+        // 1ステップの移動量が半径の半分を超えないようにサンプリングし、
+        // 初めて重なったサンプルとその手前の間を二分探索する
+        uint32_t samples = static_cast<uint32_t>(std::ceil(length / (radius_ * 0.5f)));
+        samples = std::clamp(samples, 1u, kMaxSweepSamples);
+
+        for (const CollisionObject* collider : candidates_) {
+            // 開始位置で接している場合は、離れる方向への移動のみ許す
+            CollisionResult start = CheckOverlap(MakeCapsule(position_), *collider);
+            if (start.isColliding) {
+                if (Utility::Dot(start.normal, displacement) < 0.0f) {
+                    best.hit = true;
+                    best.fraction = 0.0f;
+                    best.normal = start.normal;
+                }
+                continue;
+            }
+
+            float low = 0.0f;
+            float high = -1.0f;
+            CollisionResult hitResult;
+            for (uint32_t i = 1; i <= samples; ++i) {
+                float t = static_cast<float>(i) / static_cast<float>(samples);
+                if (t >= best.fraction && best.hit) break;
+
+                CollisionResult result = CheckOverlap(MakeCapsule(Utility::Add(position_, Utility::Multiply(displacement, t))), *collider);
+                if (result.isColliding) {
+                    high = t;
+                    hitResult = result;
+                    break;
+                }
+                low = t;
+            }
+            if (high < 0.0f) continue;
+
+            for (uint32_t i = 0; i < kBisectionIterations; ++i) {
+                float mid = (low + high) * 0.5f;
+                CollisionResult result = CheckOverlap(MakeCapsule(Utility::Add(position_, Utility::Multiply(displacement, mid))), *collider);
+                if (result.isColliding) {
+                    high = mid;
+                    hitResult = result;
+                }
+                else {
+                    low = mid;
+                }
+            }
+
+            if (!best.hit || low < best.fraction) {
+                best.hit = true;
+                best.fraction = low;
+                best.normal = hitResult.normal;
+            }
+        }
+
+        // 接触面との隙間を残す
+        if (best.hit) {
+            best.fraction = std::max(0.0f, best.fraction - skinWidth_ / length);
+        }
+        return best;
+    }
+
+    void CharacterController::Depenetrate() {
+        for (uint32_t iteration = 0; iteration < kMaxDepenetrationIterations; ++iteration) {
+            // 最も深くめり込んでいるコライダーから押し出す
+            Capsule capsule = MakeCapsule(position_);
+            CollisionResult deepest;
+            for (const CollisionObject* collider : candidates_) {
+                CollisionResult result = CheckOverlap(capsule, *collider);
+                if (result.isColliding && result.penetration > deepest.penetration) {
+                    deepest = result;
+                }
+            }
+            if (deepest.penetration <= 0.0f) return;
+
+            position_ = Utility::Add(position_, Utility::Multiply(deepest.normal, deepest.penetration + skinWidth_));
+        }
+    }
+
+    uint32_t CharacterController::SlideMove(const Vector3& displacement, bool walkOnly) {
+        uint32_t flags = kNone;
+        Vector3 remaining = displacement;
+        Vector3 firstNormal = { 0.0f, 0.0f, 0.0f };
+        bool hasFirstNormal = false;
+
+        for (uint32_t iteration = 0; iteration < kMaxSlideIterations; ++iteration) {
+            if (Utility::LengthSquared(remaining) < 1e-12f) break;
+
+            SweepHit hit = Sweep(remaining);
+            position_ = Utility::Add(position_, Utility::Multiply(remaining, hit.fraction));
+            if (!hit.hit) break;
+
+            uint32_t contact = ClassifyNormal(hit.normal);
+            flags |= contact;
+            if (contact == kBelow) {
+                groundNormal_ = hit.normal;
+            }
+
+            // 水平移動では急な斜面を垂直な壁として扱う
+            Vector3 normal = hit.normal;
+            if (walkOnly && contact == kSides) {
+                Vector3 flat = { normal.x, 0.0f, normal.z };
+                float flatLength = Utility::Length(flat);
+                if (flatLength > 1e-6f) {
+                    normal = Utility::Multiply(flat, 1.0f / flatLength);
+                }
+            }
+
+            // 残りの移動量を接触面に沿う成分だけにする
+            remaining = Utility::Multiply(remaining, 1.0f - hit.fraction);
+            if (!hasFirstNormal) {
+                float into = Utility::Dot(remaining, normal);
+                if (into < 0.0f) {
+                    remaining = Utility::Subtract(remaining, Utility::Multiply(normal, into));
+                }
+                firstNormal = normal;
+                hasFirstNormal = true;
+            }
+            else {
+                // 2面目に当たったら2面の交線に沿って動かす
+                Vector3 crease = Utility::Cross(firstNormal, normal);
+                float creaseLength = Utility::Length(crease);
+                if (creaseLength < 1e-6f) break;
+                crease = Utility::Multiply(crease, 1.0f / creaseLength);
+                remaining = Utility::Multiply(crease, Utility::Dot(remaining, crease));
+                firstNormal = normal;
+            }
+
+            // 垂直移動では上下の移動だけを続ける（地面の上で横に滑り出さないように）
+            if (!walkOnly && contact == kBelow) break;
+        }
+        return flags;
+    }
+
+    uint32_t CharacterController::ClassifyNormal(const Vector3& normal) const {
+        if (normal.y >= slopeLimitCos_) return kBelow;
+        if (normal.y <= -slopeLimitCos_) return kAbove;
+        return kSides;
+    }
+
+} // namespace Collision
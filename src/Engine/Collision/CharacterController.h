@@ -0,0 +1,123 @@
+#pragma once
+#include "CollisionManager.h"
+#include <cstdint>
+#include <vector>
+
+namespace Collision {
+    // カプセル形状のキャラクターコントローラー（キネマティック）
+    // CollisionManagerに登録されたコライダーに対してカプセルをスウィープし、
+    // 接触面に沿って滑らせる・段差を登り降りする・接地を判定する
+    // 1回のMoveで行うスウィープの回数には上限がある（GetMaxSweepCount）
+    // ※Y軸を上方向とし、位置はカプセルの足元（最下点）を表す
+    class CharacterController {
+    public:
+        // Moveで接触した方向
+        enum CollisionFlags : uint32_t {
+            kNone = 0,
+            kSides = 1 << 0, // 側面（壁・急な斜面）
+            kAbove = 1 << 1, // 上（天井）
+            kBelow = 1 << 2  // 下（歩ける地面）
+        };
+
+        // 1回のスライドで行うスウィープの最大回数
+        static constexpr uint32_t kMaxSlideIterations = 4;
+        // めり込み解消の最大反復回数
+        static constexpr uint32_t kMaxDepenetrationIterations = 4;
+        // 1回のスウィープで1つのコライダーに対して行うサンプル数の上限
+        static constexpr uint32_t kMaxSweepSamples = 16;
+        // 衝突位置の二分探索の回数
+        static constexpr uint32_t kBisectionIterations = 8;
+
+        // コンストラクタ（heightはカプセル全体の高さ）
+        CharacterController(const Vector3& position, float radius, float height);
+
+        // 移動（displacementは今回の移動量、重力などは呼び出し側で加える）
+        // 接触した方向の組み合わせ（CollisionFlags）を返す
+        uint32_t Move(const Vector3& displacement);
+
+        // 位置（足元）
+        void SetPosition(const Vector3& position) { position_ = position; }
+        const Vector3& GetPosition() const { return position_; }
+
+        // 形状
+        float GetRadius() const { return radius_; }
+        float GetHeight() const { return height_; }
+        Capsule GetCapsule() const { return MakeCapsule(position_); }
+
+        // 登れる段差の高さ
+        void SetStepOffset(float stepOffset) { stepOffset_ = stepOffset; }
+        float GetStepOffset() const { return stepOffset_; }
+
+        // 歩ける斜面の最大角度（ラジアン）
+        void SetSlopeLimit(float radians);
+        float GetSlopeLimitCos() const { return slopeLimitCos_; }
+
+        // 接触面との間に残す隙間
+        void SetSkinWidth(float skinWidth) { skinWidth_ = skinWidth; }
+        float GetSkinWidth() const { return skinWidth_; }
+
+        // 判定から除外するコライダー（キャラクター自身のコライダーなど）
+        void SetIgnoreID(uint32_t id) { ignoreID_ = id; hasIgnoreID_ = true; }
+        void ClearIgnoreID() { hasIgnoreID_ = false; }
+
+        // 接地状態
+        bool IsGrounded() const { return isGrounded_; }
+        const Vector3& GetGroundNormal() const { return groundNormal_; }
+
+        // 直近のMoveで行ったスウィープの回数と、1回のMoveで行う最大回数
+        uint32_t GetLastSweepCount() const { return lastSweepCount_; }
+        static constexpr uint32_t GetMaxSweepCount() { return 3 + kMaxSlideIterations * 3; }
+
+    private:
+        // スウィープの結果
+        struct SweepHit {
+            bool hit = false;
+            float fraction = 1.0f; // 移動量に対する衝突までの割合
+            Vector3 normal;        // 障害物からキャラクターへ向かう法線
+        };
+
+        // 位置
+        Vector3 position_;
+        // 形状
+        float radius_;
+        float height_;
+        // 登れる段差の高さ
+        float stepOffset_ = 0.3f;
+        // 歩ける斜面の最大角度の余弦（45度）
+        float slopeLimitCos_ = 0.7071f;
+        // 接触面との隙間
+        float skinWidth_ = 0.01f;
+
+        // 除外するコライダー
+        uint32_t ignoreID_ = 0;
+        bool hasIgnoreID_ = false;
+
+        // 接地状態
+        bool isGrounded_ = false;
+        Vector3 groundNormal_ = { 0.0f, 1.0f, 0.0f };
+
+        // 統計
+        uint32_t lastSweepCount_ = 0;
+
+        // 今回のMoveで判定するコライダー（Moveの開始時に1回だけ問い合わせる）
+        std::vector<CollisionObject*> candidates_;
+
+        // 指定した足元の位置でのカプセル
+        Capsule MakeCapsule(const Vector3& position) const;
+
+        // カプセルとコライダーの衝突判定（法線はコライダーからカプセルへ向かう）
+        static CollisionResult CheckOverlap(const Capsule& capsule, const CollisionObject& collider);
+
+        // 現在位置からdisplacementだけ動かしたときに最初に当たる位置を求める
+        SweepHit Sweep(const Vector3& displacement);
+
+        // めり込みを押し出しで解消する
+        void Depenetrate();
+
+        // 接触面に沿って滑らせながら移動（walkOnlyがtrueなら急な斜面を壁として扱う）
+        uint32_t SlideMove(const Vector3& displacement, bool walkOnly);
+
+        // 法線から接触方向を分類
+        uint32_t ClassifyNormal(const Vector3& normal) const;
+    };
+} // namespace Collision
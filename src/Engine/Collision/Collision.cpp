@@ -1,8 +1,35 @@
 #include "Collision.h"
+#include "ConvexCollision.h"
 #include <algorithm>
 
 namespace Collision {
 
+    namespace {
+        // 線分上でAABBに最も近い点のパラメータを求める
+        // 線分上の点からAABBまでの距離は線分パラメータに対して凸なので三分探索で求める
+        float ClosestSegmentParameterToAABB(const Segment& segment, const AABB& box) {
+            Vector3 direction = Utility::Subtract(segment.end, segment.start);
+            auto distanceSquaredAt = [&](float t) {
+                Vector3 point = Utility::Add(segment.start, Utility::Multiply(direction, t));
+                return Utility::DistanceSquared(point, Utility::ClosestPointOnAABB(point, box.min, box.max));
+            };
+
+            float low = 0.0f;
+            float high = 1.0f;
+            for (int i = 0; i < 24; ++i) {
+                float t1 = low + (high - low) / 3.0f;
+                float t2 = high - (high - low) / 3.0f;
+                if (distanceSquaredAt(t1) <= distanceSquaredAt(t2)) {
+                    high = t2;
+                }
+                else {
+                    low = t1;
+                }
+            }
+            return (low + high) * 0.5f;
+        }
+    }
+
     // 球と球の衝突判定
     CollisionResult CollisionDetector::CheckSphereToSphere(const Sphere& sphere1, const Sphere& sphere2) {
         CollisionResult result;
@@ -197,33 +224,12 @@ namespace Collision {
     CollisionResult CollisionDetector::CheckCapsuleToCapsule(const Capsule& capsule1, const Capsule& capsule2) {
         CollisionResult result;
 
-        // 2つの線分間の最近接点を計算するためのパラメータ
+        // 2つの線分間の最近接点のパラメータ
         Vector3 d1 = Utility::Subtract(capsule1.segment.end, capsule1.segment.start);
         Vector3 d2 = Utility::Subtract(capsule2.segment.end, capsule2.segment.start);
-        Vector3 r = Utility::Subtract(capsule1.segment.start, capsule2.segment.start);
-
-        float a = Utility::Dot(d1, d1);
-        float b = Utility::Dot(d1, d2);
-        float c = Utility::Dot(d2, d2);
-        float d = Utility::Dot(d1, r);
-        float e = Utility::Dot(d2, r);
-
-        float f = a * c - b * b;
-
-        // 平行でない場合
         float s = 0.0f;
         float t = 0.0f;
-
-        if (f > 0.0001f) {
-            // 最近接点のパラメータを計算
-            s = std::clamp((b * e - c * d) / f, 0.0f, 1.0f);
-            t = std::clamp((a * e - b * d) / f, 0.0f, 1.0f);
-        }
-        else {
-            // 線分がほぼ平行の場合、片方の始点と相手の線分との距離を比較して決める
-            s = std::clamp(d / a, 0.0f, 1.0f);
-            t = 0.0f;
-        }
+        Utility::ClosestSegmentParameters(capsule1.segment.start, capsule1.segment.end, capsule2.segment.start, capsule2.segment.end, s, t);
 
         // カプセル1上の最近接点
         Vector3 p1 = Utility::Add(
@@ -392,4 +398,368 @@ namespace Collision {
         return CheckSphereSweepToSphere(movingSphere, velocity, tempSphere, deltaTime);
     }
 
+    // 球とAABBの衝突判定
+    CollisionResult CollisionDetector::CheckSphereToAABB(const Sphere& sphere, const AABB& box) {
+        CollisionResult result;
+
+        // AABB上の最近接点を計算
+        Vector3 closestPoint = Utility::ClosestPointOnAABB(sphere.center, box.min, box.max);
+
+        // 最近接点から球に向かうベクトル
+        Vector3 direction = Utility::Subtract(sphere.center, closestPoint);
+        float distanceSquared = Utility::LengthSquared(direction);
+
+        // 衝突判定
+        if (distanceSquared > sphere.radius * sphere.radius) {
+            return result;
+        }
+
+        result.isColliding = true;
+
+        if (distanceSquared > 0.0001f * 0.0001f) {
+            // 球の中心がAABBの外側にある場合
+            float distance = std::sqrt(distanceSquared);
+            result.normal = Utility::Multiply(direction, 1.0f / distance);
+            result.penetration = sphere.radius - distance;
+            result.collisionPoint = closestPoint;
+        }
+        else {
+            // 球の中心がAABBの内側にある場合は最も近い面から押し出す
+            const float faceDistances[6] = {
+                sphere.center.x - box.min.x, box.max.x - sphere.center.x,
+                sphere.center.y - box.min.y, box.max.y - sphere.center.y,
+                sphere.center.z - box.min.z, box.max.z - sphere.center.z
+            };
+            const Vector3 faceNormals[6] = {
+                { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f },
+                { 0.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+                { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f }
+            };
+            int nearestFace = 0;
+            for (int i = 1; i < 6; ++i) {
+                if (faceDistances[i] < faceDistances[nearestFace]) {
+                    nearestFace = i;
+                }
+            }
+            result.normal = faceNormals[nearestFace];
+            result.penetration = sphere.radius + faceDistances[nearestFace];
+            result.collisionPoint = Utility::Add(
+                sphere.center,
+                Utility::Multiply(result.normal, faceDistances[nearestFace])
+            );
+        }
+
+        return result;
+    }
+
+    // カプセルとAABBの衝突判定
+    CollisionResult CollisionDetector::CheckCapsuleToAABB(const Capsule& capsule, const AABB& box) {
+        float t = ClosestSegmentParameterToAABB(capsule.segment, box);
+
+        // 最近接点を中心とする球とAABBの判定に帰着
+        Sphere sphere;
+        sphere.center = Utility::Add(
+            capsule.segment.start,
+            Utility::Multiply(Utility::Subtract(capsule.segment.end, capsule.segment.start), t)
+        );
+        sphere.radius = capsule.radius;
+
+        return CheckSphereToAABB(sphere, box);
+    }
+
+    // AABBとAABBの衝突判定
+    CollisionResult CollisionDetector::CheckAABBToAABB(const AABB& box1, const AABB& box2) {
+        CollisionResult result;
+
+        // 各軸の重なり量
+        float overlapX = std::min(box1.max.x, box2.max.x) - std::max(box1.min.x, box2.min.x);
+        float overlapY = std::min(box1.max.y, box2.max.y) - std::max(box1.min.y, box2.min.y);
+        float overlapZ = std::min(box1.max.z, box2.max.z) - std::max(box1.min.z, box2.min.z);
+
+        // いずれかの軸で離れていれば衝突しない
+        if (overlapX < 0.0f || overlapY < 0.0f || overlapZ < 0.0f) {
+            return result;
+        }
+
+        result.isColliding = true;
+
+        // 中心の差から法線の向きを決める
+        Vector3 center1 = Utility::Multiply(Utility::Add(box1.min, box1.max), 0.5f);
+        Vector3 center2 = Utility::Multiply(Utility::Add(box2.min, box2.max), 0.5f);
+        Vector3 direction = Utility::Subtract(center2, center1);
+
+        // 重なりが最小の軸を押し出し方向とする
+        if (overlapX <= overlapY && overlapX <= overlapZ) {
+            result.normal = { direction.x >= 0.0f ? 1.0f : -1.0f, 0.0f, 0.0f };
+            result.penetration = overlapX;
+        }
+        else if (overlapY <= overlapZ) {
+            result.normal = { 0.0f, direction.y >= 0.0f ? 1.0f : -1.0f, 0.0f };
+            result.penetration = overlapY;
+        }
+        else {
+            result.normal = { 0.0f, 0.0f, direction.z >= 0.0f ? 1.0f : -1.0f };
+            result.penetration = overlapZ;
+        }
+
+        // 衝突点（重なり領域の中心）
+        result.collisionPoint = {
+            (std::max(box1.min.x, box2.min.x) + std::min(box1.max.x, box2.max.x)) * 0.5f,
+            (std::max(box1.min.y, box2.min.y) + std::min(box1.max.y, box2.max.y)) * 0.5f,
+            (std::max(box1.min.z, box2.min.z) + std::min(box1.max.z, box2.max.z)) * 0.5f
+        };
+
+        return result;
+    }
+
+    // レイと球の交差判定
+    CollisionResult CollisionDetector::RayCastSphere(const Segment& ray, const Sphere& sphere) {
+        CollisionResult result;
+
+        Vector3 rayVector = Utility::Subtract(ray.end, ray.start);
+        float rayLength = Utility::Length(rayVector);
+        if (rayLength < 0.0001f) {
+            return result;
+        }
+        Vector3 rayDir = Utility::Multiply(rayVector, 1.0f / rayLength);
+
+        // 二次方程式 |m + t*d|^2 = r^2 を解く
+        Vector3 m = Utility::Subtract(ray.start, sphere.center);
+        float b = Utility::Dot(m, rayDir);
+        float c = Utility::LengthSquared(m) - sphere.radius * sphere.radius;
+
+        // 始点が球の外側かつ球から遠ざかる向きなら交差しない
+        if (c > 0.0f && b > 0.0f) {
+            return result;
+        }
+
+        float discriminant = b * b - c;
+        if (discriminant < 0.0f) {
+            return result;
+        }
+
+        // 始点が球の内側にある場合は始点で衝突とする
+        float t = std::max(-b - std::sqrt(discriminant), 0.0f);
+        if (t > rayLength) {
+            return result;
+        }
+
+        result.isColliding = true;
+        result.collisionPoint = Utility::Add(ray.start, Utility::Multiply(rayDir, t));
+        Vector3 toSurface = Utility::Subtract(result.collisionPoint, sphere.center);
+        result.normal = Utility::LengthSquared(toSurface) > 0.0001f * 0.0001f
+            ? Utility::Normalize(toSurface)
+            : Utility::Multiply(rayDir, -1.0f);
+        result.penetration = rayLength - t;
+
+        return result;
+    }
+
+    // レイとカプセルの交差判定
+    CollisionResult CollisionDetector::RayCastCapsule(const Segment& ray, const Capsule& capsule) {
+        CollisionResult result;
+
+        Vector3 rayVector = Utility::Subtract(ray.end, ray.start);
+        float rayLength = Utility::Length(rayVector);
+        if (rayLength < 0.0001f) {
+            return result;
+        }
+        Vector3 rayDir = Utility::Multiply(rayVector, 1.0f / rayLength);
+
+        // 両端の球との交差を先に調べる
+        CollisionResult startCap = RayCastSphere(ray, Sphere(capsule.segment.start, capsule.radius));
+        CollisionResult endCap = RayCastSphere(ray, Sphere(capsule.segment.end, capsule.radius));
+        if (startCap.isColliding) result = startCap;
+        if (endCap.isColliding && (!result.isColliding || endCap.penetration > result.penetration)) {
+            result = endCap;
+        }
+
+        // 中心軸
+        Vector3 axis = Utility::Subtract(capsule.segment.end, capsule.segment.start);
+        float axisLength = Utility::Length(axis);
+        if (axisLength < 0.0001f) {
+            return result;
+        }
+        axis = Utility::Multiply(axis, 1.0f / axisLength);
+
+        // 軸に垂直な成分だけで円柱との交差を解く
+        Vector3 m = Utility::Subtract(ray.start, capsule.segment.start);
+        Vector3 mPerp = Utility::Subtract(m, Utility::Multiply(axis, Utility::Dot(m, axis)));
+        Vector3 dPerp = Utility::Subtract(rayDir, Utility::Multiply(axis, Utility::Dot(rayDir, axis)));
+
+        float a = Utility::LengthSquared(dPerp);
+        float b = Utility::Dot(mPerp, dPerp);
+        float c = Utility::LengthSquared(mPerp) - capsule.radius * capsule.radius;
+
+        // 軸とほぼ平行なレイは両端の球の判定で十分
+        if (a < 0.000001f) {
+            return result;
+        }
+
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) {
+            return result;
+        }
+
+        float t = std::max((-b - std::sqrt(discriminant)) / a, 0.0f);
+        if (t > rayLength) {
+            return result;
+        }
+
+        // 交点が円柱部分の範囲内か確認
+        Vector3 hitPoint = Utility::Add(ray.start, Utility::Multiply(rayDir, t));
+        float axial = Utility::Dot(Utility::Subtract(hitPoint, capsule.segment.start), axis);
+        if (axial < 0.0f || axial > axisLength) {
+            return result;
+        }
+
+        // より手前の交点を採用
+        if (!result.isColliding || rayLength - t > result.penetration) {
+            result.isColliding = true;
+            result.collisionPoint = hitPoint;
+            Vector3 radial = Utility::Add(mPerp, Utility::Multiply(dPerp, t));
+            result.normal = Utility::LengthSquared(radial) > 0.0001f * 0.0001f
+                ? Utility::Normalize(radial)
+                : Utility::Multiply(rayDir, -1.0f);
+            result.penetration = rayLength - t;
+        }
+
+        return result;
+    }
+
+    // レイとAABBの交差判定（スラブ法）
+    CollisionResult CollisionDetector::RayCastAABB(const Segment& ray, const AABB& box) {
+        CollisionResult result;
+
+        Vector3 rayVector = Utility::Subtract(ray.end, ray.start);
+        float rayLength = Utility::Length(rayVector);
+        if (rayLength < 0.0001f) {
+            return result;
+        }
+        Vector3 rayDir = Utility::Multiply(rayVector, 1.0f / rayLength);
+
+        const float origin[3] = { ray.start.x, ray.start.y, ray.start.z };
+        const float direction[3] = { rayDir.x, rayDir.y, rayDir.z };
+        const float boxMin[3] = { box.min.x, box.min.y, box.min.z };
+        const float boxMax[3] = { box.max.x, box.max.y, box.max.z };
+
+        float tMin = 0.0f;
+        float tMax = rayLength;
+        int hitAxis = -1;
+        float hitSign = 0.0f;
+
+        for (int i = 0; i < 3; ++i) {
+            if (std::abs(direction[i]) < 0.000001f) {
+                // 軸に平行な場合はスラブ内にあるかだけを見る
+                if (origin[i] < boxMin[i] || origin[i] > boxMax[i]) {
+                    return result;
+                }
+                continue;
+            }
+
+            float invDir = 1.0f / direction[i];
+            float t1 = (boxMin[i] - origin[i]) * invDir;
+            float t2 = (boxMax[i] - origin[i]) * invDir;
+            float sign = -1.0f;
+            if (t1 > t2) {
+                std::swap(t1, t2);
+                sign = 1.0f;
+            }
+            if (t1 > tMin) {
+                tMin = t1;
+                hitAxis = i;
+                hitSign = sign;
+            }
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) {
+                return result;
+            }
+        }
+
+        result.isColliding = true;
+        result.collisionPoint = Utility::Add(ray.start, Utility::Multiply(rayDir, tMin));
+        if (hitAxis == 0) result.normal = { hitSign, 0.0f, 0.0f };
+        else if (hitAxis == 1) result.normal = { 0.0f, hitSign, 0.0f };
+        else if (hitAxis == 2) result.normal = { 0.0f, 0.0f, hitSign };
+        else result.normal = Utility::Multiply(rayDir, -1.0f); // 始点がAABB内部
+        result.penetration = rayLength - tMin;
+
+        return result;
+    }
+
+    // 凸包同士の衝突判定
+    CollisionResult CollisionDetector::CheckConvexToConvex(const ConvexShape& shape1, const ConvexShape& shape2) {
+        return GjkEpa::Solve(ConvexSupport::FromConvex(shape1), ConvexSupport::FromConvex(shape2));
+    }
+
+    // 凸包同士の交差判定
+    bool CollisionDetector::IntersectConvexToConvex(const ConvexShape& shape1, const ConvexShape& shape2) {
+        return GjkEpa::Intersect(ConvexSupport::FromConvex(shape1), ConvexSupport::FromConvex(shape2));
+    }
+
+    // 球と凸包の衝突判定
+    CollisionResult CollisionDetector::CheckSphereToConvex(const Sphere& sphere, const ConvexShape& shape) {
+        return GjkEpa::Solve(ConvexSupport::FromConvex(shape), ConvexSupport::FromSphere(sphere));
+    }
+
+    // カプセルと凸包の衝突判定
+    CollisionResult CollisionDetector::CheckCapsuleToConvex(const Capsule& capsule, const ConvexShape& shape) {
+        return GjkEpa::Solve(ConvexSupport::FromConvex(shape), ConvexSupport::FromCapsule(capsule));
+    }
+
+    // 以下は交差しているかどうかだけの判定
+    // 法線・めり込み量・衝突点を求めないため平方根を使わず距離の2乗の比較だけで済む
+
+    bool CollisionDetector::IntersectSphereToSphere(const Sphere& sphere1, const Sphere& sphere2) {
+        float radiusSum = sphere1.radius + sphere2.radius;
+        return Utility::DistanceSquared(sphere1.center, sphere2.center) <= radiusSum * radiusSum;
+    }
+
+    bool CollisionDetector::IntersectSphereToCapsule(const Sphere& sphere, const Capsule& capsule) {
+        Vector3 closestPoint = Utility::ClosestPointOnSegment(sphere.center, capsule.segment.start, capsule.segment.end);
+        float radiusSum = sphere.radius + capsule.radius;
+        return Utility::DistanceSquared(sphere.center, closestPoint) <= radiusSum * radiusSum;
+    }
+
+    bool CollisionDetector::IntersectCapsuleToCapsule(const Capsule& capsule1, const Capsule& capsule2) {
+        float s = 0.0f;
+        float t = 0.0f;
+        Utility::ClosestSegmentParameters(capsule1.segment.start, capsule1.segment.end, capsule2.segment.start, capsule2.segment.end, s, t);
+
+        Vector3 p1 = Utility::Add(capsule1.segment.start,
+            Utility::Multiply(Utility::Subtract(capsule1.segment.end, capsule1.segment.start), s));
+        Vector3 p2 = Utility::Add(capsule2.segment.start,
+            Utility::Multiply(Utility::Subtract(capsule2.segment.end, capsule2.segment.start), t));
+        float radiusSum = capsule1.radius + capsule2.radius;
+        return Utility::DistanceSquared(p1, p2) <= radiusSum * radiusSum;
+    }
+
+    bool CollisionDetector::IntersectSphereToAABB(const Sphere& sphere, const AABB& box) {
+        Vector3 closestPoint = Utility::ClosestPointOnAABB(sphere.center, box.min, box.max);
+        return Utility::DistanceSquared(sphere.center, closestPoint) <= sphere.radius * sphere.radius;
+    }
+
+    bool CollisionDetector::IntersectCapsuleToAABB(const Capsule& capsule, const AABB& box) {
+        float t = ClosestSegmentParameterToAABB(capsule.segment, box);
+        Sphere sphere;
+        sphere.center = Utility::Add(capsule.segment.start,
+            Utility::Multiply(Utility::Subtract(capsule.segment.end, capsule.segment.start), t));
+        sphere.radius = capsule.radius;
+        return IntersectSphereToAABB(sphere, box);
+    }
+
+    bool CollisionDetector::IntersectAABBToAABB(const AABB& box1, const AABB& box2) {
+        return box1.min.x <= box2.max.x && box1.max.x >= box2.min.x &&
+            box1.min.y <= box2.max.y && box1.max.y >= box2.min.y &&
+            box1.min.z <= box2.max.z && box1.max.z >= box2.min.z;
+    }
+
+    bool CollisionDetector::IntersectSphereToConvex(const Sphere& sphere, const ConvexShape& shape) {
+        return GjkEpa::Intersect(ConvexSupport::FromConvex(shape), ConvexSupport::FromSphere(sphere));
+    }
+
+    bool CollisionDetector::IntersectCapsuleToConvex(const Capsule& capsule, const ConvexShape& shape) {
+        return GjkEpa::Intersect(ConvexSupport::FromConvex(shape), ConvexSupport::FromCapsule(capsule));
+    }
+
 } // namespace Collision
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "CollisionPrimitive.h"
 #include "CollisionUtility.h"
+#include "ConvexHull.h"
 
 namespace Collision {
     // 衝突判定結果
@@ -40,5 +41,44 @@ namespace Collision {
         static CollisionResult CheckSphereSweepToCapsule(
             const Sphere& movingSphere, const Vector3& velocity,
             const Capsule& staticCapsule, float deltaTime);
+
+        // 球とAABBの衝突判定（法線はAABBから球へ向かう）
+        static CollisionResult CheckSphereToAABB(const Sphere& sphere, const AABB& box);
+
+        // カプセルとAABBの衝突判定（法線はAABBからカプセルへ向かう）
+        static CollisionResult CheckCapsuleToAABB(const Capsule& capsule, const AABB& box);
+
+        // AABBとAABBの衝突判定（法線はbox1からbox2へ向かう）
+        static CollisionResult CheckAABBToAABB(const AABB& box1, const AABB& box2);
+
+        // 凸包同士の衝突判定（GJK・EPA、法線はshape1からshape2へ向かう）
+        static CollisionResult CheckConvexToConvex(const ConvexShape& shape1, const ConvexShape& shape2);
+
+        // 凸包同士が交差しているかどうかだけの判定（GJKのみでEPAを行わない）
+        static bool IntersectConvexToConvex(const ConvexShape& shape1, const ConvexShape& shape2);
+
+        // 球と凸包の衝突判定（法線は凸包から球へ向かう）
+        static CollisionResult CheckSphereToConvex(const Sphere& sphere, const ConvexShape& shape);
+
+        // カプセルと凸包の衝突判定（法線は凸包からカプセルへ向かう）
+        static CollisionResult CheckCapsuleToConvex(const Capsule& capsule, const ConvexShape& shape);
+
+        // 交差しているかどうかだけの判定（トリガー・拾得物用）
+        // 詳細情報を計算しないため、対応するCheck系の関数より軽い
+        static bool IntersectSphereToSphere(const Sphere& sphere1, const Sphere& sphere2);
+        static bool IntersectSphereToCapsule(const Sphere& sphere, const Capsule& capsule);
+        static bool IntersectCapsuleToCapsule(const Capsule& capsule1, const Capsule& capsule2);
+        static bool IntersectSphereToAABB(const Sphere& sphere, const AABB& box);
+        static bool IntersectCapsuleToAABB(const Capsule& capsule, const AABB& box);
+        static bool IntersectAABBToAABB(const AABB& box1, const AABB& box2);
+        static bool IntersectSphereToConvex(const Sphere& sphere, const ConvexShape& shape);
+        static bool IntersectCapsuleToConvex(const Capsule& capsule, const ConvexShape& shape);
+
+        // レイ（線分）と各形状の交差判定
+        // 衝突点はレイが最初に表面へ到達した点、法線はその点での表面法線、
+        // めり込み量は衝突点からレイ終点までの残り距離とする
+        static CollisionResult RayCastSphere(const Segment& ray, const Sphere& sphere);
+        static CollisionResult RayCastCapsule(const Segment& ray, const Capsule& capsule);
+        static CollisionResult RayCastAABB(const Segment& ray, const AABB& box);
     };
 } // namespace Collision
\ No newline at end of file
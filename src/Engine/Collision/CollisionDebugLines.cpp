@@ -0,0 +1,197 @@
+#include "CollisionDebugLines.h"
+#include "CollisionUtility.h"
+#include <algorithm>
+#include <array>
+
+namespace Collision {
+
+    namespace {
+        // 単位円の座標テーブル（kCircleSegments + 1点、最後は始点と同じ）
+        struct CircleTable {
+            std::array<float, DebugLineBuilder::kCircleSegments + 1> cosTable;
+            std::array<float, DebugLineBuilder::kCircleSegments + 1> sinTable;
+
+            CircleTable() {
+                const float kTwoPi = 6.28318530718f;
+                for (uint32_t i = 0; i <= DebugLineBuilder::kCircleSegments; ++i) {
+                    float angle = kTwoPi * static_cast<float>(i) / static_cast<float>(DebugLineBuilder::kCircleSegments);
+                    cosTable[i] = std::cos(angle);
+                    sinTable[i] = std::sin(angle);
+                }
+            }
+        };
+
+        const CircleTable& GetCircleTable() {
+            static const CircleTable table;
+            return table;
+        }
+
+        // 指定方向に垂直な2つの単位ベクトルを求める
+        void MakeBasis(const Vector3& axis, Vector3& u, Vector3& v) {
+            Vector3 helper = std::abs(axis.y) < 0.9f ? Vector3{ 0.0f, 1.0f, 0.0f } : Vector3{ 1.0f, 0.0f, 0.0f };
+            u = Utility::Normalize(Utility::Cross(axis, helper));
+            v = Utility::Cross(axis, u);
+        }
+    }
+
+    DebugLineBuilder::DebugLineBuilder(std::vector<DebugLineVertex>& output, uint32_t maxLines)
+        : output_(output), maxLines_(maxLines) {
+        output_.clear();
+        output_.reserve(static_cast<size_t>(maxLines) * 2);
+    }
+
+    bool DebugLineBuilder::Reserve(uint32_t lines) {
+        if (lineCount_ + lines > maxLines_) {
+            ++droppedShapes_;
+            return false;
+        }
+        return true;
+    }
+
+    void DebugLineBuilder::AddLine(const Vector3& start, const Vector3& end, const Vector4& color) {
+        output_.push_back({ start, color });
+        output_.push_back({ end, color });
+        ++lineCount_;
+    }
+
+    void DebugLineBuilder::AddArc(const Vector3& center, float radius, const Vector3& axisU, const Vector3& axisV,
+        uint32_t startSegment, uint32_t segments, const Vector4& color) {
+        const CircleTable& table = GetCircleTable();
+        auto pointAt = [&](uint32_t index) {
+            uint32_t i = index % kCircleSegments;
+            return Utility::Add(center, Utility::Add(
+                Utility::Multiply(axisU, table.cosTable[i] * radius),
+                Utility::Multiply(axisV, table.sinTable[i] * radius)));
+        };
+
+        Vector3 previous = pointAt(startSegment);
+        for (uint32_t s = 1; s <= segments; ++s) {
+            Vector3 current = pointAt(startSegment + s);
+            AddLine(previous, current, color);
+            previous = current;
+        }
+    }
+
+    bool DebugLineBuilder::AddSphere(const Sphere& sphere, const Vector4& color) {
+        if (!Reserve(kSphereLineCount)) return false;
+
+        const Vector3 axisX = { 1.0f, 0.0f, 0.0f };
+        const Vector3 axisY = { 0.0f, 1.0f, 0.0f };
+        const Vector3 axisZ = { 0.0f, 0.0f, 1.0f };
+
+        // XY・YZ・ZXの3つの大円
+        AddArc(sphere.center, sphere.radius, axisX, axisY, 0, kCircleSegments, color);
+        AddArc(sphere.center, sphere.radius, axisY, axisZ, 0, kCircleSegments, color);
+        AddArc(sphere.center, sphere.radius, axisZ, axisX, 0, kCircleSegments, color);
+        return true;
+    }
+
+    bool DebugLineBuilder::AddCapsule(const Capsule& capsule, const Vector4& color) {
+        if (!Reserve(kCapsuleLineCount)) return false;
+
+        const Vector3& start = capsule.segment.start;
+        const Vector3& end = capsule.segment.end;
+        float radius = capsule.radius;
+
+        // 中心軸と直交基底
+        Vector3 axis = Utility::Subtract(end, start);
+        if (Utility::LengthSquared(axis) < 0.000001f) {
+            axis = { 0.0f, 1.0f, 0.0f };
+        }
+        axis = Utility::Normalize(axis);
+        Vector3 u, v;
+        MakeBasis(axis, u, v);
+
+        // 両端の円
+        AddArc(start, radius, u, v, 0, kCircleSegments, color);
+        AddArc(end, radius, u, v, 0, kCircleSegments, color);
+
+        // 側面の4本の線
+        const Vector3 sides[4] = { u, v, Utility::Multiply(u, -1.0f), Utility::Multiply(v, -1.0f) };
+        for (const Vector3& side : sides) {
+            Vector3 offset = Utility::Multiply(side, radius);
+            AddLine(Utility::Add(start, offset), Utility::Add(end, offset), color);
+        }
+
+        // 両端の半球（軸を含む2平面の半円）
+        const uint32_t half = kCircleSegments / 2;
+        Vector3 negAxis = Utility::Multiply(axis, -1.0f);
+        AddArc(end, radius, u, axis, 0, half, color);
+        AddArc(end, radius, v, axis, 0, half, color);
+        AddArc(start, radius, u, negAxis, 0, half, color);
+        AddArc(start, radius, v, negAxis, 0, half, color);
+        return true;
+    }
+
+    bool DebugLineBuilder::AddAABB(const AABB& box, const Vector4& color) {
+        if (!Reserve(kBoxLineCount)) return false;
+
+        // 8頂点
+        Vector3 corners[8];
+        for (uint32_t i = 0; i < 8; ++i) {
+            corners[i] = {
+                (i & 1) ? box.max.x : box.min.x,
+                (i & 2) ? box.max.y : box.min.y,
+                (i & 4) ? box.max.z : box.min.z
+            };
+        }
+
+        // 各軸方向の辺（ビットが1つだけ異なる頂点同士を結ぶ）
+        for (uint32_t i = 0; i < 8; ++i) {
+            for (uint32_t bit = 1; bit < 8; bit <<= 1) {
+                if ((i & bit) == 0) {
+                    AddLine(corners[i], corners[i | bit], color);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool DebugLineBuilder::AddConvexHull(const ConvexShape& shape, const Vector4& color) {
+        if (!shape.hull) return false;
+
+        const std::vector<uint32_t>& edges = shape.hull->GetEdges();
+        if (!Reserve(static_cast<uint32_t>(edges.size() / 2))) return false;
+
+        for (size_t i = 0; i + 1 < edges.size(); i += 2) {
+            AddLine(shape.TransformPoint(shape.hull->GetVertex(edges[i])),
+                shape.TransformPoint(shape.hull->GetVertex(edges[i + 1])), color);
+        }
+        return true;
+    }
+
+    bool DebugLineBuilder::AddHeightfield(const Heightfield& heightfield, const Vector4& color) {
+        // 線の本数が上限に収まるまで格子点を間引く
+        uint32_t stride = 1;
+        auto countSamples = [&stride](uint32_t samples) { return (samples - 1 + stride - 1) / stride + 1; };
+        auto countLines = [&]() {
+            uint32_t columns = countSamples(heightfield.GetSamplesX());
+            uint32_t rows = countSamples(heightfield.GetSamplesZ());
+            return rows * (columns - 1) + columns * (rows - 1);
+        };
+        while (countLines() > kMaxHeightfieldLines) {
+            stride *= 2;
+        }
+        if (!Reserve(countLines())) return false;
+
+        // 間引いた格子点の番号（最後の格子点は必ず含める）
+        auto sampleIndex = [&stride](uint32_t i, uint32_t samples) { return std::min(i * stride, samples - 1); };
+        uint32_t columns = countSamples(heightfield.GetSamplesX());
+        uint32_t rows = countSamples(heightfield.GetSamplesZ());
+        for (uint32_t row = 0; row < rows; ++row) {
+            uint32_t z = sampleIndex(row, heightfield.GetSamplesZ());
+            for (uint32_t column = 0; column < columns; ++column) {
+                uint32_t x = sampleIndex(column, heightfield.GetSamplesX());
+                Vector3 point = heightfield.GetPoint(x, z);
+                if (column + 1 < columns) {
+                    AddLine(point, heightfield.GetPoint(sampleIndex(column + 1, heightfield.GetSamplesX()), z), color);
+                }
+                if (row + 1 < rows) {
+                    AddLine(point, heightfield.GetPoint(x, sampleIndex(row + 1, heightfield.GetSamplesZ())), color);
+                }
+            }
+        }
+        return true;
+    }
+
+} // namespace Collision
@@ -0,0 +1,67 @@
+#pragma once
+#include "CollisionPrimitive.h"
+#include "ConvexHull.h"
+#include "Heightfield.h"
+#include "Vector4.h"
+#include <cstdint>
+#include <vector>
+
+namespace Collision {
+    // デバッグ描画用の線分頂点（2頂点で1本の線）
+    struct DebugLineVertex {
+        Vector3 position;
+        Vector4 color;
+    };
+
+    // コライダーのワイヤーフレームを1つの連続した頂点配列に書き出すクラス
+    // 出力先の配列はフレーム間で使い回し、線の本数が上限に達したら以降の形状は書き出さない
+    class DebugLineBuilder {
+    public:
+        // 円1周の分割数
+        static constexpr uint32_t kCircleSegments = 16;
+        // 球1つあたりの線の本数（3つの大円）
+        static constexpr uint32_t kSphereLineCount = kCircleSegments * 3;
+        // カプセル1つあたりの線の本数（両端の円2つ＋側面4本＋両端の半円4つ）
+        static constexpr uint32_t kCapsuleLineCount = kCircleSegments * 2 + 4 + kCircleSegments * 2;
+        // AABB1つあたりの線の本数
+        static constexpr uint32_t kBoxLineCount = 12;
+        // 地形1つあたりの線の本数の上限（超える場合は格子点を間引く）
+        static constexpr uint32_t kMaxHeightfieldLines = 4096;
+
+        // コンストラクタ（outputはクリアされ、maxLines本分の容量が確保される）
+        DebugLineBuilder(std::vector<DebugLineVertex>& output, uint32_t maxLines);
+
+        // 形状の追加（上限を超える場合は追加せずfalseを返す）
+        bool AddSphere(const Sphere& sphere, const Vector4& color);
+        bool AddCapsule(const Capsule& capsule, const Vector4& color);
+        bool AddAABB(const AABB& box, const Vector4& color);
+        bool AddConvexHull(const ConvexShape& shape, const Vector4& color); // 凸包の辺をすべて描く
+        bool AddHeightfield(const Heightfield& heightfield, const Vector4& color); // 地形の格子を描く
+
+        // 書き出した線の本数
+        uint32_t GetLineCount() const { return lineCount_; }
+
+        // 上限により書き出せなかった形状の数
+        uint32_t GetDroppedShapeCount() const { return droppedShapes_; }
+
+    private:
+        // 出力先
+        std::vector<DebugLineVertex>& output_;
+        // 線の本数の上限
+        uint32_t maxLines_;
+        // 書き出した線の本数
+        uint32_t lineCount_ = 0;
+        // 書き出せなかった形状の数
+        uint32_t droppedShapes_ = 0;
+
+        // 上限チェック（足りなければ破棄数を数えてfalse）
+        bool Reserve(uint32_t lines);
+
+        // 線分の追加
+        void AddLine(const Vector3& start, const Vector3& end, const Vector4& color);
+
+        // 中心・半径と2つの直交軸で指定した円弧を追加（segments分割、startSegmentから）
+        void AddArc(const Vector3& center, float radius, const Vector3& axisU, const Vector3& axisV,
+            uint32_t startSegment, uint32_t segments, const Vector4& color);
+    };
+} // namespace Collision
@@ -1,10 +1,38 @@
 #include "CollisionManager.h"
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
 
 namespace Collision {
 
+    namespace {
+        // 経過時間（ミリ秒）
+        using Clock = std::chrono::steady_clock;
+        double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        // 形状ごとの境界ボックス
+        AABB SphereBounds(const Sphere& sphere) {
+            AABB box;
+            box.min = { sphere.center.x - sphere.radius, sphere.center.y - sphere.radius, sphere.center.z - sphere.radius };
+            box.max = { sphere.center.x + sphere.radius, sphere.center.y + sphere.radius, sphere.center.z + sphere.radius };
+            return box;
+        }
+
+        AABB CapsuleBounds(const Capsule& capsule) {
+            const Vector3& a = capsule.segment.start;
+            const Vector3& b = capsule.segment.end;
+            AABB box;
+            box.min = { std::min(a.x, b.x) - capsule.radius, std::min(a.y, b.y) - capsule.radius, std::min(a.z, b.z) - capsule.radius };
+            box.max = { std::max(a.x, b.x) + capsule.radius, std::max(a.y, b.y) + capsule.radius, std::max(a.z, b.z) + capsule.radius };
+            return box;
+        }
+    }
+
     // 静的メンバ変数の初期化
-    uint32_t CollisionObject::nextID_ = 0;
+    std::atomic<uint32_t> CollisionObject::nextID_ = 0;
     CollisionManager* CollisionManager::instance_ = nullptr;
 
     CollisionManager* CollisionManager::GetInstance() {
@@ -15,16 +43,26 @@ namespace Collision {
     }
 
     void CollisionManager::AddCollider(std::shared_ptr<CollisionObject> collider) {
-        // 既に登録されているかチェック
-        auto it = std::find_if(colliders_.begin(), colliders_.end(),
-            [collider](const std::shared_ptr<CollisionObject>& existing) {
-                return existing->GetID() == collider->GetID();
-            });
-
-        // 登録されていなければ追加
-        if (it == colliders_.end()) {
-            colliders_.push_back(collider);
+        // 既に登録されているかチェック（IDから位置を引くので登録数によらない）
+        if (colliderIndices_.Contains(collider->GetID())) {
+            return;
         }
+
+        // 状態をマネージャーの配列の末尾に移す（以降のSet系関数は配列の要素を書き換える）
+        const uint32_t index = static_cast<uint32_t>(colliders_.size());
+        CollisionObject& object = *collider;
+        poseArrays_.ids.push_back(object.id_);
+        poseArrays_.versions.push_back(object.version_);
+        poseArrays_.flags.push_back(object.flags_);
+        poseArrays_.velocities.push_back(object.velocity_);
+        poseArrays_.poses.push_back(object.pose_);
+        poseArrays_.shapeTypes.push_back(static_cast<uint8_t>(object.GetShapeType()));
+        object.poseArrays_ = &poseArrays_;
+        object.poseIndex_ = index;
+
+        colliderIndices_.InsertOrAssign(object.id_, index);
+        removedSinceSnapshot_.Erase(object.id_);
+        colliders_.push_back(std::move(collider));
     }
 
     void CollisionManager::RemoveCollider(std::shared_ptr<CollisionObject> collider) {
@@ -32,153 +70,678 @@ namespace Collision {
     }
 
     void CollisionManager::RemoveCollider(uint32_t id) {
-        // 指定IDのコライダーを削除
-        auto it = std::remove_if(colliders_.begin(), colliders_.end(),
-            [id](const std::shared_ptr<CollisionObject>& collider) {
-                return collider->GetID() == id;
-            });
+        const uint32_t* found = colliderIndices_.Find(id);
+        if (!found) {
+            return;
+        }
 
-        // 実際に削除
-        if (it != colliders_.end()) {
-            colliders_.erase(it, colliders_.end());
+        // 末尾のコライダーを削除位置に移して詰める（以降の要素をずらさない）
+        const uint32_t index = *found;
+        const size_t last = colliders_.size() - 1;
+        colliderIndices_.Erase(id);
+        DetachPose(*colliders_[index]);
+        if (index != last) {
+            colliders_[index] = std::move(colliders_.back());
+            poseArrays_.ids[index] = poseArrays_.ids[last];
+            poseArrays_.versions[index] = poseArrays_.versions[last];
+            poseArrays_.flags[index] = poseArrays_.flags[last];
+            poseArrays_.velocities[index] = poseArrays_.velocities[last];
+            poseArrays_.poses[index] = poseArrays_.poses[last];
+            poseArrays_.shapeTypes[index] = poseArrays_.shapeTypes[last];
+            colliders_[index]->poseIndex_ = index;
+            colliderIndices_.InsertOrAssign(colliders_[index]->GetID(), index);
         }
+        colliders_.pop_back();
+        poseArrays_.ids.pop_back();
+        poseArrays_.versions.pop_back();
+        poseArrays_.flags.pop_back();
+        poseArrays_.velocities.pop_back();
+        poseArrays_.poses.pop_back();
+        poseArrays_.shapeTypes.pop_back();
+
+        // 判定済み・判定中のスナップショットに残っていても通知しない
+        removedSinceSnapshot_[id] = 1;
     }
 
     void CollisionManager::ClearColliders() {
+        // 実行中の判定はスナップショットを参照しているため完了を待って破棄する
+        if (pendingUpdate_.valid()) {
+            pendingUpdate_.get();
+        }
+
+        for (const auto& collider : colliders_) {
+            removedSinceSnapshot_[collider->GetID()] = 1;
+            DetachPose(*collider);
+        }
         colliders_.clear();
+        colliderIndices_.Clear();
+        poseArrays_.ids.clear();
+        poseArrays_.versions.clear();
+        poseArrays_.flags.clear();
+        poseArrays_.velocities.clear();
+        poseArrays_.poses.clear();
+        poseArrays_.shapeTypes.clear();
+
+        // 通知中でなければスナップショットが保持している参照も解放する
+        if (!isDispatching_) {
+            for (CollisionFrame& frame : frames_) {
+                frame.objects.clear();
+                frame.states.clear();
+                frame.contacts.clear();
+                frame.hitFlags.clear();
+            }
+            removedSinceSnapshot_.Clear();
+        }
+        pairCache_.previous.Clear();
+        pairCache_.current.Clear();
+    }
+
+    void CollisionManager::DetachPose(CollisionObject& collider) {
+        const ColliderPoseArrays& arrays = *collider.poseArrays_;
+        const uint32_t index = collider.poseIndex_;
+        collider.version_ = arrays.versions[index];
+        collider.flags_ = arrays.flags[index];
+        collider.velocity_ = arrays.velocities[index];
+        collider.pose_ = arrays.poses[index];
+        collider.poseArrays_ = nullptr;
+        collider.poseIndex_ = 0;
+    }
+
+    void CollisionManager::EnqueueAddCollider(std::shared_ptr<CollisionObject> collider) {
+        commandQueue_.Push({ ColliderCommand::Type::Add, std::move(collider), 0, false });
+    }
+
+    void CollisionManager::EnqueueRemoveCollider(uint32_t id) {
+        commandQueue_.Push({ ColliderCommand::Type::Remove, nullptr, id, false });
+    }
+
+    void CollisionManager::EnqueueSetEnabled(std::shared_ptr<CollisionObject> collider, bool enabled) {
+        commandQueue_.Push({ ColliderCommand::Type::SetEnabled, std::move(collider), 0, enabled });
+    }
+
+    uint32_t CollisionManager::ApplyQueuedCommands() {
+        size_t count = commandQueue_.Drain([this](ColliderCommand&& command) {
+            switch (command.type) {
+            case ColliderCommand::Type::Add:
+                AddCollider(std::move(command.collider));
+                break;
+            case ColliderCommand::Type::Remove:
+                RemoveCollider(command.id);
+                break;
+            case ColliderCommand::Type::SetEnabled:
+                command.collider->SetEnabled(command.enabled);
+                break;
+            }
+        });
+        return static_cast<uint32_t>(count);
+    }
+
+    void CollisionManager::QueryColliders(const AABB& bounds, std::vector<CollisionObject*>& out) const {
+        out.clear();
+        for (const auto& collider : colliders_) {
+            if (!collider->IsEnabled()) continue;
+
+            AABB box = ComputeBounds(*collider);
+            if (box.min.x > bounds.max.x || box.max.x < bounds.min.x ||
+                box.min.y > bounds.max.y || box.max.y < bounds.min.y ||
+                box.min.z > bounds.max.z || box.max.z < bounds.min.z) {
+                continue;
+            }
+            out.push_back(collider.get());
+        }
+    }
+
+    AABB CollisionManager::ComputeBounds(const CollisionObject& collider) {
+        switch (collider.GetShapeType()) {
+        case CollisionObject::ShapeType::Sphere:
+            return SphereBounds(static_cast<const SphereCollider&>(collider).GetSphere());
+        case CollisionObject::ShapeType::Capsule:
+            return CapsuleBounds(static_cast<const CapsuleCollider&>(collider).GetCapsule());
+        case CollisionObject::ShapeType::Heightfield:
+            return static_cast<const HeightfieldCollider&>(collider).GetHeightfield().GetBounds();
+        default:
+            return static_cast<const ConvexHullCollider&>(collider).GetConvexShape().ComputeBounds();
+        }
     }
 
     void CollisionManager::Update(float deltaTime) {
-        // すべてのコライダーの組み合わせで衝突判定
+        Clock::time_point updateStart = Clock::now();
+
+        // 他スレッドから発行された追加・削除・有効化を反映
+        uint32_t queuedCommands = ApplyQueuedCommands();
+
+        if (!asyncUpdate_) {
+            // 同期モード：スナップショットを判定してすぐに公開・通知
+            CollisionFrame& frame = frames_[frontFrame_ ^ 1];
+            CaptureSnapshot(frame, deltaTime);
+            Clock::time_point snapshotEnd = Clock::now();
+
+            DetectCollisions(frame, pairCache_);
+            frontFrame_ ^= 1;
+
+            Clock::time_point callbackStart = Clock::now();
+            uint32_t callbackCount = DispatchCallbacks();
+            Clock::time_point updateEnd = Clock::now();
+
+            PublishStats(callbackCount, ElapsedMs(updateStart, snapshotEnd), 0.0,
+                ElapsedMs(callbackStart, updateEnd), ElapsedMs(updateStart, updateEnd));
+            stats_.queuedCommands = queuedCommands;
+            return;
+        }
+
+        // 非同期モード：前回開始した判定の結果を公開して通知
+        bool published = CompletePendingUpdate();
+        Clock::time_point waitEnd = Clock::now();
+        uint32_t callbackCount = published ? DispatchCallbacks() : 0;
+        Clock::time_point callbackEnd = Clock::now();
+
+        // 通知後の状態でスナップショットを取り、公開中でない側のフレームで判定を開始
+        CollisionFrame& frame = frames_[frontFrame_ ^ 1];
+        CaptureSnapshot(frame, deltaTime);
+        Clock::time_point updateEnd = Clock::now();
+        pendingUpdate_ = std::async(std::launch::async, [this, &frame]() {
+            DetectCollisions(frame, pairCache_);
+        });
+
+        if (published) {
+            PublishStats(callbackCount, ElapsedMs(callbackEnd, updateEnd), ElapsedMs(updateStart, waitEnd),
+                ElapsedMs(waitEnd, callbackEnd), ElapsedMs(updateStart, updateEnd));
+        }
+        else {
+            // まだ公開できる結果がない
+            stats_ = CollisionStats();
+            stats_.colliderCount = static_cast<uint32_t>(colliders_.size());
+            stats_.snapshotMs = ElapsedMs(callbackEnd, updateEnd);
+            stats_.mainThreadMs = ElapsedMs(updateStart, updateEnd);
+        }
+        stats_.queuedCommands = queuedCommands;
+    }
+
+    void CollisionManager::SetAsyncUpdate(bool enabled) {
+        if (asyncUpdate_ == enabled) return;
+        asyncUpdate_ = enabled;
+
+        // 同期モードに戻す場合は判定中の結果を取りこぼさないように通知しておく
+        // （スナップショットは前回のUpdateで取ったものなので、ここでの作成時間は0とする）
+        if (enabled) return;
+        Clock::time_point start = Clock::now();
+        if (!CompletePendingUpdate()) return;
+        Clock::time_point waitEnd = Clock::now();
+        uint32_t callbackCount = DispatchCallbacks();
+        Clock::time_point callbackEnd = Clock::now();
+
+        PublishStats(callbackCount, 0.0, ElapsedMs(start, waitEnd),
+            ElapsedMs(waitEnd, callbackEnd), ElapsedMs(start, callbackEnd));
+    }
+
+    bool CollisionManager::CompletePendingUpdate() {
+        if (!pendingUpdate_.valid()) return false;
+
+        // ワーカースレッドでの例外もここで再送出される
+        pendingUpdate_.get();
+        frontFrame_ ^= 1;
+        return true;
+    }
+
+    void CollisionManager::SaveSnapshot(std::vector<uint8_t>& out) {
+        static_assert(std::is_trivially_copyable_v<ColliderPose>, "collider poses are copied with memcpy");
+
+        // 判定中のスレッドがペアキャッシュを書き終えるのを待つ（結果の公開は次のUpdateで行う）
+        if (pendingUpdate_.valid()) {
+            pendingUpdate_.wait();
+        }
+
+        SnapshotHeader header;
+        header.magic = kSnapshotMagic;
+        header.version = kSnapshotVersion;
+        header.colliderCount = static_cast<uint32_t>(colliders_.size());
+        header.pairCacheCount = static_cast<uint32_t>(pairCache_.current.Size());
+
+        // ペアキャッシュ（次の判定で前フレームの結果として参照される側）
+        // ハッシュマップの並びは挿入の履歴で変わるので、キーの順に並べて同じ状態なら同じバイト列にする
+        snapshotPairs_.clear();
+        pairCache_.current.ForEach([this](uint64_t key, const PairCacheEntry& entry) {
+            SnapshotPairCache record{};
+            record.key = key;
+            record.version1 = entry.version1;
+            record.version2 = entry.version2;
+            record.deltaTime = entry.deltaTime;
+            record.isColliding = entry.result.isColliding ? 1 : 0;
+            record.collisionPoint = entry.result.collisionPoint;
+            record.normal = entry.result.normal;
+            record.penetration = entry.result.penetration;
+            snapshotPairs_.push_back(record);
+        });
+        std::sort(snapshotPairs_.begin(), snapshotPairs_.end(),
+            [](const SnapshotPairCache& a, const SnapshotPairCache& b) { return a.key < b.key; });
+
+        const size_t count = header.colliderCount;
+        out.resize(sizeof(SnapshotHeader) + kSnapshotColliderSize * count + sizeof(SnapshotPairCache) * snapshotPairs_.size());
+        uint8_t* data = out.data();
+        auto write = [&data](const void* source, size_t size) {
+            if (size > 0) {
+                std::memcpy(data, source, size);
+                data += size;
+            }
+        };
+
+        // コライダーは配列ごとにそのまま写す
+        write(&header, sizeof(header));
+        write(poseArrays_.ids.data(), sizeof(uint32_t) * count);
+        write(poseArrays_.versions.data(), sizeof(uint32_t) * count);
+        write(poseArrays_.flags.data(), sizeof(uint32_t) * count);
+        write(poseArrays_.velocities.data(), sizeof(Vector3) * count);
+        write(poseArrays_.poses.data(), sizeof(ColliderPose) * count);
+        write(poseArrays_.shapeTypes.data(), sizeof(uint8_t) * count);
+        write(snapshotPairs_.data(), sizeof(SnapshotPairCache) * snapshotPairs_.size());
+    }
+
+    bool CollisionManager::RestoreSnapshot(const std::vector<uint8_t>& data) {
+        // 形式と大きさの確認
+        SnapshotHeader header;
+        if (data.size() < sizeof(header)) return false;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion) return false;
+
+        const size_t count = header.colliderCount;
+        if (data.size() != sizeof(SnapshotHeader) + kSnapshotColliderSize * count + sizeof(SnapshotPairCache) * header.pairCacheCount) {
+            return false;
+        }
+
+        // 各配列の先頭
+        const uint8_t* ids = data.data() + sizeof(SnapshotHeader);
+        const uint8_t* versions = ids + sizeof(uint32_t) * count;
+        const uint8_t* flags = versions + sizeof(uint32_t) * count;
+        const uint8_t* velocities = flags + sizeof(uint32_t) * count;
+        const uint8_t* poses = velocities + sizeof(Vector3) * count;
+        const uint8_t* shapeTypes = poses + sizeof(ColliderPose) * count;
+        const uint8_t* pairCache = shapeTypes + sizeof(uint8_t) * count;
+
+        // 保存時点と並びが同じなら配列ごと戻し、違えばIDで対応を取って1個ずつ戻す
+        const bool sameOrder = count == colliders_.size() &&
+            (count == 0 || std::memcmp(ids, poseArrays_.ids.data(), sizeof(uint32_t) * count) == 0);
+        if (sameOrder) {
+            if (count > 0 && std::memcmp(shapeTypes, poseArrays_.shapeTypes.data(), count) != 0) return false;
+        }
+        else {
+            // 書き換える前に、同じIDのコライダーの形状の種類がすべて一致するか確認する
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t id;
+                std::memcpy(&id, ids + sizeof(uint32_t) * i, sizeof(id));
+                const uint32_t* index = colliderIndices_.Find(id);
+                if (index && poseArrays_.shapeTypes[*index] != shapeTypes[i]) return false;
+            }
+        }
+
+        // 実行中の判定は戻す前の状態に対するものなので破棄する
+        if (pendingUpdate_.valid()) {
+            pendingUpdate_.get();
+        }
+
+        // コライダー（登録中のコライダーは配列の要素を読み書きするので、配列を書き換えれば戻る）
+        if (sameOrder) {
+            if (count > 0) {
+                std::memcpy(poseArrays_.versions.data(), versions, sizeof(uint32_t) * count);
+                std::memcpy(poseArrays_.flags.data(), flags, sizeof(uint32_t) * count);
+                std::memcpy(poseArrays_.velocities.data(), velocities, sizeof(Vector3) * count);
+                std::memcpy(poseArrays_.poses.data(), poses, sizeof(ColliderPose) * count);
+            }
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t id;
+                std::memcpy(&id, ids + sizeof(uint32_t) * i, sizeof(id));
+                const uint32_t* found = colliderIndices_.Find(id);
+                if (!found) continue;
+
+                const uint32_t index = *found;
+                std::memcpy(&poseArrays_.versions[index], versions + sizeof(uint32_t) * i, sizeof(uint32_t));
+                std::memcpy(&poseArrays_.flags[index], flags + sizeof(uint32_t) * i, sizeof(uint32_t));
+                std::memcpy(&poseArrays_.velocities[index], velocities + sizeof(Vector3) * i, sizeof(Vector3));
+                std::memcpy(&poseArrays_.poses[index], poses + sizeof(ColliderPose) * i, sizeof(ColliderPose));
+            }
+        }
+
+        // ペアキャッシュ（保存後に削除されたコライダーのペアは参照されないまま次の判定で消える）
+        pairCache_.previous.Clear();
+        pairCache_.current.Clear();
+        pairCache_.current.Reserve(header.pairCacheCount);
+        for (uint32_t i = 0; i < header.pairCacheCount; ++i) {
+            SnapshotPairCache record;
+            std::memcpy(&record, pairCache + sizeof(SnapshotPairCache) * i, sizeof(record));
+            PairCacheEntry entry;
+            entry.version1 = record.version1;
+            entry.version2 = record.version2;
+            entry.deltaTime = record.deltaTime;
+            entry.result.isColliding = record.isColliding != 0;
+            entry.result.collisionPoint = record.collisionPoint;
+            entry.result.normal = record.normal;
+            entry.result.penetration = record.penetration;
+            pairCache_.current.InsertOrAssign(record.key, entry);
+        }
+        return true;
+    }
+
+    void CollisionManager::CaptureSnapshot(CollisionFrame& frame, float deltaTime) {
+        frame.deltaTime = deltaTime;
+        frame.usePairCache = pairCacheEnabled_;
+        frame.objects.assign(colliders_.begin(), colliders_.end());
+        frame.states.resize(colliders_.size());
+
+        // 状態はマネージャーの配列から読み、共有している凸包・地形だけをコライダーから取る
         for (size_t i = 0; i < colliders_.size(); ++i) {
-            // 無効なコライダーはスキップ
-            if (!colliders_[i]->IsEnabled()) continue;
-
-            for (size_t j = i + 1; j < colliders_.size(); ++j) {
-                // 無効なコライダーはスキップ
-                if (!colliders_[j]->IsEnabled()) continue;
-
-                // 衝突判定
-                CollisionResult result;
-
-                // 両方とも剛体の場合や、少なくとも一方が速度を持つ場合はスウィープテストを行う
-                if ((colliders_[i]->IsRigidbody() && colliders_[j]->IsRigidbody()) ||
-                    Utility::Length(colliders_[i]->GetVelocity()) > 0.0001f ||
-                    Utility::Length(colliders_[j]->GetVelocity()) > 0.0001f) {
-
-                    // 動いているオブジェクトを優先してスウィープテスト
-                    if (Utility::Length(colliders_[i]->GetVelocity()) >
-                        Utility::Length(colliders_[j]->GetVelocity())) {
-                        result = CheckSweepCollision(colliders_[i].get(), colliders_[j].get(), deltaTime);
-                    }
-                    else {
-                        result = CheckSweepCollision(colliders_[j].get(), colliders_[i].get(), deltaTime);
-                        // 法線の向きを反転
-                        if (result.isColliding) {
-                            result.normal = Utility::Multiply(result.normal, -1.0f);
-                        }
-                    }
+            ColliderState& state = frame.states[i];
+            const ColliderPose& pose = poseArrays_.poses[i];
+            const uint32_t flags = poseArrays_.flags[i];
+
+            state.id = poseArrays_.ids[i];
+            state.version = poseArrays_.versions[i];
+            state.shapeType = static_cast<CollisionObject::ShapeType>(poseArrays_.shapeTypes[i]);
+            if (state.shapeType == CollisionObject::ShapeType::Sphere) {
+                state.sphere = pose.sphere;
+            }
+            else if (state.shapeType == CollisionObject::ShapeType::Capsule) {
+                state.capsule = pose.capsule;
+            }
+            else if (state.shapeType == CollisionObject::ShapeType::Heightfield) {
+                state.heightfield = static_cast<const HeightfieldCollider*>(colliders_[i].get())->GetHeightfieldShape().heightfield;
+            }
+            else {
+                state.convex.hull = static_cast<const ConvexHullCollider*>(colliders_[i].get())->GetHull();
+                state.convex.world = pose.world;
+            }
+            state.velocity = poseArrays_.velocities[i];
+            state.isEnabled = (flags & CollisionObject::kFlagEnabled) != 0;
+            state.isRigidbody = (flags & CollisionObject::kFlagRigidbody) != 0;
+            state.isTrigger = (flags & CollisionObject::kFlagTrigger) != 0;
+        }
+
+        // 削除の記録はこのスナップショット以降の分だけでよい
+        removedSinceSnapshot_.Clear();
+    }
+
+    void CollisionManager::DetectCollisions(CollisionFrame& frame, PairCache& cache) {
+        Clock::time_point frameStart = Clock::now();
+
+        frame.stats = CollisionStats();
+        frame.stats.colliderCount = static_cast<uint32_t>(frame.states.size());
+
+        // ブロードフェーズ
+        BuildCandidatePairs(frame);
+        frame.stats.broadphasePairs = static_cast<uint32_t>(frame.candidatePairs.size());
+        Clock::time_point broadphaseEnd = Clock::now();
+
+        // ナローフェーズ（結果はまとめてから通知する）
+        frame.contacts.clear();
+        frame.hitFlags.assign(frame.states.size(), 0);
+        std::swap(cache.previous, cache.current);
+        cache.current.Clear();
+        for (const auto& [i, j] : frame.candidatePairs) {
+            const ColliderState& state1 = frame.states[i];
+            const ColliderState& state2 = frame.states[j];
+            CollisionResult result;
+
+            // どちらのコライダーも前フレームから変わっていなければ前回の結果を使う
+            // （ペアはIDの小さい方が1つ目なので、削除で並びが入れ替わってもキーは変わらない）
+            uint64_t key = (static_cast<uint64_t>(state1.id) << 32) | state2.id;
+            const PairCacheEntry* cached = frame.usePairCache ? cache.previous.Find(key) : nullptr;
+            if (cached && cached->version1 == state1.version && cached->version2 == state2.version &&
+                cached->deltaTime == frame.deltaTime) {
+                result = cached->result;
+                ++frame.stats.pairCacheHits;
+            }
+            else {
+                result = CheckPair(state1, state2, frame.deltaTime, frame.stats);
+            }
+            if (frame.usePairCache) {
+                cache.current.InsertOrAssign(key, { state1.version, state2.version, frame.deltaTime, result });
+            }
+
+            if (result.isColliding) {
+                frame.contacts.push_back({ frame.objects[i].get(), frame.objects[j].get(), result });
+                frame.hitFlags[i] = 1;
+                frame.hitFlags[j] = 1;
+            }
+        }
+        frame.stats.hitCount = static_cast<uint32_t>(frame.contacts.size());
+        Clock::time_point narrowphaseEnd = Clock::now();
+
+        frame.stats.broadphaseMs = ElapsedMs(frameStart, broadphaseEnd);
+        frame.stats.narrowphaseMs = ElapsedMs(broadphaseEnd, narrowphaseEnd);
+    }
+
+    uint32_t CollisionManager::DispatchCallbacks() {
+        if (contactOutputMode_ == ContactOutputMode::Buffer) return 0;
+
+        // 接触バッファの上に載せたアダプター
+        const CollisionFrame& frame = frames_[frontFrame_];
+        uint32_t callbackCount = 0;
+        isDispatching_ = true;
+
+        // 衝突していれば通知（コールバック内での追加・削除に備えて毎回サイズを確認する）
+        for (size_t i = 0; i < frame.contacts.size(); ++i) {
+            const CollisionContact& contact = frame.contacts[i];
+            CollisionObject* collider1 = contact.collider1;
+            CollisionObject* collider2 = contact.collider2;
+
+            // スナップショット以降に削除・無効化されたコライダーには通知しない
+            if (removedSinceSnapshot_.Contains(collider1->GetID()) || removedSinceSnapshot_.Contains(collider2->GetID())) continue;
+            if (!collider1->IsEnabled() || !collider2->IsEnabled()) continue;
+
+            // コライダー1のコールバックを呼び出し
+            if (collider1->onCollisionEnter) {
+                collider1->onCollisionEnter(collider2, contact.result);
+                ++callbackCount;
+            }
+
+            // コライダー2のコールバックを呼び出し（法線の向きを反転）
+            if (collider2->onCollisionEnter) {
+                // 法線の向きを反転
+                CollisionResult reversedResult = contact.result;
+                reversedResult.normal = Utility::Multiply(contact.result.normal, -1.0f);
+
+                collider2->onCollisionEnter(collider1, reversedResult);
+                ++callbackCount;
+            }
+        }
+
+        isDispatching_ = false;
+        return callbackCount;
+    }
+
+    void CollisionManager::PublishStats(uint32_t callbackCount, double snapshotMs, double waitMs, double callbackMs, double mainThreadMs) {
+        stats_ = frames_[frontFrame_].stats;
+        stats_.callbackCount = callbackCount;
+
+        stats_.snapshotMs = snapshotMs;
+        stats_.waitMs = waitMs;
+        stats_.callbackMs = callbackMs;
+        stats_.totalMs = snapshotMs + stats_.broadphaseMs + stats_.narrowphaseMs + callbackMs;
+        stats_.mainThreadMs = mainThreadMs;
+    }
+
+    void CollisionManager::BuildCandidatePairs(CollisionFrame& frame) {
+        std::vector<BroadphaseEntry>& entries = frame.broadphaseEntries;
+        entries.clear();
+        frame.candidatePairs.clear();
+
+        // 有効なコライダーの境界を連続配列に詰める
+        for (size_t i = 0; i < frame.states.size(); ++i) {
+            const ColliderState& state = frame.states[i];
+            if (!state.isEnabled) continue;
+
+            BroadphaseEntry entry;
+            entry.index = static_cast<uint32_t>(i);
+            AABB bounds;
+            if (state.shapeType == CollisionObject::ShapeType::Sphere) {
+                bounds = SphereBounds(state.sphere);
+            }
+            else if (state.shapeType == CollisionObject::ShapeType::Capsule) {
+                bounds = CapsuleBounds(state.capsule);
+            }
+            else if (state.shapeType == CollisionObject::ShapeType::Heightfield) {
+                bounds = state.heightfield->GetBounds();
+            }
+            else {
+                bounds = state.convex.ComputeBounds();
+            }
+            entry.min = bounds.min;
+            entry.max = bounds.max;
+
+            // スウィープテストで到達しうる範囲まで広げる
+            Vector3 move = Utility::Multiply(state.velocity, frame.deltaTime);
+            entry.min = { entry.min.x + std::min(move.x, 0.0f), entry.min.y + std::min(move.y, 0.0f), entry.min.z + std::min(move.z, 0.0f) };
+            entry.max = { entry.max.x + std::max(move.x, 0.0f), entry.max.y + std::max(move.y, 0.0f), entry.max.z + std::max(move.z, 0.0f) };
+
+            entries.push_back(entry);
+        }
+        frame.stats.enabledColliderCount = static_cast<uint32_t>(entries.size());
+
+        // X軸の最小値でソートしてスイープ
+        std::sort(entries.begin(), entries.end(),
+            [](const BroadphaseEntry& a, const BroadphaseEntry& b) {
+                return a.min.x < b.min.x;
+            });
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const BroadphaseEntry& a = entries[i];
+            for (size_t j = i + 1; j < entries.size(); ++j) {
+                const BroadphaseEntry& b = entries[j];
+
+                // X軸で離れたらこれ以降は重ならない
+                if (b.min.x > a.max.x) break;
+                if (b.min.y > a.max.y || b.max.y < a.min.y || b.min.z > a.max.z || b.max.z < a.min.z) continue;
+
+                // IDの小さい方を1つ目にする（法線の向きとキャッシュのキーを配列内の位置に左右されないようにする）
+                if (frame.states[a.index].id < frame.states[b.index].id) {
+                    frame.candidatePairs.emplace_back(a.index, b.index);
                 }
                 else {
-                    // 通常の衝突判定
-                    result = CheckCollision(colliders_[i].get(), colliders_[j].get());
+                    frame.candidatePairs.emplace_back(b.index, a.index);
                 }
+            }
+        }
+    }
 
-                // 衝突していれば通知
+    CollisionResult CollisionManager::CheckPair(
+        const ColliderState& collider1,
+        const ColliderState& collider2,
+        float deltaTime,
+        CollisionStats& stats
+    ) {
+        CollisionResult result;
+        ++stats.narrowphaseTests;
+
+        // トリガーは重なっているかどうかだけを判定する
+        if (collider1.isTrigger || collider2.isTrigger) {
+            ++stats.triggerTests;
+            result.isColliding = IntersectPair(collider1, collider2);
+            return result;
+        }
+
+        // 両方とも剛体の場合や、少なくとも一方が速度を持つ場合はスウィープテストを行う
+        float speed1 = Utility::Length(collider1.velocity);
+        float speed2 = Utility::Length(collider2.velocity);
+        if ((collider1.isRigidbody && collider2.isRigidbody) ||
+            speed1 > 0.0001f || speed2 > 0.0001f) {
+
+            ++stats.sweepTests;
+
+            // 動いているオブジェクトを優先してスウィープテスト
+            if (speed1 > speed2) {
+                result = CheckSweepCollision(collider1, collider2, deltaTime);
+            }
+            else {
+                result = CheckSweepCollision(collider2, collider1, deltaTime);
+                // 法線の向きを反転
                 if (result.isColliding) {
-                    // コライダー1のコールバックを呼び出し
-                    if (colliders_[i]->onCollisionEnter) {
-                        colliders_[i]->onCollisionEnter(colliders_[j].get(), result);
-                    }
-
-                    // コライダー2のコールバックを呼び出し（法線の向きを反転）
-                    if (colliders_[j]->onCollisionEnter) {
-                        // 法線の向きを反転
-                        CollisionResult reversedResult = result;
-                        reversedResult.normal = Utility::Multiply(result.normal, -1.0f);
-
-                        colliders_[j]->onCollisionEnter(colliders_[i].get(), reversedResult);
-                    }
+                    result.normal = Utility::Multiply(result.normal, -1.0f);
                 }
             }
         }
+        else {
+            // 通常の衝突判定
+            result = CheckCollision(collider1, collider2);
+        }
+
+        return result;
     }
 
     CollisionResult CollisionManager::CheckCollision(
-        const CollisionObject* collider1,
-        const CollisionObject* collider2
+        const ColliderState& collider1,
+        const ColliderState& collider2
     ) {
         CollisionResult result;
 
+        // 地形を含む組み合わせは地形側のセル単位の判定を使う
+        if (collider1.shapeType == CollisionObject::ShapeType::Heightfield ||
+            collider2.shapeType == CollisionObject::ShapeType::Heightfield) {
+            return CheckHeightfieldCollision(collider1, collider2);
+        }
+
+        // 凸包を含む組み合わせはGJK・EPAで判定する
+        if (collider1.shapeType == CollisionObject::ShapeType::ConvexHull ||
+            collider2.shapeType == CollisionObject::ShapeType::ConvexHull) {
+            return CheckConvexCollision(collider1, collider2);
+        }
+
         // 形状の種類に応じて適切な衝突判定関数を呼び出す
-        if (collider1->GetShapeType() == CollisionObject::ShapeType::Sphere &&
-            collider2->GetShapeType() == CollisionObject::ShapeType::Sphere) {
+        if (collider1.shapeType == CollisionObject::ShapeType::Sphere &&
+            collider2.shapeType == CollisionObject::ShapeType::Sphere) {
 
             // 球 vs 球
-            const Sphere* sphere1 = static_cast<const Sphere*>(collider1->GetShapeData());
-            const Sphere* sphere2 = static_cast<const Sphere*>(collider2->GetShapeData());
-
-            result = CollisionDetector::CheckSphereToSphere(*sphere1, *sphere2);
+            result = CollisionDetector::CheckSphereToSphere(collider1.sphere, collider2.sphere);
         }
-        else if (collider1->GetShapeType() == CollisionObject::ShapeType::Sphere &&
-            collider2->GetShapeType() == CollisionObject::ShapeType::Capsule) {
+        else if (collider1.shapeType == CollisionObject::ShapeType::Sphere &&
+            collider2.shapeType == CollisionObject::ShapeType::Capsule) {
 
             // 球 vs カプセル
-            const Sphere* sphere = static_cast<const Sphere*>(collider1->GetShapeData());
-            const Capsule* capsule = static_cast<const Capsule*>(collider2->GetShapeData());
-
-            result = CollisionDetector::CheckSphereToCapusle(*sphere, *capsule);
+            result = CollisionDetector::CheckSphereToCapusle(collider1.sphere, collider2.capsule);
         }
-        else if (collider1->GetShapeType() == CollisionObject::ShapeType::Capsule &&
-            collider2->GetShapeType() == CollisionObject::ShapeType::Sphere) {
+        else if (collider1.shapeType == CollisionObject::ShapeType::Capsule &&
+            collider2.shapeType == CollisionObject::ShapeType::Sphere) {
 
             // カプセル vs 球
-            const Capsule* capsule = static_cast<const Capsule*>(collider1->GetShapeData());
-            const Sphere* sphere = static_cast<const Sphere*>(collider2->GetShapeData());
-
-            result = CollisionDetector::CheckSphereToCapusle(*sphere, *capsule);
+            result = CollisionDetector::CheckSphereToCapusle(collider2.sphere, collider1.capsule);
 
             // 法線の向きを反転（球からカプセルへの向きになっているため）
             if (result.isColliding) {
                 result.normal = Utility::Multiply(result.normal, -1.0f);
             }
         }
-        else if (collider1->GetShapeType() == CollisionObject::ShapeType::Capsule &&
-            collider2->GetShapeType() == CollisionObject::ShapeType::Capsule) {
+        else if (collider1.shapeType == CollisionObject::ShapeType::Capsule &&
+            collider2.shapeType == CollisionObject::ShapeType::Capsule) {
 
             // カプセル vs カプセル
-            const Capsule* capsule1 = static_cast<const Capsule*>(collider1->GetShapeData());
-            const Capsule* capsule2 = static_cast<const Capsule*>(collider2->GetShapeData());
-
-            result = CollisionDetector::CheckCapsuleToCapsule(*capsule1, *capsule2);
+            result = CollisionDetector::CheckCapsuleToCapsule(collider1.capsule, collider2.capsule);
         }
 
         return result;
     }
 
     CollisionResult CollisionManager::CheckSweepCollision(
-        const CollisionObject* movingCollider,
-        const CollisionObject* staticCollider,
+        const ColliderState& movingCollider,
+        const ColliderState& staticCollider,
         float deltaTime
     ) {
         CollisionResult result;
 
         // 移動オブジェクトの速度
-        const Vector3& velocity = movingCollider->GetVelocity();
+        const Vector3& velocity = movingCollider.velocity;
 
         // 形状の種類に応じて適切なスウィープテスト関数を呼び出す
-        if (movingCollider->GetShapeType() == CollisionObject::ShapeType::Sphere) {
-            const Sphere* movingSphere = static_cast<const Sphere*>(movingCollider->GetShapeData());
-
-            if (staticCollider->GetShapeType() == CollisionObject::ShapeType::Sphere) {
+        if (movingCollider.shapeType == CollisionObject::ShapeType::Sphere) {
+            if (staticCollider.shapeType == CollisionObject::ShapeType::Sphere) {
                 // 球 vs 球（スウィープ）
-                const Sphere* staticSphere = static_cast<const Sphere*>(staticCollider->GetShapeData());
-                result = CollisionDetector::CheckSphereSweepToSphere(*movingSphere, velocity, *staticSphere, deltaTime);
+                result = CollisionDetector::CheckSphereSweepToSphere(movingCollider.sphere, velocity, staticCollider.sphere, deltaTime);
             }
-            else if (staticCollider->GetShapeType() == CollisionObject::ShapeType::Capsule) {
+            else if (staticCollider.shapeType == CollisionObject::ShapeType::Capsule) {
                 // 球 vs カプセル（スウィープ）
-                const Capsule* staticCapsule = static_cast<const Capsule*>(staticCollider->GetShapeData());
-                result = CollisionDetector::CheckSphereSweepToCapsule(*movingSphere, velocity, *staticCapsule, deltaTime);
+                result = CollisionDetector::CheckSphereSweepToCapsule(movingCollider.sphere, velocity, staticCollider.capsule, deltaTime);
+            }
+            else {
+                // 凸包に対するスウィープは未実装のため現在位置で判定
+                result = CheckCollision(movingCollider, staticCollider);
             }
         }
         else {
@@ -190,9 +753,126 @@ namespace Collision {
         return result;
     }
 
+    bool CollisionManager::IntersectPair(
+        const ColliderState& collider1,
+        const ColliderState& collider2
+    ) {
+        using ShapeType = CollisionObject::ShapeType;
+
+        // 形状の種類の順に並べて組み合わせを減らす（交差の有無は順序によらない）
+        const ColliderState& a = collider1.shapeType <= collider2.shapeType ? collider1 : collider2;
+        const ColliderState& b = collider1.shapeType <= collider2.shapeType ? collider2 : collider1;
+
+        // 地形は詳細判定の結果をそのまま使う
+        if (b.shapeType == ShapeType::Heightfield) {
+            return CheckHeightfieldCollision(a, b).isColliding;
+        }
+
+        if (a.shapeType == ShapeType::Sphere) {
+            switch (b.shapeType) {
+            case ShapeType::Sphere:
+                return CollisionDetector::IntersectSphereToSphere(a.sphere, b.sphere);
+            case ShapeType::Capsule:
+                return CollisionDetector::IntersectSphereToCapsule(a.sphere, b.capsule);
+            case ShapeType::ConvexHull:
+                return CollisionDetector::IntersectSphereToConvex(a.sphere, b.convex);
+            default:
+                break;
+            }
+        }
+        else if (a.shapeType == ShapeType::Capsule) {
+            switch (b.shapeType) {
+            case ShapeType::Capsule:
+                return CollisionDetector::IntersectCapsuleToCapsule(a.capsule, b.capsule);
+            case ShapeType::ConvexHull:
+                return CollisionDetector::IntersectCapsuleToConvex(a.capsule, b.convex);
+            default:
+                break;
+            }
+        }
+        return CollisionDetector::IntersectConvexToConvex(a.convex, b.convex);
+    }
+
+    CollisionResult CollisionManager::CheckConvexCollision(
+        const ColliderState& collider1,
+        const ColliderState& collider2
+    ) {
+        using ShapeType = CollisionObject::ShapeType;
+
+        if (collider1.shapeType == ShapeType::ConvexHull && collider2.shapeType == ShapeType::ConvexHull) {
+            // 凸包 vs 凸包
+            return CollisionDetector::CheckConvexToConvex(collider1.convex, collider2.convex);
+        }
+
+        // 凸包 vs 球・カプセル（法線は凸包から相手へ向かう）
+        const ColliderState& convex = collider1.shapeType == ShapeType::ConvexHull ? collider1 : collider2;
+        const ColliderState& other = collider1.shapeType == ShapeType::ConvexHull ? collider2 : collider1;
+        CollisionResult result = other.shapeType == ShapeType::Sphere
+            ? CollisionDetector::CheckSphereToConvex(other.sphere, convex.convex)
+            : CollisionDetector::CheckCapsuleToConvex(other.capsule, convex.convex);
+
+        // collider1からcollider2への向きにそろえる
+        if (result.isColliding && &convex == &collider2) {
+            result.normal = Utility::Multiply(result.normal, -1.0f);
+        }
+        return result;
+    }
+
+    CollisionResult CollisionManager::CheckHeightfieldCollision(
+        const ColliderState& collider1,
+        const ColliderState& collider2
+    ) {
+        using ShapeType = CollisionObject::ShapeType;
+
+        // 地形どうし・地形と凸包は判定しない
+        const ColliderState& terrain = collider1.shapeType == ShapeType::Heightfield ? collider1 : collider2;
+        const ColliderState& other = collider1.shapeType == ShapeType::Heightfield ? collider2 : collider1;
+        CollisionResult result;
+        if (other.shapeType == ShapeType::Sphere) {
+            result = terrain.heightfield->CheckSphere(other.sphere);
+        }
+        else if (other.shapeType == ShapeType::Capsule) {
+            result = terrain.heightfield->CheckCapsule(other.capsule);
+        }
+
+        // collider1からcollider2への向きにそろえる（地形の判定の法線は地形から相手へ向かう）
+        if (result.isColliding && &terrain == &collider2) {
+            result.normal = Utility::Multiply(result.normal, -1.0f);
+        }
+        return result;
+    }
+
     void CollisionManager::DebugDraw() {
-        // Debug描画は別途実装
-        // 今回は基本実装のみなのでスキップ
+        // 状態ごとの色
+        const Vector4 kHitColor = { 1.0f, 0.2f, 0.2f, 1.0f };
+        const Vector4 kEnabledColor = { 0.2f, 1.0f, 0.2f, 1.0f };
+        const Vector4 kDisabledColor = { 0.5f, 0.5f, 0.5f, 1.0f };
+
+        // 公開中のスナップショットを1パスで連続した頂点配列に書き出す
+        // （判定中のフレームには触れないので非同期モードでも安全）
+        const CollisionFrame& frame = frames_[frontFrame_];
+        DebugLineBuilder builder(debugLineVertices_, debugLineBudget_);
+        for (size_t i = 0; i < frame.states.size(); ++i) {
+            const ColliderState& state = frame.states[i];
+            bool isHit = i < frame.hitFlags.size() && frame.hitFlags[i] != 0;
+            const Vector4& color = !state.isEnabled ? kDisabledColor : (isHit ? kHitColor : kEnabledColor);
+
+            if (state.shapeType == CollisionObject::ShapeType::Sphere) {
+                builder.AddSphere(state.sphere, color);
+            }
+            else if (state.shapeType == CollisionObject::ShapeType::Capsule) {
+                builder.AddCapsule(state.capsule, color);
+            }
+            else if (state.shapeType == CollisionObject::ShapeType::Heightfield) {
+                builder.AddHeightfield(*state.heightfield, color);
+            }
+            else {
+                builder.AddConvexHull(state.convex, color);
+            }
+        }
+
+        stats_.debugLineCount = builder.GetLineCount();
+        stats_.debugShapesDropped = builder.GetDroppedShapeCount();
     }
 
 }
\ No newline at end of file
@@ -1,11 +1,42 @@
 #pragma once
 #include "Collision.h"
+#include "CollisionDebugLines.h"
+#include "Heightfield.h"
+#include "FlatHashMap.h"
+#include "MpscQueue.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <future>
+#include <utility>
 
 namespace Collision {
+    // 形状の姿勢（球・カプセルは形状そのもの、凸包はワールド行列。地形は静的なので使わない）
+    union ColliderPose {
+        Sphere sphere;
+        Capsule capsule;
+        Matrix4x4 world;
+
+        // コンストラクタ（使わない部分も含めて0で埋める）
+        ColliderPose() : world() {}
+    };
+
+    // 判定に影響するコライダーの状態を項目ごとに並べた配列
+    // 登録中のコライダーの状態はCollisionManagerが持つこの配列に置かれ、
+    // 要素の並びはCollisionManager内のコライダーの並びと一致する（スナップショットは配列ごとのmemcpyで取れる）
+    struct ColliderPoseArrays {
+        std::vector<uint32_t> ids;
+        std::vector<uint32_t> versions;   // CollisionObject::GetPoseVersion
+        std::vector<uint32_t> flags;      // CollisionObject::kFlagEnabled・kFlagRigidbody・kFlagTrigger
+        std::vector<Vector3> velocities;
+        std::vector<ColliderPose> poses;
+        std::vector<uint8_t> shapeTypes;  // CollisionObject::ShapeType
+    };
+
     // 衝突オブジェクトの基底クラス
+    // 形状の姿勢・速度・フラグ・更新回数は、登録中はCollisionManagerの配列に置かれ、未登録の間は自身が持つ
+    // （登録時に配列へ移し、削除時に書き戻すので、どちらの間もSet系・Get系関数は同じように使える）
     class CollisionObject {
     public:
         // 仮想デストラクタ
@@ -14,96 +45,230 @@ namespace Collision {
         // 衝突形状の種類
         enum class ShapeType {
             Sphere,
-            Capsule
+            Capsule,
+            ConvexHull,
+            Heightfield
         };
 
         // 形状種別の取得
         virtual ShapeType GetShapeType() const = 0;
 
-        // 形状データの取得（キャスト必要）
-        virtual void* GetShapeData() = 0;
-        virtual const void* GetShapeData() const = 0;
-
         // 衝突時コールバック
         std::function<void(CollisionObject*, const CollisionResult&)> onCollisionEnter;
 
         // オブジェクトIDを取得
         uint32_t GetID() const { return id_; }
 
-        // 有効・無効設定
-        void SetEnabled(bool enabled) { isEnabled_ = enabled; }
-        bool IsEnabled() const { return isEnabled_; }
+        // 有効・無効設定（メインスレッド以外からはCollisionManager::EnqueueSetEnabledを使う）
+        void SetEnabled(bool enabled) { SetFlag(kFlagEnabled, enabled); }
+        bool IsEnabled() const { return (Flags() & kFlagEnabled) != 0; }
 
         // 剛体フラグの設定
-        void SetIsRigidbody(bool isRigidbody) { isRigidbody_ = isRigidbody; }
-        bool IsRigidbody() const { return isRigidbody_; }
+        void SetIsRigidbody(bool isRigidbody) { SetFlag(kFlagRigidbody, isRigidbody); }
+        bool IsRigidbody() const { return (Flags() & kFlagRigidbody) != 0; }
+
+        // トリガーの設定（トリガーを含むペアは重なっているかどうかだけを判定する）
+        // 通知されるCollisionResultはisCollidingのみ有効で、法線・めり込み量・衝突点は計算しない
+        void SetIsTrigger(bool isTrigger) { SetFlag(kFlagTrigger, isTrigger); }
+        bool IsTrigger() const { return (Flags() & kFlagTrigger) != 0; }
 
         // 速度の設定
-        void SetVelocity(const Vector3& velocity) { velocity_ = velocity; }
-        const Vector3& GetVelocity() const { return velocity_; }
+        void SetVelocity(const Vector3& velocity) { Velocity() = velocity; MarkPoseChanged(); }
+        Vector3 GetVelocity() const { return Velocity(); }
+
+        // 判定に影響する状態（形状・速度・フラグ）の更新回数
+        // 変更されていないペアの判定結果を使い回すために使う
+        uint32_t GetPoseVersion() const { return poseArrays_ ? poseArrays_->versions[poseIndex_] : version_; }
+
+        // 状態フラグ（ColliderPoseArrays::flagsのビット）
+        static constexpr uint32_t kFlagEnabled = 1 << 0;
+        static constexpr uint32_t kFlagRigidbody = 1 << 1;
+        static constexpr uint32_t kFlagTrigger = 1 << 2;
 
     protected:
         // コンストラクタは派生クラスからのみ呼び出し可能
-        CollisionObject() : id_(nextID_++), isEnabled_(true), isRigidbody_(false), velocity_({ 0, 0, 0 }) {}
+        CollisionObject() : id_(nextID_++) {}
+
+        // 状態の変更を記録（形状・速度・フラグを変更するSet系関数から呼び出す）
+        void MarkPoseChanged() { ++(poseArrays_ ? poseArrays_->versions[poseIndex_] : version_); }
+
+        // 形状の姿勢（登録中はCollisionManagerの配列の要素）
+        ColliderPose& Pose() { return poseArrays_ ? poseArrays_->poses[poseIndex_] : pose_; }
+        const ColliderPose& Pose() const { return poseArrays_ ? poseArrays_->poses[poseIndex_] : pose_; }
 
     private:
+        // 登録先の配列の要素
+        uint32_t& Flags() { return poseArrays_ ? poseArrays_->flags[poseIndex_] : flags_; }
+        uint32_t Flags() const { return poseArrays_ ? poseArrays_->flags[poseIndex_] : flags_; }
+        Vector3& Velocity() { return poseArrays_ ? poseArrays_->velocities[poseIndex_] : velocity_; }
+        const Vector3& Velocity() const { return poseArrays_ ? poseArrays_->velocities[poseIndex_] : velocity_; }
+
+        // フラグの設定
+        void SetFlag(uint32_t flag, bool value) {
+            uint32_t& flags = Flags();
+            flags = value ? (flags | flag) : (flags & ~flag);
+            MarkPoseChanged();
+        }
+
         // オブジェクトID
         uint32_t id_;
-        // 有効フラグ
-        bool isEnabled_;
-        // 剛体フラグ（押し出し処理の対象になるか）
-        bool isRigidbody_;
-        // 速度ベクトル
-        Vector3 velocity_;
-
-        // 次に割り当てるID
-        static uint32_t nextID_;
+
+        // 未登録の間の状態（登録中の値はposeArrays_側にある）
+        ColliderPose pose_;
+        Vector3 velocity_ = { 0, 0, 0 };
+        uint32_t flags_ = kFlagEnabled;
+        uint32_t version_ = 0;
+
+        // 登録先の配列と要素の位置（未登録ならnullptr）
+        ColliderPoseArrays* poseArrays_ = nullptr;
+        uint32_t poseIndex_ = 0;
+
+        // 次に割り当てるID（任意のスレッドで生成できるようにアトミックにする）
+        static std::atomic<uint32_t> nextID_;
+
+        // 登録・削除で状態を配列との間で移すため
+        friend class CollisionManager;
     };
 
     // 球コリジョン
     class SphereCollider : public CollisionObject {
     public:
         // コンストラクタ
-        SphereCollider(const Vector3& center, float radius)
-            : sphere_({ center, radius }) {
+        SphereCollider(const Vector3& center, float radius) {
+            Pose().sphere = Sphere(center, radius);
         }
 
         // 形状種別の取得
         ShapeType GetShapeType() const override { return ShapeType::Sphere; }
 
-        // 形状データの取得
-        void* GetShapeData() override { return &sphere_; }
-        const void* GetShapeData() const override { return &sphere_; }
-
-        // 球データへの直接アクセス
-        Sphere& GetSphere() { return sphere_; }
-        const Sphere& GetSphere() const { return sphere_; }
+        // 球データの取得・設定（登録中は配列の要素が移動するので値で返す）
+        Sphere GetSphere() const { return Pose().sphere; }
+        void SetSphere(const Sphere& sphere) { Pose().sphere = sphere; MarkPoseChanged(); }
 
-    private:
-        Sphere sphere_;
+        // 中心の設定（半径は変えない）
+        void SetCenter(const Vector3& center) { Pose().sphere.center = center; MarkPoseChanged(); }
     };
 
     // カプセルコリジョン
     class CapsuleCollider : public CollisionObject {
     public:
         // コンストラクタ
-        CapsuleCollider(const Vector3& start, const Vector3& end, float radius)
-            : capsule_({ start, end }, radius) {
+        CapsuleCollider(const Vector3& start, const Vector3& end, float radius) {
+            Pose().capsule = Capsule(start, end, radius);
         }
 
         // 形状種別の取得
         ShapeType GetShapeType() const override { return ShapeType::Capsule; }
 
+        // カプセルデータの取得・設定（登録中は配列の要素が移動するので値で返す）
+        Capsule GetCapsule() const { return Pose().capsule; }
+        void SetCapsule(const Capsule& capsule) { Pose().capsule = capsule; MarkPoseChanged(); }
+
+        // 中心の設定（線分の向きと長さ・半径は変えずに平行移動する）
+        void SetCenter(const Vector3& center) {
+            Capsule& capsule = Pose().capsule;
+            Vector3 offset = {
+                center.x - (capsule.segment.start.x + capsule.segment.end.x) * 0.5f,
+                center.y - (capsule.segment.start.y + capsule.segment.end.y) * 0.5f,
+                center.z - (capsule.segment.start.z + capsule.segment.end.z) * 0.5f };
+            capsule.segment.start = { capsule.segment.start.x + offset.x, capsule.segment.start.y + offset.y, capsule.segment.start.z + offset.z };
+            capsule.segment.end = { capsule.segment.end.x + offset.x, capsule.segment.end.y + offset.y, capsule.segment.end.z + offset.z };
+            MarkPoseChanged();
+        }
+    };
+
+    // 凸包コリジョン（凸包は同じモデルのコライダー間で共有できる）
+    class ConvexHullCollider : public CollisionObject {
+    public:
+        // コンストラクタ
+        ConvexHullCollider(std::shared_ptr<const Collision::ConvexHull> hull, const Matrix4x4& world)
+            : hull_(std::move(hull)) {
+            Pose().world = world;
+        }
+
+        // 形状種別の取得
+        ShapeType GetShapeType() const override { return ShapeType::ConvexHull; }
+
+        // 凸包データの取得（凸包とワールド行列を組にしたコピー）
+        ConvexShape GetConvexShape() const { return ConvexShape(hull_, Pose().world); }
+
+        // 共有している凸包
+        const std::shared_ptr<const Collision::ConvexHull>& GetHull() const { return hull_; }
+
+        // ワールド行列の取得・設定
+        Matrix4x4 GetWorldMatrix() const { return Pose().world; }
+        void SetWorldMatrix(const Matrix4x4& world) { Pose().world = world; MarkPoseChanged(); }
+
+    private:
+        std::shared_ptr<const Collision::ConvexHull> hull_;
+    };
+
+    // 地形コリジョン（高さマップは静的な地形として扱い、球・カプセルとのみ判定する）
+    class HeightfieldCollider : public CollisionObject {
+    public:
+        // コンストラクタ
+        HeightfieldCollider(std::shared_ptr<const Collision::Heightfield> heightfield) {
+            shape_.heightfield = std::move(heightfield);
+        }
+
+        // 形状種別の取得
+        ShapeType GetShapeType() const override { return ShapeType::Heightfield; }
+
         // 形状データの取得
-        void* GetShapeData() override { return &capsule_; }
-        const void* GetShapeData() const override { return &capsule_; }
+        const HeightfieldShape& GetHeightfieldShape() const { return shape_; }
 
-        // カプセルデータへの直接アクセス
-        Capsule& GetCapsule() { return capsule_; }
-        const Capsule& GetCapsule() const { return capsule_; }
+        // 高さマップへの直接アクセス
+        const Collision::Heightfield& GetHeightfield() const { return *shape_.heightfield; }
 
     private:
-        Capsule capsule_;
+        HeightfieldShape shape_;
+    };
+
+    // 衝突したペア（collider1がIDの小さい方、normalはcollider1側から見た向き）
+    struct CollisionContact {
+        CollisionObject* collider1;
+        CollisionObject* collider2;
+        CollisionResult result;
+
+        // 指定したコライダーの相手
+        CollisionObject* GetOther(const CollisionObject* self) const { return self == collider1 ? collider2 : collider1; }
+
+        // 指定したコライダー側から見た法線の符号（collider2側なら-1）
+        float GetNormalSign(const CollisionObject* self) const { return self == collider1 ? 1.0f : -1.0f; }
+    };
+
+    // 衝突結果の受け取り方
+    enum class ContactOutputMode {
+        Callbacks, // 衝突した両方のコライダーのonCollisionEnterを呼び出す（既定）
+        Buffer     // 接触バッファに書き出すだけで呼び出さない（GetContacts・ForEachContactでまとめて処理する）
+    };
+
+    // 1フレーム分の衝突判定の統計情報
+    struct CollisionStats {
+        uint32_t colliderCount = 0;        // 登録されているコライダー数
+        uint32_t queuedCommands = 0;       // Update開始時に反映した遅延コマンド数
+        uint32_t enabledColliderCount = 0; // 有効なコライダー数
+        uint32_t broadphasePairs = 0;      // ブロードフェーズを通過したペア数
+        uint32_t narrowphaseTests = 0;     // 詳細判定を行ったペア数
+        uint32_t sweepTests = 0;           // そのうちスウィープテストを行ったペア数
+        uint32_t triggerTests = 0;         // そのうち交差の有無だけを判定したトリガーのペア数
+        uint32_t pairCacheHits = 0;        // 前フレームの結果を使い回したペア数
+        uint32_t hitCount = 0;             // 衝突したペア数
+        uint32_t callbackCount = 0;        // 呼び出したコールバック数
+        uint32_t debugLineCount = 0;       // デバッグ描画で生成した線の本数
+        uint32_t debugShapesDropped = 0;   // 線の上限により描画しなかった形状数
+        double snapshotMs = 0.0;           // コライダー状態のスナップショット作成時間
+        double broadphaseMs = 0.0;         // ブロードフェーズの処理時間
+        double narrowphaseMs = 0.0;        // ナローフェーズの処理時間
+        double waitMs = 0.0;               // 非同期判定の完了待ち時間
+        double callbackMs = 0.0;           // コールバックの処理時間
+        double totalMs = 0.0;              // 判定全体の処理時間（スナップショット〜コールバック）
+        double mainThreadMs = 0.0;         // Updateがメインスレッドを占有した時間
+
+        // ブロードフェーズを通過したペアのうち結果を使い回した割合
+        double GetPairCacheHitRate() const {
+            return broadphasePairs > 0 ? static_cast<double>(pairCacheHits) / broadphasePairs : 0.0;
+        }
     };
 
     // 衝突マネージャー
@@ -112,28 +277,224 @@ namespace Collision {
         // シングルトンインスタンス取得
         static CollisionManager* GetInstance();
 
-        // コリジョンの登録
+        // コリジョンの登録（以下の登録・削除はメインスレッド専用、他スレッドからは遅延コマンドを使う）
         void AddCollider(std::shared_ptr<CollisionObject> collider);
 
-        // コリジョンの削除
+        // コリジョンの削除（末尾のコライダーを削除位置に移すので、登録順は保たれない）
         void RemoveCollider(std::shared_ptr<CollisionObject> collider);
         void RemoveCollider(uint32_t id);
 
         // コリジョンのクリア
         void ClearColliders();
 
+        // 遅延コマンド（任意のスレッドからロックなしで呼び出せ、次のUpdateの開始時に発行順に反映される）
+        void EnqueueAddCollider(std::shared_ptr<CollisionObject> collider);
+        void EnqueueRemoveCollider(uint32_t id);
+        void EnqueueSetEnabled(std::shared_ptr<CollisionObject> collider, bool enabled);
+
+        // 境界ボックスと重なる有効なコライダーを列挙（outはクリアしてから追加する、メインスレッド専用）
+        void QueryColliders(const AABB& bounds, std::vector<CollisionObject*>& out) const;
+
+        // コライダーのワールド座標での境界ボックス
+        static AABB ComputeBounds(const CollisionObject& collider);
+
         // 衝突判定の更新
+        // 非同期モードでは前回のUpdateで開始した判定の結果を通知してから、
+        // 今回のスナップショットの判定をワーカースレッドで開始する（結果は1フレーム遅れる）
         void Update(float deltaTime);
 
-        // デバッグ描画
+        // 非同期モードの設定（既定は無効）
+        // 無効にすると実行中の判定の完了を待ち、その結果を通知する
+        void SetAsyncUpdate(bool enabled);
+        bool IsAsyncUpdate() const { return asyncUpdate_; }
+
+        // ペアの判定結果のキャッシュ（既定は有効）
+        // 両方のコライダーの状態が前フレームから変わっていないペアは判定を省略して前回の結果を使う
+        void SetPairCacheEnabled(bool enabled) { pairCacheEnabled_ = enabled; }
+        bool IsPairCacheEnabled() const { return pairCacheEnabled_; }
+
+        // 衝突結果の受け取り方の設定
+        void SetContactOutputMode(ContactOutputMode mode) { contactOutputMode_ = mode; }
+        ContactOutputMode GetContactOutputMode() const { return contactOutputMode_; }
+
+        // 直近に公開された衝突ペア一覧（接触バッファ、非同期モードでは1フレーム前のスナップショットの結果）
+        // 連続した配列で、次のUpdateまで有効（含まれるコライダーもそれまでは破棄されない）
+        const std::vector<CollisionContact>& GetContacts() const { return frames_[frontFrame_].contacts; }
+
+        // 指定したコライダーを含む接触だけを列挙する
+        // funcには(相手, 接触)が渡される（法線の向きはcontact.GetNormalSign(collider)で補正する）
+        template<typename Func>
+        void ForEachContact(const CollisionObject* collider, Func&& func) const {
+            for (const CollisionContact& contact : frames_[frontFrame_].contacts) {
+                if (contact.collider1 == collider || contact.collider2 == collider) {
+                    func(contact.GetOther(collider), contact);
+                }
+            }
+        }
+
+        // デバッグ描画（直近に判定したスナップショットのワイヤーフレームを線分頂点配列に書き出す）
         void DebugDraw();
 
+        // デバッグ描画の線の本数の上限（1フレームあたり）
+        void SetDebugLineBudget(uint32_t maxLines) { debugLineBudget_ = maxLines; }
+        uint32_t GetDebugLineBudget() const { return debugLineBudget_; }
+
+        // DebugDrawで生成した線分頂点（2頂点で1本、描画側でそのままアップロードできる）
+        const std::vector<DebugLineVertex>& GetDebugLineVertices() const { return debugLineVertices_; }
+
+        // 直近のUpdate・DebugDrawの統計情報
+        const CollisionStats& GetStats() const { return stats_; }
+
+        // 状態のスナップショット（ロールバック・リプレイ用）
+        // 登録中のコライダーの形状・速度・フラグ・状態の更新回数（マネージャーが持つ配列を項目ごとにmemcpyする）と、
+        // ペアの判定結果のキャッシュ（キーの順に並べた固定長レコード）をoutに書き出す（outの容量は使い回される）
+        // 非同期モードでは実行中の判定の完了を待つ（結果は次のUpdateで通常どおり通知される）
+        // ※地形・凸包の形状データ自体は共有されたままなので含まない（ワールド行列のみ）
+        void SaveSnapshot(std::vector<uint8_t>& out);
+
+        // スナップショットの状態に戻す（次のUpdateから保存時点と同じ判定結果になる）
+        // 保存時点のコライダーとはIDで対応を取る（並びが保存時点と同じなら配列ごとmemcpyで戻す）
+        // ・保存後に追加されたコライダーは変更せず、現在の状態のまま残る
+        // ・保存後に削除されたコライダーは戻らない（先に登録し直しておけば、その状態も保存時点に戻る）
+        // 形式が不正な場合と、同じIDで形状の種類が異なる場合は何も変更せずfalseを返す
+        // 非同期モードで実行中の判定は、戻す前の状態に対するものなので結果を破棄する
+        bool RestoreSnapshot(const std::vector<uint8_t>& data);
+
     private:
+        // ブロードフェーズ用の境界（コライダー自身の1フレームの移動量を含む）
+        struct BroadphaseEntry {
+            Vector3 min;
+            Vector3 max;
+            uint32_t index;
+        };
+
+        // 判定に使うコライダー状態のコピー（ワーカースレッドはこれだけを読む）
+        struct ColliderState {
+            uint32_t id;
+            uint32_t version; // CollisionObject::GetPoseVersion
+            CollisionObject::ShapeType shapeType;
+            Sphere sphere;
+            Capsule capsule;
+            ConvexShape convex;
+            std::shared_ptr<const Heightfield> heightfield;
+            Vector3 velocity;
+            bool isEnabled;
+            bool isRigidbody;
+            bool isTrigger;
+        };
+
+        // スナップショットの形式
+        // 先頭にヘッダー、続いてColliderPoseArraysの各配列（ids・versions・flags・velocities・poses・shapeTypesの順）、
+        // 最後にペアキャッシュの固定長レコードが並ぶ
+        static constexpr uint32_t kSnapshotMagic = 0x50414E53; // "SNAP"
+        static constexpr uint32_t kSnapshotVersion = 2;
+        struct SnapshotHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t colliderCount;
+            uint32_t pairCacheCount;
+        };
+        // コライダー1個あたりの大きさ
+        static constexpr size_t kSnapshotColliderSize =
+            sizeof(uint32_t) * 3 + sizeof(Vector3) + sizeof(ColliderPose) + sizeof(uint8_t);
+
+        // 遅延コマンド
+        struct ColliderCommand {
+            enum class Type {
+                Add,
+                Remove,
+                SetEnabled
+            };
+            Type type;
+            std::shared_ptr<CollisionObject> collider; // Add・SetEnabledの対象
+            uint32_t id;                               // Removeの対象
+            bool enabled;                              // SetEnabledの値
+        };
+
+        // ペアの判定結果のキャッシュ
+        struct PairCacheEntry {
+            uint32_t version1;
+            uint32_t version2;
+            float deltaTime; // スウィープテストの結果は経過時間にも依存する
+            CollisionResult result;
+        };
+        struct PairCache {
+            // 前フレームの結果と今フレームの結果（毎フレーム入れ替え、候補から外れたペアは自然に消える）
+            FlatHashMap<uint64_t, PairCacheEntry> previous;
+            FlatHashMap<uint64_t, PairCacheEntry> current;
+        };
+        struct SnapshotPairCache {
+            uint64_t key;
+            uint32_t version1;
+            uint32_t version2;
+            float deltaTime;
+            uint32_t isColliding;
+            Vector3 collisionPoint;
+            Vector3 normal;
+            float penetration;
+            uint32_t reserved; // 詰め物を明示してバイト列を決定的にする
+        };
+
+        // 1回分の判定の入力と結果（2つを交互に使うダブルバッファ）
+        struct CollisionFrame {
+            // スナップショット時点のコライダー（通知が終わるまで寿命を保証する）
+            std::vector<std::shared_ptr<CollisionObject>> objects;
+            std::vector<ColliderState> states;
+            float deltaTime = 0.0f;
+            bool usePairCache = true;
+
+            // 作業用配列（フレーム間で再利用して毎フレームの確保を避ける）
+            std::vector<BroadphaseEntry> broadphaseEntries;
+            std::vector<std::pair<uint32_t, uint32_t>> candidatePairs;
+
+            // 結果
+            std::vector<CollisionContact> contacts;
+            std::vector<uint8_t> hitFlags;
+            CollisionStats stats;
+        };
+
         // シングルトンインスタンス
         static CollisionManager* instance_;
 
         // コリジョンリスト
         std::vector<std::shared_ptr<CollisionObject>> colliders_;
+        // IDからcolliders_内の位置（登録・削除の重複チェックと検索を定数時間で行う）
+        FlatHashMap<uint32_t, uint32_t> colliderIndices_;
+        // 登録中のコライダーの状態（colliders_と同じ並び）
+        ColliderPoseArrays poseArrays_;
+
+        // 遅延コマンドのキュー（複数スレッドから追加、Updateでメインスレッドが取り出す）
+        MpscQueue<ColliderCommand> commandQueue_;
+
+        // 判定フレームのダブルバッファ（frontFrame_側が公開中、もう一方が判定中）
+        CollisionFrame frames_[2];
+        uint32_t frontFrame_ = 0;
+
+        // ペアの判定結果のキャッシュ（判定中のスレッドだけが読み書きする）
+        PairCache pairCache_;
+        bool pairCacheEnabled_ = true;
+
+        // スナップショット作成用の作業配列（キーの順に並べて同じ状態なら同じバイト列にする）
+        std::vector<SnapshotPairCache> snapshotPairs_;
+
+        // 衝突結果の受け取り方
+        ContactOutputMode contactOutputMode_ = ContactOutputMode::Callbacks;
+
+        // 非同期モード
+        bool asyncUpdate_ = false;
+        std::future<void> pendingUpdate_;
+
+        // スナップショット作成後に削除されたコライダーのID（削除済みの相手には通知しない）
+        FlatHashMap<uint32_t, uint8_t> removedSinceSnapshot_;
+        // コールバック通知中か
+        bool isDispatching_ = false;
+
+        // 統計情報
+        CollisionStats stats_;
+
+        // デバッグ描画
+        uint32_t debugLineBudget_ = 8192;
+        std::vector<DebugLineVertex> debugLineVertices_;
 
         // コンストラクタ（シングルトン）
         CollisionManager() = default;
@@ -143,18 +504,65 @@ namespace Collision {
         CollisionManager(const CollisionManager&) = delete;
         CollisionManager& operator=(const CollisionManager&) = delete;
 
+        // 遅延コマンドをすべて反映（反映したコマンド数を返す）
+        uint32_t ApplyQueuedCommands();
+
+        // コライダーの状態を配列から自身に書き戻して登録先を外す
+        static void DetachPose(CollisionObject& collider);
+
+        // コライダー状態をフレームにコピー（メインスレッド）
+        void CaptureSnapshot(CollisionFrame& frame, float deltaTime);
+
+        // ブロードフェーズとナローフェーズ（frameのみを読み書きするためワーカースレッドで実行できる）
+        static void DetectCollisions(CollisionFrame& frame, PairCache& cache);
+
+        // ブロードフェーズ（X軸のスイープ＆プルーンで候補ペアを列挙）
+        static void BuildCandidatePairs(CollisionFrame& frame);
+
+        // 1ペアの詳細判定（スウィープテストの選択を含む）
+        static CollisionResult CheckPair(const ColliderState& collider1, const ColliderState& collider2,
+            float deltaTime, CollisionStats& stats);
+
         // 2つのコライダー間の衝突判定
-        CollisionResult CheckCollision(
-            const CollisionObject* collider1,
-            const CollisionObject* collider2
+        static CollisionResult CheckCollision(
+            const ColliderState& collider1,
+            const ColliderState& collider2
+        );
+
+        // 交差しているかどうかだけの判定（トリガー用）
+        static bool IntersectPair(
+            const ColliderState& collider1,
+            const ColliderState& collider2
+        );
+
+        // 凸包を含むペアの衝突判定（GJK・EPA）
+        static CollisionResult CheckConvexCollision(
+            const ColliderState& collider1,
+            const ColliderState& collider2
+        );
+
+        // 地形を含むペアの衝突判定
+        static CollisionResult CheckHeightfieldCollision(
+            const ColliderState& collider1,
+            const ColliderState& collider2
         );
 
         // 移動を考慮した衝突判定（スウィープテスト）
-        CollisionResult CheckSweepCollision(
-            const CollisionObject* movingCollider,
-            const CollisionObject* staticCollider,
+        static CollisionResult CheckSweepCollision(
+            const ColliderState& movingCollider,
+            const ColliderState& staticCollider,
             float deltaTime
         );
+
+        // 非同期判定の完了を待ち、結果を公開する（実行中の判定がなければfalse）
+        bool CompletePendingUpdate();
+
+        // 公開中のフレームの接触バッファをコールバックで通知（呼び出したコールバック数を返す）
+        // バッファ出力モードでは何もしない
+        uint32_t DispatchCallbacks();
+
+        // 公開中のフレームの統計情報にメインスレッド側の計測値を加えてstats_に反映
+        void PublishStats(uint32_t callbackCount, double snapshotMs, double waitMs, double callbackMs, double mainThreadMs);
     };
 
 } // namespace Collision
\ No newline at end of file
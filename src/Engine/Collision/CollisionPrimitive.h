@@ -36,6 +36,17 @@ namespace Collision {
         }
     };
 
+    // AABB（軸平行境界ボックス）
+    struct AABB {
+        Vector3 min; // 最小点
+        Vector3 max; // 最大点
+
+        // コンストラクタ
+        // ※Windows.hのmin/maxマクロと衝突しないよう波括弧で初期化する
+        AABB() : min{ -1.0f, -1.0f, -1.0f }, max{ 1.0f, 1.0f, 1.0f } {}
+        AABB(const Vector3& minPoint, const Vector3& maxPoint) : min{ minPoint }, max{ maxPoint } {}
+    };
+
     // OBB（有向境界ボックス）- 基本実装のみ
     struct OBB {
         Vector3 center;     // 中心点
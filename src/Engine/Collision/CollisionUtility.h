@@ -1,5 +1,6 @@
 #pragma once
 #include "Vector3.h"
+#include <algorithm>
 #include <cmath>
 
 namespace Collision {
@@ -89,5 +90,41 @@ namespace Collision {
             // 線分上の最近接点を計算
             return Add(segmentStart, Multiply(segment, t));
         }
+
+        // 2つの線分の最近接点のパラメータ（線分1上のs、線分2上のt）を求める
+        static void ClosestSegmentParameters(const Vector3& start1, const Vector3& end1,
+            const Vector3& start2, const Vector3& end2, float& s, float& t) {
+            Vector3 d1 = Subtract(end1, start1);
+            Vector3 d2 = Subtract(end2, start2);
+            Vector3 r = Subtract(start1, start2);
+
+            float a = Dot(d1, d1);
+            float b = Dot(d1, d2);
+            float c = Dot(d2, d2);
+            float d = Dot(d1, r);
+            float e = Dot(d2, r);
+
+            float f = a * c - b * b;
+
+            if (f > 0.0001f) {
+                // 平行でない場合
+                s = std::clamp((b * e - c * d) / f, 0.0f, 1.0f);
+                t = std::clamp((a * e - b * d) / f, 0.0f, 1.0f);
+            }
+            else {
+                // 線分がほぼ平行の場合、片方の始点と相手の線分との距離を比較して決める
+                s = std::clamp(d / a, 0.0f, 1.0f);
+                t = 0.0f;
+            }
+        }
+
+        // AABB上の最近接点を求める
+        static Vector3 ClosestPointOnAABB(const Vector3& point, const Vector3& boxMin, const Vector3& boxMax) {
+            return {
+                std::fmax(boxMin.x, std::fmin(point.x, boxMax.x)),
+                std::fmax(boxMin.y, std::fmin(point.y, boxMax.y)),
+                std::fmax(boxMin.z, std::fmin(point.z, boxMax.z))
+            };
+        }
     };
 } // namespace Collision
\ No newline at end of file
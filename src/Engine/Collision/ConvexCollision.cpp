@@ -0,0 +1,404 @@
+#include "ConvexCollision.h"
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+namespace Collision {
+
+    namespace {
+        // 反復回数の上限
+        const int kMaxGjkIterations = 64;
+        const int kMaxEpaIterations = 64;
+
+        // 方向ベクトルがほぼゼロかどうか
+        bool IsNearlyZero(const Vector3& v) {
+            return Utility::LengthSquared(v) < 1e-12f;
+        }
+
+        // 正規化（Utility::Normalizeは短いベクトルをそのまま返すため、小さな面の法線用に別に用意する）
+        Vector3 NormalizeSmall(const Vector3& v) {
+            float length = Utility::Length(v);
+            return length > 0.0f ? Utility::Multiply(v, 1.0f / length) : v;
+        }
+
+        // 正規化した方向に半径分だけ伸ばす
+        Vector3 Inflate(const Vector3& point, const Vector3& direction, float radius) {
+            if (radius <= 0.0f || IsNearlyZero(direction)) return point;
+            return Utility::Add(point, Utility::Multiply(NormalizeSmall(direction), radius));
+        }
+
+        // a×b×a（aに垂直で、bの側を向くベクトル）
+        Vector3 TripleCross(const Vector3& a, const Vector3& b) {
+            return Utility::Cross(Utility::Cross(a, b), a);
+        }
+
+        // EPAの面
+        struct EpaFace {
+            int v[3];
+            Vector3 normal;
+            float distance;
+        };
+    }
+
+    ConvexSupport ConvexSupport::FromSphere(const Sphere& sphere) {
+        return { Core::Point, sphere.center, sphere.center, nullptr, sphere.radius };
+    }
+
+    ConvexSupport ConvexSupport::FromCapsule(const Capsule& capsule) {
+        return { Core::Segment, capsule.segment.start, capsule.segment.end, nullptr, capsule.radius };
+    }
+
+    ConvexSupport ConvexSupport::FromConvex(const ConvexShape& shape) {
+        return { Core::Hull, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, &shape, 0.0f };
+    }
+
+    Vector3 ConvexSupport::Support(const Vector3& direction) const {
+        Vector3 point;
+        switch (core) {
+        case Core::Point:
+            point = a;
+            break;
+        case Core::Segment:
+            point = Utility::Dot(a, direction) >= Utility::Dot(b, direction) ? a : b;
+            break;
+        default:
+            point = hull->Support(direction);
+            break;
+        }
+        return Inflate(point, direction, radius);
+    }
+
+    Vector3 ConvexSupport::GetCenter() const {
+        switch (core) {
+        case Core::Point:
+            return a;
+        case Core::Segment:
+            return Utility::Multiply(Utility::Add(a, b), 0.5f);
+        default:
+            return hull->GetCenter();
+        }
+    }
+
+    GjkEpa::SimplexVertex GjkEpa::Support(const ConvexSupport& shape1, const ConvexSupport& shape2, const Vector3& direction) {
+        SimplexVertex vertex;
+        vertex.onShape1 = shape1.Support(direction);
+        vertex.point = Utility::Subtract(vertex.onShape1, shape2.Support(Utility::Multiply(direction, -1.0f)));
+        return vertex;
+    }
+
+    bool GjkEpa::UpdateSimplex(SimplexVertex simplex[4], int& simplexCount, Vector3& direction) {
+        // 最後に追加した点をaとする
+        const Vector3 a = simplex[simplexCount - 1].point;
+        const Vector3 ao = Utility::Multiply(a, -1.0f);
+
+        if (simplexCount == 2) {
+            // 線分
+            Vector3 ab = Utility::Subtract(simplex[0].point, a);
+            if (Utility::Dot(ab, ao) > 0.0f) {
+                direction = TripleCross(ab, ao);
+                // 原点が線分上にある
+                if (IsNearlyZero(direction)) return true;
+            }
+            else {
+                simplex[0] = simplex[1];
+                simplexCount = 1;
+                direction = ao;
+            }
+            return false;
+        }
+
+        if (simplexCount == 3) {
+            // 三角形（b・cは古い点）
+            SimplexVertex vb = simplex[1];
+            SimplexVertex vc = simplex[0];
+            SimplexVertex va = simplex[2];
+            Vector3 ab = Utility::Subtract(vb.point, a);
+            Vector3 ac = Utility::Subtract(vc.point, a);
+            Vector3 abc = Utility::Cross(ab, ac);
+
+            if (Utility::Dot(Utility::Cross(abc, ac), ao) > 0.0f) {
+                if (Utility::Dot(ac, ao) > 0.0f) {
+                    // 辺ACの領域
+                    simplex[0] = vc;
+                    simplex[1] = va;
+                    simplexCount = 2;
+                    direction = TripleCross(ac, ao);
+                    if (IsNearlyZero(direction)) return true;
+                    return false;
+                }
+                // 辺ABの領域として線分の処理へ
+                simplex[0] = vb;
+                simplex[1] = va;
+                simplexCount = 2;
+                return UpdateSimplex(simplex, simplexCount, direction);
+            }
+            if (Utility::Dot(Utility::Cross(ab, abc), ao) > 0.0f) {
+                simplex[0] = vb;
+                simplex[1] = va;
+                simplexCount = 2;
+                return UpdateSimplex(simplex, simplexCount, direction);
+            }
+
+            // 三角形の上か下
+            float side = Utility::Dot(abc, ao);
+            if (std::abs(side) < 1e-12f) return true;
+            if (side > 0.0f) {
+                direction = abc;
+            }
+            else {
+                // 巻き順を入れ替えて法線を原点側に向ける
+                simplex[0] = vb;
+                simplex[1] = vc;
+                direction = Utility::Multiply(abc, -1.0f);
+            }
+            return false;
+        }
+
+        // 四面体：原点が外側にある面があればその三角形に縮小する
+        const SimplexVertex va = simplex[3];
+        const SimplexVertex others[3] = { simplex[0], simplex[1], simplex[2] };
+        for (int i = 0; i < 3; ++i) {
+            const SimplexVertex& vx = others[i];
+            const SimplexVertex& vy = others[(i + 1) % 3];
+            const SimplexVertex& vz = others[(i + 2) % 3];
+            Vector3 normal = Utility::Cross(Utility::Subtract(vx.point, a), Utility::Subtract(vy.point, a));
+            if (Utility::Dot(normal, Utility::Subtract(vz.point, a)) > 0.0f) {
+                normal = Utility::Multiply(normal, -1.0f);
+            }
+            if (Utility::Dot(normal, ao) > 0.0f) {
+                simplex[0] = vy;
+                simplex[1] = vx;
+                simplex[2] = va;
+                simplexCount = 3;
+                return UpdateSimplex(simplex, simplexCount, direction);
+            }
+        }
+        return true;
+    }
+
+    bool GjkEpa::RunGjk(const ConvexSupport& shape1, const ConvexSupport& shape2,
+        SimplexVertex simplex[4], int& simplexCount) {
+        // 中心同士を結ぶ方向から探索を始める
+        Vector3 direction = Utility::Subtract(shape2.GetCenter(), shape1.GetCenter());
+        if (IsNearlyZero(direction)) {
+            direction = { 1.0f, 0.0f, 0.0f };
+        }
+
+        simplex[0] = Support(shape1, shape2, direction);
+        simplexCount = 1;
+        direction = Utility::Multiply(simplex[0].point, -1.0f);
+        if (IsNearlyZero(direction)) return true;
+
+        for (int iteration = 0; iteration < kMaxGjkIterations; ++iteration) {
+            SimplexVertex vertex = Support(shape1, shape2, direction);
+
+            // 原点を越えられなければ交差していない
+            if (Utility::Dot(vertex.point, direction) < 0.0f) return false;
+
+            simplex[simplexCount++] = vertex;
+            if (UpdateSimplex(simplex, simplexCount, direction)) return true;
+            if (IsNearlyZero(direction)) return true;
+        }
+
+        // 収束しなかった場合は接触しているものとみなす
+        return true;
+    }
+
+    bool GjkEpa::Intersect(const ConvexSupport& shape1, const ConvexSupport& shape2) {
+        SimplexVertex simplex[4];
+        int simplexCount = 0;
+        return RunGjk(shape1, shape2, simplex, simplexCount);
+    }
+
+    CollisionResult GjkEpa::Solve(const ConvexSupport& shape1, const ConvexSupport& shape2) {
+        CollisionResult result;
+
+        SimplexVertex simplex[4];
+        int simplexCount = 0;
+        if (!RunGjk(shape1, shape2, simplex, simplexCount)) return result;
+        result.isColliding = true;
+
+        // 原点が境界上で止まった場合は四面体になるまで点を補う
+        std::vector<SimplexVertex> vertices(simplex, simplex + simplexCount);
+        auto isIndependent = [&vertices](const Vector3& point) {
+            Vector3 av = Utility::Subtract(point, vertices[0].point);
+            if (vertices.size() == 1) return !IsNearlyZero(av);
+            Vector3 ab = Utility::Subtract(vertices[1].point, vertices[0].point);
+            if (vertices.size() == 2) return !IsNearlyZero(Utility::Cross(ab, av));
+            Vector3 ac = Utility::Subtract(vertices[2].point, vertices[0].point);
+            return std::abs(Utility::Dot(Utility::Cross(ab, ac), av)) > 1e-10f;
+        };
+        while (vertices.size() < 4) {
+            // 今の単体に対して独立な点が得られやすい探索方向
+            std::vector<Vector3> directions = {
+                { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+                { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+                { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+            };
+            if (vertices.size() == 2) {
+                // 線分に垂直な方向
+                Vector3 line = Utility::Subtract(vertices[1].point, vertices[0].point);
+                Vector3 axis = std::abs(line.x) < std::abs(line.y)
+                    ? (std::abs(line.x) < std::abs(line.z) ? Vector3{ 1.0f, 0.0f, 0.0f } : Vector3{ 0.0f, 0.0f, 1.0f })
+                    : (std::abs(line.y) < std::abs(line.z) ? Vector3{ 0.0f, 1.0f, 0.0f } : Vector3{ 0.0f, 0.0f, 1.0f });
+                Vector3 perpendicular1 = Utility::Cross(line, axis);
+                Vector3 perpendicular2 = Utility::Cross(line, perpendicular1);
+                directions.insert(directions.begin(), {
+                    perpendicular1, Utility::Multiply(perpendicular1, -1.0f),
+                    perpendicular2, Utility::Multiply(perpendicular2, -1.0f) });
+            }
+            else if (vertices.size() == 3) {
+                // 三角形の法線方向
+                Vector3 normal = Utility::Cross(
+                    Utility::Subtract(vertices[1].point, vertices[0].point),
+                    Utility::Subtract(vertices[2].point, vertices[0].point));
+                directions.insert(directions.begin(), { normal, Utility::Multiply(normal, -1.0f) });
+            }
+
+            bool added = false;
+            for (const Vector3& direction : directions) {
+                if (IsNearlyZero(direction)) continue;
+                SimplexVertex vertex = Support(shape1, shape2, direction);
+                if (isIndependent(vertex.point)) {
+                    vertices.push_back(vertex);
+                    added = true;
+                    break;
+                }
+            }
+            if (!added) break;
+        }
+        auto hasVolume = [&vertices]() {
+            if (vertices.size() < 4) return false;
+            Vector3 ab = Utility::Subtract(vertices[1].point, vertices[0].point);
+            Vector3 ac = Utility::Subtract(vertices[2].point, vertices[0].point);
+            Vector3 ad = Utility::Subtract(vertices[3].point, vertices[0].point);
+            return std::abs(Utility::Dot(Utility::Cross(ab, ac), ad)) > 1e-10f;
+        };
+        if (!hasVolume()) {
+            // 体積を持たない（接しているだけ）の場合は中心同士の向きを法線とする
+            Vector3 direction = Utility::Subtract(shape2.GetCenter(), shape1.GetCenter());
+            result.normal = IsNearlyZero(direction) ? Vector3{ 0.0f, 1.0f, 0.0f } : NormalizeSmall(direction);
+            result.penetration = 0.0f;
+            result.collisionPoint = shape1.Support(result.normal);
+            return result;
+        }
+
+        // 初期四面体の面（原点を含むので内側の重心から見て外向きにする）
+        Vector3 centroid = Utility::Multiply(Utility::Add(
+            Utility::Add(vertices[0].point, vertices[1].point),
+            Utility::Add(vertices[2].point, vertices[3].point)), 0.25f);
+        std::vector<EpaFace> faces;
+        auto addFace = [&vertices, &faces](int a, int b, int c) {
+            EpaFace face = { { a, b, c }, { 0.0f, 0.0f, 0.0f }, 0.0f };
+            Vector3 normal = Utility::Cross(
+                Utility::Subtract(vertices[b].point, vertices[a].point),
+                Utility::Subtract(vertices[c].point, vertices[a].point));
+            if (Utility::LengthSquared(normal) < 1e-20f) {
+                // 縮退した面は選ばれないよう遠くに置く
+                face.distance = FLT_MAX;
+            }
+            else {
+                face.normal = NormalizeSmall(normal);
+                face.distance = Utility::Dot(face.normal, vertices[a].point);
+            }
+            faces.push_back(face);
+        };
+        const int kTetrahedron[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 1, 3, 2 }, { 2, 3, 0 } };
+        for (const auto& indices : kTetrahedron) {
+            int a = indices[0];
+            int b = indices[1];
+            int c = indices[2];
+            Vector3 normal = Utility::Cross(
+                Utility::Subtract(vertices[b].point, vertices[a].point),
+                Utility::Subtract(vertices[c].point, vertices[a].point));
+            if (Utility::Dot(normal, Utility::Subtract(vertices[a].point, centroid)) < 0.0f) {
+                std::swap(b, c);
+            }
+            addFace(a, b, c);
+        }
+
+        // 原点に最も近い面をサポート点で押し広げていく
+        std::vector<std::pair<int, int>> edges;
+        auto findClosestFace = [&faces]() {
+            size_t closest = 0;
+            for (size_t f = 1; f < faces.size(); ++f) {
+                if (faces[f].distance < faces[closest].distance) closest = f;
+            }
+            return closest;
+        };
+        for (int iteration = 0; iteration < kMaxEpaIterations; ++iteration) {
+            const EpaFace& face = faces[findClosestFace()];
+
+            SimplexVertex vertex = Support(shape1, shape2, face.normal);
+            float supportDistance = Utility::Dot(vertex.point, face.normal);
+            float tolerance = 1e-4f * std::max(1.0f, face.distance);
+            if (supportDistance - face.distance < tolerance) break;
+
+            // 新しい点から見える面を削除し、境界の辺を集める
+            int newIndex = static_cast<int>(vertices.size());
+            vertices.push_back(vertex);
+            edges.clear();
+            for (size_t f = 0; f < faces.size();) {
+                const EpaFace& candidate = faces[f];
+                if (candidate.distance != FLT_MAX &&
+                    Utility::Dot(candidate.normal, Utility::Subtract(vertex.point, vertices[candidate.v[0]].point)) > 0.0f) {
+                    for (int e = 0; e < 3; ++e) {
+                        std::pair<int, int> edge = { candidate.v[e], candidate.v[(e + 1) % 3] };
+                        // 逆向きの辺が既にあれば共有辺なので境界ではない
+                        auto reverse = std::find(edges.begin(), edges.end(), std::make_pair(edge.second, edge.first));
+                        if (reverse != edges.end()) {
+                            edges.erase(reverse);
+                        }
+                        else {
+                            edges.push_back(edge);
+                        }
+                    }
+                    faces[f] = faces.back();
+                    faces.pop_back();
+                }
+                else {
+                    ++f;
+                }
+            }
+            if (edges.empty()) break;
+
+            for (const auto& [from, to] : edges) {
+                addFace(from, to, newIndex);
+            }
+        }
+
+        // 最も近い面の法線とめり込み量
+        const EpaFace& face = faces[findClosestFace()];
+        result.normal = face.normal;
+        result.penetration = face.distance;
+
+        // 原点を面へ投影した点の重心座標から、shape1上の衝突点を求める
+        const Vector3& p0 = vertices[face.v[0]].point;
+        const Vector3& p1 = vertices[face.v[1]].point;
+        const Vector3& p2 = vertices[face.v[2]].point;
+        Vector3 projected = Utility::Multiply(face.normal, face.distance);
+        Vector3 v0 = Utility::Subtract(p1, p0);
+        Vector3 v1 = Utility::Subtract(p2, p0);
+        Vector3 v2 = Utility::Subtract(projected, p0);
+        float d00 = Utility::Dot(v0, v0);
+        float d01 = Utility::Dot(v0, v1);
+        float d11 = Utility::Dot(v1, v1);
+        float d20 = Utility::Dot(v2, v0);
+        float d21 = Utility::Dot(v2, v1);
+        float denominator = d00 * d11 - d01 * d01;
+        if (std::abs(denominator) > 1e-12f) {
+            float v = (d11 * d20 - d01 * d21) / denominator;
+            float w = (d00 * d21 - d01 * d20) / denominator;
+            float u = 1.0f - v - w;
+            result.collisionPoint = Utility::Add(
+                Utility::Add(Utility::Multiply(vertices[face.v[0]].onShape1, u), Utility::Multiply(vertices[face.v[1]].onShape1, v)),
+                Utility::Multiply(vertices[face.v[2]].onShape1, w));
+        }
+        else {
+            result.collisionPoint = vertices[face.v[0]].onShape1;
+        }
+
+        return result;
+    }
+
+} // namespace Collision
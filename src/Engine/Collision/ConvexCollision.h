@@ -0,0 +1,58 @@
+#pragma once
+#include "Collision.h"
+#include "ConvexHull.h"
+
+namespace Collision {
+    // GJK・EPAで扱う凸形状（芯となる点・線分・凸包に半径を加えたもの）
+    struct ConvexSupport {
+        enum class Core {
+            Point,   // 球（a＋半径）
+            Segment, // カプセル（a-b＋半径）
+            Hull     // 凸包（＋半径）
+        };
+
+        Core core;
+        Vector3 a;
+        Vector3 b;
+        const ConvexShape* hull;
+        float radius;
+
+        // 各形状からの作成
+        static ConvexSupport FromSphere(const Sphere& sphere);
+        static ConvexSupport FromCapsule(const Capsule& capsule);
+        static ConvexSupport FromConvex(const ConvexShape& shape);
+
+        // 指定方向に最も遠い点
+        Vector3 Support(const Vector3& direction) const;
+
+        // 形状の内部にある代表点（初期探索方向に使う）
+        Vector3 GetCenter() const;
+    };
+
+    // GJK（交差判定）とEPA（めり込み量の計算）
+    class GjkEpa {
+    public:
+        // 交差しているかどうかだけを判定する
+        static bool Intersect(const ConvexSupport& shape1, const ConvexSupport& shape2);
+
+        // 交差していればめり込み量・法線（shape1からshape2へ向かう）・衝突点を求める
+        static CollisionResult Solve(const ConvexSupport& shape1, const ConvexSupport& shape2);
+
+    private:
+        // ミンコフスキー差の頂点（衝突点の計算用にshape1側の点も保持する）
+        struct SimplexVertex {
+            Vector3 point;
+            Vector3 onShape1;
+        };
+
+        // ミンコフスキー差（shape1 - shape2）のサポート点
+        static SimplexVertex Support(const ConvexSupport& shape1, const ConvexSupport& shape2, const Vector3& direction);
+
+        // GJK本体（交差していればsimplexに原点を含む四面体を残してtrueを返す）
+        static bool RunGjk(const ConvexSupport& shape1, const ConvexSupport& shape2,
+            SimplexVertex simplex[4], int& simplexCount);
+
+        // 単体を原点に最も近い部分に縮小し、次の探索方向を求める（原点を含めばtrue）
+        static bool UpdateSimplex(SimplexVertex simplex[4], int& simplexCount, Vector3& direction);
+    };
+} // namespace Collision
@@ -0,0 +1,387 @@
+#include "ConvexHull.h"
+#include "CollisionUtility.h"
+#include "FlatHashMap.h"
+#include <algorithm>
+#include <cfloat>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define COLLISION_CONVEX_SSE2
+#endif
+
+namespace Collision {
+
+    namespace {
+        // クイックハルの作業用の面
+        struct HullFace {
+            uint32_t v[3];
+            Vector3 normal;
+            float offset;                  // 平面の原点からの距離（dot(normal, v0)）
+            std::vector<uint32_t> outside; // この面の外側にある点
+            bool alive;
+        };
+
+        // 3点から面を作る（(b-a)×(c-a)を法線とする）
+        HullFace MakeFace(const std::vector<Vector3>& points, uint32_t a, uint32_t b, uint32_t c) {
+            HullFace face;
+            face.v[0] = a;
+            face.v[1] = b;
+            face.v[2] = c;
+            Vector3 normal = Utility::Cross(
+                Utility::Subtract(points[b], points[a]),
+                Utility::Subtract(points[c], points[a]));
+            float length = Utility::Length(normal);
+            // 縮退した面はどの点からも見えない面として扱う
+            face.normal = length > 1e-12f ? Utility::Multiply(normal, 1.0f / length) : Vector3{ 0.0f, 0.0f, 0.0f };
+            face.offset = Utility::Dot(face.normal, points[a]);
+            face.alive = true;
+            return face;
+        }
+
+        // 面から点までの符号付き距離（正なら外側）
+        float DistanceToFace(const HullFace& face, const Vector3& point) {
+            return Utility::Dot(face.normal, point) - face.offset;
+        }
+
+        // 有向辺のキー
+        uint64_t EdgeKey(uint32_t from, uint32_t to) {
+            return (static_cast<uint64_t>(from) << 32) | to;
+        }
+
+        // 最も外側にある面へ点を割り当てる（どの面の外にもなければ内部の点として捨てる）
+        void AssignToFaces(const std::vector<Vector3>& points, std::vector<HullFace>& faces,
+            size_t firstFace, uint32_t point, float epsilon) {
+            float bestDistance = epsilon;
+            size_t bestFace = faces.size();
+            for (size_t f = firstFace; f < faces.size(); ++f) {
+                if (!faces[f].alive) continue;
+                float distance = DistanceToFace(faces[f], points[point]);
+                if (distance > bestDistance) {
+                    bestDistance = distance;
+                    bestFace = f;
+                }
+            }
+            if (bestFace < faces.size()) {
+                faces[bestFace].outside.push_back(point);
+            }
+        }
+    }
+
+    std::shared_ptr<const ConvexHull> ConvexHull::Build(const std::vector<Vector3>& points) {
+        if (points.size() < 4) return nullptr;
+        const uint32_t pointCount = static_cast<uint32_t>(points.size());
+
+        // 各軸の最小・最大の点と、大きさに応じた許容誤差
+        uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+        for (uint32_t i = 1; i < pointCount; ++i) {
+            const Vector3& p = points[i];
+            if (p.x < points[extremes[0]].x) extremes[0] = i;
+            if (p.x > points[extremes[1]].x) extremes[1] = i;
+            if (p.y < points[extremes[2]].y) extremes[2] = i;
+            if (p.y > points[extremes[3]].y) extremes[3] = i;
+            if (p.z < points[extremes[4]].z) extremes[4] = i;
+            if (p.z > points[extremes[5]].z) extremes[5] = i;
+        }
+        float extentSum =
+            (points[extremes[1]].x - points[extremes[0]].x) +
+            (points[extremes[3]].y - points[extremes[2]].y) +
+            (points[extremes[5]].z - points[extremes[4]].z);
+        const float epsilon = std::max(extentSum * 1e-5f, 1e-7f);
+
+        // 初期の四面体：最も離れた極点の組
+        uint32_t i0 = extremes[0];
+        uint32_t i1 = extremes[1];
+        float bestDistance = -1.0f;
+        for (int a = 0; a < 6; ++a) {
+            for (int b = a + 1; b < 6; ++b) {
+                float distance = Utility::DistanceSquared(points[extremes[a]], points[extremes[b]]);
+                if (distance > bestDistance) {
+                    bestDistance = distance;
+                    i0 = extremes[a];
+                    i1 = extremes[b];
+                }
+            }
+        }
+
+        // 線分i0-i1から最も遠い点
+        uint32_t i2 = i0;
+        bestDistance = 0.0f;
+        for (uint32_t i = 0; i < pointCount; ++i) {
+            Vector3 closest = Utility::ClosestPointOnSegment(points[i], points[i0], points[i1]);
+            float distance = Utility::DistanceSquared(points[i], closest);
+            if (distance > bestDistance) {
+                bestDistance = distance;
+                i2 = i;
+            }
+        }
+        if (bestDistance <= epsilon * epsilon) return nullptr;
+
+        // 平面i0-i1-i2から最も遠い点
+        HullFace base = MakeFace(points, i0, i1, i2);
+        uint32_t i3 = i0;
+        bestDistance = 0.0f;
+        for (uint32_t i = 0; i < pointCount; ++i) {
+            float distance = std::abs(DistanceToFace(base, points[i]));
+            if (distance > bestDistance) {
+                bestDistance = distance;
+                i3 = i;
+            }
+        }
+        if (bestDistance <= epsilon) return nullptr;
+
+        // 4点目が裏側に来るように向きを揃えて四面体を作る
+        // 有向辺から面への対応を持ち、隣の面を辿れるようにする
+        std::vector<HullFace> faces;
+        FlatHashMap<uint64_t, uint32_t> edgeToFace;
+        auto addFace = [&](uint32_t a, uint32_t b, uint32_t c) {
+            uint32_t index = static_cast<uint32_t>(faces.size());
+            faces.push_back(MakeFace(points, a, b, c));
+            edgeToFace.InsertOrAssign(EdgeKey(a, b), index);
+            edgeToFace.InsertOrAssign(EdgeKey(b, c), index);
+            edgeToFace.InsertOrAssign(EdgeKey(c, a), index);
+        };
+        if (DistanceToFace(base, points[i3]) > 0.0f) {
+            std::swap(i1, i2);
+        }
+        addFace(i0, i1, i2);
+        addFace(i0, i3, i1);
+        addFace(i1, i3, i2);
+        addFace(i2, i3, i0);
+
+        for (uint32_t i = 0; i < pointCount; ++i) {
+            if (i == i0 || i == i1 || i == i2 || i == i3) continue;
+            AssignToFaces(points, faces, 0, i, epsilon);
+        }
+
+        // 外側に点を持つ面がなくなるまで凸包を広げる
+        std::vector<size_t> pending = { 0, 1, 2, 3 };
+        std::vector<uint32_t> visible;
+        std::vector<uint8_t> isVisible;
+        std::vector<std::pair<uint32_t, uint32_t>> horizon;
+        std::vector<uint32_t> orphans;
+        while (!pending.empty()) {
+            size_t faceIndex = pending.back();
+            pending.pop_back();
+            if (!faces[faceIndex].alive || faces[faceIndex].outside.empty()) continue;
+
+            // 面から最も遠い点
+            const std::vector<uint32_t>& outside = faces[faceIndex].outside;
+            uint32_t eye = outside[0];
+            float eyeDistance = DistanceToFace(faces[faceIndex], points[eye]);
+            for (uint32_t point : outside) {
+                float distance = DistanceToFace(faces[faceIndex], points[point]);
+                if (distance > eyeDistance) {
+                    eyeDistance = distance;
+                    eye = point;
+                }
+            }
+
+            // その点から見える面を隣接面を辿って集める（見える領域が連続するようにする）
+            // わずかでも表側にある面は見えるものとして扱い、細い面で凹みが生じないようにする
+            isVisible.resize(faces.size(), 0);
+            visible.clear();
+            visible.push_back(static_cast<uint32_t>(faceIndex));
+            isVisible[faceIndex] = 1;
+            horizon.clear();
+            for (size_t v = 0; v < visible.size(); ++v) {
+                const HullFace& face = faces[visible[v]];
+                for (int e = 0; e < 3; ++e) {
+                    uint32_t from = face.v[e];
+                    uint32_t to = face.v[(e + 1) % 3];
+                    const uint32_t* neighbor = edgeToFace.Find(EdgeKey(to, from));
+                    if (!neighbor || isVisible[*neighbor]) continue;
+                    if (DistanceToFace(faces[*neighbor], points[eye]) > 0.0f) {
+                        isVisible[*neighbor] = 1;
+                        visible.push_back(*neighbor);
+                    }
+                }
+            }
+
+            // 見える面と見えない面の境界の辺
+            for (uint32_t f : visible) {
+                const HullFace& face = faces[f];
+                for (int e = 0; e < 3; ++e) {
+                    uint32_t from = face.v[e];
+                    uint32_t to = face.v[(e + 1) % 3];
+                    const uint32_t* neighbor = edgeToFace.Find(EdgeKey(to, from));
+                    if (!neighbor || !isVisible[*neighbor]) {
+                        horizon.emplace_back(from, to);
+                    }
+                }
+            }
+
+            // 見える面を削除
+            orphans.clear();
+            for (uint32_t f : visible) {
+                HullFace& face = faces[f];
+                for (int e = 0; e < 3; ++e) {
+                    edgeToFace.Erase(EdgeKey(face.v[e], face.v[(e + 1) % 3]));
+                }
+                orphans.insert(orphans.end(), face.outside.begin(), face.outside.end());
+                face.outside.clear();
+                face.alive = false;
+                isVisible[f] = 0;
+            }
+
+            // 境界の辺と点を結ぶ面を追加し、宙に浮いた点を割り当て直す
+            size_t firstNewFace = faces.size();
+            for (const auto& [from, to] : horizon) {
+                addFace(from, to, eye);
+            }
+            for (uint32_t point : orphans) {
+                if (point == eye) continue;
+                AssignToFaces(points, faces, firstNewFace, point, epsilon);
+            }
+            for (size_t f = firstNewFace; f < faces.size(); ++f) {
+                if (!faces[f].outside.empty()) {
+                    pending.push_back(f);
+                }
+            }
+        }
+
+        // 残った面が使う頂点だけを詰め直す
+        std::shared_ptr<ConvexHull> hull = std::make_shared<ConvexHull>();
+        std::vector<uint32_t> remap(pointCount, UINT32_MAX);
+        std::vector<Vector3> vertices;
+        for (const HullFace& face : faces) {
+            if (!face.alive) continue;
+            for (uint32_t v : face.v) {
+                if (remap[v] == UINT32_MAX) {
+                    remap[v] = static_cast<uint32_t>(vertices.size());
+                    vertices.push_back(points[v]);
+                }
+                hull->triangles_.push_back(remap[v]);
+            }
+        }
+
+        // 辺（隣り合う面で逆向きに2回現れるので片方だけ採用）
+        for (size_t t = 0; t < hull->triangles_.size(); t += 3) {
+            for (int e = 0; e < 3; ++e) {
+                uint32_t from = hull->triangles_[t + e];
+                uint32_t to = hull->triangles_[t + (e + 1) % 3];
+                if (from < to) {
+                    hull->edges_.push_back(from);
+                    hull->edges_.push_back(to);
+                }
+            }
+        }
+
+        // SoA配列に格納（SIMD幅の倍数に切り上げ、余りは先頭頂点で埋める）
+        hull->vertexCount_ = static_cast<uint32_t>(vertices.size());
+        size_t paddedCount = (vertices.size() + kSimdWidth - 1) / kSimdWidth * kSimdWidth;
+        hull->xs_.assign(paddedCount, vertices[0].x);
+        hull->ys_.assign(paddedCount, vertices[0].y);
+        hull->zs_.assign(paddedCount, vertices[0].z);
+        Vector3 boundsMin = vertices[0];
+        Vector3 boundsMax = vertices[0];
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vector3& v = vertices[i];
+            hull->xs_[i] = v.x;
+            hull->ys_[i] = v.y;
+            hull->zs_[i] = v.z;
+            boundsMin = { std::min(boundsMin.x, v.x), std::min(boundsMin.y, v.y), std::min(boundsMin.z, v.z) };
+            boundsMax = { std::max(boundsMax.x, v.x), std::max(boundsMax.y, v.y), std::max(boundsMax.z, v.z) };
+        }
+        hull->bounds_ = AABB(boundsMin, boundsMax);
+
+        return hull;
+    }
+
+    Vector3 ConvexHull::Support(const Vector3& direction) const {
+        const size_t count = xs_.size();
+        uint32_t bestIndex = 0;
+
+#ifdef COLLISION_CONVEX_SSE2
+        // 4頂点ずつ内積を計算し、レーンごとの最大値とその番号を保持する
+        const __m128 dx = _mm_set1_ps(direction.x);
+        const __m128 dy = _mm_set1_ps(direction.y);
+        const __m128 dz = _mm_set1_ps(direction.z);
+        __m128 best = _mm_set1_ps(-FLT_MAX);
+        __m128i bestLane = _mm_setzero_si128();
+        __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i step = _mm_set1_epi32(static_cast<int>(kSimdWidth));
+
+        for (size_t i = 0; i < count; i += kSimdWidth) {
+            __m128 dot = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&xs_[i]), dx), _mm_mul_ps(_mm_loadu_ps(&ys_[i]), dy)),
+                _mm_mul_ps(_mm_loadu_ps(&zs_[i]), dz));
+            __m128i greater = _mm_castps_si128(_mm_cmpgt_ps(dot, best));
+            best = _mm_max_ps(best, dot);
+            bestLane = _mm_or_si128(_mm_and_si128(greater, lane), _mm_andnot_si128(greater, bestLane));
+            lane = _mm_add_epi32(lane, step);
+        }
+
+        // レーン間の最大値（同値なら番号の小さい方）
+        alignas(16) float bestValues[4];
+        alignas(16) int32_t bestIndices[4];
+        _mm_store_ps(bestValues, best);
+        _mm_store_si128(reinterpret_cast<__m128i*>(bestIndices), bestLane);
+        float bestValue = bestValues[0];
+        bestIndex = static_cast<uint32_t>(bestIndices[0]);
+        for (int l = 1; l < 4; ++l) {
+            uint32_t index = static_cast<uint32_t>(bestIndices[l]);
+            if (bestValues[l] > bestValue || (bestValues[l] == bestValue && index < bestIndex)) {
+                bestValue = bestValues[l];
+                bestIndex = index;
+            }
+        }
+#else
+        float bestValue = -FLT_MAX;
+        for (size_t i = 0; i < count; ++i) {
+            float dot = xs_[i] * direction.x + ys_[i] * direction.y + zs_[i] * direction.z;
+            if (dot > bestValue) {
+                bestValue = dot;
+                bestIndex = static_cast<uint32_t>(i);
+            }
+        }
+#endif
+
+        return GetVertex(bestIndex);
+    }
+
+    ConvexShape::ConvexShape() : hull(nullptr), world{} {
+        world.m[0][0] = world.m[1][1] = world.m[2][2] = world.m[3][3] = 1.0f;
+    }
+
+    ConvexShape::ConvexShape(std::shared_ptr<const ConvexHull> hull, const Matrix4x4& world)
+        : hull(std::move(hull)), world(world) {
+    }
+
+    Vector3 ConvexShape::Support(const Vector3& direction) const {
+        // ワールドの方向をローカルへ（行ベクトル形式なので行列×列ベクトルで転置を掛けたことになる）
+        Vector3 local = {
+            world.m[0][0] * direction.x + world.m[0][1] * direction.y + world.m[0][2] * direction.z,
+            world.m[1][0] * direction.x + world.m[1][1] * direction.y + world.m[1][2] * direction.z,
+            world.m[2][0] * direction.x + world.m[2][1] * direction.y + world.m[2][2] * direction.z
+        };
+        return TransformPoint(hull->Support(local));
+    }
+
+    Vector3 ConvexShape::TransformPoint(const Vector3& point) const {
+        return {
+            point.x * world.m[0][0] + point.y * world.m[1][0] + point.z * world.m[2][0] + world.m[3][0],
+            point.x * world.m[0][1] + point.y * world.m[1][1] + point.z * world.m[2][1] + world.m[3][1],
+            point.x * world.m[0][2] + point.y * world.m[1][2] + point.z * world.m[2][2] + world.m[3][2]
+        };
+    }
+
+    AABB ConvexShape::ComputeBounds() const {
+        // ローカルの中心と半径を変換する
+        const AABB& local = hull->GetLocalBounds();
+        Vector3 center = Utility::Multiply(Utility::Add(local.min, local.max), 0.5f);
+        Vector3 extent = Utility::Multiply(Utility::Subtract(local.max, local.min), 0.5f);
+        Vector3 worldCenter = TransformPoint(center);
+        Vector3 worldExtent = {
+            std::abs(world.m[0][0]) * extent.x + std::abs(world.m[1][0]) * extent.y + std::abs(world.m[2][0]) * extent.z,
+            std::abs(world.m[0][1]) * extent.x + std::abs(world.m[1][1]) * extent.y + std::abs(world.m[2][1]) * extent.z,
+            std::abs(world.m[0][2]) * extent.x + std::abs(world.m[1][2]) * extent.y + std::abs(world.m[2][2]) * extent.z
+        };
+        return AABB(Utility::Subtract(worldCenter, worldExtent), Utility::Add(worldCenter, worldExtent));
+    }
+
+    Vector3 ConvexShape::GetCenter() const {
+        const AABB& local = hull->GetLocalBounds();
+        return TransformPoint(Utility::Multiply(Utility::Add(local.min, local.max), 0.5f));
+    }
+
+} // namespace Collision
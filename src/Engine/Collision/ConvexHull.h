@@ -0,0 +1,72 @@
+#pragma once
+#include "CollisionPrimitive.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Collision {
+    // 凸包（ローカル座標の頂点と面）
+    // 頂点はサポート点探索をSIMDで行えるようにSoA（x・y・zの別配列）で保持する
+    class ConvexHull {
+    public:
+        // SoA配列の要素数の単位（余りは先頭頂点の複製で埋める）
+        static constexpr uint32_t kSimdWidth = 4;
+
+        // 点群から凸包を生成する（クイックハル）
+        // 点が4つ未満、またはすべて同一平面上にあるなど体積を持たない場合はnullptr
+        static std::shared_ptr<const ConvexHull> Build(const std::vector<Vector3>& points);
+
+        // 指定方向に最も遠い頂点（ローカル座標）
+        Vector3 Support(const Vector3& direction) const;
+
+        // 頂点
+        uint32_t GetVertexCount() const { return vertexCount_; }
+        Vector3 GetVertex(uint32_t index) const { return { xs_[index], ys_[index], zs_[index] }; }
+
+        // 三角形の頂点インデックス（3つで1面、(v1-v0)×(v2-v0)が外向き）
+        const std::vector<uint32_t>& GetTriangles() const { return triangles_; }
+
+        // 辺の頂点インデックス（2つで1本、重複なし）
+        const std::vector<uint32_t>& GetEdges() const { return edges_; }
+
+        // ローカル座標での境界ボックス
+        const AABB& GetLocalBounds() const { return bounds_; }
+
+    private:
+        // 頂点座標（SoA）
+        std::vector<float> xs_;
+        std::vector<float> ys_;
+        std::vector<float> zs_;
+        uint32_t vertexCount_ = 0;
+
+        // 面と辺
+        std::vector<uint32_t> triangles_;
+        std::vector<uint32_t> edges_;
+
+        // 境界ボックス
+        AABB bounds_;
+    };
+
+    // ワールドに配置した凸包
+    // worldはMakeAffineMatrixと同じ行ベクトル形式のアフィン行列（拡大縮小・回転・平行移動）
+    struct ConvexShape {
+        std::shared_ptr<const ConvexHull> hull;
+        Matrix4x4 world;
+
+        // コンストラクタ
+        ConvexShape();
+        ConvexShape(std::shared_ptr<const ConvexHull> hull, const Matrix4x4& world);
+
+        // 指定方向に最も遠い点（ワールド座標）
+        Vector3 Support(const Vector3& direction) const;
+
+        // ローカル座標の点をワールド座標へ変換
+        Vector3 TransformPoint(const Vector3& point) const;
+
+        // ワールド座標での境界ボックス
+        AABB ComputeBounds() const;
+
+        // 中心（境界ボックスの中心のワールド座標）
+        Vector3 GetCenter() const;
+    };
+} // namespace Collision
@@ -0,0 +1,208 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Collision {
+    // オープンアドレス法（線形探索）によるフラットなハッシュマップ
+    // 要素ごとのノード確保を行わず、すべての要素を連続したスロット配列に格納する
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class FlatHashMap {
+    public:
+        // コンストラクタ
+        FlatHashMap() = default;
+
+        // 要素の検索（見つからなければnullptr）
+        Value* Find(const Key& key) {
+            if (size_ == 0) return nullptr;
+            size_t index = IndexFor(key);
+            while (slots_[index].occupied) {
+                if (KeyEqual()(slots_[index].key, key)) {
+                    return &slots_[index].value;
+                }
+                index = (index + 1) & mask_;
+            }
+            return nullptr;
+        }
+        const Value* Find(const Key& key) const {
+            return const_cast<FlatHashMap*>(this)->Find(key);
+        }
+
+        // 要素が存在するかどうか
+        bool Contains(const Key& key) const { return Find(key) != nullptr; }
+
+        // 要素の取得（存在しなければデフォルト値で挿入）
+        Value& operator[](const Key& key) {
+            Value* found = Find(key);
+            if (found) return *found;
+            return InsertNew(key, Value());
+        }
+
+        // 要素の挿入（既に存在する場合は上書き）
+        Value& InsertOrAssign(const Key& key, Value value) {
+            Value* found = Find(key);
+            if (found) {
+                *found = std::move(value);
+                return *found;
+            }
+            return InsertNew(key, std::move(value));
+        }
+
+        // 要素の削除（削除できればtrue）
+        bool Erase(const Key& key) {
+            if (size_ == 0) return false;
+            size_t index = IndexFor(key);
+            while (slots_[index].occupied) {
+                if (KeyEqual()(slots_[index].key, key)) {
+                    EraseSlot(index);
+                    return true;
+                }
+                index = (index + 1) & mask_;
+            }
+            return false;
+        }
+
+        // 条件に一致する要素をまとめて削除（削除数を返す）
+        template<typename Predicate>
+        size_t EraseIf(Predicate predicate) {
+            size_t erased = 0;
+            for (Slot& slot : slots_) {
+                if (slot.occupied && predicate(slot.key, slot.value)) {
+                    slot.occupied = false;
+                    slot.value = Value();
+                    ++erased;
+                }
+            }
+            if (erased > 0) {
+                // 探索チェーンが途切れるため同じ容量で詰め直す
+                Rehash(slots_.size());
+            }
+            return erased;
+        }
+
+        // 全要素の走査
+        template<typename Func>
+        void ForEach(Func func) {
+            for (Slot& slot : slots_) {
+                if (slot.occupied) func(slot.key, slot.value);
+            }
+        }
+        template<typename Func>
+        void ForEach(Func func) const {
+            for (const Slot& slot : slots_) {
+                if (slot.occupied) func(slot.key, slot.value);
+            }
+        }
+
+        // 全要素の削除（容量は維持する）
+        void Clear() {
+            for (Slot& slot : slots_) {
+                if (slot.occupied) {
+                    slot.occupied = false;
+                    slot.value = Value();
+                }
+            }
+            size_ = 0;
+        }
+
+        // 指定数の要素を再確保なしで格納できるようにする
+        void Reserve(size_t count) {
+            size_t required = CapacityFor(count);
+            if (required > slots_.size()) {
+                Rehash(required);
+            }
+        }
+
+        // 要素数
+        size_t Size() const { return size_; }
+        bool Empty() const { return size_ == 0; }
+
+    private:
+        // スロット
+        struct Slot {
+            Key key{};
+            Value value{};
+            bool occupied = false;
+        };
+
+        // スロット配列（容量は常に2の累乗）
+        std::vector<Slot> slots_;
+        // 要素数
+        size_t size_ = 0;
+        // インデックス計算用マスク
+        size_t mask_ = 0;
+
+        // 最大負荷率 7/8 を満たす容量を求める
+        static size_t CapacityFor(size_t count) {
+            size_t capacity = 8;
+            while (capacity * 7 / 8 < count + 1) {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        // ハッシュ値からスロット番号を求める
+        size_t IndexFor(const Key& key) const {
+            // 下位ビットの偏りを抑えるために混ぜ合わせる
+            uint64_t h = static_cast<uint64_t>(Hash()(key));
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            return static_cast<size_t>(h) & mask_;
+        }
+
+        // 新規要素の挿入
+        Value& InsertNew(const Key& key, Value value) {
+            if (slots_.empty() || (size_ + 1) > slots_.size() * 7 / 8) {
+                Rehash(slots_.empty() ? 8 : slots_.size() * 2);
+            }
+            size_t index = IndexFor(key);
+            while (slots_[index].occupied) {
+                index = (index + 1) & mask_;
+            }
+            slots_[index].key = key;
+            slots_[index].value = std::move(value);
+            slots_[index].occupied = true;
+            ++size_;
+            return slots_[index].value;
+        }
+
+        // スロットの削除（後続要素を詰めて探索チェーンを保つ）
+        void EraseSlot(size_t index) {
+            size_t hole = index;
+            size_t next = (hole + 1) & mask_;
+            while (slots_[next].occupied) {
+                size_t home = IndexFor(slots_[next].key);
+                // homeが(hole, next]の範囲外なら穴に移動できる
+                bool movable = (hole <= next)
+                    ? (home <= hole || home > next)
+                    : (home <= hole && home > next);
+                if (movable) {
+                    slots_[hole].key = std::move(slots_[next].key);
+                    slots_[hole].value = std::move(slots_[next].value);
+                    hole = next;
+                }
+                next = (next + 1) & mask_;
+            }
+            slots_[hole].occupied = false;
+            slots_[hole].value = Value();
+            --size_;
+        }
+
+        // 容量を変更して全要素を再配置
+        void Rehash(size_t newCapacity) {
+            std::vector<Slot> oldSlots = std::move(slots_);
+            slots_.clear();
+            slots_.resize(newCapacity);
+            mask_ = newCapacity - 1;
+            size_ = 0;
+            for (Slot& slot : oldSlots) {
+                if (slot.occupied) {
+                    InsertNew(slot.key, std::move(slot.value));
+                }
+            }
+        }
+    };
+} // namespace Collision
@@ -0,0 +1,467 @@
+#include "Heightfield.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Collision {
+
+    namespace {
+        // 量子化の段階数
+        constexpr float kQuantizeLevels = 65535.0f;
+
+        // 三角形の上向きの法線
+        Vector3 UpwardNormal(const Vector3& a, const Vector3& b, const Vector3& c) {
+            Vector3 normal = Utility::Cross(Utility::Subtract(b, a), Utility::Subtract(c, a));
+            if (normal.y < 0.0f) {
+                normal = Utility::Multiply(normal, -1.0f);
+            }
+            float length = Utility::Length(normal);
+            return length > 0.0f ? Utility::Multiply(normal, 1.0f / length) : Vector3{ 0.0f, 1.0f, 0.0f };
+        }
+
+        // XZ平面に投影した三角形の重心座標（投影が縮退していればfalse）
+        bool BarycentricXZ(const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c,
+            float& u, float& v, float& w) {
+            float denominator = (b.z - c.z) * (a.x - c.x) + (c.x - b.x) * (a.z - c.z);
+            if (std::abs(denominator) < 1e-12f) return false;
+            u = ((b.z - c.z) * (p.x - c.x) + (c.x - b.x) * (p.z - c.z)) / denominator;
+            v = ((c.z - a.z) * (p.x - c.x) + (a.x - c.x) * (p.z - c.z)) / denominator;
+            w = 1.0f - u - v;
+            return true;
+        }
+
+        // 三角形上の最近接点
+        Vector3 ClosestPointOnTriangle(const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c) {
+            Vector3 ab = Utility::Subtract(b, a);
+            Vector3 ac = Utility::Subtract(c, a);
+            Vector3 ap = Utility::Subtract(p, a);
+            float d1 = Utility::Dot(ab, ap);
+            float d2 = Utility::Dot(ac, ap);
+            if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+            Vector3 bp = Utility::Subtract(p, b);
+            float d3 = Utility::Dot(ab, bp);
+            float d4 = Utility::Dot(ac, bp);
+            if (d3 >= 0.0f && d4 <= d3) return b;
+
+            float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+                return Utility::Add(a, Utility::Multiply(ab, d1 / (d1 - d3)));
+            }
+
+            Vector3 cp = Utility::Subtract(p, c);
+            float d5 = Utility::Dot(ab, cp);
+            float d6 = Utility::Dot(ac, cp);
+            if (d6 >= 0.0f && d5 <= d6) return c;
+
+            float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+                return Utility::Add(a, Utility::Multiply(ac, d2 / (d2 - d6)));
+            }
+
+            float va = d3 * d6 - d5 * d4;
+            if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+                return Utility::Add(b, Utility::Multiply(Utility::Subtract(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+            }
+
+            float denominator = 1.0f / (va + vb + vc);
+            return Utility::Add(a, Utility::Add(Utility::Multiply(ab, vb * denominator), Utility::Multiply(ac, vc * denominator)));
+        }
+
+        // レイと三角形の交差（Moller-Trumbore、表から当たった場合のみ）
+        bool RayTriangle(const Vector3& origin, const Vector3& direction, const Vector3& a, const Vector3& b, const Vector3& c,
+            const Vector3& normal, float& t) {
+            if (Utility::Dot(direction, normal) >= 0.0f) return false;
+
+            Vector3 edge1 = Utility::Subtract(b, a);
+            Vector3 edge2 = Utility::Subtract(c, a);
+            Vector3 p = Utility::Cross(direction, edge2);
+            float determinant = Utility::Dot(edge1, p);
+            if (std::abs(determinant) < 1e-12f) return false;
+
+            float inverse = 1.0f / determinant;
+            Vector3 s = Utility::Subtract(origin, a);
+            float u = Utility::Dot(s, p) * inverse;
+            if (u < 0.0f || u > 1.0f) return false;
+
+            Vector3 q = Utility::Cross(s, edge1);
+            float v = Utility::Dot(direction, q) * inverse;
+            if (v < 0.0f || u + v > 1.0f) return false;
+
+            t = Utility::Dot(edge2, q) * inverse;
+            return true;
+        }
+    }
+
+    std::shared_ptr<const Heightfield> Heightfield::Create(uint32_t samplesX, uint32_t samplesZ,
+        const std::vector<float>& heights, const Vector3& origin, float cellSize) {
+        if (samplesX < 2 || samplesZ < 2 || heights.size() != static_cast<size_t>(samplesX) * samplesZ || cellSize <= 0.0f) {
+            return nullptr;
+        }
+
+        auto field = std::make_shared<Heightfield>();
+        field->samplesX_ = samplesX;
+        field->samplesZ_ = samplesZ;
+        field->origin_ = origin;
+        field->cellSize_ = cellSize;
+
+        // 高さの範囲を16ビットに量子化
+        auto [lowest, highest] = std::minmax_element(heights.begin(), heights.end());
+        float minHeight = *lowest;
+        float maxHeight = *highest;
+        field->minHeight_ = origin.y + minHeight;
+        field->heightStep_ = (maxHeight - minHeight) / kQuantizeLevels;
+
+        float scale = maxHeight > minHeight ? kQuantizeLevels / (maxHeight - minHeight) : 0.0f;
+        field->heights_.resize(heights.size());
+        for (size_t i = 0; i < heights.size(); ++i) {
+            field->heights_[i] = static_cast<uint16_t>(std::lround((heights[i] - minHeight) * scale));
+        }
+
+        // セルごとの最大の高さ
+        field->cellMaxHeights_.resize(static_cast<size_t>(samplesX - 1) * (samplesZ - 1));
+        for (uint32_t z = 0; z + 1 < samplesZ; ++z) {
+            for (uint32_t x = 0; x + 1 < samplesX; ++x) {
+                const uint16_t* row0 = &field->heights_[z * samplesX + x];
+                const uint16_t* row1 = row0 + samplesX;
+                field->cellMaxHeights_[z * (samplesX - 1) + x] = std::max({ row0[0], row0[1], row1[0], row1[1] });
+            }
+        }
+
+        field->bounds_.min = { origin.x, field->minHeight_, origin.z };
+        field->bounds_.max = {
+            origin.x + cellSize * static_cast<float>(samplesX - 1),
+            origin.y + maxHeight,
+            origin.z + cellSize * static_cast<float>(samplesZ - 1)
+        };
+        return field;
+    }
+
+    std::shared_ptr<const Heightfield> Heightfield::FromGrayscale(const uint8_t* pixels, uint32_t width, uint32_t height,
+        uint32_t rowPitch, uint32_t bytesPerPixel, const Vector3& origin, float cellSize, float heightScale) {
+        if (!pixels) return nullptr;
+
+        std::vector<float> heights(static_cast<size_t>(width) * height);
+        for (uint32_t z = 0; z < height; ++z) {
+            const uint8_t* row = pixels + static_cast<size_t>(z) * rowPitch;
+            for (uint32_t x = 0; x < width; ++x) {
+                heights[static_cast<size_t>(z) * width + x] = static_cast<float>(row[x * bytesPerPixel]) / 255.0f * heightScale;
+            }
+        }
+        return Create(width, height, heights, origin, cellSize);
+    }
+
+    std::shared_ptr<const Heightfield> Heightfield::FromTriangles(const std::vector<Vector3>& vertices, float cellSize) {
+        if (vertices.size() < 3 || cellSize <= 0.0f) return nullptr;
+
+        // XZの範囲から格子を決める
+        Vector3 low = vertices[0];
+        Vector3 high = vertices[0];
+        for (const Vector3& vertex : vertices) {
+            low = { std::min(low.x, vertex.x), std::min(low.y, vertex.y), std::min(low.z, vertex.z) };
+            high = { std::max(high.x, vertex.x), std::max(high.y, vertex.y), std::max(high.z, vertex.z) };
+        }
+        uint32_t samplesX = static_cast<uint32_t>(std::ceil((high.x - low.x) / cellSize)) + 1;
+        uint32_t samplesZ = static_cast<uint32_t>(std::ceil((high.z - low.z) / cellSize)) + 1;
+        samplesX = std::max(samplesX, 2u);
+        samplesZ = std::max(samplesZ, 2u);
+
+        // 三角形ごとにXZの範囲に含まれる格子点だけを調べ、最も高い面の高さを残す
+        std::vector<float> heights(static_cast<size_t>(samplesX) * samplesZ, -FLT_MAX);
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+            const Vector3& a = vertices[i];
+            const Vector3& b = vertices[i + 1];
+            const Vector3& c = vertices[i + 2];
+
+            float minX = std::min({ a.x, b.x, c.x });
+            float maxX = std::max({ a.x, b.x, c.x });
+            float minZ = std::min({ a.z, b.z, c.z });
+            float maxZ = std::max({ a.z, b.z, c.z });
+            uint32_t beginX = static_cast<uint32_t>(std::max(0.0f, std::ceil((minX - low.x) / cellSize)));
+            uint32_t endX = std::min(samplesX - 1, static_cast<uint32_t>(std::floor((maxX - low.x) / cellSize)));
+            uint32_t beginZ = static_cast<uint32_t>(std::max(0.0f, std::ceil((minZ - low.z) / cellSize)));
+            uint32_t endZ = std::min(samplesZ - 1, static_cast<uint32_t>(std::floor((maxZ - low.z) / cellSize)));
+
+            for (uint32_t z = beginZ; z <= endZ; ++z) {
+                for (uint32_t x = beginX; x <= endX; ++x) {
+                    Vector3 point = { low.x + cellSize * static_cast<float>(x), 0.0f, low.z + cellSize * static_cast<float>(z) };
+                    float u, v, w;
+                    if (!BarycentricXZ(point, a, b, c, u, v, w)) continue;
+
+                    const float kEpsilon = -1e-5f;
+                    if (u < kEpsilon || v < kEpsilon || w < kEpsilon) continue;
+
+                    float& sample = heights[static_cast<size_t>(z) * samplesX + x];
+                    sample = std::max(sample, a.y * u + b.y * v + c.y * w);
+                }
+            }
+        }
+
+        // 面に覆われなかった格子点は最も低い高さにする
+        for (float& sample : heights) {
+            if (sample == -FLT_MAX) sample = low.y;
+        }
+        return Create(samplesX, samplesZ, heights, { low.x, 0.0f, low.z }, cellSize);
+    }
+
+    bool Heightfield::SampleHeight(float x, float z, float& height, Vector3* normal) const {
+        float fx = (x - origin_.x) / cellSize_;
+        float fz = (z - origin_.z) / cellSize_;
+        if (fx < 0.0f || fz < 0.0f || fx > static_cast<float>(samplesX_ - 1) || fz > static_cast<float>(samplesZ_ - 1)) {
+            return false;
+        }
+
+        uint32_t cellX = std::min(static_cast<uint32_t>(fx), samplesX_ - 2);
+        uint32_t cellZ = std::min(static_cast<uint32_t>(fz), samplesZ_ - 2);
+        float u = fx - static_cast<float>(cellX);
+        float v = fz - static_cast<float>(cellZ);
+
+        float h00 = GetHeight(cellX, cellZ);
+        float h10 = GetHeight(cellX + 1, cellZ);
+        float h01 = GetHeight(cellX, cellZ + 1);
+        float h11 = GetHeight(cellX + 1, cellZ + 1);
+
+        // 対角線(0,0)-(1,1)のどちら側の三角形か
+        Vector3 n;
+        if (u >= v) {
+            height = h00 + u * (h10 - h00) + v * (h11 - h10);
+            n = { -(h10 - h00), cellSize_, -(h11 - h10) };
+        }
+        else {
+            height = h00 + v * (h01 - h00) + u * (h11 - h01);
+            n = { -(h11 - h01), cellSize_, -(h01 - h00) };
+        }
+        if (normal) {
+            *normal = Utility::Multiply(n, 1.0f / Utility::Length(n));
+        }
+        return true;
+    }
+
+    bool Heightfield::GetCellRange(const Vector3& boundsMin, const Vector3& boundsMax,
+        uint32_t& minX, uint32_t& minZ, uint32_t& maxX, uint32_t& maxZ) const {
+        if (boundsMax.x < bounds_.min.x || boundsMin.x > bounds_.max.x ||
+            boundsMax.z < bounds_.min.z || boundsMin.z > bounds_.max.z ||
+            boundsMin.y > bounds_.max.y) {
+            return false;
+        }
+
+        float lastCellX = static_cast<float>(samplesX_ - 2);
+        float lastCellZ = static_cast<float>(samplesZ_ - 2);
+        minX = static_cast<uint32_t>(std::clamp(std::floor((boundsMin.x - origin_.x) / cellSize_), 0.0f, lastCellX));
+        maxX = static_cast<uint32_t>(std::clamp(std::floor((boundsMax.x - origin_.x) / cellSize_), 0.0f, lastCellX));
+        minZ = static_cast<uint32_t>(std::clamp(std::floor((boundsMin.z - origin_.z) / cellSize_), 0.0f, lastCellZ));
+        maxZ = static_cast<uint32_t>(std::clamp(std::floor((boundsMax.z - origin_.z) / cellSize_), 0.0f, lastCellZ));
+        return true;
+    }
+
+    void Heightfield::GetCellTriangles(uint32_t x, uint32_t z, Vector3 vertices[6]) const {
+        Vector3 p00 = GetPoint(x, z);
+        Vector3 p10 = GetPoint(x + 1, z);
+        Vector3 p01 = GetPoint(x, z + 1);
+        Vector3 p11 = GetPoint(x + 1, z + 1);
+        vertices[0] = p00;
+        vertices[1] = p10;
+        vertices[2] = p11;
+        vertices[3] = p00;
+        vertices[4] = p11;
+        vertices[5] = p01;
+    }
+
+    CollisionResult Heightfield::CheckSphere(const Sphere& sphere) const {
+        return CheckSegment(Segment(sphere.center, sphere.center), sphere.radius);
+    }
+
+    CollisionResult Heightfield::CheckCapsule(const Capsule& capsule) const {
+        return CheckSegment(capsule.segment, capsule.radius);
+    }
+
+    CollisionResult Heightfield::CheckSegment(const Segment& segment, float radius) const {
+        CollisionResult result;
+
+        Vector3 boundsMin = {
+            std::min(segment.start.x, segment.end.x) - radius,
+            std::min(segment.start.y, segment.end.y) - radius,
+            std::min(segment.start.z, segment.end.z) - radius
+        };
+        Vector3 boundsMax = {
+            std::max(segment.start.x, segment.end.x) + radius,
+            std::max(segment.start.y, segment.end.y) + radius,
+            std::max(segment.start.z, segment.end.z) + radius
+        };
+        uint32_t minX, minZ, maxX, maxZ;
+        if (!GetCellRange(boundsMin, boundsMax, minX, minZ, maxX, maxZ)) {
+            return result;
+        }
+
+        // 始点と終点が同じ（球）なら点と三角形の最近接点だけで求める
+        // （線分と辺の最近接パラメータは線分の長さの2乗で割るため、長さ0では求まらない）
+        const bool isPoint = Utility::DistanceSquared(segment.start, segment.end) < 1e-12f;
+        const uint32_t endpointCount = isPoint ? 1 : 2;
+
+        // 重なるセルの三角形のうち最も深くめり込んでいるものを採用する
+        auto apply = [&](float penetration, const Vector3& normal, const Vector3& point) {
+            if (penetration > 0.0f && (!result.isColliding || penetration > result.penetration)) {
+                result.isColliding = true;
+                result.penetration = penetration;
+                result.normal = normal;
+                result.collisionPoint = point;
+            }
+        };
+
+        Vector3 triangles[6];
+        for (uint32_t z = minZ; z <= maxZ; ++z) {
+            for (uint32_t x = minX; x <= maxX; ++x) {
+                GetCellTriangles(x, z, triangles);
+                for (uint32_t t = 0; t < 2; ++t) {
+                    const Vector3& a = triangles[t * 3];
+                    const Vector3& b = triangles[t * 3 + 1];
+                    const Vector3& c = triangles[t * 3 + 2];
+                    Vector3 normal = UpwardNormal(a, b, c);
+
+                    // 真上から見て三角形の上にある端点は、面より下にあればそのまま押し上げる
+                    // （地形の下側は中身が詰まっているものとして扱う）
+                    const Vector3 endpoints[2] = { segment.start, segment.end };
+                    for (uint32_t i = 0; i < endpointCount; ++i) {
+                        const Vector3& point = endpoints[i];
+                        float u, v, w;
+                        if (!BarycentricXZ(point, a, b, c, u, v, w) || u < 0.0f || v < 0.0f || w < 0.0f) continue;
+
+                        float distance = Utility::Dot(Utility::Subtract(point, a), normal);
+                        if (distance < radius) {
+                            apply(radius - distance, normal, Utility::Subtract(point, Utility::Multiply(normal, distance)));
+                        }
+                    }
+
+                    // 線分と三角形の最近接点（端点と面、線分と3辺）
+                    Vector3 closestOnSegment = segment.start;
+                    Vector3 closestOnTriangle = ClosestPointOnTriangle(segment.start, a, b, c);
+                    float bestDistanceSquared = Utility::DistanceSquared(closestOnSegment, closestOnTriangle);
+                    auto consider = [&](const Vector3& onSegment, const Vector3& onTriangle) {
+                        float distanceSquared = Utility::DistanceSquared(onSegment, onTriangle);
+                        if (distanceSquared < bestDistanceSquared) {
+                            bestDistanceSquared = distanceSquared;
+                            closestOnSegment = onSegment;
+                            closestOnTriangle = onTriangle;
+                        }
+                    };
+                    if (!isPoint) {
+                        consider(segment.end, ClosestPointOnTriangle(segment.end, a, b, c));
+
+                        const Vector3* edges[3][2] = { { &a, &b }, { &b, &c }, { &c, &a } };
+                        for (const auto& edge : edges) {
+                            float s, e;
+                            Utility::ClosestSegmentParameters(segment.start, segment.end, *edge[0], *edge[1], s, e);
+                            consider(Utility::Add(segment.start, Utility::Multiply(Utility::Subtract(segment.end, segment.start), s)),
+                                Utility::Add(*edge[0], Utility::Multiply(Utility::Subtract(*edge[1], *edge[0]), e)));
+                        }
+                    }
+
+                    if (bestDistanceSquared < radius * radius) {
+                        float distance = std::sqrt(bestDistanceSquared);
+                        Vector3 direction = distance > 0.0001f
+                            ? Utility::Multiply(Utility::Subtract(closestOnSegment, closestOnTriangle), 1.0f / distance)
+                            : normal;
+                        apply(radius - distance, direction, closestOnTriangle);
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    CollisionResult Heightfield::RayCast(const Segment& ray) const {
+        CollisionResult result;
+
+        Vector3 direction = Utility::Subtract(ray.end, ray.start);
+        float rayLength = Utility::Length(direction);
+        if (rayLength < 0.0001f) return result;
+
+        // 境界ボックスでレイを切り詰める（パラメータtは0～1）
+        float enter = 0.0f;
+        float exit = 1.0f;
+        const float starts[3] = { ray.start.x, ray.start.y, ray.start.z };
+        const float directions[3] = { direction.x, direction.y, direction.z };
+        const float lows[3] = { bounds_.min.x, bounds_.min.y, bounds_.min.z };
+        const float highs[3] = { bounds_.max.x, bounds_.max.y, bounds_.max.z };
+        for (int axis = 0; axis < 3; ++axis) {
+            if (std::abs(directions[axis]) < 1e-12f) {
+                if (starts[axis] < lows[axis] || starts[axis] > highs[axis]) return result;
+                continue;
+            }
+            float inverse = 1.0f / directions[axis];
+            float t1 = (lows[axis] - starts[axis]) * inverse;
+            float t2 = (highs[axis] - starts[axis]) * inverse;
+            if (t1 > t2) std::swap(t1, t2);
+            enter = std::max(enter, t1);
+            exit = std::min(exit, t2);
+            if (enter > exit) return result;
+        }
+
+        // 開始セル
+        float fx = (ray.start.x + direction.x * enter - origin_.x) / cellSize_;
+        float fz = (ray.start.z + direction.z * enter - origin_.z) / cellSize_;
+        int cellX = std::clamp(static_cast<int>(std::floor(fx)), 0, static_cast<int>(samplesX_) - 2);
+        int cellZ = std::clamp(static_cast<int>(std::floor(fz)), 0, static_cast<int>(samplesZ_) - 2);
+
+        // 2DのDDA（次にX・Zの格子線を越えるパラメータと、1セル進むごとの増分）
+        int stepX = direction.x > 0.0f ? 1 : -1;
+        int stepZ = direction.z > 0.0f ? 1 : -1;
+        float deltaX = std::abs(direction.x) > 1e-12f ? cellSize_ / std::abs(direction.x) : FLT_MAX;
+        float deltaZ = std::abs(direction.z) > 1e-12f ? cellSize_ / std::abs(direction.z) : FLT_MAX;
+        float nextX = deltaX == FLT_MAX ? FLT_MAX
+            : (origin_.x + cellSize_ * static_cast<float>(cellX + (stepX > 0 ? 1 : 0)) - ray.start.x) / direction.x;
+        float nextZ = deltaZ == FLT_MAX ? FLT_MAX
+            : (origin_.z + cellSize_ * static_cast<float>(cellZ + (stepZ > 0 ? 1 : 0)) - ray.start.z) / direction.z;
+
+        float cellEnter = enter;
+        Vector3 triangles[6];
+        while (true) {
+            float cellExit = std::min({ nextX, nextZ, exit });
+
+            // このセル内でのレイの最も低い位置がセルの最高点より上なら当たらない
+            float lowestY = std::min(ray.start.y + direction.y * cellEnter, ray.start.y + direction.y * cellExit);
+            float cellMax = minHeight_ + heightStep_ * static_cast<float>(cellMaxHeights_[cellZ * (samplesX_ - 1) + cellX]);
+            if (lowestY <= cellMax) {
+                GetCellTriangles(static_cast<uint32_t>(cellX), static_cast<uint32_t>(cellZ), triangles);
+                float bestT = FLT_MAX;
+                Vector3 bestNormal;
+                for (uint32_t t = 0; t < 2; ++t) {
+                    const Vector3& a = triangles[t * 3];
+                    const Vector3& b = triangles[t * 3 + 1];
+                    const Vector3& c = triangles[t * 3 + 2];
+                    Vector3 normal = UpwardNormal(a, b, c);
+                    float hitT;
+                    if (RayTriangle(ray.start, direction, a, b, c, normal, hitT) && hitT >= 0.0f && hitT <= 1.0f && hitT < bestT) {
+                        bestT = hitT;
+                        bestNormal = normal;
+                    }
+                }
+                if (bestT != FLT_MAX) {
+                    result.isColliding = true;
+                    result.collisionPoint = Utility::Add(ray.start, Utility::Multiply(direction, bestT));
+                    result.normal = bestNormal;
+                    result.penetration = (1.0f - bestT) * rayLength;
+                    return result;
+                }
+            }
+
+            if (cellExit >= exit) break;
+
+            // 次のセルへ
+            if (nextX < nextZ) {
+                cellX += stepX;
+                nextX += deltaX;
+            }
+            else {
+                cellZ += stepZ;
+                nextZ += deltaZ;
+            }
+            if (cellX < 0 || cellZ < 0 || cellX > static_cast<int>(samplesX_) - 2 || cellZ > static_cast<int>(samplesZ_) - 2) break;
+            cellEnter = cellExit;
+        }
+
+        return result;
+    }
+
+} // namespace Collision
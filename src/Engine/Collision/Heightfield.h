@@ -0,0 +1,94 @@
+#pragma once
+#include "Collision.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Collision {
+    // 高さマップの地形
+    // XZ平面上の等間隔な格子点ごとに高さを16ビットに量子化して保持する（1点2バイト）
+    // 各セルは(x0,z0)-(x1,z1)の対角線で2つの三角形に分割した面として扱う
+    // セルの参照は座標からの割り算だけで求まる
+    class Heightfield {
+    public:
+        // 高さの配列から作成（heightsはsamplesX×samplesZ、X方向が連続）
+        // originは格子点(0,0)のワールド座標で、heightsはorigin.yからの高さ
+        // 格子点が2×2未満、または配列の大きさが合わない場合はnullptr
+        static std::shared_ptr<const Heightfield> Create(uint32_t samplesX, uint32_t samplesZ,
+            const std::vector<float>& heights, const Vector3& origin, float cellSize);
+
+        // グレースケール画像から作成（画素ごとのバイト数がbytesPerPixelの先頭バイトを輝度として使う）
+        // 輝度0～255を高さ0～heightScaleに対応させる
+        static std::shared_ptr<const Heightfield> FromGrayscale(const uint8_t* pixels, uint32_t width, uint32_t height,
+            uint32_t rowPitch, uint32_t bytesPerPixel, const Vector3& origin, float cellSize, float heightScale);
+
+        // 三角形リスト（3頂点で1面）を上から見下ろしたときの最も高い面で作成（モデルの地形用）
+        // 面に覆われない格子点は最も低い高さになる
+        static std::shared_ptr<const Heightfield> FromTriangles(const std::vector<Vector3>& vertices, float cellSize);
+
+        // 格子点の数・間隔
+        uint32_t GetSamplesX() const { return samplesX_; }
+        uint32_t GetSamplesZ() const { return samplesZ_; }
+        float GetCellSize() const { return cellSize_; }
+
+        // 格子点の高さ（ワールド座標）
+        float GetHeight(uint32_t x, uint32_t z) const {
+            return minHeight_ + heightStep_ * static_cast<float>(heights_[z * samplesX_ + x]);
+        }
+
+        // 格子点のワールド座標
+        Vector3 GetPoint(uint32_t x, uint32_t z) const {
+            return { origin_.x + cellSize_ * static_cast<float>(x), GetHeight(x, z), origin_.z + cellSize_ * static_cast<float>(z) };
+        }
+
+        // 指定したXZ位置の地面の高さと法線（範囲外ならfalse）
+        bool SampleHeight(float x, float z, float& height, Vector3* normal = nullptr) const;
+
+        // ワールド座標での境界ボックス
+        const AABB& GetBounds() const { return bounds_; }
+
+        // 高さデータの使用メモリ（バイト）
+        size_t GetMemorySize() const { return heights_.size() * sizeof(uint16_t) + cellMaxHeights_.size() * sizeof(uint16_t); }
+
+        // 衝突判定（法線は地形から相手へ向かう、形状の範囲に重なるセルだけを調べる）
+        CollisionResult CheckSphere(const Sphere& sphere) const;
+        CollisionResult CheckCapsule(const Capsule& capsule) const;
+
+        // レイ（線分）との交差判定（セルを2DのDDAで順にたどる）
+        // 衝突点・法線・めり込み量の意味はCollisionDetector::RayCast系と同じ
+        CollisionResult RayCast(const Segment& ray) const;
+
+    private:
+        // 格子
+        uint32_t samplesX_ = 0;
+        uint32_t samplesZ_ = 0;
+        Vector3 origin_ = { 0.0f, 0.0f, 0.0f };
+        float cellSize_ = 1.0f;
+
+        // 量子化した高さ（高さ = minHeight_ + heightStep_ × 値）
+        std::vector<uint16_t> heights_;
+        float minHeight_ = 0.0f;
+        float heightStep_ = 0.0f;
+
+        // セルごとの4隅の最大の高さ（量子化値、レイの早期判定用）
+        std::vector<uint16_t> cellMaxHeights_;
+
+        // 境界ボックス
+        AABB bounds_;
+
+        // 形状のXZ範囲に重なるセルの範囲を求める（重ならなければfalse）
+        bool GetCellRange(const Vector3& boundsMin, const Vector3& boundsMax,
+            uint32_t& minX, uint32_t& minZ, uint32_t& maxX, uint32_t& maxZ) const;
+
+        // セルの2つの三角形の頂点（6点）
+        void GetCellTriangles(uint32_t x, uint32_t z, Vector3 vertices[6]) const;
+
+        // 球とカプセルの判定の共通部分（segmentの長さ0なら球）
+        CollisionResult CheckSegment(const Segment& segment, float radius) const;
+    };
+
+    // 地形コリジョン用の形状データ（HeightfieldColliderが持つもの）
+    struct HeightfieldShape {
+        std::shared_ptr<const Heightfield> heightfield;
+    };
+} // namespace Collision
@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Collision {
+    // 複数スレッドから追加し、1つのスレッドがまとめて取り出すロックフリーなキュー
+    // 追加はCASのみで行い、取り出し側はリスト全体を一度に奪ってから追加順に処理する
+    // ノードは生成時に確保したプールから取り出し、取り出し側が処理後に返却する
+    // ※プールが尽きた場合のみ通常のnewで確保する（次のDrainで解放）
+    // ※Tはデフォルト構築できる必要がある（返却したノードはT()で上書きして参照を解放する）
+    template<typename T>
+    class MpscQueue {
+    public:
+        // プールのノード数の既定値
+        static constexpr uint32_t kDefaultPoolSize = 1024;
+
+        // コンストラクタ・デストラクタ
+        explicit MpscQueue(uint32_t poolSize = kDefaultPoolSize)
+            : pool_(std::make_unique<Node[]>(poolSize)), poolSize_(poolSize) {
+            // 全ノードを空きリストにつなぐ（番号は1始まり、0は終端）
+            for (uint32_t i = 0; i < poolSize_; ++i) {
+                pool_[i].poolIndex = i + 1;
+                pool_[i].nextFree.store(i + 2 <= poolSize_ ? i + 2 : 0, std::memory_order_relaxed);
+            }
+            freeHead_.store(poolSize_ > 0 ? 1 : 0, std::memory_order_relaxed);
+        }
+        ~MpscQueue() {
+            Drain([](T&&) {});
+        }
+
+        // コピー禁止
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        // 要素の追加（任意のスレッドから呼び出せる）
+        void Push(T value) {
+            Node* node = AcquireNode();
+            node->value = std::move(value);
+            node->next = head_.load(std::memory_order_relaxed);
+            while (!head_.compare_exchange_weak(node->next, node,
+                std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+
+        // 追加済みの要素を追加順にすべて取り出す（取り出し側の1スレッドのみ）
+        // 処理した要素数を返す
+        template<typename Func>
+        size_t Drain(Func&& func) {
+            Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+
+            // 後から追加したものが先頭にあるので反転して追加順にする
+            Node* ordered = nullptr;
+            while (node) {
+                Node* next = node->next;
+                node->next = ordered;
+                ordered = node;
+                node = next;
+            }
+
+            size_t count = 0;
+            while (ordered) {
+                Node* next = ordered->next;
+                func(std::move(ordered->value));
+                ReleaseNode(ordered);
+                ordered = next;
+                ++count;
+            }
+            return count;
+        }
+
+        // 空かどうか（他スレッドが追加中の場合は目安）
+        bool Empty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+    private:
+        // 単方向リストのノード
+        struct Node {
+            T value{};
+            Node* next = nullptr;
+            // 空きリストの次のノード番号（取り出しと競合して読まれるのでアトミック）
+            std::atomic<uint32_t> nextFree{ 0 };
+            // プール内の番号（1始まり、0ならnewで確保したノード）
+            uint32_t poolIndex = 0;
+        };
+
+        // 空きリストの先頭は上位32ビットに変更回数、下位32ビットにノード番号を持つ
+        // 変更のたびに回数を増やし、同じノードが戻ってきた場合のCASの誤成功（ABA）を防ぐ
+        static constexpr uint64_t kTagUnit = uint64_t(1) << 32;
+
+        // プールからノードを取り出す（複数スレッドから同時に呼ばれる）
+        Node* AcquireNode() {
+            uint64_t head = freeHead_.load(std::memory_order_acquire);
+            for (;;) {
+                const uint32_t index = static_cast<uint32_t>(head);
+                if (index == 0) {
+                    return new Node();
+                }
+                Node& node = pool_[index - 1];
+                const uint64_t next = ((head & ~(kTagUnit - 1)) + kTagUnit) | node.nextFree.load(std::memory_order_relaxed);
+                if (freeHead_.compare_exchange_weak(head, next,
+                    std::memory_order_acquire, std::memory_order_acquire)) {
+                    return &node;
+                }
+            }
+        }
+
+        // ノードをプールに返す（取り出し側のスレッドのみ）
+        void ReleaseNode(Node* node) {
+            if (node->poolIndex == 0) {
+                delete node;
+                return;
+            }
+
+            // 保持している参照（shared_ptrなど）をここで解放する
+            node->value = T();
+            node->next = nullptr;
+
+            uint64_t head = freeHead_.load(std::memory_order_relaxed);
+            uint64_t next;
+            do {
+                node->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                next = ((head & ~(kTagUnit - 1)) + kTagUnit) | node->poolIndex;
+            } while (!freeHead_.compare_exchange_weak(head, next,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // 最後に追加されたノード
+        std::atomic<Node*> head_{ nullptr };
+
+        // ノードのプールと空きリストの先頭
+        std::unique_ptr<Node[]> pool_;
+        uint32_t poolSize_ = 0;
+        std::atomic<uint64_t> freeHead_{ 0 };
+    };
+} // namespace Collision
@@ -5,8 +5,15 @@
 #include <sstream>
 #include <cassert>
 #include <unordered_map>
+#include <mutex>
 #include <cmath>
 
+namespace {
+    // ファイルのパスごとの凸包（作れなかったモデルはnullptrを記録する）
+    std::mutex convexHullCacheMutex;
+    std::unordered_map<std::string, std::shared_ptr<const Collision::ConvexHull>> convexHullCache;
+}
+
 Model::Model() : dxCommon_(nullptr) {}
 
 Model::~Model() {}
@@ -18,6 +25,7 @@ void Model::Initialize(DirectXCommon* dxCommon) {
 
 void Model::LoadFromObj(const std::string& directoryPath, const std::string& filename) {
     // モデルデータの読み込み
+    filePath_ = directoryPath + "/" + filename;
     modelData_ = LoadObjFile(directoryPath, filename);
 
     // モデルデータを最適化（UV球などの表示品質向上のため）
@@ -96,6 +104,33 @@ void Model::LoadFromObj(const std::string& directoryPath, const std::string& fil
     OutputDebugStringA(("Model: Loaded " + std::to_string(modelData_.vertices.size()) + " vertices from " + filename + "\n").c_str());
 }
 
+std::shared_ptr<const Collision::ConvexHull> Model::GetConvexHull() const {
+    // 生成中も排他する（同じモデルを同時に要求したスレッドが二重に生成しないように）
+    std::lock_guard<std::mutex> lock(convexHullCacheMutex);
+    auto found = convexHullCache.find(filePath_);
+    if (found != convexHullCache.end()) {
+        return found->second;
+    }
+
+    std::vector<Vector3> points;
+    points.reserve(modelData_.vertices.size());
+    for (const VertexData& vertex : modelData_.vertices) {
+        points.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+    }
+    std::shared_ptr<const Collision::ConvexHull> hull = Collision::ConvexHull::Build(points);
+    convexHullCache.emplace(filePath_, hull);
+    return hull;
+}
+
+std::shared_ptr<const Collision::Heightfield> Model::CreateHeightfield(float cellSize) const {
+    std::vector<Vector3> triangles;
+    triangles.reserve(modelData_.vertices.size());
+    for (const VertexData& vertex : modelData_.vertices) {
+        triangles.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+    }
+    return Collision::Heightfield::FromTriangles(triangles, cellSize);
+}
+
 // UV球などの表示品質を向上させるためのモデルデータ最適化関数
 void Model::OptimizeTriangles(ModelData& modelData, const std::string& filename) {
     // 最適化前の頂点数を保存
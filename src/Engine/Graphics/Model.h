@@ -9,6 +9,9 @@
 #include <wrl.h>
 #include "DirectXCommon.h"
 #include "Mymath.h"
+#include "ConvexHull.h"
+#include "Heightfield.h"
+#include <memory>
 
 // モデルデータクラス
 class Model {
@@ -32,6 +35,14 @@ public:
     const D3D12_VERTEX_BUFFER_VIEW& GetVBView() const { return vertexBufferView_; }
     ID3D12Resource* GetVertexResource() const { return vertexResource_.Get(); }
 
+    // 頂点から作った凸包（同じファイルから読み込んだモデルの間で共有し、最初の呼び出しで生成する）
+    // 平らなモデルなど凸包を作れない場合はnullptrを返す（失敗も記録し、作り直さない）
+    // 任意のスレッドから呼び出せる
+    std::shared_ptr<const Collision::ConvexHull> GetConvexHull() const;
+
+    // 三角形を上から見下ろした高さマップ（地形モデル用、ローカル座標）
+    std::shared_ptr<const Collision::Heightfield> CreateHeightfield(float cellSize) const;
+
 private:
     // モデルデータの最適化（UV球など改善のため）
     void OptimizeTriangles(ModelData& modelData, const std::string& filename);
@@ -49,4 +60,6 @@ private:
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
     // DirectXCommon
     DirectXCommon* dxCommon_;
+    // 読み込んだファイルのパス（凸包のキャッシュのキー）
+    std::string filePath_;
 };
\ No newline at end of file
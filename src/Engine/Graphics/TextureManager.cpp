@@ -246,4 +246,34 @@ uint32_t TextureManager::GetSrvIndex(const std::string& filePath)
         return textureDatas[GetDefaultTexturePath()].srvIndex;
     }
     return textureDatas[filePath].srvIndex;
+}
+
+std::shared_ptr<const Collision::Heightfield> TextureManager::LoadHeightfield(const std::string& filePath,
+    const Vector3& origin, float cellSize, float heightScale)
+{
+    // 高さとして使うのでsRGBの変換はしない
+    DirectX::ScratchImage image{};
+    std::wstring filePathW = ConvertString(filePath);
+    HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_IGNORE_SRGB, nullptr, image);
+    if (FAILED(hr)) {
+        OutputDebugStringA(("ERROR: TextureManager::LoadHeightfield - Failed to load from file: " + filePath + "\n").c_str());
+        return nullptr;
+    }
+
+    // 1チャンネル8ビットにそろえる
+    DirectX::ScratchImage grayImage{};
+    hr = DirectX::Convert(*image.GetImage(0, 0, 0), DXGI_FORMAT_R8_UNORM, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, grayImage);
+    if (FAILED(hr)) {
+        OutputDebugStringA(("ERROR: TextureManager::LoadHeightfield - Failed to convert: " + filePath + "\n").c_str());
+        return nullptr;
+    }
+
+    const DirectX::Image* gray = grayImage.GetImage(0, 0, 0);
+    auto heightfield = Collision::Heightfield::FromGrayscale(gray->pixels,
+        static_cast<uint32_t>(gray->width), static_cast<uint32_t>(gray->height),
+        static_cast<uint32_t>(gray->rowPitch), 1, origin, cellSize, heightScale);
+    if (!heightfield) {
+        OutputDebugStringA(("ERROR: TextureManager::LoadHeightfield - Image too small: " + filePath + "\n").c_str());
+    }
+    return heightfield;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "DirectXTex.h"
 #include "d3dx12.h"
 #include "DirectXCommon.h"
+#include "Heightfield.h"
+#include <memory>
 #include <unordered_map>
 
 class SrvManager;
@@ -58,6 +60,11 @@ public:
     // デフォルトテクスチャを読み込む（新規追加）
     void LoadDefaultTexture();
 
+    // グレースケール画像から地形コリジョン用の高さマップを作成（GPUには転送しない）
+    // 輝度0～1を高さ0～heightScaleに対応させる。失敗した場合はnullptr
+    std::shared_ptr<const Collision::Heightfield> LoadHeightfield(const std::string& filePath,
+        const Vector3& origin, float cellSize, float heightScale);
+
     // デフォルトテクスチャのパスを取得（新規追加）
     const std::string& GetDefaultTexturePath() const {
         static const std::string defaultTexturePath = "Resources/textures/default_white.png";
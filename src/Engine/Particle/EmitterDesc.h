@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstdint>
+
+// パーティクルグループのハンドル（ParticleManager::CreateParticleGroupの戻り値）
+using ParticleGroupHandle = uint32_t;
+// 無効なハンドル
+constexpr ParticleGroupHandle kInvalidParticleGroup = 0xFFFFFFFF;
+
+// 発生時の設定（属性ごとの乱数の範囲）
+// 範囲は属性ごとの最小値・最大値の配列で持ち、Emitは属性ごとにこの範囲でまとめて乱数を作る
+// 作成時にSet～で範囲を決めておき、発生のたびに組み立て直さないこと
+struct EmitterDesc {
+    // 乱数で決める属性（minimum・maximumの添字）
+    enum Attribute : uint32_t {
+        kVelocityX,
+        kVelocityY,
+        kVelocityZ,
+        kAccelX,
+        kAccelY,
+        kAccelZ,
+        kStartSize,
+        kEndSize,
+        kStartColorR,
+        kStartColorG,
+        kStartColorB,
+        kStartColorA,
+        kEndColorR,
+        kEndColorG,
+        kEndColorB,
+        kEndColorA,
+        kRotation,
+        kRotationVelocity,
+        kLifeTime,
+        kAttributeCount,
+    };
+
+    // 属性ごとの最小値（既定値はシンプル版のEmitと同じ）
+    float minimum[kAttributeCount] = {
+        -1.0f, -1.0f, -1.0f,     // 速度
+        0.0f, 0.0f, 0.0f,        // 加速度
+        0.5f, 0.0f,              // 開始・終了サイズ
+        1.0f, 1.0f, 1.0f, 1.0f,  // 開始色
+        1.0f, 1.0f, 1.0f, 0.0f,  // 終了色
+        0.0f, 0.0f,              // 回転・回転速度
+        1.0f,                    // 寿命
+    };
+    // 属性ごとの最大値
+    float maximum[kAttributeCount] = {
+        1.0f, 1.0f, 1.0f,
+        0.0f, -9.8f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f, 1.0f, 1.0f,
+        1.0f, 1.0f, 1.0f, 0.0f,
+        0.0f, 0.0f,
+        3.0f,
+    };
+
+    // 寿命に対するサイズ・色の変化の表の番号（ParticleManager::CreateLifetimeCurveの戻り値、0なら開始～終了の直線補間のみ）
+    // 表は発生先のグループごとに登録するので、同じグループへのEmitでのみ使う
+    uint32_t lifetimeCurve = 0;
+
+    // 範囲の設定
+    void SetRange(Attribute attribute, float min, float max) {
+        minimum[attribute] = min;
+        maximum[attribute] = max;
+    }
+    void SetVelocity(const Vector3& min, const Vector3& max) { SetRange(kVelocityX, min, max); }
+    void SetAccel(const Vector3& min, const Vector3& max) { SetRange(kAccelX, min, max); }
+    void SetStartSize(float min, float max) { SetRange(kStartSize, min, max); }
+    void SetEndSize(float min, float max) { SetRange(kEndSize, min, max); }
+    void SetStartColor(const Vector4& min, const Vector4& max) { SetRange(kStartColorR, min, max); }
+    void SetEndColor(const Vector4& min, const Vector4& max) { SetRange(kEndColorR, min, max); }
+    void SetRotation(float min, float max) { SetRange(kRotation, min, max); }
+    void SetRotationVelocity(float min, float max) { SetRange(kRotationVelocity, min, max); }
+    void SetLifeTime(float min, float max) { SetRange(kLifeTime, min, max); }
+    void SetLifetimeCurve(uint32_t curve) { lifetimeCurve = curve; }
+
+private:
+    // 連続する属性の範囲をまとめて設定
+    void SetRange(Attribute first, const Vector3& min, const Vector3& max) {
+        SetRange(first, min.x, max.x);
+        SetRange(static_cast<Attribute>(first + 1), min.y, max.y);
+        SetRange(static_cast<Attribute>(first + 2), min.z, max.z);
+    }
+    void SetRange(Attribute first, const Vector4& min, const Vector4& max) {
+        SetRange(first, min.x, max.x);
+        SetRange(static_cast<Attribute>(first + 1), min.y, max.y);
+        SetRange(static_cast<Attribute>(first + 2), min.z, max.z);
+        SetRange(static_cast<Attribute>(first + 3), min.w, max.w);
+    }
+};
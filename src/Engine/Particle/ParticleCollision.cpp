@@ -0,0 +1,288 @@
+#include "ParticleCollision.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    // 格子の座標をキーにする（各軸21ビット、±2^20セルを超える座標は重なる）
+    uint64_t CellKey(int32_t x, int32_t y, int32_t z) {
+        const uint64_t mask = (1ull << 21) - 1;
+        return (static_cast<uint64_t>(x) & mask) | ((static_cast<uint64_t>(y) & mask) << 21) | ((static_cast<uint64_t>(z) & mask) << 42);
+    }
+
+    // 座標を含むセルの格子の座標（切り捨て、負の数は0に向かう変換から1引く）
+    int32_t CellCoord(float value, float inverseCellSize) {
+        float scaled = value * inverseCellSize;
+        int32_t truncated = static_cast<int32_t>(scaled);
+        return truncated - (scaled < static_cast<float>(truncated) ? 1 : 0);
+    }
+
+    // 衝突の応答（めり込んだ深さdepthだけ法線nの方向に押し戻して表面に置き、速度の法線成分が内向きなら反射する）
+    // 反射する速さは、めり込んだ分を戻した表面での速さ（vn^2 + 2 * dot(a, n) * depth）に反発係数を掛けたもの
+    // （めり込んだ位置の速さのまま表面に戻すと、跳ね返るたびに高さが増える）
+    void Bounce(float p[3], float v[3], const float n[3], const float a[3], float depth, float restitution) {
+        p[0] += n[0] * depth;
+        p[1] += n[1] * depth;
+        p[2] += n[2] * depth;
+        float vn = v[0] * n[0] + v[1] * n[1] + v[2] * n[2];
+        if (vn < 0.0f) {
+            float an = a[0] * n[0] + a[1] * n[1] + a[2] * n[2];
+            float surfaceSpeed = std::sqrt(std::max(vn * vn + 2.0f * an * depth, 0.0f));
+            float scale = vn - restitution * surfaceSpeed;
+            v[0] -= n[0] * scale;
+            v[1] -= n[1] * scale;
+            v[2] -= n[2] * scale;
+        }
+    }
+}
+
+void ParticleCollisionStats::Merge(const ParticleCollisionStats& other) {
+    testCount += other.testCount;
+    contactCount += other.contactCount;
+    killedCount += other.killedCount;
+}
+
+void ParticleCollision::Reserve(uint32_t capacity) {
+    cellOfSlot_.resize(capacity);
+}
+
+void ParticleCollision::SetDesc(const ParticleCollisionDesc& desc) {
+    assert(desc.cellSize > 0.0f);
+    desc_ = desc;
+    enabled_ = true;
+}
+
+void ParticleCollision::Prepare(const ParticleStorage& particles, float deltaTime, const QueryFunction& query, ParticleCollisionStats& stats) {
+    stats = ParticleCollisionStats();
+    cellIndex_.Clear();
+    cells_.clear();
+    shapes_.clear();
+    hasCells_ = false;
+    if (!enabled_ || !desc_.useWorldColliders || !query || particles.Empty()) {
+        return;
+    }
+    assert(cellOfSlot_.size() >= particles.GetCapacity());
+
+    // 1フレームの最大移動量と最大半径を求める
+    // 移動量は軸ごとに |v| * dt + |a| * dt^2 以下（積分でも経過時間からの計算でも）
+    const float dt = deltaTime + particles.GetDeferredTime();
+    const float inverseCellSize = 1.0f / desc_.cellSize;
+    const bool analytic = particles.GetSimulation() == ParticleStorage::Simulation::Analytic;
+    const float* x = particles.GetStream(ParticleStorage::kPositionX);
+    const float* y = particles.GetStream(ParticleStorage::kPositionY);
+    const float* z = particles.GetStream(ParticleStorage::kPositionZ);
+    const float* velocity[3] = {
+        particles.GetStream(ParticleStorage::kVelocityX), particles.GetStream(ParticleStorage::kVelocityY), particles.GetStream(ParticleStorage::kVelocityZ) };
+    const float* accel[3] = {
+        particles.GetStream(ParticleStorage::kAccelX), particles.GetStream(ParticleStorage::kAccelY), particles.GetStream(ParticleStorage::kAccelZ) };
+    const float* age = particles.GetStream(ParticleStorage::kLifeTime);
+    const float* size = particles.GetStream(ParticleStorage::kSize);
+    const uint32_t* slots = particles.GetSlots();
+    const uint32_t count = particles.GetCount();
+    float maxSize = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        float value = std::abs(size[i]);
+        maxSize = value > maxSize ? value : maxSize;
+    }
+    float maxMove = 0.0f;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        // Analyticでは速度の配列が発生時の速度なので今の速度に直す
+        const float* v = velocity[axis];
+        const float* a = accel[axis];
+        for (uint32_t i = 0; i < count; ++i) {
+            float speed = std::abs(analytic ? v[i] + a[i] * age[i] : v[i]);
+            float move = (speed + std::abs(a[i]) * dt) * dt;
+            maxMove = move > maxMove ? move : maxMove;
+        }
+    }
+
+    // 今の座標で格子に分ける
+    // 粒の範囲を覆う格子が粒の数に比べて小さければ配列で、大きければハッシュでセルを引く
+    float minimum[3] = { x[0], y[0], z[0] };
+    float maximum[3] = { x[0], y[0], z[0] };
+    const float* position[3] = { x, y, z };
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        const float* p = position[axis];
+        for (uint32_t i = 1; i < count; ++i) {
+            minimum[axis] = p[i] < minimum[axis] ? p[i] : minimum[axis];
+            maximum[axis] = p[i] > maximum[axis] ? p[i] : maximum[axis];
+        }
+    }
+    int32_t origin[3];
+    uint64_t extent[3];
+    const uint64_t denseLimit = static_cast<uint64_t>(count) * kDenseCellsPerParticle + kMinDenseCells;
+    bool dense = true;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        origin[axis] = CellCoord(minimum[axis], inverseCellSize);
+        extent[axis] = static_cast<uint64_t>(static_cast<int64_t>(CellCoord(maximum[axis], inverseCellSize)) - origin[axis] + 1);
+        dense = dense && extent[axis] <= denseLimit;
+    }
+    dense = dense && extent[0] * extent[1] * extent[2] <= denseLimit;
+
+    if (dense) {
+        denseCells_.assign(static_cast<size_t>(extent[0] * extent[1] * extent[2]), UINT32_MAX);
+        const uint32_t sizeX = static_cast<uint32_t>(extent[0]);
+        const uint32_t sizeY = static_cast<uint32_t>(extent[1]);
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t cellX = CellCoord(x[i], inverseCellSize);
+            int32_t cellY = CellCoord(y[i], inverseCellSize);
+            int32_t cellZ = CellCoord(z[i], inverseCellSize);
+            uint32_t& cell = denseCells_[(static_cast<size_t>(cellZ - origin[2]) * sizeY + static_cast<uint32_t>(cellY - origin[1])) * sizeX + static_cast<uint32_t>(cellX - origin[0])];
+            if (cell == UINT32_MAX) {
+                cell = static_cast<uint32_t>(cells_.size());
+                cells_.push_back({ cellX, cellY, cellZ, 0, 0 });
+            }
+            cellOfSlot_[slots[i]] = cell;
+        }
+    }
+    else {
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t cellX = CellCoord(x[i], inverseCellSize);
+            int32_t cellY = CellCoord(y[i], inverseCellSize);
+            int32_t cellZ = CellCoord(z[i], inverseCellSize);
+            uint64_t key = CellKey(cellX, cellY, cellZ);
+            const uint32_t* found = cellIndex_.Find(key);
+            uint32_t cell = found ? *found : static_cast<uint32_t>(cells_.size());
+            if (!found) {
+                cellIndex_.InsertOrAssign(key, cell);
+                cells_.push_back({ cellX, cellY, cellZ, 0, 0 });
+            }
+            cellOfSlot_[slots[i]] = cell;
+        }
+    }
+
+    // セルごとに一度だけ、移動後の粒が届く範囲と重なる衝突形状を集める
+    const float margin = maxSize * desc_.radiusScale + maxMove;
+    for (Cell& cell : cells_) {
+        Collision::AABB bounds(
+            { cell.x * desc_.cellSize - margin, cell.y * desc_.cellSize - margin, cell.z * desc_.cellSize - margin },
+            { (cell.x + 1) * desc_.cellSize + margin, (cell.y + 1) * desc_.cellSize + margin, (cell.z + 1) * desc_.cellSize + margin });
+        cell.shapeBegin = static_cast<uint32_t>(shapes_.size());
+        query(bounds, shapes_);
+        cell.shapeCount = static_cast<uint32_t>(shapes_.size()) - cell.shapeBegin;
+    }
+    hasCells_ = true;
+    stats.cellCount = static_cast<uint32_t>(cells_.size());
+    stats.shapeCount = static_cast<uint32_t>(shapes_.size());
+}
+
+uint32_t ParticleCollision::CollideRange(ParticleStorage& particles, uint32_t begin, uint32_t count, ParticleCollisionStats& stats,
+    std::vector<ParticleEvent>* events) const {
+    stats = ParticleCollisionStats();
+    if (!enabled_ || count == 0 || (desc_.planes.empty() && !hasCells_)) {
+        return count;
+    }
+
+    const bool kill = desc_.response == ParticleCollisionResponse::Kill;
+    const bool analytic = particles.GetSimulation() == ParticleStorage::Simulation::Analytic;
+    float* position[3] = {
+        particles.GetStream(ParticleStorage::kPositionX), particles.GetStream(ParticleStorage::kPositionY), particles.GetStream(ParticleStorage::kPositionZ) };
+    float* velocity[3] = {
+        particles.GetStream(ParticleStorage::kVelocityX), particles.GetStream(ParticleStorage::kVelocityY), particles.GetStream(ParticleStorage::kVelocityZ) };
+    float* startPosition[3] = {
+        particles.GetStream(ParticleStorage::kStartPositionX), particles.GetStream(ParticleStorage::kStartPositionY), particles.GetStream(ParticleStorage::kStartPositionZ) };
+    const float* accel[3] = {
+        particles.GetStream(ParticleStorage::kAccelX), particles.GetStream(ParticleStorage::kAccelY), particles.GetStream(ParticleStorage::kAccelZ) };
+    const float* age = particles.GetStream(ParticleStorage::kLifeTime);
+    const float* size = particles.GetStream(ParticleStorage::kSize);
+    const uint32_t* slots = particles.GetSlots();
+
+    uint32_t end = begin + count;
+    for (uint32_t i = begin; i < end; ) {
+        float p[3] = { position[0][i], position[1][i], position[2][i] };
+        float v[3] = { velocity[0][i], velocity[1][i], velocity[2][i] };
+        const float a[3] = { accel[0][i], accel[1][i], accel[2][i] };
+        if (analytic) {
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                v[axis] += accel[axis][i] * age[i];
+            }
+        }
+        const float radius = std::abs(size[i]) * desc_.radiusScale;
+        bool hit = false;
+
+        // 平面
+        for (const Vector4& plane : desc_.planes) {
+            ++stats.testCount;
+            float distance = plane.x * p[0] + plane.y * p[1] + plane.z * p[2] + plane.w;
+            if (distance >= radius) {
+                continue;
+            }
+            hit = true;
+            if (kill) {
+                break;
+            }
+            const float n[3] = { plane.x, plane.y, plane.z };
+            Bounce(p, v, n, a, radius - distance, desc_.restitution);
+        }
+
+        // 粒のセルで集めた球・カプセル
+        if (hasCells_ && !(kill && hit)) {
+            const Cell& cell = cells_[cellOfSlot_[slots[i]]];
+            for (uint32_t shape = cell.shapeBegin; shape < cell.shapeBegin + cell.shapeCount; ++shape) {
+                ++stats.testCount;
+                // 中心の線分上の最も近い点
+                const Collision::Capsule& capsule = shapes_[shape];
+                const Vector3& segmentStart = capsule.segment.start;
+                const Vector3& segmentEnd = capsule.segment.end;
+                float axis[3] = { segmentEnd.x - segmentStart.x, segmentEnd.y - segmentStart.y, segmentEnd.z - segmentStart.z };
+                float lengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+                float s = 0.0f;
+                if (lengthSquared > 0.0f) {
+                    s = std::clamp(((p[0] - segmentStart.x) * axis[0] + (p[1] - segmentStart.y) * axis[1] + (p[2] - segmentStart.z) * axis[2]) / lengthSquared, 0.0f, 1.0f);
+                }
+                const float closest[3] = { segmentStart.x + axis[0] * s, segmentStart.y + axis[1] * s, segmentStart.z + axis[2] * s };
+                float d[3] = { p[0] - closest[0], p[1] - closest[1], p[2] - closest[2] };
+                float distanceSquared = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+                float reach = capsule.radius + radius;
+                if (distanceSquared >= reach * reach) {
+                    continue;
+                }
+                hit = true;
+                if (kill) {
+                    break;
+                }
+                // 中心の線分上にある粒は上に押し出す
+                float distance = std::sqrt(distanceSquared);
+                float n[3] = { 0.0f, 1.0f, 0.0f };
+                if (distance > 0.0f) {
+                    n[0] = d[0] / distance;
+                    n[1] = d[1] / distance;
+                    n[2] = d[2] / distance;
+                }
+                Bounce(p, v, n, a, reach - distance, desc_.restitution);
+            }
+        }
+
+        if (!hit) {
+            ++i;
+            continue;
+        }
+        ++stats.contactCount;
+        if (events) {
+            events->push_back({ { p[0], p[1], p[2] }, { v[0], v[1], v[2] }, ParticleEventType::Collision });
+        }
+        if (kill) {
+            // 移動してきた末尾の要素は同じ位置でもう一度判定する
+            end = particles.RemoveInRange(i, end);
+            ++stats.killedCount;
+            continue;
+        }
+
+        // 押し戻した位置と反射した速度を書き戻す
+        // Analyticでは今の状態を通る放物線になるよう、発生時の座標と速度を求め直す
+        const float t = age[i];
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            position[axis][i] = p[axis];
+            if (analytic) {
+                float v0 = v[axis] - accel[axis][i] * t;
+                velocity[axis][i] = v0;
+                startPosition[axis][i] = p[axis] - t * (v0 + accel[axis][i] * (t * 0.5f));
+            }
+            else {
+                velocity[axis][i] = v[axis];
+            }
+        }
+        ++i;
+    }
+    return end - begin;
+}
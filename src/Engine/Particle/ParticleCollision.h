@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CollisionPrimitive.h"
+#include "FlatHashMap.h"
+#include "ParticleStorage.h"
+#include "ParticleSubEmitter.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 衝突したときの応答
+enum class ParticleCollisionResponse {
+    Bounce, // 表面まで押し戻し、法線方向の速度を反発係数倍にして反転する
+    Kill,   // 削除する
+};
+
+// パーティクルグループの衝突の設定
+struct ParticleCollisionDesc {
+    // 衝突したときの応答
+    ParticleCollisionResponse response = ParticleCollisionResponse::Bounce;
+    // 反発係数（Bounceのみ、0で表面に沿って滑り、1で速さを保って跳ね返る）
+    float restitution = 0.5f;
+    // 粒の半径のサイズに対する割合（0なら中心の点で判定する）
+    float radiusScale = 0.5f;
+    // 格子の一辺の長さ（衝突形状を集める単位）
+    float cellSize = 2.0f;
+    // 平面（xyzが単位法線、wが原点からの距離で、dot(n, p) + w >= 0の側に粒を残す）
+    std::vector<Vector4> planes;
+    // ワールドの衝突形状（Collision::CollisionManagerに登録された球・カプセル）とも判定するかどうか
+    bool useWorldColliders = true;
+};
+
+// 衝突の統計情報
+struct ParticleCollisionStats {
+    // 粒が入っていたセルの数（衝突形状を集めた回数）
+    uint32_t cellCount = 0;
+    // セルごとに集めた衝突形状の数の合計
+    uint32_t shapeCount = 0;
+    // 粒と形状・平面の判定数
+    uint32_t testCount = 0;
+    // 衝突した粒の数
+    uint32_t contactCount = 0;
+    // 衝突で削除した粒の数（Killのみ）
+    uint32_t killedCount = 0;
+
+    // 結合（判定数・衝突数・削除数のみ）
+    void Merge(const ParticleCollisionStats& other);
+};
+
+// パーティクルと平面・球・カプセルの衝突
+// 更新前に粒を一定の大きさの格子に分け、粒の入っているセルごとに一度だけ衝突形状を集める
+// 更新後は各粒のセルの形状とだけ判定するので、粒の数に対してほぼ線形の処理時間になる
+// 球は長さ0のカプセルとして扱う
+class ParticleCollision {
+public:
+    // セルの境界ボックスと重なる衝突形状をoutに追加する
+    using QueryFunction = std::function<void(const Collision::AABB& bounds, std::vector<Collision::Capsule>& out)>;
+
+    // 作業用配列を最大数分だけ確保（以降の判定では確保しない、セルと衝突形状の配列は必要に応じて伸ばす）
+    void Reserve(uint32_t capacity);
+
+    // 設定（設定すると有効になる）
+    void SetDesc(const ParticleCollisionDesc& desc);
+    const ParticleCollisionDesc& GetDesc() const { return desc_; }
+    // 無効にする
+    void Disable() { enabled_ = false; }
+    bool IsEnabled() const { return enabled_; }
+
+    // 更新前の準備（メインスレッド）
+    // 粒を今の座標で格子に分け、セルを1フレームの最大移動量と最大半径だけ広げた範囲でqueryを呼ぶ
+    // queryが空か、ワールドの衝突形状を使わない設定なら平面だけと判定する
+    void Prepare(const ParticleStorage& particles, float deltaTime, const QueryFunction& query, ParticleCollisionStats& stats);
+
+    // 更新後の判定と応答（ParticleUpdater::ResolveFunctionの中で使う）
+    // particlesの[begin, begin + count)を判定し、生存数を返す（Killでは削除した粒を範囲の末尾と入れ替える）
+    // eventsがあれば衝突した粒ごとにParticleEventType::Collisionの出来事を追加する
+    // 別々の範囲（別々のevents）なら複数スレッドから同時に呼んでよい
+    uint32_t CollideRange(ParticleStorage& particles, uint32_t begin, uint32_t count, ParticleCollisionStats& stats,
+        std::vector<ParticleEvent>* events = nullptr) const;
+
+private:
+    // 配列で引く格子のセル数の上限（粒1つあたりの数と、粒が少ないときの最低限の数）
+    static constexpr uint32_t kDenseCellsPerParticle = 2;
+    static constexpr uint32_t kMinDenseCells = 4096;
+
+    // セル
+    struct Cell {
+        int32_t x, y, z;     // 格子の座標
+        uint32_t shapeBegin; // shapes_の先頭
+        uint32_t shapeCount; // 衝突形状の数
+    };
+
+    // 設定
+    ParticleCollisionDesc desc_;
+    bool enabled_ = false;
+
+    // 格子の座標からセルの番号への対応（粒の範囲を覆う格子が小さいときは配列、大きいときはハッシュ）
+    std::vector<uint32_t> denseCells_;
+    Collision::FlatHashMap<uint64_t, uint32_t> cellIndex_;
+    // セル
+    std::vector<Cell> cells_;
+    // セルごとに集めた衝突形状（セルの順に並ぶ）
+    std::vector<Collision::Capsule> shapes_;
+    // スロットごとのセルの番号（Prepareの時点で生存していた粒のみ有効）
+    std::vector<uint32_t> cellOfSlot_;
+    // Prepareでセルを作ったかどうか（falseなら平面だけと判定する）
+    bool hasCells_ = false;
+};
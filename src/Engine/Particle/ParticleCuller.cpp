@@ -0,0 +1,236 @@
+#include "ParticleCuller.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    const float kRadiusScale = ParticleCuller::kRadiusScale;
+
+    // 範囲の境界ボックス（各粒の中心から球の半径だけ広げたもの）
+    // レーンごとに求めてから合わせる（ベクトル化のため）
+    void RangeBounds(
+        const float* __restrict x, const float* __restrict y, const float* __restrict z, const float* __restrict size,
+        uint32_t count, ParticleBounds& bounds) {
+        const uint32_t kLanes = ParticleStorage::kLaneCount;
+        float minX[kLanes], minY[kLanes], minZ[kLanes];
+        float maxX[kLanes], maxY[kLanes], maxZ[kLanes];
+        for (uint32_t lane = 0; lane < kLanes; ++lane) {
+            float r = size[0] * kRadiusScale;
+            minX[lane] = x[0] - r;
+            minY[lane] = y[0] - r;
+            minZ[lane] = z[0] - r;
+            maxX[lane] = x[0] + r;
+            maxY[lane] = y[0] + r;
+            maxZ[lane] = z[0] + r;
+        }
+        uint32_t i = 0;
+        for (; i + kLanes <= count; i += kLanes) {
+            for (uint32_t lane = 0; lane < kLanes; ++lane) {
+                float r = size[i + lane] * kRadiusScale;
+                float lowX = x[i + lane] - r, highX = x[i + lane] + r;
+                float lowY = y[i + lane] - r, highY = y[i + lane] + r;
+                float lowZ = z[i + lane] - r, highZ = z[i + lane] + r;
+                minX[lane] = lowX < minX[lane] ? lowX : minX[lane];
+                minY[lane] = lowY < minY[lane] ? lowY : minY[lane];
+                minZ[lane] = lowZ < minZ[lane] ? lowZ : minZ[lane];
+                maxX[lane] = highX > maxX[lane] ? highX : maxX[lane];
+                maxY[lane] = highY > maxY[lane] ? highY : maxY[lane];
+                maxZ[lane] = highZ > maxZ[lane] ? highZ : maxZ[lane];
+            }
+        }
+        for (; i < count; ++i) {
+            float r = size[i] * kRadiusScale;
+            minX[0] = std::min(minX[0], x[i] - r);
+            minY[0] = std::min(minY[0], y[i] - r);
+            minZ[0] = std::min(minZ[0], z[i] - r);
+            maxX[0] = std::max(maxX[0], x[i] + r);
+            maxY[0] = std::max(maxY[0], y[i] + r);
+            maxZ[0] = std::max(maxZ[0], z[i] + r);
+        }
+        bounds.min = { minX[0], minY[0], minZ[0] };
+        bounds.max = { maxX[0], maxY[0], maxZ[0] };
+        for (uint32_t lane = 1; lane < kLanes; ++lane) {
+            bounds.min = { std::min(bounds.min.x, minX[lane]), std::min(bounds.min.y, minY[lane]), std::min(bounds.min.z, minZ[lane]) };
+            bounds.max = { std::max(bounds.max.x, maxX[lane]), std::max(bounds.max.y, maxY[lane]), std::max(bounds.max.z, maxZ[lane]) };
+        }
+    }
+
+    // 境界ボックスと視錐台の関係
+    enum class Containment {
+        Outside,   // 完全に外
+        Intersect, // 一部が内
+        Inside,    // 完全に内
+    };
+
+    Containment Classify(const ParticleBounds& bounds, const ParticleFrustum& frustum) {
+        Vector3 center = {
+            (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+        Vector3 extent = {
+            (bounds.max.x - bounds.min.x) * 0.5f, (bounds.max.y - bounds.min.y) * 0.5f, (bounds.max.z - bounds.min.z) * 0.5f };
+        Containment result = Containment::Inside;
+        for (const Vector4& plane : frustum.planes) {
+            float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+            if (distance < -radius) {
+                return Containment::Outside;
+            }
+            if (distance < radius) {
+                result = Containment::Intersect;
+            }
+        }
+        return result;
+    }
+
+    // 点から境界ボックスの最も遠い角までの距離の2乗
+    float FarthestDistanceSquared(const Vector3& point, const ParticleBounds& bounds) {
+        float dx = std::max(std::abs(bounds.min.x - point.x), std::abs(bounds.max.x - point.x));
+        float dy = std::max(std::abs(bounds.min.y - point.y), std::abs(bounds.max.y - point.y));
+        float dz = std::max(std::abs(bounds.min.z - point.z), std::abs(bounds.max.z - point.z));
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // スロット番号から決まる0～1の値（黄金比の乗算なので、連番のスロットでも偏らずに間引ける）
+    float SlotThreshold(uint32_t slot) {
+        return static_cast<float>((slot * 0x9E3779B1u) >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+ParticleFrustum ParticleFrustum::Create(const Matrix4x4& viewProjection, const Vector3& cameraPosition) {
+    // クリップ座標 = [x y z 1] * viewProjection なので、列jがクリップ座標のj成分になる
+    auto column = [&](int j) {
+        return Vector4{ viewProjection.m[0][j], viewProjection.m[1][j], viewProjection.m[2][j], viewProjection.m[3][j] };
+    };
+    auto add = [](const Vector4& a, const Vector4& b) { return Vector4{ a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }; };
+    auto subtract = [](const Vector4& a, const Vector4& b) { return Vector4{ a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w }; };
+    Vector4 x = column(0);
+    Vector4 y = column(1);
+    Vector4 z = column(2);
+    Vector4 w = column(3);
+
+    ParticleFrustum frustum;
+    frustum.planes[0] = add(w, x);      // 左（-w <= x）
+    frustum.planes[1] = subtract(w, x); // 右（x <= w）
+    frustum.planes[2] = add(w, y);      // 下（-w <= y）
+    frustum.planes[3] = subtract(w, y); // 上（y <= w）
+    frustum.planes[4] = z;              // 手前（0 <= z）
+    frustum.planes[5] = subtract(w, z); // 奥（z <= w）
+    for (Vector4& plane : frustum.planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+        }
+    }
+    frustum.cameraPosition = cameraPosition;
+    return frustum;
+}
+
+bool ParticleFrustum::IsOutside(const ParticleBounds& bounds) const {
+    return !bounds.IsEmpty() && Classify(bounds, *this) == Containment::Outside;
+}
+
+void ParticleBounds::Merge(const ParticleBounds& other) {
+    if (other.IsEmpty()) {
+        return;
+    }
+    if (IsEmpty()) {
+        *this = other;
+        return;
+    }
+    min = { std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z) };
+    max = { std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z) };
+}
+
+void ParticleCullStats::Merge(const ParticleCullStats& other) {
+    visibleCount += other.visibleCount;
+    frustumCulledCount += other.frustumCulledCount;
+    lodCulledCount += other.lodCulledCount;
+    bounds.Merge(other.bounds);
+}
+
+void ParticleCuller::Reserve(uint32_t capacity) {
+    indices_.resize(capacity);
+    sizeScales_.resize(capacity);
+}
+
+uint32_t ParticleCuller::CullRange(
+    const ParticleStorage& particles, uint32_t begin, uint32_t count,
+    const ParticleFrustum& frustum, const ParticleLod& lod, ParticleCullStats& stats) {
+    stats = ParticleCullStats();
+    if (count == 0) {
+        return 0;
+    }
+    assert(begin + count <= indices_.size());
+
+    const float* x = particles.GetStream(ParticleStorage::kPositionX) + begin;
+    const float* y = particles.GetStream(ParticleStorage::kPositionY) + begin;
+    const float* z = particles.GetStream(ParticleStorage::kPositionZ) + begin;
+    const float* size = particles.GetStream(ParticleStorage::kSize) + begin;
+    const uint32_t* slots = particles.GetSlots() + begin;
+    uint32_t* indices = indices_.data() + begin;
+    float* sizeScales = sizeScales_.data() + begin;
+
+    // 範囲の境界ボックスで、完全に外なら全て除き、完全に内なら平面の判定を省く
+    RangeBounds(x, y, z, size, count, stats.bounds);
+    Containment containment = Classify(stats.bounds, frustum);
+    if (containment == Containment::Outside) {
+        stats.frustumCulledCount = count;
+        return 0;
+    }
+    const bool testFrustum = containment == Containment::Intersect;
+    // 範囲の全粒が間引き始める距離より近ければLODの判定を省く
+    const bool testLod = lod.IsEnabled() &&
+        FarthestDistanceSquared(frustum.cameraPosition, stats.bounds) > lod.startDistance * lod.startDistance;
+
+    uint32_t visible = 0;
+    if (!testFrustum && !testLod) {
+        for (uint32_t i = 0; i < count; ++i) {
+            indices[i] = begin + i;
+            sizeScales[i] = 1.0f;
+        }
+        visible = count;
+    }
+    else {
+        const float startSquared = lod.startDistance * lod.startDistance;
+        const float inverseRange = lod.endDistance > lod.startDistance ? 1.0f / (lod.endDistance - lod.startDistance) : 0.0f;
+        const Vector3& camera = frustum.cameraPosition;
+        for (uint32_t i = 0; i < count; ++i) {
+            // 視錐台（四角形を囲む球が全ての平面の内側にあるか）
+            if (testFrustum) {
+                float radius = size[i] * kRadiusScale;
+                bool inside = true;
+                for (const Vector4& plane : frustum.planes) {
+                    inside &= plane.x * x[i] + plane.y * y[i] + plane.z * z[i] + plane.w >= -radius;
+                }
+                if (!inside) {
+                    ++stats.frustumCulledCount;
+                    continue;
+                }
+            }
+
+            // 距離LOD（遠いほど残す割合を下げ、スロット番号で残す粒を決める）
+            float sizeScale = 1.0f;
+            if (testLod) {
+                float dx = x[i] - camera.x;
+                float dy = y[i] - camera.y;
+                float dz = z[i] - camera.z;
+                float distanceSquared = dx * dx + dy * dy + dz * dz;
+                if (distanceSquared > startSquared) {
+                    float t = inverseRange > 0.0f ? std::min((std::sqrt(distanceSquared) - lod.startDistance) * inverseRange, 1.0f) : 1.0f;
+                    float density = 1.0f - t * (1.0f - lod.minDensity);
+                    if (SlotThreshold(slots[i]) >= density) {
+                        ++stats.lodCulledCount;
+                        continue;
+                    }
+                    if (lod.preserveCoverage) {
+                        sizeScale = 1.0f / std::sqrt(density);
+                    }
+                }
+            }
+
+            indices[visible++] = begin + i;
+            sizeScales[i] = sizeScale;
+        }
+    }
+    stats.visibleCount = visible;
+    return visible;
+}
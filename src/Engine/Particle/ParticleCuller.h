@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "ParticleStorage.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstdint>
+#include <vector>
+
+// 軸並行境界ボックス（min > maxなら空）
+struct ParticleBounds {
+    Vector3 min = { 1.0f, 1.0f, 1.0f };
+    Vector3 max = { -1.0f, -1.0f, -1.0f };
+
+    bool IsEmpty() const { return min.x > max.x; }
+    // 結合
+    void Merge(const ParticleBounds& other);
+};
+
+// 視錐台（6平面、xyzが内向きの単位法線、wが原点からの距離で、内側はdot(n, p) + w >= 0）
+struct ParticleFrustum {
+    Vector4 planes[6];
+    // カメラの位置（距離LOD用）
+    Vector3 cameraPosition;
+
+    // ビュープロジェクション行列（行ベクトル形式、クリップ空間のzは0～1）から作成
+    static ParticleFrustum Create(const Matrix4x4& viewProjection, const Vector3& cameraPosition);
+
+    // 境界ボックスが完全に外側にあるかどうか
+    bool IsOutside(const ParticleBounds& bounds) const;
+};
+
+// 距離によるLOD（startDistanceより遠い粒を間引く）
+// 間引く粒はスロット番号から決めるので、同じ粒が毎フレーム出たり消えたりしない
+struct ParticleLod {
+    // 間引き始める距離（0以下ならLODなし）
+    float startDistance = 0.0f;
+    // 残す割合がminDensityになる距離（これより遠くは一定）
+    float endDistance = 0.0f;
+    // endDistanceより遠い粒を残す割合
+    float minDensity = 0.25f;
+    // 残した粒を1 / sqrt(残す割合)倍に拡大し、画面上の覆う面積を保つ
+    bool preserveCoverage = true;
+
+    bool IsEnabled() const { return startDistance > 0.0f && minDensity < 1.0f; }
+};
+
+// 選別の結果（範囲内の生存している粒の内訳と境界ボックス）
+struct ParticleCullStats {
+    // 描画する数
+    uint32_t visibleCount = 0;
+    // 視錐台の外で除いた数
+    uint32_t frustumCulledCount = 0;
+    // 距離LODで間引いた数
+    uint32_t lodCulledCount = 0;
+    // 生存している全粒を囲む境界ボックス（四角形の大きさを含む）
+    ParticleBounds bounds;
+
+    // 結合
+    void Merge(const ParticleCullStats& other);
+};
+
+// 描画する粒の選別（視錐台カリングと距離LOD）
+// 選別した粒の番号を範囲の先頭から詰めて保存し、書き込み時はその番号の粒だけをインスタンス配列に書き込む
+// 範囲ごとに境界ボックスを先に求め、視錐台の完全に外・内の範囲は1粒ずつの判定を省く
+// 別々の範囲なら複数スレッドから同時に呼んでよい
+class ParticleCuller {
+public:
+    // 一辺sizeの四角形を囲む球の半径の係数（対角線の半分、回転しても収まる）
+    static constexpr float kRadiusScale = 0.70710678f;
+
+    // 作業用配列を最大数分だけ確保（以降の選別では確保しない）
+    void Reserve(uint32_t capacity);
+
+    // particlesの[begin, begin + count)から描画する粒を選び、その数を返す
+    // 選んだ粒の番号はGetIndices() + begin から詰めて保存する
+    uint32_t CullRange(
+        const ParticleStorage& particles, uint32_t begin, uint32_t count,
+        const ParticleFrustum& frustum, const ParticleLod& lod, ParticleCullStats& stats);
+
+    // 選んだ粒の番号
+    const uint32_t* GetIndices() const { return indices_.data(); }
+    // 粒ごとのサイズの倍率（配列の番号で引く、距離LODで拡大する分）
+    const float* GetSizeScales() const { return sizeScales_.data(); }
+
+private:
+    // 選んだ粒の番号
+    std::vector<uint32_t> indices_;
+    // 粒ごとのサイズの倍率
+    std::vector<float> sizeScales_;
+};
@@ -0,0 +1,116 @@
+#include "ParticleCurve.h"
+#include <algorithm>
+#include <cmath>
+
+ParticleCurve& ParticleCurve::AddKey(float time, float value) {
+    // 同じ時刻のキーは追加順に並べる（2つ置くとその時刻で値が切り替わる）
+    auto position = std::upper_bound(keys_.begin(), keys_.end(), time,
+        [](float t, const Key& key) { return t < key.time; });
+    keys_.insert(position, Key{ time, value });
+    return *this;
+}
+
+float ParticleCurve::Tangent(size_t index) const {
+    // 前後の区間の傾き（幅0の区間は0として扱う）
+    auto secant = [&](size_t segment) {
+        float width = keys_[segment + 1].time - keys_[segment].time;
+        return width > 0.0f ? (keys_[segment + 1].value - keys_[segment].value) / width : 0.0f;
+    };
+    if (index == 0) {
+        return secant(0);
+    }
+    if (index + 1 == keys_.size()) {
+        return secant(index - 1);
+    }
+
+    // 前後で増減が変わるキーは傾き0（山・谷で行き過ぎない）
+    float before = secant(index - 1);
+    float after = secant(index);
+    if (before * after <= 0.0f) {
+        return 0.0f;
+    }
+    // 平均を取り、前後の傾きの3倍までに抑える（単調な区間が単調なまま）
+    float tangent = (before + after) * 0.5f;
+    float limit = 3.0f * std::min(std::abs(before), std::abs(after));
+    return std::clamp(tangent, -limit, limit);
+}
+
+float ParticleCurve::Evaluate(float time) const {
+    if (keys_.empty()) {
+        return 1.0f;
+    }
+
+    // timeより後の最初のキーとその前のキーの間を補間
+    auto upper = std::upper_bound(keys_.begin(), keys_.end(), time,
+        [](float t, const Key& key) { return t < key.time; });
+    if (upper == keys_.begin()) {
+        return keys_.front().value;
+    }
+    if (upper == keys_.end()) {
+        return keys_.back().value;
+    }
+    size_t index = static_cast<size_t>(upper - keys_.begin()) - 1;
+    const Key& key0 = keys_[index];
+    const Key& key1 = keys_[index + 1];
+    float width = key1.time - key0.time;
+    float s = (time - key0.time) / width;
+
+    if (interpolation_ == Interpolation::Linear || keys_.size() < 3) {
+        return key0.value + s * (key1.value - key0.value);
+    }
+
+    // 3次エルミート補間
+    float s2 = s * s;
+    float s3 = s2 * s;
+    float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+    float h10 = s3 - 2.0f * s2 + s;
+    float h01 = -2.0f * s3 + 3.0f * s2;
+    float h11 = s3 - s2;
+    return h00 * key0.value + h10 * width * Tangent(index) + h01 * key1.value + h11 * width * Tangent(index + 1);
+}
+
+ParticleGradient& ParticleGradient::AddKey(float time, const Vector4& color) {
+    channels_[0].AddKey(time, color.x);
+    channels_[1].AddKey(time, color.y);
+    channels_[2].AddKey(time, color.z);
+    channels_[3].AddKey(time, color.w);
+    return *this;
+}
+
+void ParticleGradient::SetInterpolation(ParticleCurve::Interpolation interpolation) {
+    for (ParticleCurve& channel : channels_) {
+        channel.SetInterpolation(interpolation);
+    }
+}
+
+Vector4 ParticleGradient::Evaluate(float time) const {
+    return { channels_[0].Evaluate(time), channels_[1].Evaluate(time), channels_[2].Evaluate(time), channels_[3].Evaluate(time) };
+}
+
+ParticleCurveTable ParticleCurveTable::Bake(const ParticleCurve& size, const ParticleGradient& color) {
+    ParticleCurveTable table;
+    for (uint32_t i = 0; i < kResolution; ++i) {
+        float time = static_cast<float>(i) / static_cast<float>(kResolution - 1);
+        table.values[kSize][i] = size.Evaluate(time);
+        for (uint32_t channel = 0; channel < 4; ++channel) {
+            table.values[kColorR + channel][i] = color.GetChannel(channel).Evaluate(time);
+        }
+    }
+    return table;
+}
+
+ParticleCurveTable ParticleCurveTable::Identity() {
+    ParticleCurveTable table;
+    std::fill(&table.values[0][0], &table.values[0][0] + kChannelCount * kResolution, 1.0f);
+    return table;
+}
+
+float ParticleCurveTable::Sample(Channel channel, float time) const {
+    // 表の位置に直して隣り合う2点を線形補間（最後の区間はf = 1で終端の値になる）
+    const float last = static_cast<float>(kResolution - 1);
+    float x = std::clamp(time * last, 0.0f, last);
+    uint32_t index = std::min(static_cast<uint32_t>(x), kResolution - 2);
+    float f = x - static_cast<float>(index);
+    const float* values0 = values[channel];
+    return values0[index] + f * (values0[index + 1] - values0[index]);
+}
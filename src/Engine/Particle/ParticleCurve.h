@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Vector4.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 寿命に対する変化の曲線（時刻は寿命に対する経過時間の割合0～1）
+// 複数のキーを置き、キーの間を補間する（最初のキーより前・最後のキーより後は端の値）
+// 評価は表を作るときだけ行い、更新ではParticleCurveTableの値を使う
+class ParticleCurve {
+public:
+    // キーの間の補間方法
+    enum class Interpolation {
+        Linear, // 直線
+        Smooth, // 3次エルミート（キーの前後が単調なら行き過ぎない）
+    };
+
+    // キーがなければ常に1
+    ParticleCurve() = default;
+
+    // キーの追加（時刻の順に並べ替えて保持する）
+    ParticleCurve& AddKey(float time, float value);
+
+    // 補間方法
+    void SetInterpolation(Interpolation interpolation) { interpolation_ = interpolation; }
+    Interpolation GetInterpolation() const { return interpolation_; }
+
+    // キーがないかどうか
+    bool IsEmpty() const { return keys_.empty(); }
+
+    // 時刻timeの値
+    float Evaluate(float time) const;
+
+private:
+    // キー
+    struct Key {
+        float time;
+        float value;
+    };
+
+    // 時刻の順に並んだキー
+    std::vector<Key> keys_;
+    // 補間方法
+    Interpolation interpolation_ = Interpolation::Smooth;
+
+    // キーindexでの傾き（Smooth用）
+    float Tangent(size_t index) const;
+};
+
+// 寿命に対する色の変化（RGBAのチャンネルごとの曲線）
+class ParticleGradient {
+public:
+    // キーがなければ常に(1, 1, 1, 1)
+    ParticleGradient() = default;
+
+    // キーの追加
+    ParticleGradient& AddKey(float time, const Vector4& color);
+
+    // 補間方法（全チャンネル共通）
+    void SetInterpolation(ParticleCurve::Interpolation interpolation);
+
+    // キーがないかどうか
+    bool IsEmpty() const { return channels_[0].IsEmpty(); }
+
+    // 時刻timeの色
+    Vector4 Evaluate(float time) const;
+
+    // チャンネルごとの曲線
+    const ParticleCurve& GetChannel(uint32_t channel) const { return channels_[channel]; }
+
+private:
+    // R, G, B, Aの曲線
+    ParticleCurve channels_[4];
+};
+
+// サイズと色の曲線を一定数の点で標本化した表
+// 更新では寿命に対する割合から隣り合う2点を読んで線形補間し、開始～終了の補間結果に掛ける
+struct ParticleCurveTable {
+    // 表の点の数（時刻0と1を両端に含む）
+    static constexpr uint32_t kResolution = 64;
+
+    // 表のチャンネル
+    enum Channel : uint32_t {
+        kSize,
+        kColorR,
+        kColorG,
+        kColorB,
+        kColorA,
+        kChannelCount,
+    };
+
+    // チャンネルごとの値（kResolution個ずつ連続して並ぶ）
+    float values[kChannelCount][kResolution];
+
+    // 曲線から表を作る（キーのない曲線は常に1）
+    static ParticleCurveTable Bake(const ParticleCurve& size, const ParticleGradient& color);
+
+    // 全て1の表（曲線なし）
+    static ParticleCurveTable Identity();
+
+    // 時刻timeの値（更新処理と同じ計算で表から読む）
+    float Sample(Channel channel, float time) const;
+};
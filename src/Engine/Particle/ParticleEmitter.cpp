@@ -1,49 +1,27 @@
 #include "ParticleEmitter.h"
+#include <cstring>
+
+namespace {
+    // グループ名と座標からシードを作る
+    uint64_t MakeSeed(const std::string& name, const Vector3& position) {
+        uint32_t bits[3];
+        std::memcpy(bits, &position, sizeof(bits));
+        uint64_t salt = (static_cast<uint64_t>(bits[0]) << 32) ^ (static_cast<uint64_t>(bits[1]) << 16) ^ bits[2];
+        return ParticleRandom::HashSeed(name.c_str(), salt);
+    }
+}
 
 ParticleEmitter::ParticleEmitter(
-    const std::string& name,
+    ParticleGroupHandle group,
     const Vector3& position,
     uint32_t emitCount,
     float emitRate,
-    const Vector3& velocityMin,
-    const Vector3& velocityMax,
-    const Vector3& accelMin,
-    const Vector3& accelMax,
-    float startSizeMin,
-    float startSizeMax,
-    float endSizeMin,
-    float endSizeMax,
-    const Vector4& startColorMin,
-    const Vector4& startColorMax,
-    const Vector4& endColorMin,
-    const Vector4& endColorMax,
-    float rotationMin,
-    float rotationMax,
-    float rotationVelocityMin,
-    float rotationVelocityMax,
-    float lifeTimeMin,
-    float lifeTimeMax)
-    : name_(name),
+    const EmitterDesc& desc)
+    : group_(group),
     emitCount_(emitCount),
     emitRate_(emitRate),
-    velocityMin_(velocityMin),
-    velocityMax_(velocityMax),
-    accelMin_(accelMin),
-    accelMax_(accelMax),
-    startSizeMin_(startSizeMin),
-    startSizeMax_(startSizeMax),
-    endSizeMin_(endSizeMin),
-    endSizeMax_(endSizeMax),
-    startColorMin_(startColorMin),
-    startColorMax_(startColorMax),
-    endColorMin_(endColorMin),
-    endColorMax_(endColorMax),
-    rotationMin_(rotationMin),
-    rotationMax_(rotationMax),
-    rotationVelocityMin_(rotationVelocityMin),
-    rotationVelocityMax_(rotationVelocityMax),
-    lifeTimeMin_(lifeTimeMin),
-    lifeTimeMax_(lifeTimeMax) {
+    random_(MakeSeed(ParticleManager::GetInstance()->GetParticleGroupName(group), position)),
+    desc_(desc) {
 
     // トランスフォームの初期化
     transform_.scale = { 1.0f, 1.0f, 1.0f };
@@ -51,28 +29,8 @@ ParticleEmitter::ParticleEmitter(
     transform_.translate = position;
 
     // 即座に多数のパーティクルを発生させる（初期状態で表示するため）
-    ParticleManager::GetInstance()->Emit(
-        name_,
-        transform_.translate,
-        emitCount_ * 5, // 初期状態では通常の5倍のパーティクルを発生
-        velocityMin_,
-        velocityMax_,
-        accelMin_,
-        accelMax_,
-        startSizeMin_,
-        startSizeMax_,
-        endSizeMin_,
-        endSizeMax_,
-        startColorMin_,
-        startColorMax_,
-        endColorMin_,
-        endColorMax_,
-        rotationMin_,
-        rotationMax_,
-        rotationVelocityMin_,
-        rotationVelocityMax_,
-        lifeTimeMin_,
-        lifeTimeMax_);
+    // 初期状態では通常の5倍のパーティクルを発生
+    ParticleManager::GetInstance()->Emit(group_, transform_.translate, emitCount_ * 5, desc_, random_);
 }
 
 void ParticleEmitter::Update() {
@@ -89,29 +47,8 @@ void ParticleEmitter::Update() {
 
     // 発生タイミングを超えていたらパーティクルを発生
     if (currentTime_ >= interval) {
-        // 発生処理
-        ParticleManager::GetInstance()->Emit(
-            name_,
-            transform_.translate,
-            emitCount_,
-            velocityMin_,
-            velocityMax_,
-            accelMin_,
-            accelMax_,
-            startSizeMin_,
-            startSizeMax_,
-            endSizeMin_,
-            endSizeMax_,
-            startColorMin_,
-            startColorMax_,
-            endColorMin_,
-            endColorMax_,
-            rotationMin_,
-            rotationMax_,
-            rotationVelocityMin_,
-            rotationVelocityMax_,
-            lifeTimeMin_,
-            lifeTimeMax_);
+        // 発生処理（ハンドルで直接グループを参照し、設定はまとめて渡す）
+        ParticleManager::GetInstance()->Emit(group_, transform_.translate, emitCount_, desc_, random_);
 
         // 経過時間を戻す（余剰分を考慮）
         currentTime_ -= interval;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "EmitterDesc.h"
 #include "ParticleManager.h"
+#include "ParticleRandom.h"
 #include "Vector3.h"
 #include "Mymath.h"
 #include <memory>
@@ -9,30 +11,14 @@
 class ParticleEmitter {
 public:
     // コンストラクタ
+    // groupはParticleManager::CreateParticleGroupで作成したグループのハンドル
+    // descは発生時の設定（発生のたびにそのまま使う）
     ParticleEmitter(
-        const std::string& name,
+        ParticleGroupHandle group,
         const Vector3& position,
         uint32_t emitCount,
         float emitRate,
-        const Vector3& velocityMin = { -1.0f, -1.0f, -1.0f },
-        const Vector3& velocityMax = { 1.0f, 1.0f, 1.0f },
-        const Vector3& accelMin = { 0.0f, 0.0f, 0.0f },
-        const Vector3& accelMax = { 0.0f, -9.8f, 0.0f },
-        float startSizeMin = 0.5f,
-        float startSizeMax = 1.0f,
-        float endSizeMin = 0.0f,
-        float endSizeMax = 0.0f,
-        const Vector4& startColorMin = { 1.0f, 1.0f, 1.0f, 1.0f },
-        const Vector4& startColorMax = { 1.0f, 1.0f, 1.0f, 1.0f },
-        const Vector4& endColorMin = { 1.0f, 1.0f, 1.0f, 0.0f },
-        const Vector4& endColorMax = { 1.0f, 1.0f, 1.0f, 0.0f },
-        float rotationMin = 0.0f,
-        float rotationMax = 0.0f,
-        float rotationVelocityMin = 0.0f,
-        float rotationVelocityMax = 0.0f,
-        float lifeTimeMin = 1.0f,
-        float lifeTimeMax = 3.0f
-    );
+        const EmitterDesc& desc = EmitterDesc());
 
     // デストラクタ
     ~ParticleEmitter() = default;
@@ -76,9 +62,22 @@ public:
     // Emit頻度取得
     float GetEmitRate() const { return emitRate_; }
 
+    // 寿命に対するサイズ・色の曲線の設定（表にしてグループに登録し、発生時の設定に番号を入れる）
+    // 曲線の評価はここで一度だけ行うので、発生のたびに呼ばないこと
+    void SetLifetimeCurves(const ParticleCurve& size, const ParticleGradient& color) {
+        desc_.SetLifetimeCurve(ParticleManager::GetInstance()->CreateLifetimeCurve(group_, size, color));
+    }
+
+    // 発生時の設定
+    void SetDesc(const EmitterDesc& desc) { desc_ = desc; }
+    const EmitterDesc& GetDesc() const { return desc_; }
+
+    // 乱数のシード設定（既定ではグループ名と生成時の座標から決まるので、同じ配置なら毎回同じ発生内容になる）
+    void SetSeed(uint64_t seed) { random_.Seed(seed); }
+
 private:
-    // パーティクルグループ名
-    std::string name_;
+    // パーティクルグループのハンドル
+    ParticleGroupHandle group_;
 
     // 発生フラグ
     bool isEmitting_ = true;
@@ -95,23 +94,9 @@ private:
     // 発生頻度（秒間の発生回数）
     float emitRate_;
 
-    // パーティクル設定
-    Vector3 velocityMin_;
-    Vector3 velocityMax_;
-    Vector3 accelMin_;
-    Vector3 accelMax_;
-    float startSizeMin_;
-    float startSizeMax_;
-    float endSizeMin_;
-    float endSizeMax_;
-    Vector4 startColorMin_;
-    Vector4 startColorMax_;
-    Vector4 endColorMin_;
-    Vector4 endColorMax_;
-    float rotationMin_;
-    float rotationMax_;
-    float rotationVelocityMin_;
-    float rotationVelocityMax_;
-    float lifeTimeMin_;
-    float lifeTimeMax_;
+    // 乱数生成器（エミッタごとに持つ）
+    ParticleRandom random_;
+
+    // 発生時の設定
+    EmitterDesc desc_;
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "ParticleInstance.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // 0～1の値を0～255に変換
+    uint32_t ToUnorm8(float value) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+uint32_t PackParticleColor(const Vector4& color) {
+    return ToUnorm8(color.x) | (ToUnorm8(color.y) << 8) | (ToUnorm8(color.z) << 16) | (ToUnorm8(color.w) << 24);
+}
+
+Vector4 UnpackParticleColor(uint32_t color) {
+    const float scale = 1.0f / 255.0f;
+    return {
+        static_cast<float>(color & 0xFF) * scale,
+        static_cast<float>((color >> 8) & 0xFF) * scale,
+        static_cast<float>((color >> 16) & 0xFF) * scale,
+        static_cast<float>(color >> 24) * scale,
+    };
+}
+
+void PackParticleInstances(const ParticleStorage& storage, uint32_t begin, uint32_t count, ParticleInstance* out) {
+    const float* positionX = storage.GetStream(ParticleStorage::kPositionX) + begin;
+    const float* positionY = storage.GetStream(ParticleStorage::kPositionY) + begin;
+    const float* positionZ = storage.GetStream(ParticleStorage::kPositionZ) + begin;
+    const float* size = storage.GetStream(ParticleStorage::kSize) + begin;
+    const float* rotation = storage.GetStream(ParticleStorage::kRotation) + begin;
+    const float* colorR = storage.GetStream(ParticleStorage::kColorR) + begin;
+    const float* colorG = storage.GetStream(ParticleStorage::kColorG) + begin;
+    const float* colorB = storage.GetStream(ParticleStorage::kColorB) + begin;
+    const float* colorA = storage.GetStream(ParticleStorage::kColorA) + begin;
+    for (uint32_t i = 0; i < count; ++i) {
+        // 書き込み先はGPUのアップロードヒープ（書き込み結合メモリ）なので、読み返さずに全メンバーを順に書き込む
+        ParticleInstance& instance = out[i];
+        instance.position = { positionX[i], positionY[i], positionZ[i] };
+        instance.size = size[i];
+        instance.rotation = rotation[i];
+        instance.color = PackParticleColor({ colorR[i], colorG[i], colorB[i], colorA[i] });
+        instance.padding[0] = 0.0f;
+        instance.padding[1] = 0.0f;
+    }
+}
+
+void PackIndexedParticleInstances(
+    const ParticleStorage& storage, const uint32_t* indices, uint32_t count, ParticleInstance* out, const float* sizeScales) {
+    const float* positionX = storage.GetStream(ParticleStorage::kPositionX);
+    const float* positionY = storage.GetStream(ParticleStorage::kPositionY);
+    const float* positionZ = storage.GetStream(ParticleStorage::kPositionZ);
+    const float* size = storage.GetStream(ParticleStorage::kSize);
+    const float* rotation = storage.GetStream(ParticleStorage::kRotation);
+    const float* colorR = storage.GetStream(ParticleStorage::kColorR);
+    const float* colorG = storage.GetStream(ParticleStorage::kColorG);
+    const float* colorB = storage.GetStream(ParticleStorage::kColorB);
+    const float* colorA = storage.GetStream(ParticleStorage::kColorA);
+    for (uint32_t i = 0; i < count; ++i) {
+        // 読み出しは飛び飛びになるが、書き込みは連続のまま
+        uint32_t index = indices[i];
+        ParticleInstance& instance = out[i];
+        instance.position = { positionX[index], positionY[index], positionZ[index] };
+        instance.size = sizeScales ? size[index] * sizeScales[index] : size[index];
+        instance.rotation = rotation[index];
+        instance.color = PackParticleColor({ colorR[index], colorG[index], colorB[index], colorA[index] });
+        instance.padding[0] = 0.0f;
+        instance.padding[1] = 0.0f;
+    }
+}
+
+Vector3 ExpandParticleVertex(const ParticleInstance& instance, const ParticleFrameConstants& frame, const Vector2& corner) {
+    // スケール -> Z軸回転（MakeRotateZMatrixと同じ向き）
+    float s = std::sin(instance.rotation);
+    float c = std::cos(instance.rotation);
+    float x = (corner.x * c - corner.y * s) * instance.size;
+    float y = (corner.x * s + corner.y * c) * instance.size;
+
+    // ビルボード -> 平行移動
+    return {
+        instance.position.x + frame.cameraRight.x * x + frame.cameraUp.x * y,
+        instance.position.y + frame.cameraRight.y * x + frame.cameraUp.y * y,
+        instance.position.z + frame.cameraRight.z * x + frame.cameraUp.z * y,
+    };
+}
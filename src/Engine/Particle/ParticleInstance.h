@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "ParticleStorage.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstdint>
+
+// インスタンシング描画用の1粒分のデータ（32バイト）
+// 行列は送らず、ビルボードとビュープロジェクションは頂点シェーダーで
+// フレーム定数（ParticleFrameConstants）を使って計算する
+// Particle.VS.hlslのParticleInstanceと同じ並びにすること
+struct ParticleInstance {
+    // 座標（ワールド）
+    Vector3 position;
+    // サイズ
+    float size;
+    // 回転（ビルボード面内のZ軸回転、ラジアン）
+    float rotation;
+    // 色（RGBA8、Rが最下位バイト）
+    uint32_t color;
+    // 16バイト境界に揃えるための余り
+    float padding[2];
+};
+static_assert(sizeof(ParticleInstance) == 32, "ParticleInstance must be 32 bytes");
+
+// パーティクル描画のフレーム定数（頂点シェーダーのb2）
+// Particle.VS.hlslのParticleFrameと同じ並びにすること
+struct ParticleFrameConstants {
+    // ビュープロジェクション行列
+    Matrix4x4 viewProjection;
+    // カメラの右方向（ワールド、ビルボード行列の1行目）
+    Vector3 cameraRight;
+    float padding0;
+    // カメラの上方向（ワールド、ビルボード行列の2行目）
+    Vector3 cameraUp;
+    float padding1;
+};
+
+// 色をRGBA8に変換（各成分は0～1に切り詰めて四捨五入）
+uint32_t PackParticleColor(const Vector4& color);
+
+// RGBA8の色を0～1の成分に戻す（シェーダーと同じ計算）
+Vector4 UnpackParticleColor(uint32_t color);
+
+// storageの[begin, begin + count)をoutに書き込む
+void PackParticleInstances(const ParticleStorage& storage, uint32_t begin, uint32_t count, ParticleInstance* out);
+
+// storageのindices[0]～indices[count - 1]番目をこの順にoutに書き込む（選別・並べ替えたグループ用）
+// sizeScalesを指定すると、サイズに配列の番号ごとの倍率を掛ける
+void PackIndexedParticleInstances(
+    const ParticleStorage& storage, const uint32_t* indices, uint32_t count, ParticleInstance* out, const float* sizeScales = nullptr);
+
+// 頂点シェーダーと同じ計算で四角形の頂点のワールド座標を求める（cornerは-0.5～0.5の頂点座標）
+Vector3 ExpandParticleVertex(const ParticleInstance& instance, const ParticleFrameConstants& frame, const Vector2& corner);
@@ -1,4 +1,5 @@
 #include "ParticleManager.h"
+#include "CollisionManager.h"
 #include "TextureManager.h"
 #include <cassert>
 #include <algorithm>
@@ -15,9 +16,9 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     dxCommon_ = dxCommon;
     srvManager_ = srvManager;
 
-    // 乱数エンジンの初期化
+    // 乱数生成器の初期化（リプレイで同じ結果にしたい場合はSetRandomSeedで固定する）
     std::random_device seed_gen;
-    randomEngine_.seed(seed_gen());
+    random_.Seed((static_cast<uint64_t>(seed_gen()) << 32) | seed_gen());
 
     // グラフィックスパイプラインの初期化
     InitializeGraphicsPipeline();
@@ -61,6 +62,13 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     directionalLightData->color = { 1.0f, 1.0f, 1.0f, 1.0f }; // 白色光
     directionalLightData->direction = { 0.0f, -1.0f, 0.0f }; // 下向き
     directionalLightData->intensity = 1.0f; // 通常の強度
+
+    // フレーム定数リソースの作成（内容は毎フレームUpdateで書き込む）
+    frameResource = dxCommon_->CreateBufferResource(sizeof(ParticleFrameConstants));
+    frameResource->Map(0, nullptr, reinterpret_cast<void**>(&frameData));
+    frameData->viewProjection = MakeIdentity4x4();
+    frameData->cameraRight = { 1.0f, 0.0f, 0.0f };
+    frameData->cameraUp = { 0.0f, 1.0f, 0.0f };
 }
 
 void ParticleManager::InitializeGraphicsPipeline() {
@@ -119,8 +127,8 @@ void ParticleManager::InitializeGraphicsPipeline() {
     D3D12_DEPTH_STENCIL_DESC depthStencilDesc{};
     depthStencilDesc.DepthEnable = false; // 深度テストを無効化
 
-    // ルートパラメータの設定 - シェーダーに合わせて修正（4つのパラメータを使用）
-    D3D12_ROOT_PARAMETER rootParameters[4] = {}; // 4つのパラメータに変更
+    // ルートパラメータの設定 - シェーダーに合わせて修正（5つのパラメータを使用）
+    D3D12_ROOT_PARAMETER rootParameters[5] = {};
 
     // マテリアル用（b0, PS）
     rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
@@ -160,6 +168,12 @@ void ParticleManager::InitializeGraphicsPipeline() {
     rootParameters[3].DescriptorTable.pDescriptorRanges = &instanceRange;
     rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 
+    // フレーム定数用（b2, VS）
+    rootParameters[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParameters[4].Descriptor.ShaderRegister = 2;
+    rootParameters[4].Descriptor.RegisterSpace = 0;
+    rootParameters[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
     // サンプラーの設定
     D3D12_STATIC_SAMPLER_DESC staticSamplerDesc{};
     staticSamplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
@@ -214,18 +228,30 @@ void ParticleManager::InitializeGraphicsPipeline() {
     hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
         &pipelineDesc, IID_PPV_ARGS(pipelineState.GetAddressOf()));
     assert(SUCCEEDED(hr));
+
+    // 半透明合成用（描画順は奥から手前に並べ替えて送る）
+    pipelineDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+    hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
+        &pipelineDesc, IID_PPV_ARGS(alphaPipelineState.GetAddressOf()));
+    assert(SUCCEEDED(hr));
 }
 
-void ParticleManager::CreateParticleGroup(const std::string& name, const std::string& textureFilePath) {
-    // 既に同名のグループが存在する場合は処理をスキップ
-    if (particleGroups.find(name) != particleGroups.end()) {
+ParticleGroupHandle ParticleManager::CreateParticleGroup(
+    const std::string& name,
+    const std::string& textureFilePath,
+    uint32_t capacity,
+    ParticleStorage::OverflowPolicy overflowPolicy) {
+    // 既に同名のグループが存在する場合は既存のハンドルを返す
+    auto it = groupHandles_.find(name);
+    if (it != groupHandles_.end()) {
         // 既存のグループがあることをデバッグ出力
         OutputDebugStringA(("ParticleManager: Group already exists - " + name + "\n").c_str());
-        return;
+        return it->second;
     }
 
     // 新規パーティクルグループを作成
     ParticleGroup group;
+    group.name = name;
     group.textureFilePath = textureFilePath;
     group.instanceCount = 0;
 
@@ -234,9 +260,18 @@ void ParticleManager::CreateParticleGroup(const std::string& name, const std::st
     // テクスチャのSRVインデックスを取得
     group.textureSrvIndex = TextureManager::GetInstance()->GetSrvIndex(textureFilePath);
 
-    // インスタンシング用リソースの作成（最大10000パーティクル）
-    const uint32_t kMaxInstanceCount = 10000;
-    group.instanceResource = dxCommon_->CreateBufferResource(sizeof(ParticleForGPU) * kMaxInstanceCount);
+    // パーティクルの配列を最大数分だけ確保（以降の発生では確保しない）
+    assert(capacity > 0);
+    group.particles.Reserve(capacity, overflowPolicy);
+    group.sorter.Reserve(capacity);
+    group.culler.Reserve(capacity);
+    group.chunkCullStats.resize((capacity + ParticleUpdater::kChunkSize - 1) / ParticleUpdater::kChunkSize);
+    group.collision.Reserve(capacity);
+    group.chunkCollisionStats.resize(group.chunkCullStats.size());
+    group.chunkEvents.resize(group.chunkCullStats.size());
+
+    // インスタンシング用リソースの作成（最大数と同じ要素数なので、更新で書き込む数は必ず収まる）
+    group.instanceResource = dxCommon_->CreateBufferResource(sizeof(ParticleInstance) * capacity);
 
     // マップしてポインタを取得
     group.instanceResource->Map(0, nullptr, reinterpret_cast<void**>(&group.instanceData));
@@ -246,14 +281,26 @@ void ParticleManager::CreateParticleGroup(const std::string& name, const std::st
     srvManager_->CreateSRVForStructuredBuffer(
         group.instanceSrvIndex,
         group.instanceResource,
-        kMaxInstanceCount,
-        sizeof(ParticleForGPU));
+        capacity,
+        sizeof(ParticleInstance));
 
-    // パーティクルグループを登録
-    particleGroups[name] = group;
+    // パーティクルグループを登録（ハンドルは登録順の添字）
+    ParticleGroupHandle handle = static_cast<ParticleGroupHandle>(particleGroups.size());
+    particleGroups.push_back(std::move(group));
+    groupHandles_[name] = handle;
 
     // 登録成功をデバッグ出力
     OutputDebugStringA(("ParticleManager: Created particle group - " + name + "\n").c_str());
+
+    return handle;
+}
+
+ParticleGroupHandle ParticleManager::FindParticleGroup(const std::string& name) const {
+    auto it = groupHandles_.find(name);
+    if (it != groupHandles_.end()) {
+        return it->second;
+    }
+    return kInvalidParticleGroup;
 }
 
 void ParticleManager::CalculateBillboardMatrix(const Camera* camera) {
@@ -283,216 +330,226 @@ void ParticleManager::Update(const Camera* camera) {
     // ビルボード行列の計算
     CalculateBillboardMatrix(camera);
 
-    // ビュー行列、プロジェクション行列を取得
-    Matrix4x4 viewMatrix = camera->GetViewMatrix();
-    Matrix4x4 projectionMatrix = camera->GetProjectionMatrix();
-    Matrix4x4 viewProjectionMatrix = camera->GetViewProjectionMatrix();
-
-    // 全パーティクルグループの更新
-    for (auto& [name, group] : particleGroups) {
-        // インスタンス数をリセット
-        group.instanceCount = 0;
-
-        // 各パーティクルの更新
-        for (auto it = group.particles.begin(); it != group.particles.end(); ) {
-            // 寿命チェック
-            it->lifeTime += 1.0f / 60.0f; // 60FPS想定
-            if (it->lifeTime >= it->lifeTimeMax) {
-                // 寿命が尽きたら削除
-                it = group.particles.erase(it);
-                continue;
+    // フレーム定数の書き込み（ビルボード行列の1・2行目がカメラの右・上方向）
+    frameData->viewProjection = camera->GetViewProjectionMatrix();
+    frameData->cameraRight = { billboardMatrix.m[0][0], billboardMatrix.m[0][1], billboardMatrix.m[0][2] };
+    frameData->cameraUp = { billboardMatrix.m[1][0], billboardMatrix.m[1][1], billboardMatrix.m[1][2] };
+
+    // 視錐台（カメラの位置はワールド行列の4行目）
+    const Matrix4x4& cameraWorld = camera->GetWorldMatrix();
+    const ParticleFrustum frustum = ParticleFrustum::Create(
+        camera->GetViewProjectionMatrix(), { cameraWorld.m[3][0], cameraWorld.m[3][1], cameraWorld.m[3][2] });
+
+    // 全パーティクルグループを一定数ごとのチャンクに分けて並列に更新
+    updateGroups_.clear();
+    updateStorages_.clear();
+    for (ParticleGroup& group : particleGroups) {
+        // Analyticのグループが見えないままなら、更新せず経過時間だけをためる
+        if (DeferIfHidden(group, frustum)) {
+            continue;
+        }
+
+        // 今回のチャンク数（選別結果の集計に使う）
+        group.chunkCount = (group.particles.GetCount() + ParticleUpdater::kChunkSize - 1) / ParticleUpdater::kChunkSize;
+        updateGroups_.push_back(&group);
+        updateStorages_.push_back(&group.particles);
+    }
+
+    // 衝突するグループは更新前の座標で粒を格子に分け、セルごとに一度だけ球・カプセルを集める
+    // （CollisionManagerはメインスレッド専用なので、ワーカーは集めた形状のコピーだけを読む）
+    Collision::CollisionManager* collisionManager = Collision::CollisionManager::GetInstance();
+    auto queryShapes = [&](const Collision::AABB& bounds, std::vector<Collision::Capsule>& out) {
+        collisionManager->QueryColliders(bounds, queryColliders_);
+        for (Collision::CollisionObject* collider : queryColliders_) {
+            if (collider->GetShapeType() == Collision::CollisionObject::ShapeType::Sphere) {
+                const Collision::Sphere sphere = static_cast<const Collision::SphereCollider*>(collider)->GetSphere();
+                out.emplace_back(sphere.center, sphere.center, sphere.radius);
+            }
+            else if (collider->GetShapeType() == Collision::CollisionObject::ShapeType::Capsule) {
+                out.push_back(static_cast<const Collision::CapsuleCollider*>(collider)->GetCapsule());
             }
+        }
+    };
+    for (ParticleGroup* group : updateGroups_) {
+        if (group->collision.IsEnabled()) {
+            group->collision.Prepare(group->particles, kDeltaTime, queryShapes, group->collisionStats);
+        }
+    }
 
-            // パーティクルの更新
-            // 速度に加速度を加算
-            it->velocity.x += it->accel.x / 60.0f;
-            it->velocity.y += it->accel.y / 60.0f;
-            it->velocity.z += it->accel.z / 60.0f;
-
-            // 位置に速度を加算
-            it->position.x += it->velocity.x / 60.0f;
-            it->position.y += it->velocity.y / 60.0f;
-            it->position.z += it->velocity.z / 60.0f;
-
-            // 回転を更新
-            it->rotation += it->rotationVelocity / 60.0f;
-
-            // 線形補間でサイズと色を更新
-            float t = it->lifeTime / it->lifeTimeMax;
-            it->size = (1.0f - t) * it->startSize + t * it->endSize;
-
-            it->color.x = (1.0f - t) * it->startColor.x + t * it->endColor.x;
-            it->color.y = (1.0f - t) * it->startColor.y + t * it->endColor.y;
-            it->color.z = (1.0f - t) * it->startColor.z + t * it->endColor.z;
-            it->color.w = (1.0f - t) * it->startColor.w + t * it->endColor.w;
-
-            // スケール、回転、座標を使用して行列を作成
-            Vector3 scale = { it->size, it->size, it->size };
-            Vector3 rotate = { 0.0f, 0.0f, it->rotation };
-
-            // ワールド行列を計算（ビルボード処理も含む）
-            Matrix4x4 matScale = MakeScaleMatrix(scale);
-            Matrix4x4 matRotZ = MakeRotateZMatrix(rotate.z);
-
-            // スケール -> 回転 -> ビルボード -> 平行移動
-            Matrix4x4 matWorld = matScale;
-            matWorld = Multiply(matWorld, matRotZ);
-            matWorld = Multiply(matWorld, billboardMatrix);
-            matWorld.m[3][0] = it->position.x;
-            matWorld.m[3][1] = it->position.y;
-            matWorld.m[3][2] = it->position.z;
-
-            // WVP行列を計算
-            Matrix4x4 matWVP = Multiply(matWorld, viewProjectionMatrix);
-
-            // インスタンシングデータの書き込み（新しいシェーダー形式に合わせて）
-            group.instanceData[group.instanceCount].WVP = matWVP;
-            group.instanceData[group.instanceCount].World = matWorld;
-            group.instanceData[group.instanceCount].color = it->color;
-
-            // インスタンス数をインクリメント
-            group.instanceCount++;
-
-            // 次のパーティクルへ
-            ++it;
+    // 各チャンクは更新の直後に寿命が尽きた粒と衝突した粒の出来事を自分のバッファに記録し、
+    // 視錐台カリングと距離LODで描画する粒を選び、
+    // 描画する数の累積和で決まったインスタンス配列の区間に書き込む（チャンク間で重ならない）
+    // 行列は作らず、座標・サイズ・回転・色だけを詰めて送る
+    // 並べ替えるグループは全体の順序が決まってから選別して書き込むので、ここでは何もしない
+    updater_.Update(updateStorages_, kDeltaTime,
+        [&](uint32_t groupIndex, ParticleStorage& particles, uint32_t begin, uint32_t count, uint32_t end) -> uint32_t {
+        ParticleGroup* group = updateGroups_[groupIndex];
+        const uint32_t chunk = begin / ParticleUpdater::kChunkSize;
+        std::vector<ParticleEvent>* events = nullptr;
+        if (!group->subEmitters.empty()) {
+            // [begin + count, end)に残っている寿命が尽きた粒は、衝突で削除する粒と混ざる前に記録する
+            group->chunkEvents[chunk].clear();
+            if (group->emitsOnDeath) {
+                AppendDeathEvents(particles, begin + count, end, group->chunkEvents[chunk]);
+            }
+            events = group->emitsOnCollision ? &group->chunkEvents[chunk] : nullptr;
+        }
+        if (!group->collision.IsEnabled()) {
+            return count;
+        }
+        return group->collision.CollideRange(particles, begin, count, group->chunkCollisionStats[chunk], events);
+    },
+        [&](uint32_t groupIndex, const ParticleStorage& particles, uint32_t begin, uint32_t count) -> uint32_t {
+        ParticleGroup* group = updateGroups_[groupIndex];
+        if (group->sortMode != ParticleSortMode::None) {
+            return 0;
+        }
+        ParticleCullStats& stats = group->chunkCullStats[begin / ParticleUpdater::kChunkSize];
+        return group->culler.CullRange(particles, begin, count, frustum, group->lod, stats);
+    },
+        [&](uint32_t groupIndex, const ParticleStorage& particles, uint32_t begin, uint32_t count, uint32_t offset) {
+        ParticleGroup* group = updateGroups_[groupIndex];
+        PackIndexedParticleInstances(
+            particles, group->culler.GetIndices() + begin, count, group->instanceData + offset, group->culler.GetSizeScales());
+    });
+
+    // 並べ替えるグループは詰めた後の配列から選別し、奥から手前の順に書き込む（ビルボード行列の3行目が視線方向）
+    const Vector3 forward = { billboardMatrix.m[2][0], billboardMatrix.m[2][1], billboardMatrix.m[2][2] };
+    for (ParticleGroup* group : updateGroups_) {
+        if (group->sortMode == ParticleSortMode::BackToFront) {
+            uint32_t visible = group->culler.CullRange(
+                group->particles, 0, group->particles.GetCount(), frustum, group->lod, group->cullStats);
+            group->sorter.SortBackToFront(group->particles, group->culler.GetIndices(), visible, forward);
+            PackIndexedParticleInstances(
+                group->particles, group->sorter.GetIndices(), visible, group->instanceData, group->culler.GetSizeScales());
+        }
+        else {
+            // チャンクごとの選別結果をグループの結果にまとめる
+            group->cullStats = ParticleCullStats();
+            for (uint32_t chunk = 0; chunk < group->chunkCount; ++chunk) {
+                group->cullStats.Merge(group->chunkCullStats[chunk]);
+            }
+        }
+
+        // インスタンス数は選別で残した数
+        group->instanceCount = group->cullStats.visibleCount;
+
+        // チャンクごとの衝突の統計情報をまとめる（セル数と形状の数はPrepareで設定済み）
+        if (group->collision.IsEnabled()) {
+            for (uint32_t chunk = 0; chunk < group->chunkCount; ++chunk) {
+                group->collisionStats.Merge(group->chunkCollisionStats[chunk]);
+            }
         }
     }
+
+    // 更新中にためた出来事からサブエミッターを発生させる（全グループの更新と詰め直しが終わった後）
+    SpawnSubEmitters();
 }
 
-void ParticleManager::Emit(const std::string& name, const Vector3& position, uint32_t count) {
-    // 詳細設定版のEmitを呼び出し
-    Emit(
-        name,
-        position,
-        count,
-        { -1.0f, -1.0f, -1.0f },  // velocityMin
-        { 1.0f, 1.0f, 1.0f },     // velocityMax
-        { 0.0f, 0.0f, 0.0f },     // accelMin
-        { 0.0f, -9.8f, 0.0f },    // accelMax
-        0.5f,                     // startSizeMin
-        1.0f,                     // startSizeMax
-        0.0f,                     // endSizeMin
-        0.0f,                     // endSizeMax
-        { 1.0f, 1.0f, 1.0f, 1.0f }, // startColorMin
-        { 1.0f, 1.0f, 1.0f, 1.0f }, // startColorMax
-        { 1.0f, 1.0f, 1.0f, 0.0f }, // endColorMin
-        { 1.0f, 1.0f, 1.0f, 0.0f }, // endColorMax
-        0.0f,                     // rotationMin
-        0.0f,                     // rotationMax
-        0.0f,                     // rotationVelocityMin
-        0.0f,                     // rotationVelocityMax
-        1.0f,                     // lifeTimeMin
-        3.0f                      // lifeTimeMax
-    );
+void ParticleManager::SpawnSubEmitters() {
+    for (ParticleGroup* group : updateGroups_) {
+        group->eventCount = 0;
+        if (group->subEmitters.empty()) {
+            continue;
+        }
+
+        // きっかけごとに全チャンクのバッファの出来事を1つの配列にまとめ、サブエミッターごとに一度だけ発生させる
+        // （出来事ごとにEmitを呼ぶと、出来事の数だけ乱数の作成と容量の確認を繰り返すことになる）
+        for (ParticleEventType type : { ParticleEventType::Death, ParticleEventType::Collision }) {
+            spawnEvents_.clear();
+            for (uint32_t chunk = 0; chunk < group->chunkCount; ++chunk) {
+                for (const ParticleEvent& event : group->chunkEvents[chunk]) {
+                    if (event.type == type) {
+                        spawnEvents_.push_back(event);
+                    }
+                }
+            }
+            const uint32_t eventCount = static_cast<uint32_t>(spawnEvents_.size());
+            group->eventCount += eventCount;
+            if (eventCount == 0) {
+                continue;
+            }
+            for (size_t index = 0; index < group->subEmitters.size(); ++index) {
+                const ParticleSubEmitterDesc& subEmitter = group->subEmitters[index];
+                if (subEmitter.trigger == type) {
+                    SpawnParticles(particleGroups[subEmitter.target].particles, spawnEvents_.data(), eventCount,
+                        subEmitter.count, subEmitter.inheritVelocity, subEmitter.emitter, group->subEmitterRandoms[index]);
+                }
+            }
+        }
+    }
 }
 
-void ParticleManager::Emit(
-    const std::string& name,
-    const Vector3& position,
-    uint32_t count,
-    const Vector3& velocityMin,
-    const Vector3& velocityMax,
-    const Vector3& accelMin,
-    const Vector3& accelMax,
-    float startSizeMin,
-    float startSizeMax,
-    float endSizeMin,
-    float endSizeMax,
-    const Vector4& startColorMin,
-    const Vector4& startColorMax,
-    const Vector4& endColorMin,
-    const Vector4& endColorMax,
-    float rotationMin,
-    float rotationMax,
-    float rotationVelocityMin,
-    float rotationVelocityMax,
-    float lifeTimeMin,
-    float lifeTimeMax) {
-
-    // 指定された名前のパーティクルグループが存在するか確認
-    auto it = particleGroups.find(name);
-    assert(it != particleGroups.end());
-
-    // 均等分布乱数生成器
-    std::uniform_real_distribution<float> velocityDistX(velocityMin.x, velocityMax.x);
-    std::uniform_real_distribution<float> velocityDistY(velocityMin.y, velocityMax.y);
-    std::uniform_real_distribution<float> velocityDistZ(velocityMin.z, velocityMax.z);
-
-    std::uniform_real_distribution<float> accelDistX(accelMin.x, accelMax.x);
-    std::uniform_real_distribution<float> accelDistY(accelMin.y, accelMax.y);
-    std::uniform_real_distribution<float> accelDistZ(accelMin.z, accelMax.z);
-
-    std::uniform_real_distribution<float> startSizeDist(startSizeMin, startSizeMax);
-    std::uniform_real_distribution<float> endSizeDist(endSizeMin, endSizeMax);
-
-    std::uniform_real_distribution<float> startColorDistR(startColorMin.x, startColorMax.x);
-    std::uniform_real_distribution<float> startColorDistG(startColorMin.y, startColorMax.y);
-    std::uniform_real_distribution<float> startColorDistB(startColorMin.z, startColorMax.z);
-    std::uniform_real_distribution<float> startColorDistA(startColorMin.w, startColorMax.w);
-
-    std::uniform_real_distribution<float> endColorDistR(endColorMin.x, endColorMax.x);
-    std::uniform_real_distribution<float> endColorDistG(endColorMin.y, endColorMax.y);
-    std::uniform_real_distribution<float> endColorDistB(endColorMin.z, endColorMax.z);
-    std::uniform_real_distribution<float> endColorDistA(endColorMin.w, endColorMax.w);
-
-    std::uniform_real_distribution<float> rotationDist(rotationMin, rotationMax);
-    std::uniform_real_distribution<float> rotationVelocityDist(rotationVelocityMin, rotationVelocityMax);
-
-    std::uniform_real_distribution<float> lifeTimeDist(lifeTimeMin, lifeTimeMax);
-
-    // 指定された数のパーティクルを生成
-    for (uint32_t i = 0; i < count; ++i) {
-        Particle particle;
-
-        // 座標
-        particle.position = position;
-
-        // 速度（ランダム）
-        particle.velocity.x = velocityDistX(randomEngine_);
-        particle.velocity.y = velocityDistY(randomEngine_);
-        particle.velocity.z = velocityDistZ(randomEngine_);
-
-        // 加速度（ランダム）
-        particle.accel.x = accelDistX(randomEngine_);
-        particle.accel.y = accelDistY(randomEngine_);
-        particle.accel.z = accelDistZ(randomEngine_);
-
-        // サイズ（ランダム）
-        particle.startSize = startSizeDist(randomEngine_);
-        particle.endSize = endSizeDist(randomEngine_);
-        particle.size = particle.startSize;
-
-        // 色（ランダム）
-        particle.startColor.x = startColorDistR(randomEngine_);
-        particle.startColor.y = startColorDistG(randomEngine_);
-        particle.startColor.z = startColorDistB(randomEngine_);
-        particle.startColor.w = startColorDistA(randomEngine_);
-
-        particle.endColor.x = endColorDistR(randomEngine_);
-        particle.endColor.y = endColorDistG(randomEngine_);
-        particle.endColor.z = endColorDistB(randomEngine_);
-        particle.endColor.w = endColorDistA(randomEngine_);
-
-        particle.color = particle.startColor;
-
-        // 回転（ランダム）
-        particle.rotation = rotationDist(randomEngine_);
-        particle.rotationVelocity = rotationVelocityDist(randomEngine_);
-
-        // 寿命（ランダム）
-        particle.lifeTimeMax = lifeTimeDist(randomEngine_);
-        particle.lifeTime = 0.0f;
-
-        // パーティクルリストに追加
-        it->second.particles.push_back(particle);
+uint32_t ParticleManager::AddSubEmitter(ParticleGroupHandle group, const ParticleSubEmitterDesc& desc) {
+    assert(group < particleGroups.size());
+    assert(desc.target < particleGroups.size());
+    ParticleGroup& source = particleGroups[group];
+    source.subEmitters.push_back(desc);
+    source.subEmitterRandoms.emplace_back(ParticleRandom::HashSeed(source.name.c_str(), source.subEmitters.size() - 1));
+    source.emitsOnDeath = source.emitsOnDeath || desc.trigger == ParticleEventType::Death;
+    source.emitsOnCollision = source.emitsOnCollision || desc.trigger == ParticleEventType::Collision;
+    return static_cast<uint32_t>(source.subEmitters.size()) - 1;
+}
+
+void ParticleManager::ClearSubEmitters(ParticleGroupHandle group) {
+    assert(group < particleGroups.size());
+    ParticleGroup& source = particleGroups[group];
+    source.subEmitters.clear();
+    source.subEmitterRandoms.clear();
+    source.emitsOnDeath = false;
+    source.emitsOnCollision = false;
+    source.eventCount = 0;
+}
+
+bool ParticleManager::DeferIfHidden(ParticleGroup& group, const ParticleFrustum& frustum) {
+    // 直前に描画した粒があるグループは調べない（見えている間は軌跡の境界ボックスを毎フレーム求め直さない）
+    // 衝突するグループとサブエミッターのあるグループは、見えない間も判定と出来事の記録が必要なので省かない
+    ParticleStorage& particles = group.particles;
+    if (particles.GetSimulation() != ParticleStorage::Simulation::Analytic || group.collision.IsEnabled() ||
+        !group.subEmitters.empty() || particles.Empty() || group.cullStats.visibleCount > 0) {
+        return false;
+    }
+
+    // 寿命が尽きるまでの軌跡を四角形の大きさだけ広げ、視錐台の完全に外なら今回は更新しない
+    // 寿命の尽きた粒も次に更新するまで配列に残るが、描画しないので問題ない
+    ParticleBounds bounds;
+    float maxSize = 0.0f;
+    particles.GetTrajectoryBounds(bounds.min, bounds.max, maxSize);
+    float radius = maxSize * ParticleCuller::kRadiusScale;
+    bounds.min = { bounds.min.x - radius, bounds.min.y - radius, bounds.min.z - radius };
+    bounds.max = { bounds.max.x + radius, bounds.max.y + radius, bounds.max.z + radius };
+    if (!frustum.IsOutside(bounds)) {
+        return false;
     }
+
+    particles.Defer(kDeltaTime);
+    group.cullStats = ParticleCullStats();
+    group.cullStats.frustumCulledCount = particles.GetCount();
+    group.cullStats.bounds = bounds;
+    group.instanceCount = 0;
+    return true;
+}
+
+void ParticleManager::Emit(ParticleGroupHandle group, const Vector3& position, uint32_t count) {
+    // 既定の設定で詳細設定版のEmitを呼び出し
+    static const EmitterDesc kDefaultDesc;
+    Emit(group, position, count, kDefaultDesc, random_);
+}
+
+void ParticleManager::Emit(ParticleGroupHandle group, const Vector3& position, uint32_t count, const EmitterDesc& desc, ParticleRandom& random) {
+    // ハンドルが有効か確認
+    assert(group < particleGroups.size());
+
+    // 座標1つ・速度0の出来事としてまとめて発生させる（属性ごとにまとめて乱数を作る）
+    const ParticleEvent event = { position, { 0.0f, 0.0f, 0.0f }, ParticleEventType::Death };
+    SpawnParticles(particleGroups[group].particles, &event, 1, count, 0.0f, desc, random);
 }
 
 void ParticleManager::Draw() {
     // パーティクルがない場合は描画しない
     bool hasParticles = false;
-    for (auto& [name, group] : particleGroups) {
-        if (!group.particles.empty()) {
+    for (ParticleGroup& group : particleGroups) {
+        if (!group.particles.Empty()) {
             hasParticles = true;
             break;
         }
@@ -518,13 +575,21 @@ void ParticleManager::Draw() {
     commandList->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
     commandList->SetGraphicsRootConstantBufferView(1, directionalLightResource->GetGPUVirtualAddress());
 
+    // フレーム定数をセット（頂点シェーダー用）
+    commandList->SetGraphicsRootConstantBufferView(4, frameResource->GetGPUVirtualAddress());
+
     // 各パーティクルグループの描画
-    for (auto& [name, group] : particleGroups) {
+    for (ParticleGroup& group : particleGroups) {
         // パーティクルがない場合はスキップ
-        if (group.particles.empty() || group.instanceCount == 0) {
+        if (group.particles.Empty() || group.instanceCount == 0) {
             continue;
         }
 
+        // 合成方法に合わせたパイプラインステートをセット
+        ID3D12PipelineState* groupPipelineState =
+            group.blendMode == ParticleBlendMode::Alpha ? alphaPipelineState.Get() : pipelineState.Get();
+        commandList->SetPipelineState(groupPipelineState);
+
         // テクスチャをセット（ピクセルシェーダー用）
         srvManager_->SetGraphicsRootDescriptorTable(2, group.textureSrvIndex);
 
@@ -555,11 +620,14 @@ void ParticleManager::DrawSimpleQuad() {
     commandList->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
     commandList->SetGraphicsRootConstantBufferView(1, directionalLightResource->GetGPUVirtualAddress());
 
+    // フレーム定数をセット（頂点シェーダー用）
+    commandList->SetGraphicsRootConstantBufferView(4, frameResource->GetGPUVirtualAddress());
+
     // テクスチャのテスト用にsmoke.pngを使用
-    auto it = particleGroups.find("smoke");
-    if (it != particleGroups.end()) {
+    ParticleGroupHandle smoke = FindParticleGroup("smoke");
+    if (smoke != kInvalidParticleGroup) {
         // テクスチャをセット
-        srvManager_->SetGraphicsRootDescriptorTable(2, it->second.textureSrvIndex);
+        srvManager_->SetGraphicsRootDescriptorTable(2, particleGroups[smoke].textureSrvIndex);
 
         // 単純な四角形を描画
         commandList->DrawInstanced(4, 1, 0, 0);
@@ -1,70 +1,50 @@
 #pragma once
 
+#include <cassert>
 #include <unordered_map>
 #include <string>
-#include <list>
 #include <random>
 #include <memory>
+#include <vector>
 #include "DirectXCommon.h"
 #include "SRVManager.h"
 #include "Vector3.h"
 #include "Mymath.h"
 #include "Camera.h"
+#include "EmitterDesc.h"
+#include "ParticleCollision.h"
+#include "ParticleCuller.h"
+#include "ParticleCurve.h"
+#include "ParticleInstance.h"
+#include "ParticleRandom.h"
+#include "ParticleSorter.h"
+#include "ParticleStorage.h"
+#include "ParticleSubEmitter.h"
+#include "ParticleUpdater.h"
 
 // 前方宣言
 class ParticleEmitter;
-
-// パーティクル1粒の情報
-struct Particle {
-    // 座標
-    Vector3 position;
-    // 速度
-    Vector3 velocity;
-    // 加速度
-    Vector3 accel;
-    // 色
-    Vector4 color;
-    // 初期サイズ
-    float startSize;
-    // 最終サイズ
-    float endSize;
-    // 現在サイズ
-    float size;
-    // 初期色
-    Vector4 startColor;
-    // 最終色
-    Vector4 endColor;
-    // 回転
-    float rotation;
-    // 回転速度
-    float rotationVelocity;
-    // 経過時間
-    float lifeTime;
-    // 寿命
-    float lifeTimeMax;
-
-    // 生存フラグ
-    bool isDead = false;
-};
-
-// インスタンシング描画用データ
-struct ParticleForGPU {
-    // WVP行列
-    Matrix4x4 WVP;
-    // World行列
-    Matrix4x4 World;
-    // 色
-    Vector4 color;
+namespace Collision {
+    class CollisionObject;
+}
+
+// パーティクルグループの合成方法
+enum class ParticleBlendMode {
+    Add,   // 加算合成（順序に依存しない）
+    Alpha, // 半透明合成（ParticleSortMode::BackToFrontと組み合わせる）
 };
 
 // パーティクルグループ（テクスチャごとにグループ化）
 struct ParticleGroup {
+    // グループ名
+    std::string name;
+
     // マテリアルデータ（テクスチャファイルパスとテクスチャのSRVインデックス）
     std::string textureFilePath;
     uint32_t textureSrvIndex;
 
-    // パーティクルのリスト
-    std::list<Particle> particles;
+    // パーティクル（属性ごとの配列、容量と容量超過時の動作はグループ作成時に指定）
+    ParticleStorage particles;
 
     // インスタンシングデータのSRVインデックス
     uint32_t instanceSrvIndex;
@@ -76,29 +56,83 @@ struct ParticleGroup {
     uint32_t instanceCount;
 
     // インスタンシングデータを書き込むためのポインタ
-    ParticleForGPU* instanceData;
+    ParticleInstance* instanceData;
+
+    // 合成方法と描画順
+    ParticleBlendMode blendMode = ParticleBlendMode::Add;
+    ParticleSortMode sortMode = ParticleSortMode::None;
+    // 描画順の並べ替え（sortModeがBackToFrontのときのみ使う）
+    ParticleSorter sorter;
+
+    // 描画する粒の選別（視錐台カリングと距離LOD）
+    ParticleCuller culler;
+    ParticleLod lod;
+    // チャンクごとの選別結果（容量分のチャンク数だけ確保）と今回のチャンク数
+    std::vector<ParticleCullStats> chunkCullStats;
+    uint32_t chunkCount = 0;
+    // 直前の更新の選別結果（グループ全体）
+    ParticleCullStats cullStats;
+
+    // 平面・ワールドの衝突形状との衝突（既定では無効）
+    ParticleCollision collision;
+    // チャンクごとの衝突の統計情報（容量分のチャンク数だけ確保）と直前の更新のグループ全体の統計情報
+    std::vector<ParticleCollisionStats> chunkCollisionStats;
+    ParticleCollisionStats collisionStats;
+
+    // サブエミッター（登録順）と、きっかけごとに登録されているかどうか
+    std::vector<ParticleSubEmitterDesc> subEmitters;
+    // サブエミッターごとの乱数生成器（subEmittersと同じ並び、グループ名と登録番号から作ったシード）
+    // 他のサブエミッターやEmitの呼び出しに左右されず、同じ出来事の列からは同じ粒を発生させる
+    std::vector<ParticleRandom> subEmitterRandoms;
+    bool emitsOnDeath = false;
+    bool emitsOnCollision = false;
+    // チャンクごとの出来事のバッファ（容量分のチャンク数だけ確保、各チャンクの処理が自分のバッファにだけ追加する）
+    std::vector<std::vector<ParticleEvent>> chunkEvents;
+    // 直前の更新で記録した出来事の数
+    uint32_t eventCount = 0;
 };
 
 // パーティクルマネージャクラス
 class ParticleManager {
+public:
+    // 1グループあたりの最大パーティクル数の既定値（インスタンシング用バッファの要素数）
+    static constexpr uint32_t kMaxInstanceCount = 10000;
+
 private:
+    // 1フレームの経過時間（60FPS想定）
+    static constexpr float kDeltaTime = 1.0f / 60.0f;
+
     // DirectXCommon
     DirectXCommon* dxCommon_ = nullptr;
 
     // SRVマネージャ
     SrvManager* srvManager_ = nullptr;
 
-    // 乱数生成器
-    std::mt19937 randomEngine_;
+    // 乱数生成器（Emitで生成器を指定しなかった場合に使う）
+    ParticleRandom random_;
+
+    // パーティクルグループコンテナ（添字がハンドル、作成順）
+    std::vector<ParticleGroup> particleGroups;
+    // グループ名からハンドルへの対応（作成時と名前での検索時のみ使う）
+    std::unordered_map<std::string, ParticleGroupHandle> groupHandles_;
 
-    // パーティクルグループコンテナ
-    std::unordered_map<std::string, ParticleGroup> particleGroups;
+    // 全グループの更新を分割してワーカースレッドで実行する
+    ParticleUpdater updater_;
+    // 更新対象のグループと配列（updater_に渡す番号順、毎フレーム作り直す）
+    std::vector<ParticleGroup*> updateGroups_;
+    std::vector<ParticleStorage*> updateStorages_;
+    // 衝突形状を集めるときの作業用配列
+    std::vector<Collision::CollisionObject*> queryColliders_;
+    // サブエミッターを発生させるときの作業用配列（1グループ・1つのきっかけの全チャンクの出来事）
+    std::vector<ParticleEvent> spawnEvents_;
 
     // 描画用ルートシグネチャ
     Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;
 
-    // 描画用パイプラインステート
+    // 描画用パイプラインステート（加算合成）
     Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState;
+    // 描画用パイプラインステート（半透明合成）
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> alphaPipelineState;
 
     // 頂点バッファビュー
     D3D12_VERTEX_BUFFER_VIEW vbView;
@@ -114,6 +148,10 @@ private:
     Microsoft::WRL::ComPtr<ID3D12Resource> directionalLightResource;
     DirectionalLight* directionalLightData;
 
+    // フレーム定数用リソース（ビルボードとビュープロジェクションは頂点シェーダーで計算する）
+    Microsoft::WRL::ComPtr<ID3D12Resource> frameResource;
+    ParticleFrameConstants* frameData;
+
     // ビルボード行列
     Matrix4x4 billboardMatrix;
 
@@ -134,6 +172,12 @@ private:
     // ビルボード行列の計算
     void CalculateBillboardMatrix(const Camera* camera);
 
+    // Analyticのグループの軌跡が視錐台の外なら、更新を省いて経過時間をためる（省いた場合はtrue）
+    bool DeferIfHidden(ParticleGroup& group, const ParticleFrustum& frustum);
+
+    // 更新中にためた出来事からサブエミッターをまとめて発生させる（全グループの更新後）
+    void SpawnSubEmitters();
+
     // フレンドクラス
     friend class ParticleEmitter;
 
@@ -165,43 +209,125 @@ public:
     // 描画
     void Draw();
 
-    // パーティクルグループの作成
-    void CreateParticleGroup(const std::string& name, const std::string& textureFilePath);
+    // パーティクルグループの作成（戻り値のハンドルで発生させる、同名のグループがあればそのハンドルを返す）
+    // capacityは最大パーティクル数（配列とインスタンシング用バッファはここで一度だけ確保する）
+    // overflowPolicyは最大数に達しているときに発生させた場合の動作
+    ParticleGroupHandle CreateParticleGroup(
+        const std::string& name,
+        const std::string& textureFilePath,
+        uint32_t capacity = kMaxInstanceCount,
+        ParticleStorage::OverflowPolicy overflowPolicy = ParticleStorage::OverflowPolicy::DropNew);
 
-    // パーティクルの発生（シンプル版）
-    void Emit(const std::string& name, const Vector3& position, uint32_t count);
+    // パーティクルの発生（シンプル版、EmitterDescの既定値とマネージャの乱数生成器を使う）
+    void Emit(ParticleGroupHandle group, const Vector3& position, uint32_t count);
 
     // パーティクルの発生（詳細設定版）
-    void Emit(
-        const std::string& name,
-        const Vector3& position,
-        uint32_t count,
-        const Vector3& velocityMin,
-        const Vector3& velocityMax,
-        const Vector3& accelMin,
-        const Vector3& accelMax,
-        float startSizeMin,
-        float startSizeMax,
-        float endSizeMin,
-        float endSizeMax,
-        const Vector4& startColorMin,
-        const Vector4& startColorMax,
-        const Vector4& endColorMin,
-        const Vector4& endColorMax,
-        float rotationMin,
-        float rotationMax,
-        float rotationVelocityMin,
-        float rotationVelocityMax,
-        float lifeTimeMin,
-        float lifeTimeMax);
+    // descの範囲で属性ごとにまとめて乱数を作り、randomの列で属性を決める
+    void Emit(ParticleGroupHandle group, const Vector3& position, uint32_t count, const EmitterDesc& desc, ParticleRandom& random);
+
+    // 寿命に対するサイズ・色の曲線をParticleCurveTable::kResolution点の表にしてグループに登録する
+    // 戻り値をEmitterDesc::SetLifetimeCurveに指定すると、サイズと色の開始～終了の補間結果に曲線の値が掛かる
+    // 曲線の評価はここで一度だけ行い、更新では表を読んで補間するだけ（同じ曲線なら同じ番号を返す）
+    uint32_t CreateLifetimeCurve(ParticleGroupHandle group, const ParticleCurve& size, const ParticleGradient& color) {
+        assert(group < particleGroups.size());
+        return particleGroups[group].particles.AddCurveTable(ParticleCurveTable::Bake(size, color));
+    }
+
+    // 合成方法と描画順の設定（半透明のグループはAlphaとBackToFrontを指定する）
+    void SetBlendMode(ParticleGroupHandle group, ParticleBlendMode blendMode) {
+        assert(group < particleGroups.size());
+        particleGroups[group].blendMode = blendMode;
+    }
+    void SetSortMode(ParticleGroupHandle group, ParticleSortMode sortMode) {
+        assert(group < particleGroups.size());
+        particleGroups[group].sortMode = sortMode;
+    }
+
+    // 動きの求め方の設定（グループが空のときのみ、既定ではIntegrate）
+    // Analyticのグループは、直前の更新で描画した粒がなく、全粒の寿命までの軌跡が視錐台の外にある間は更新を省き、
+    // 見えるようになった最初の更新で省いた時間をまとめて進める
+    void SetSimulation(ParticleGroupHandle group, ParticleStorage::Simulation simulation) {
+        assert(group < particleGroups.size());
+        particleGroups[group].particles.SetSimulation(simulation);
+    }
+
+    // 衝突の設定（設定すると有効になる）
+    // 更新ごとに粒をdesc.cellSizeの格子に分け、粒のあるセルごとにCollision::CollisionManagerの球・カプセルを一度だけ集める
+    // 衝突を有効にしたグループは、Analyticでも見えない間の更新を省かない
+    void SetCollision(ParticleGroupHandle group, const ParticleCollisionDesc& desc) {
+        assert(group < particleGroups.size());
+        particleGroups[group].collision.SetDesc(desc);
+    }
+    void DisableCollision(ParticleGroupHandle group) {
+        assert(group < particleGroups.size());
+        particleGroups[group].collision.Disable();
+    }
+
+    // 直前の更新の衝突の統計情報（セル数、集めた衝突形状の数、判定数、衝突数、削除数）
+    const ParticleCollisionStats& GetCollisionStats(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].collisionStats;
+    }
+
+    // サブエミッターの登録（戻り値は登録順の番号）
+    // 更新中は出来事をチャンクごとのバッファに追加するだけにし、全グループの更新後にまとめて発生させる
+    // 発生させた粒は次の更新から動き、描画される。サブエミッターのあるグループは、Analyticでも見えない間の更新を省かない
+    // Collisionをきっかけにする場合は、SetCollisionで衝突も有効にする
+    // 乱数はサブエミッターごとに持ち、シードはHashSeed(発生元のグループ名, 登録番号)
+    uint32_t AddSubEmitter(ParticleGroupHandle group, const ParticleSubEmitterDesc& desc);
+    void ClearSubEmitters(ParticleGroupHandle group);
+
+    // デバッグ用：直前の更新で記録した出来事の数
+    uint32_t GetEventCount(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].eventCount;
+    }
+
+    // 距離LODの設定（既定では無効）
+    void SetLod(ParticleGroupHandle group, const ParticleLod& lod) {
+        assert(group < particleGroups.size());
+        particleGroups[group].lod = lod;
+    }
+
+    // 直前の更新の選別結果（描画した数、視錐台の外・距離LODで除いた数、境界ボックス）
+    // 除いた数 * sizeof(ParticleInstance)がアップロードを省いたバイト数
+    const ParticleCullStats& GetCullStats(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].cullStats;
+    }
+
+    // グループ名からハンドルを取得（存在しなければkInvalidParticleGroup）
+    ParticleGroupHandle FindParticleGroup(const std::string& name) const;
+
+    // グループ名の取得
+    const std::string& GetParticleGroupName(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].name;
+    }
+
+    // 乱数生成器を指定しないEmitで使うシードの設定
+    void SetRandomSeed(uint64_t seed) { random_.Seed(seed); }
+
+    // 更新に使うスレッド数（呼び出し元を含む、0ならハードウェアのスレッド数）
+    void SetWorkerCount(uint32_t workerCount) { updater_.SetWorkerCount(workerCount); }
+    uint32_t GetWorkerCount() const { return updater_.GetWorkerCount(); }
+
+    // デバッグ用：更新を省いてためている時間の取得（Analyticのグループのみ0以外になる）
+    float GetDeferredTime(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].particles.GetDeferredTime();
+    }
 
     // デバッグ用：パーティクル数の取得
-    uint32_t GetParticleCount(const std::string& name) {
-        auto it = particleGroups.find(name);
-        if (it != particleGroups.end()) {
-            return static_cast<uint32_t>(it->second.particles.size());
-        }
-        return 0;
+    uint32_t GetParticleCount(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].particles.GetCount();
+    }
+
+    // デバッグ用：最大数を超えて発生させた数の取得（発生させなかった数と削除した数の合計）
+    uint64_t GetOverflowCount(ParticleGroupHandle group) const {
+        assert(group < particleGroups.size());
+        return particleGroups[group].particles.GetOverflowCount();
     }
 
     // デバッグ用：シンプルな四角形を描画
@@ -0,0 +1,138 @@
+#include "ParticleRandom.h"
+#include "ParticleStorage.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#include <immintrin.h>
+#define PARTICLE_RANDOM_AVX2
+#ifdef _MSC_VER
+#define PARTICLE_AVX2_FUNCTION
+#else
+#define PARTICLE_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    // 上位24ビットを[0, 1)の浮動小数点数にする係数
+    const float kUnitScale = 1.0f / 16777216.0f;
+
+    // splitmix64（シードから状態を作る）
+    uint64_t SplitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // 32ビットの左回転
+    uint32_t RotateLeft(uint32_t value, int shift) {
+        return (value << shift) | (value >> (32 - shift));
+    }
+}
+
+ParticleRandom::ParticleRandom(uint64_t seed) {
+    Seed(seed);
+}
+
+void ParticleRandom::Seed(uint64_t seed) {
+    uint64_t state = seed;
+    for (uint32_t lane = 0; lane < kLaneCount; ++lane) {
+        uint64_t a = SplitMix64(state);
+        uint64_t b = SplitMix64(state);
+        s0_[lane] = static_cast<uint32_t>(a);
+        s1_[lane] = static_cast<uint32_t>(a >> 32);
+        s2_[lane] = static_cast<uint32_t>(b);
+        s3_[lane] = static_cast<uint32_t>(b >> 32);
+        // 全て0の状態からは抜け出せないので避ける
+        if ((s0_[lane] | s1_[lane] | s2_[lane] | s3_[lane]) == 0) {
+            s0_[lane] = 1;
+        }
+    }
+}
+
+uint64_t ParticleRandom::HashSeed(const char* text, uint64_t salt) {
+    uint64_t hash = 0xCBF29CE484222325ull ^ salt;
+    for (const char* c = text; *c != '\0'; ++c) {
+        hash ^= static_cast<uint8_t>(*c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+void ParticleRandom::Fill(float* out, uint32_t count, float min, float max) {
+    if (ParticleStorage::IsAvx2Supported()) {
+        FillAvx2(out, count, min, max);
+    }
+    else {
+        FillScalar(out, count, min, max);
+    }
+}
+
+void ParticleRandom::FillScalar(float* out, uint32_t count, float min, float max) {
+    const float range = max - min;
+    for (uint32_t i = 0; i < count; i += kLaneCount) {
+        for (uint32_t lane = 0; lane < kLaneCount; ++lane) {
+            // xoshiro128+
+            uint32_t result = s0_[lane] + s3_[lane];
+            uint32_t t = s1_[lane] << 9;
+            s2_[lane] ^= s0_[lane];
+            s3_[lane] ^= s1_[lane];
+            s1_[lane] ^= s2_[lane];
+            s0_[lane] ^= s3_[lane];
+            s2_[lane] ^= t;
+            s3_[lane] = RotateLeft(s3_[lane], 11);
+
+            // 下位ビットは質が低いので上位24ビットを使う（AVX2と結果を揃えるためFMAは使わない）
+            if (i + lane < count) {
+                float unit = static_cast<float>(result >> 8) * kUnitScale;
+                out[i + lane] = min + range * unit;
+            }
+        }
+    }
+}
+
+#ifdef PARTICLE_RANDOM_AVX2
+PARTICLE_AVX2_FUNCTION void ParticleRandom::FillAvx2(float* out, uint32_t count, float min, float max) {
+    __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s0_));
+    __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s1_));
+    __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s2_));
+    __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s3_));
+    const __m256 minimum = _mm256_set1_ps(min);
+    const __m256 range = _mm256_set1_ps(max - min);
+    const __m256 scale = _mm256_set1_ps(kUnitScale);
+
+    for (uint32_t i = 0; i < count; i += kLaneCount) {
+        // xoshiro128+を8本同時に進める
+        __m256i result = _mm256_add_epi32(s0, s3);
+        __m256i t = _mm256_slli_epi32(s1, 9);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+
+        // 上位24ビットを[min, max)に変換（24ビットなので符号付きの変換でも正しい）
+        __m256 unit = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(result, 8)), scale);
+        __m256 value = _mm256_add_ps(minimum, _mm256_mul_ps(range, unit));
+        if (i + kLaneCount <= count) {
+            _mm256_storeu_ps(out + i, value);
+        }
+        else {
+            alignas(32) float tail[kLaneCount];
+            _mm256_store_ps(tail, value);
+            for (uint32_t lane = 0; i + lane < count; ++lane) {
+                out[i + lane] = tail[lane];
+            }
+        }
+    }
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s0_), s0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s1_), s1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s2_), s2);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s3_), s3);
+}
+#else
+void ParticleRandom::FillAvx2(float* out, uint32_t count, float min, float max) {
+    FillScalar(out, count, min, max);
+}
+#endif
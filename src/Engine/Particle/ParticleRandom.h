@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// パーティクル発生用の乱数生成器（xoshiro128+を8本並べたもの）
+// 8本の状態を同時に進めるので、AVX2では1回の処理で8個の乱数が得られる
+// AVX2の有無にかかわらず同じシードからは同じ列を返す（リプレイで同じ発生内容になる）
+class ParticleRandom {
+public:
+    // 同時に進める状態の数（Fillはこの単位で乱数を消費する）
+    static constexpr uint32_t kLaneCount = 8;
+
+    // コンストラクタ
+    explicit ParticleRandom(uint64_t seed = 0);
+
+    // シードの設定（splitmix64で全ての状態を初期化する）
+    void Seed(uint64_t seed);
+
+    // [min, max)の一様乱数でout[0]～out[count - 1]を埋める
+    // 端数の分もkLaneCount個単位で状態を進める（呼び出し方が同じなら結果も同じ）
+    void Fill(float* out, uint32_t count, float min, float max);
+
+    // 文字列からシードを作る（FNV-1a）
+    static uint64_t HashSeed(const char* text, uint64_t salt = 0);
+
+private:
+    // 状態（xoshiro128+の4語をそれぞれkLaneCount本分）
+    alignas(32) uint32_t s0_[kLaneCount];
+    alignas(32) uint32_t s1_[kLaneCount];
+    alignas(32) uint32_t s2_[kLaneCount];
+    alignas(32) uint32_t s3_[kLaneCount];
+
+    // kLaneCount個ずつの生成
+    void FillScalar(float* out, uint32_t count, float min, float max);
+    void FillAvx2(float* out, uint32_t count, float min, float max);
+};
@@ -0,0 +1,151 @@
+#include "ParticleSorter.h"
+#include <algorithm>
+
+namespace {
+    // 基数（8ビット）
+    const uint32_t kRadix = 256;
+
+    // 視線方向の深度はカメラ位置の分が全粒で同じなので、座標と視線方向の内積だけで順序が決まる
+    // 深度は配列に保存せず、範囲を求めるときと量子化するときに座標から2回計算する（メモリの読み書きを減らす）
+
+    // 深度の最小値と最大値（レーンごとに求めてから合わせる、std::minmax_elementはベクトル化されない）
+    // kIndexedがtrueなら座標をsubset[i]番目から直接読む（一部だけを並べるときに座標を集め直さない）
+    template<bool kIndexed>
+    void DepthRange(
+        const float* __restrict x, const float* __restrict y, const float* __restrict z, const uint32_t* __restrict subset,
+        const Vector3& forward, uint32_t count, float& nearest, float& farthest) {
+        const uint32_t kLanes = ParticleStorage::kLaneCount;
+        const float fx = forward.x;
+        const float fy = forward.y;
+        const float fz = forward.z;
+        const uint32_t first = kIndexed ? subset[0] : 0;
+        float laneMin[kLanes];
+        float laneMax[kLanes];
+        for (uint32_t lane = 0; lane < kLanes; ++lane) {
+            laneMin[lane] = x[first] * fx + y[first] * fy + z[first] * fz;
+            laneMax[lane] = laneMin[lane];
+        }
+        uint32_t i = 0;
+        for (; i + kLanes <= count; i += kLanes) {
+            for (uint32_t lane = 0; lane < kLanes; ++lane) {
+                const uint32_t index = kIndexed ? subset[i + lane] : i + lane;
+                float depth = x[index] * fx + y[index] * fy + z[index] * fz;
+                laneMin[lane] = depth < laneMin[lane] ? depth : laneMin[lane];
+                laneMax[lane] = depth > laneMax[lane] ? depth : laneMax[lane];
+            }
+        }
+        for (; i < count; ++i) {
+            const uint32_t index = kIndexed ? subset[i] : i;
+            float depth = x[index] * fx + y[index] * fy + z[index] * fz;
+            laneMin[0] = depth < laneMin[0] ? depth : laneMin[0];
+            laneMax[0] = depth > laneMax[0] ? depth : laneMax[0];
+        }
+        nearest = laneMin[0];
+        farthest = laneMax[0];
+        for (uint32_t lane = 1; lane < kLanes; ++lane) {
+            nearest = std::min(nearest, laneMin[lane]);
+            farthest = std::max(farthest, laneMax[lane]);
+        }
+    }
+
+    // 深度を奥ほど小さい16ビットのキーに量子化（kIndexedはDepthRangeと同じ）
+    template<bool kIndexed>
+    void Quantize(
+        uint16_t* __restrict key, const float* __restrict x, const float* __restrict y, const float* __restrict z,
+        const uint32_t* __restrict subset, const Vector3& forward, float farthest, float scale, uint32_t count) {
+        const float fx = forward.x;
+        const float fy = forward.y;
+        const float fz = forward.z;
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t index = kIndexed ? subset[i] : i;
+            float depth = x[index] * fx + y[index] * fy + z[index] * fz;
+            key[i] = static_cast<uint16_t>((farthest - depth) * scale);
+        }
+    }
+
+    // ヒストグラムを書き込み位置（累積和）に変換
+    void PrefixSum(uint32_t* offsets) {
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < kRadix; ++i) {
+            uint32_t count = offsets[i];
+            offsets[i] = sum;
+            sum += count;
+        }
+    }
+}
+
+void ParticleSorter::Reserve(uint32_t capacity) {
+    keys_.reserve(capacity);
+    tempIndices_.reserve(capacity);
+    tempKeys_.reserve(capacity);
+    indices_.reserve(capacity);
+}
+
+void ParticleSorter::SortBackToFront(const ParticleStorage& particles, const Vector3& forward) {
+    Sort(
+        particles.GetStream(ParticleStorage::kPositionX),
+        particles.GetStream(ParticleStorage::kPositionY),
+        particles.GetStream(ParticleStorage::kPositionZ),
+        nullptr, particles.GetCount(), forward);
+}
+
+void ParticleSorter::SortBackToFront(const ParticleStorage& particles, const uint32_t* subset, uint32_t count, const Vector3& forward) {
+    // 座標は集め直さず、深度の範囲と量子化でsubsetの番号から直接読む
+    Sort(
+        particles.GetStream(ParticleStorage::kPositionX),
+        particles.GetStream(ParticleStorage::kPositionY),
+        particles.GetStream(ParticleStorage::kPositionZ),
+        subset, count, forward);
+}
+
+void ParticleSorter::Sort(const float* x, const float* y, const float* z, const uint32_t* subset, uint32_t count, const Vector3& forward) {
+    count_ = count;
+    keys_.resize(count_);
+    tempIndices_.resize(count_);
+    tempKeys_.resize(count_);
+    indices_.resize(count_);
+    if (count_ == 0) {
+        return;
+    }
+
+    // 1. 深度の範囲
+    float nearest = 0.0f;
+    float farthest = 0.0f;
+    if (subset) {
+        DepthRange<true>(x, y, z, subset, forward, count_, nearest, farthest);
+    }
+    else {
+        DepthRange<false>(x, y, z, nullptr, forward, count_, nearest, farthest);
+    }
+    float range = farthest - nearest;
+    float scale = range > 0.0f ? 65535.0f / range : 0.0f;
+
+    // 2. 量子化と下位・上位8ビットのヒストグラム（1回の走査で両方数える）
+    if (subset) {
+        Quantize<true>(keys_.data(), x, y, z, subset, forward, farthest, scale, count_);
+    }
+    else {
+        Quantize<false>(keys_.data(), x, y, z, nullptr, forward, farthest, scale, count_);
+    }
+    uint32_t low[kRadix] = {};
+    uint32_t high[kRadix] = {};
+    for (uint32_t i = 0; i < count_; ++i) {
+        ++low[keys_[i] & 0xFF];
+        ++high[keys_[i] >> 8];
+    }
+    PrefixSum(low);
+    PrefixSum(high);
+
+    // 3. 下位8ビットで並べる（対象が全粒なら元の添字は0からの連番なので添字配列は読まない）
+    for (uint32_t i = 0; i < count_; ++i) {
+        uint16_t key = keys_[i];
+        uint32_t position = low[key & 0xFF]++;
+        tempIndices_[position] = subset ? subset[i] : i;
+        tempKeys_[position] = key;
+    }
+
+    // 4. 上位8ビットで並べる（安定なので下位の順序が保たれる）
+    for (uint32_t i = 0; i < count_; ++i) {
+        indices_[high[tempKeys_[i] >> 8]++] = tempIndices_[i];
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ParticleStorage.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+// パーティクルグループの並べ替え方法
+enum class ParticleSortMode {
+    None,        // 並べ替えない（加算合成向け、格納順に描画）
+    BackToFront, // 視線方向の奥から手前の順（半透明合成向け）
+};
+
+// パーティクルの描画順の並べ替え
+// 視線方向の深度を16ビットに量子化し、8ビットずつ2回のLSD基数ソートで添字を並べる
+// 量子化の幅（深度の範囲 / 65535）より近い粒どうしは格納順のまま（安定ソート）
+class ParticleSorter {
+public:
+    // 作業用配列を最大数分だけ確保（以降の並べ替えでは確保しない）
+    void Reserve(uint32_t capacity);
+
+    // particlesの[0, GetCount())を奥から手前の順に並べた添字を作る
+    // forwardはカメラの視線方向（ワールド、正規化済み）
+    void SortBackToFront(const ParticleStorage& particles, const Vector3& forward);
+
+    // particlesのsubset[0]～subset[count - 1]番目だけを奥から手前の順に並べる（視錐台カリングの後など）
+    // 座標は集め直さずsubsetの番号から直接読む
+    void SortBackToFront(const ParticleStorage& particles, const uint32_t* subset, uint32_t count, const Vector3& forward);
+
+    // 並べ替えた配列の番号（GetIndices()[0]が最も奥）
+    const uint32_t* GetIndices() const { return indices_.data(); }
+    uint32_t GetCount() const { return count_; }
+
+private:
+    // 量子化した深度（奥ほど小さい）
+    std::vector<uint16_t> keys_;
+    // 1回目の並べ替えの結果（添字とキー）
+    std::vector<uint32_t> tempIndices_;
+    std::vector<uint16_t> tempKeys_;
+    // 並べ替えた添字
+    std::vector<uint32_t> indices_;
+    // 並べ替えた数
+    uint32_t count_ = 0;
+
+    // x, y, zの[0, count)を並べ替える
+    // subsetがnullptrでなければx, y, zのsubset[0]～subset[count - 1]番目を読み、結果はsubsetの値
+    void Sort(const float* x, const float* y, const float* z, const uint32_t* subset, uint32_t count, const Vector3& forward);
+};
@@ -0,0 +1,657 @@
+#include "ParticleStorage.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#include <immintrin.h>
+#define PARTICLE_STORAGE_AVX2
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVCは/arch:AVX2なしでもAVX2の組み込み関数を使える（呼び出し前に実行時判定する）
+#define PARTICLE_AVX2_FUNCTION
+#else
+#define PARTICLE_AVX2_FUNCTION __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace {
+    // 速度に加速度を、位置に速度を加算
+    void Integrate(float* __restrict velocity, float* __restrict position, const float* __restrict accel, uint32_t count, float deltaTime) {
+        for (uint32_t i = 0; i < count; ++i) {
+            velocity[i] += accel[i] * deltaTime;
+            position[i] += velocity[i] * deltaTime;
+        }
+    }
+
+    // 値に変化量を加算
+    void Advance(float* __restrict value, const float* __restrict speed, uint32_t count, float deltaTime) {
+        for (uint32_t i = 0; i < count; ++i) {
+            value[i] += speed[i] * deltaTime;
+        }
+    }
+
+    // 発生時の状態と経過時間から座標を求める（p = p0 + t * (v0 + a * t / 2)）
+    void Evaluate(float* __restrict position, const float* __restrict start, const float* __restrict velocity,
+        const float* __restrict accel, const float* __restrict age, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            float t = age[i];
+            position[i] = start[i] + t * (velocity[i] + accel[i] * (t * 0.5f));
+        }
+    }
+
+    // 初期値と変化量と経過時間から値を求める
+    void EvaluateLinear(float* __restrict value, const float* __restrict start, const float* __restrict speed, const float* __restrict age, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            value[i] = start[i] + speed[i] * age[i];
+        }
+    }
+
+    // p0 + t * (v0 + a * t / 2) の区間[t0, t1]での最小値・最大値（端点と頂点で決まる）
+    void ParabolaRange(float p0, float v0, float a, float t0, float t1, float& low, float& high) {
+        auto at = [&](float t) { return p0 + t * (v0 + a * (t * 0.5f)); };
+        float start = at(t0);
+        float end = at(t1);
+        low = std::min(start, end);
+        high = std::max(start, end);
+        if (a != 0.0f) {
+            float vertex = -v0 / a;
+            if (vertex > t0 && vertex < t1) {
+                float value = at(vertex);
+                low = std::min(low, value);
+                high = std::max(high, value);
+            }
+        }
+    }
+
+    // 値に逆数を掛ける
+    void Scale(float* __restrict out, const float* __restrict value, const float* __restrict inverse, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            out[i] = value[i] * inverse[i];
+        }
+    }
+
+    // 線形補間
+    void Lerp(float* __restrict out, const float* __restrict start, const float* __restrict end, const float* __restrict t, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            out[i] = start[i] + t[i] * (end[i] - start[i]);
+        }
+    }
+
+    // 寿命に対する変化の表を読んで値に掛ける（ParticleCurveTable::Sampleと同じ計算）
+    // outputsはサイズ・R・G・B・Aの配列、curveは粒ごとの表の番号、tableは（始点の値, 差）の組の表
+    void ApplyCurves(float* const* outputs, const float* __restrict table, const float* __restrict curve, const float* __restrict t, uint32_t count) {
+        const uint32_t kSegmentCount = ParticleCurveTable::kResolution - 1;
+        const uint32_t kTableSize = ParticleCurveTable::kChannelCount * kSegmentCount * 2;
+        const float last = static_cast<float>(kSegmentCount);
+        for (uint32_t i = 0; i < count; ++i) {
+            float x = std::clamp(t[i] * last, 0.0f, last);
+            uint32_t index = std::min(static_cast<uint32_t>(x), kSegmentCount - 1);
+            float f = x - static_cast<float>(index);
+            const float* pairs = table + static_cast<uint32_t>(curve[i]) * kTableSize + index * 2;
+            for (uint32_t channel = 0; channel < ParticleCurveTable::kChannelCount; ++channel) {
+                const float* pair = pairs + channel * kSegmentCount * 2;
+                outputs[channel][i] *= pair[0] + f * pair[1];
+            }
+        }
+    }
+
+#ifdef PARTICLE_STORAGE_AVX2
+    // 8粒分の線形補間（start + t * (end - start)）に倍率を掛ける
+    PARTICLE_AVX2_FUNCTION inline void LerpAvx2(float* out, const float* start, const float* end, __m256 t, __m256 scale, uint32_t i) {
+        __m256 a = _mm256_loadu_ps(start + i);
+        __m256 b = _mm256_loadu_ps(end + i);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_fmadd_ps(t, _mm256_sub_ps(b, a), a), scale));
+    }
+
+    // 8粒分の表の値（pairsはチャンネルの先頭、indexは粒ごとの組の位置を粒0, 1, 4, 5, 2, 3, 6, 7の順に並べたもの）
+    // 4粒ずつ（始点の値, 差）の組を64ビットのgatherで読み、値と差に分けると128ビットの組み替えだけで粒の順に並ぶ
+    PARTICLE_AVX2_FUNCTION inline __m256 SampleCurveAvx2(const float* pairs, __m256i index, __m256 fraction) {
+        // マスク付きの形で呼ぶ（全要素を読むので結果は同じ、GCCの未初期化の警告を避ける）
+        const double* base = reinterpret_cast<const double*>(pairs);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        __m256 a = _mm256_castpd_ps(_mm256_mask_i32gather_pd(zero, base, _mm256_castsi256_si128(index), all, 8));      // 粒0, 1, 4, 5
+        __m256 b = _mm256_castpd_ps(_mm256_mask_i32gather_pd(zero, base, _mm256_extracti128_si256(index, 1), all, 8)); // 粒2, 3, 6, 7
+        __m256 value = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 delta = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm256_fmadd_ps(fraction, delta, value);
+    }
+
+    // CPUがAVX2とFMAに対応し、OSがYMMレジスタを保存するかどうか
+    bool DetectAvx2() {
+#ifdef _MSC_VER
+        int info[4] = {};
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+#endif
+}
+
+bool ParticleStorage::IsAvx2Supported() {
+#ifdef PARTICLE_STORAGE_AVX2
+    static const bool supported = DetectAvx2();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void ParticleStorage::Reserve(uint32_t capacity, OverflowPolicy policy) {
+    capacity_ = capacity;
+    stride_ = (capacity + kLaneCount - 1) / kLaneCount * kLaneCount;
+    policy_ = policy;
+    overflowCount_ = 0;
+    data_.assign(static_cast<size_t>(stride_) * kStreamCount, 0.0f);
+    scratch_.assign(stride_, 0.0f);
+    slotOf_.assign(capacity_, kInvalidSlot);
+    indexOf_.assign(capacity_, 0);
+    prev_.assign(capacity_, kInvalidSlot);
+    next_.assign(capacity_, kInvalidSlot);
+    freeSlots_.resize(capacity_);
+    Clear();
+}
+
+void ParticleStorage::Clear() {
+    count_ = 0;
+    head_ = kInvalidSlot;
+    tail_ = kInvalidSlot;
+    deferredTime_ = 0.0f;
+    trajectoryValid_ = false;
+    // 若い番号のスロットから使うよう逆順に積む
+    freeCount_ = capacity_;
+    for (uint32_t slot = 0; slot < capacity_; ++slot) {
+        freeSlots_[slot] = capacity_ - 1 - slot;
+    }
+}
+
+void ParticleStorage::SetSimulation(Simulation simulation) {
+    assert(Empty());
+    simulation_ = simulation;
+}
+
+void ParticleStorage::Defer(float deltaTime) {
+    assert(simulation_ == Simulation::Analytic);
+    deferredTime_ += deltaTime;
+}
+
+void ParticleStorage::GetTrajectoryBounds(Vector3& min, Vector3& max, float& maxSize) {
+    assert(simulation_ == Simulation::Analytic);
+    if (!trajectoryValid_) {
+        const float infinity = std::numeric_limits<float>::infinity();
+        trajectoryMin_ = { infinity, infinity, infinity };
+        trajectoryMax_ = { -infinity, -infinity, -infinity };
+        trajectoryMaxSize_ = 0.0f;
+        for (uint32_t i = 0; i < count_; ++i) {
+            ExpandTrajectory(i);
+        }
+        trajectoryValid_ = true;
+    }
+    min = trajectoryMin_;
+    max = trajectoryMax_;
+    maxSize = trajectoryMaxSize_;
+}
+
+void ParticleStorage::ExpandTrajectory(uint32_t index) {
+    // 今の経過時間（ためている間に追加した粒は負なので0から）から寿命までの軌跡
+    float t0 = std::max(GetStream(kLifeTime)[index], 0.0f);
+    float t1 = std::max(GetStream(kLifeTimeMax)[index], t0);
+    float low = 0.0f;
+    float high = 0.0f;
+    ParabolaRange(GetStream(kStartPositionX)[index], GetStream(kVelocityX)[index], GetStream(kAccelX)[index], t0, t1, low, high);
+    trajectoryMin_.x = std::min(trajectoryMin_.x, low);
+    trajectoryMax_.x = std::max(trajectoryMax_.x, high);
+    ParabolaRange(GetStream(kStartPositionY)[index], GetStream(kVelocityY)[index], GetStream(kAccelY)[index], t0, t1, low, high);
+    trajectoryMin_.y = std::min(trajectoryMin_.y, low);
+    trajectoryMax_.y = std::max(trajectoryMax_.y, high);
+    ParabolaRange(GetStream(kStartPositionZ)[index], GetStream(kVelocityZ)[index], GetStream(kAccelZ)[index], t0, t1, low, high);
+    trajectoryMin_.z = std::min(trajectoryMin_.z, low);
+    trajectoryMax_.z = std::max(trajectoryMax_.z, high);
+
+    // サイズは開始～終了の補間に表の倍率が掛かるので、両端の大きい方に表の倍率の最大値を掛けたもの以下
+    float size = std::max(std::abs(GetStream(kStartSize)[index]), std::abs(GetStream(kEndSize)[index]));
+    if (!curveMaxSizes_.empty()) {
+        size *= curveMaxSizes_[static_cast<uint32_t>(GetStream(kCurve)[index])];
+    }
+    trajectoryMaxSize_ = std::max(trajectoryMaxSize_, size);
+}
+
+uint32_t ParticleStorage::AddCurveTable(const ParticleCurveTable& table) {
+    // 表を区間ごとの（始点の値, 終点との差）の組に直す
+    auto toPairs = [](const ParticleCurveTable& source, float* pairs) {
+        for (uint32_t channel = 0; channel < ParticleCurveTable::kChannelCount; ++channel) {
+            const float* values = source.values[channel];
+            for (uint32_t segment = 0; segment < kCurveSegmentCount; ++segment) {
+                *pairs++ = values[segment];
+                *pairs++ = values[segment + 1] - values[segment];
+            }
+        }
+    };
+    float pairs[kCurveTableSize];
+
+    // 0番に全て1の表を置く（番号0の粒は表を読んでも値が変わらない）
+    if (curves_.empty()) {
+        toPairs(ParticleCurveTable::Identity(), pairs);
+        curves_.assign(pairs, pairs + kCurveTableSize);
+        curveMaxSizes_.assign(1, 1.0f);
+    }
+
+    // 同じ内容の表があればその番号（エミッタを作り直すたびに増えないように）
+    toPairs(table, pairs);
+    const uint32_t count = GetCurveTableCount();
+    for (uint32_t curve = 0; curve < count; ++curve) {
+        if (std::memcmp(curves_.data() + static_cast<size_t>(curve) * kCurveTableSize, pairs, sizeof(pairs)) == 0) {
+            return curve;
+        }
+    }
+    curves_.insert(curves_.end(), pairs, pairs + kCurveTableSize);
+    float maxSize = 0.0f;
+    for (float size : table.values[ParticleCurveTable::kSize]) {
+        maxSize = std::max(maxSize, std::abs(size));
+    }
+    curveMaxSizes_.push_back(maxSize);
+    return count;
+}
+
+bool ParticleStorage::Add(const Particle& particle) {
+    assert(particle.curve == 0 || particle.curve < GetCurveTableCount());
+    if (IsFull()) {
+        // 容量超過時の動作に従い、削除して空きを作るか追加をやめる
+        ++overflowCount_;
+        if (policy_ == OverflowPolicy::DropNew || capacity_ == 0) {
+            return false;
+        }
+        RemoveSwap(SelectVictim());
+    }
+
+    // スロットを割り当てて発生順のリストの末尾につなぐ
+    uint32_t slot = freeSlots_[--freeCount_];
+    slotOf_[count_] = slot;
+    indexOf_[slot] = count_;
+    prev_[slot] = tail_;
+    next_[slot] = kInvalidSlot;
+    if (tail_ != kInvalidSlot) {
+        next_[tail_] = slot;
+    }
+    else {
+        head_ = slot;
+    }
+    tail_ = slot;
+
+    uint32_t i = count_++;
+    GetStream(kPositionX)[i] = particle.position.x;
+    GetStream(kPositionY)[i] = particle.position.y;
+    GetStream(kPositionZ)[i] = particle.position.z;
+    GetStream(kVelocityX)[i] = particle.velocity.x;
+    GetStream(kVelocityY)[i] = particle.velocity.y;
+    GetStream(kVelocityZ)[i] = particle.velocity.z;
+    GetStream(kAccelX)[i] = particle.accel.x;
+    GetStream(kAccelY)[i] = particle.accel.y;
+    GetStream(kAccelZ)[i] = particle.accel.z;
+    GetStream(kRotation)[i] = particle.rotation;
+    GetStream(kRotationVelocity)[i] = particle.rotationVelocity;
+    // 更新を省いている間は、次の更新でまとめて進める分だけ経過時間を戻しておく
+    GetStream(kLifeTime)[i] = particle.lifeTime - deferredTime_;
+    GetStream(kLifeTimeMax)[i] = particle.lifeTimeMax;
+    GetStream(kInvLifeTimeMax)[i] = 1.0f / particle.lifeTimeMax;
+    GetStream(kSize)[i] = particle.size;
+    GetStream(kColorR)[i] = particle.color.x;
+    GetStream(kColorG)[i] = particle.color.y;
+    GetStream(kColorB)[i] = particle.color.z;
+    GetStream(kColorA)[i] = particle.color.w;
+    GetStream(kStartSize)[i] = particle.startSize;
+    GetStream(kEndSize)[i] = particle.endSize;
+    GetStream(kStartColorR)[i] = particle.startColor.x;
+    GetStream(kStartColorG)[i] = particle.startColor.y;
+    GetStream(kStartColorB)[i] = particle.startColor.z;
+    GetStream(kStartColorA)[i] = particle.startColor.w;
+    GetStream(kEndColorR)[i] = particle.endColor.x;
+    GetStream(kEndColorG)[i] = particle.endColor.y;
+    GetStream(kEndColorB)[i] = particle.endColor.z;
+    GetStream(kEndColorA)[i] = particle.endColor.w;
+    GetStream(kCurve)[i] = static_cast<float>(particle.curve);
+    GetStream(kStartPositionX)[i] = particle.position.x;
+    GetStream(kStartPositionY)[i] = particle.position.y;
+    GetStream(kStartPositionZ)[i] = particle.position.z;
+    GetStream(kStartRotation)[i] = particle.rotation;
+    if (trajectoryValid_) {
+        ExpandTrajectory(i);
+    }
+    return true;
+}
+
+Particle ParticleStorage::Get(uint32_t index) const {
+    Particle particle;
+    particle.position = { GetStream(kPositionX)[index], GetStream(kPositionY)[index], GetStream(kPositionZ)[index] };
+    particle.velocity = { GetStream(kVelocityX)[index], GetStream(kVelocityY)[index], GetStream(kVelocityZ)[index] };
+    particle.accel = { GetStream(kAccelX)[index], GetStream(kAccelY)[index], GetStream(kAccelZ)[index] };
+    particle.rotation = GetStream(kRotation)[index];
+    particle.rotationVelocity = GetStream(kRotationVelocity)[index];
+    particle.lifeTime = GetStream(kLifeTime)[index];
+    particle.lifeTimeMax = GetStream(kLifeTimeMax)[index];
+    particle.size = GetStream(kSize)[index];
+    particle.color = { GetStream(kColorR)[index], GetStream(kColorG)[index], GetStream(kColorB)[index], GetStream(kColorA)[index] };
+    particle.startSize = GetStream(kStartSize)[index];
+    particle.endSize = GetStream(kEndSize)[index];
+    particle.startColor = { GetStream(kStartColorR)[index], GetStream(kStartColorG)[index], GetStream(kStartColorB)[index], GetStream(kStartColorA)[index] };
+    particle.endColor = { GetStream(kEndColorR)[index], GetStream(kEndColorG)[index], GetStream(kEndColorB)[index], GetStream(kEndColorA)[index] };
+    particle.curve = static_cast<uint32_t>(GetStream(kCurve)[index]);
+    return particle;
+}
+
+void ParticleStorage::RemoveSwap(uint32_t index) {
+    ReleaseSlot(slotOf_[index]);
+    uint32_t last = --count_;
+    if (index != last) {
+        Move(last, index);
+    }
+}
+
+uint32_t ParticleStorage::SelectVictim() {
+    if (policy_ == OverflowPolicy::KillOldest) {
+        return indexOf_[head_];
+    }
+
+    // KillSmallest：ランダムに選んだ一定数の中で現在サイズが最小のもの
+    const float* size = GetStream(kSize);
+    uint32_t victim = 0;
+    for (uint32_t sample = 0; sample < kSmallestSampleCount; ++sample) {
+        sampleState_ ^= sampleState_ << 13;
+        sampleState_ ^= sampleState_ >> 17;
+        sampleState_ ^= sampleState_ << 5;
+        uint32_t index = sampleState_ % count_;
+        if (sample == 0 || size[index] < size[victim]) {
+            victim = index;
+        }
+    }
+    return victim;
+}
+
+void ParticleStorage::ReleaseSlot(uint32_t slot) {
+    uint32_t prev = prev_[slot];
+    uint32_t next = next_[slot];
+    if (prev != kInvalidSlot) {
+        next_[prev] = next;
+    }
+    else {
+        head_ = next;
+    }
+    if (next != kInvalidSlot) {
+        prev_[next] = prev;
+    }
+    else {
+        tail_ = prev;
+    }
+    freeSlots_[freeCount_++] = slot;
+}
+
+void ParticleStorage::Move(uint32_t from, uint32_t to) {
+    for (uint32_t stream = 0; stream < kStreamCount; ++stream) {
+        float* values = GetStream(static_cast<Stream>(stream));
+        values[to] = values[from];
+    }
+
+    // スロットの入れ替え（移動先にあった削除済みのスロットは移動元に残し、後でまとめて外す）
+    uint32_t slot = slotOf_[from];
+    slotOf_[from] = slotOf_[to];
+    slotOf_[to] = slot;
+    indexOf_[slot] = to;
+}
+
+void ParticleStorage::Swap(uint32_t a, uint32_t b) {
+    for (uint32_t stream = 0; stream < kStreamCount; ++stream) {
+        float* values = GetStream(static_cast<Stream>(stream));
+        float value = values[a];
+        values[a] = values[b];
+        values[b] = value;
+    }
+
+    uint32_t slot = slotOf_[a];
+    slotOf_[a] = slotOf_[b];
+    slotOf_[b] = slot;
+    indexOf_[slotOf_[a]] = a;
+    indexOf_[slotOf_[b]] = b;
+}
+
+void ParticleStorage::Update(float deltaTime) {
+    Update(deltaTime, GetDefaultKernel());
+}
+
+void ParticleStorage::Update(float deltaTime, Kernel kernel) {
+    // 全体を1つの範囲として更新し、削除されたもののスロットを外す
+    uint32_t alive = UpdateRange(0, count_, deltaTime, kernel);
+    CompactChunks(&alive, 1, capacity_);
+}
+
+uint32_t ParticleStorage::RemoveInRange(uint32_t index, uint32_t end) {
+    assert(index < end && end <= count_);
+    if (index != --end) {
+        Move(end, index);
+    }
+    return end;
+}
+
+uint32_t ParticleStorage::UpdateRange(uint32_t begin, uint32_t end, float deltaTime, Kernel kernel) {
+    // Deferでためた時間もまとめて進める（ためた時間は全範囲の更新後にCompactChunksで0に戻す）
+    deltaTime += deferredTime_;
+    end = RemoveExpired(begin, end, deltaTime);
+
+    // 生き残ったパーティクルの積分と補間
+    if (kernel == Kernel::Avx2 && IsAvx2Supported()) {
+        IntegrateAvx2(begin, end, deltaTime);
+    }
+    else {
+        IntegrateScalar(begin, end, deltaTime);
+    }
+    return end - begin;
+}
+
+void ParticleStorage::CompactChunks(const uint32_t* aliveCounts, uint32_t chunkCount, uint32_t chunkSize) {
+    // ためた時間は全範囲で進め終わった。軌跡の境界ボックスは死んだ粒の分を除くため次に使うときに求め直す
+    deferredTime_ = 0.0f;
+    trajectoryValid_ = false;
+
+    // 各範囲の生存分の後ろに残った、削除されたもののスロットを外す
+    uint32_t alive = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+        uint32_t chunkBegin = chunk * chunkSize;
+        uint32_t chunkEnd = std::min(chunkBegin + chunkSize, count_);
+        for (uint32_t index = chunkBegin + aliveCounts[chunk]; index < chunkEnd; ++index) {
+            ReleaseSlot(slotOf_[index]);
+        }
+        alive += aliveCounts[chunk];
+    }
+
+    // 先頭alive個の中の隙間を前から順に、alive以降にある生存分を後ろから順に移して埋める
+    // （隙間の数とalive以降の生存数は必ず一致する）
+    uint32_t sourceChunk = chunkCount;
+    uint32_t sourceEnd = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount && chunk * chunkSize < alive; ++chunk) {
+        uint32_t chunkBegin = chunk * chunkSize;
+        uint32_t gapEnd = std::min(std::min(chunkBegin + chunkSize, count_), alive);
+        for (uint32_t gap = chunkBegin + aliveCounts[chunk]; gap < gapEnd; ++gap) {
+            // 取り出す範囲の生存分を使い切ったら1つ前の範囲へ
+            while (sourceEnd <= sourceChunk * chunkSize) {
+                --sourceChunk;
+                sourceEnd = sourceChunk * chunkSize + aliveCounts[sourceChunk];
+            }
+            Move(--sourceEnd, gap);
+        }
+    }
+    count_ = alive;
+}
+
+uint32_t ParticleStorage::RemoveExpired(uint32_t begin, uint32_t end, float deltaTime) {
+    // 経過時間だけを読み書きし、尽きたものは範囲の末尾と入れ替えて削除
+    // （上書きせず入れ替えるので、削除したものの属性はCompactChunksまで範囲の末尾で読める）
+    float* lifeTime = GetStream(kLifeTime);
+    const float* lifeTimeMax = GetStream(kLifeTimeMax);
+    for (uint32_t i = begin; i < end; ) {
+        lifeTime[i] += deltaTime;
+        if (lifeTime[i] >= lifeTimeMax[i]) {
+            // 移動してきた末尾の要素は同じ位置でもう一度処理する
+            if (i != --end) {
+                Swap(end, i);
+            }
+            continue;
+        }
+        ++i;
+    }
+    return end;
+}
+
+void ParticleStorage::IntegrateScalar(uint32_t begin, uint32_t end, float deltaTime) {
+    // 属性ごとの小さなループに分け、コンパイラが配列の重なりを確認しやすくして自動ベクトル化させる
+    if (end <= begin) {
+        return;
+    }
+    const uint32_t count = end - begin;
+    if (simulation_ == Simulation::Analytic) {
+        // 発生時の状態と経過時間から求める（速度の配列は発生時の速度）
+        const float* age = GetStream(kLifeTime) + begin;
+        Evaluate(GetStream(kPositionX) + begin, GetStream(kStartPositionX) + begin, GetStream(kVelocityX) + begin, GetStream(kAccelX) + begin, age, count);
+        Evaluate(GetStream(kPositionY) + begin, GetStream(kStartPositionY) + begin, GetStream(kVelocityY) + begin, GetStream(kAccelY) + begin, age, count);
+        Evaluate(GetStream(kPositionZ) + begin, GetStream(kStartPositionZ) + begin, GetStream(kVelocityZ) + begin, GetStream(kAccelZ) + begin, age, count);
+        EvaluateLinear(GetStream(kRotation) + begin, GetStream(kStartRotation) + begin, GetStream(kRotationVelocity) + begin, age, count);
+    }
+    else {
+        Integrate(GetStream(kVelocityX) + begin, GetStream(kPositionX) + begin, GetStream(kAccelX) + begin, count, deltaTime);
+        Integrate(GetStream(kVelocityY) + begin, GetStream(kPositionY) + begin, GetStream(kAccelY) + begin, count, deltaTime);
+        Integrate(GetStream(kVelocityZ) + begin, GetStream(kPositionZ) + begin, GetStream(kAccelZ) + begin, count, deltaTime);
+        Advance(GetStream(kRotation) + begin, GetStream(kRotationVelocity) + begin, count, deltaTime);
+    }
+
+    // 線形補間の係数（寿命に対する経過時間の割合）は発生時に求めた逆数で一度だけ求めて使い回す
+    float* t = scratch_.data() + begin;
+    Scale(t, GetStream(kLifeTime) + begin, GetStream(kInvLifeTimeMax) + begin, count);
+    Lerp(GetStream(kSize) + begin, GetStream(kStartSize) + begin, GetStream(kEndSize) + begin, t, count);
+    for (uint32_t channel = 0; channel < 4; ++channel) {
+        Lerp(GetStream(static_cast<Stream>(kColorR + channel)) + begin,
+            GetStream(static_cast<Stream>(kStartColorR + channel)) + begin,
+            GetStream(static_cast<Stream>(kEndColorR + channel)) + begin, t, count);
+    }
+
+    // 寿命に対する変化の表があれば補間結果に掛ける
+    if (!curves_.empty()) {
+        float* outputs[ParticleCurveTable::kChannelCount] = {
+            GetStream(kSize) + begin,
+            GetStream(kColorR) + begin, GetStream(kColorG) + begin, GetStream(kColorB) + begin, GetStream(kColorA) + begin };
+        ApplyCurves(outputs, curves_.data(), GetStream(kCurve) + begin, t, count);
+    }
+}
+
+#ifdef PARTICLE_STORAGE_AVX2
+PARTICLE_AVX2_FUNCTION void ParticleStorage::IntegrateAvx2(uint32_t begin, uint32_t end, float deltaTime) {
+    float* positionX = GetStream(kPositionX);
+    float* positionY = GetStream(kPositionY);
+    float* positionZ = GetStream(kPositionZ);
+    float* velocityX = GetStream(kVelocityX);
+    float* velocityY = GetStream(kVelocityY);
+    float* velocityZ = GetStream(kVelocityZ);
+    const float* accelX = GetStream(kAccelX);
+    const float* accelY = GetStream(kAccelY);
+    const float* accelZ = GetStream(kAccelZ);
+    float* rotation = GetStream(kRotation);
+    const float* rotationVelocity = GetStream(kRotationVelocity);
+    const float* lifeTime = GetStream(kLifeTime);
+    const float* invLifeTimeMax = GetStream(kInvLifeTimeMax);
+    float* size = GetStream(kSize);
+    const float* startSize = GetStream(kStartSize);
+    const float* endSize = GetStream(kEndSize);
+    float* color[4];
+    const float* startColor[4];
+    const float* endColor[4];
+    for (uint32_t channel = 0; channel < 4; ++channel) {
+        color[channel] = GetStream(static_cast<Stream>(kColorR + channel));
+        startColor[channel] = GetStream(static_cast<Stream>(kStartColorR + channel));
+        endColor[channel] = GetStream(static_cast<Stream>(kEndColorR + channel));
+    }
+    const float* curve = GetStream(kCurve);
+    const float* curves = curves_.empty() ? nullptr : curves_.data();
+    const bool analytic = simulation_ == Simulation::Analytic;
+    const float* startPositionX = GetStream(kStartPositionX);
+    const float* startPositionY = GetStream(kStartPositionY);
+    const float* startPositionZ = GetStream(kStartPositionZ);
+    const float* startRotation = GetStream(kStartRotation);
+
+    // 8粒単位で処理し、端数は1粒ずつ処理する（範囲外には書き込まない）
+    const uint32_t blockEnd = begin + (end - begin) / kLaneCount * kLaneCount;
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 last = _mm256_set1_ps(static_cast<float>(kCurveSegmentCount));
+    const __m256i lastSegment = _mm256_set1_epi32(kCurveSegmentCount - 1);
+    const __m256i tablePairs = _mm256_set1_epi32(kCurveTableSize / 2);
+    const __m256i pairOrder = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+    for (uint32_t i = begin; i < blockEnd; i += kLaneCount) {
+        if (analytic) {
+            // 発生時の状態と経過時間から求める（p = p0 + t * (v0 + a * t / 2)、速度の配列は読むだけ）
+            __m256 age = _mm256_loadu_ps(lifeTime + i);
+            __m256 halfAge = _mm256_mul_ps(age, half);
+            _mm256_storeu_ps(positionX + i, _mm256_fmadd_ps(age, _mm256_fmadd_ps(_mm256_loadu_ps(accelX + i), halfAge, _mm256_loadu_ps(velocityX + i)), _mm256_loadu_ps(startPositionX + i)));
+            _mm256_storeu_ps(positionY + i, _mm256_fmadd_ps(age, _mm256_fmadd_ps(_mm256_loadu_ps(accelY + i), halfAge, _mm256_loadu_ps(velocityY + i)), _mm256_loadu_ps(startPositionY + i)));
+            _mm256_storeu_ps(positionZ + i, _mm256_fmadd_ps(age, _mm256_fmadd_ps(_mm256_loadu_ps(accelZ + i), halfAge, _mm256_loadu_ps(velocityZ + i)), _mm256_loadu_ps(startPositionZ + i)));
+            _mm256_storeu_ps(rotation + i, _mm256_fmadd_ps(_mm256_loadu_ps(rotationVelocity + i), age, _mm256_loadu_ps(startRotation + i)));
+        }
+        else {
+            // 速度に加速度を、位置に速度を加算（v = a * dt + v、p = v * dt + p）
+            __m256 vx = _mm256_fmadd_ps(_mm256_loadu_ps(accelX + i), dt, _mm256_loadu_ps(velocityX + i));
+            __m256 vy = _mm256_fmadd_ps(_mm256_loadu_ps(accelY + i), dt, _mm256_loadu_ps(velocityY + i));
+            __m256 vz = _mm256_fmadd_ps(_mm256_loadu_ps(accelZ + i), dt, _mm256_loadu_ps(velocityZ + i));
+            _mm256_storeu_ps(velocityX + i, vx);
+            _mm256_storeu_ps(velocityY + i, vy);
+            _mm256_storeu_ps(velocityZ + i, vz);
+            _mm256_storeu_ps(positionX + i, _mm256_fmadd_ps(vx, dt, _mm256_loadu_ps(positionX + i)));
+            _mm256_storeu_ps(positionY + i, _mm256_fmadd_ps(vy, dt, _mm256_loadu_ps(positionY + i)));
+            _mm256_storeu_ps(positionZ + i, _mm256_fmadd_ps(vz, dt, _mm256_loadu_ps(positionZ + i)));
+
+            // 回転を更新
+            _mm256_storeu_ps(rotation + i, _mm256_fmadd_ps(_mm256_loadu_ps(rotationVelocity + i), dt, _mm256_loadu_ps(rotation + i)));
+        }
+
+        // 寿命の逆数を掛けて補間係数を求める
+        __m256 t = _mm256_mul_ps(_mm256_loadu_ps(lifeTime + i), _mm256_loadu_ps(invLifeTimeMax + i));
+
+        // 寿命に対する変化の表があれば、粒ごとの表の区間をgatherで読んで補間する
+        __m256 scale[ParticleCurveTable::kChannelCount] = { one, one, one, one, one };
+        if (curves) {
+            __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(t, last), _mm256_setzero_ps()), last);
+            __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(x), lastSegment);
+            __m256 fraction = _mm256_sub_ps(x, _mm256_cvtepi32_ps(index));
+            index = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(_mm256_loadu_ps(curve + i)), tablePairs), index);
+            index = _mm256_permutevar8x32_epi32(index, pairOrder);
+            for (uint32_t channel = 0; channel < ParticleCurveTable::kChannelCount; ++channel) {
+                scale[channel] = SampleCurveAvx2(curves + channel * kCurveSegmentCount * 2, index, fraction);
+            }
+        }
+
+        // サイズと色を補間して表の値を掛ける
+        LerpAvx2(size, startSize, endSize, t, scale[ParticleCurveTable::kSize], i);
+        LerpAvx2(color[0], startColor[0], endColor[0], t, scale[ParticleCurveTable::kColorR], i);
+        LerpAvx2(color[1], startColor[1], endColor[1], t, scale[ParticleCurveTable::kColorG], i);
+        LerpAvx2(color[2], startColor[2], endColor[2], t, scale[ParticleCurveTable::kColorB], i);
+        LerpAvx2(color[3], startColor[3], endColor[3], t, scale[ParticleCurveTable::kColorA], i);
+    }
+    IntegrateScalar(blockEnd, end, deltaTime);
+}
+#else
+void ParticleStorage::IntegrateAvx2(uint32_t begin, uint32_t end, float deltaTime) {
+    IntegrateScalar(begin, end, deltaTime);
+}
+#endif
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "ParticleCurve.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// パーティクル1粒の情報（発生時の設定や1粒単位の読み書きに使う）
+struct Particle {
+    // 座標
+    Vector3 position;
+    // 速度
+    Vector3 velocity;
+    // 加速度
+    Vector3 accel;
+    // 色
+    Vector4 color;
+    // 初期サイズ
+    float startSize;
+    // 最終サイズ
+    float endSize;
+    // 現在サイズ
+    float size;
+    // 初期色
+    Vector4 startColor;
+    // 最終色
+    Vector4 endColor;
+    // 回転
+    float rotation;
+    // 回転速度
+    float rotationVelocity;
+    // 経過時間
+    float lifeTime;
+    // 寿命
+    float lifeTimeMax;
+    // 寿命に対する変化の表の番号（ParticleStorage::AddCurveTableの戻り値、0なら表なし）
+    uint32_t curve = 0;
+
+    // 生存フラグ
+    bool isDead = false;
+};
+
+// パーティクルの属性ごとの連続配列（SoA）
+// 属性ごとに別々の配列に格納し、更新では必要な配列だけを先頭から順に読み書きする
+// 容量はReserveで一度だけ確保し、死んだパーティクルは末尾の要素と入れ替えて削除する（並び順は保たれない）
+// 発生順は配列とは別に、粒ごとの番号（スロット）の双方向リストで保持する
+// 動きは毎フレームの積分（Integrate）か、発生時の状態と経過時間からの計算（Analytic）で求める
+class ParticleStorage {
+public:
+    // 属性の配列
+    enum Stream : uint32_t {
+        // 毎フレーム読み書きする属性
+        kPositionX, kPositionY, kPositionZ,
+        kVelocityX, kVelocityY, kVelocityZ,
+        kAccelX, kAccelY, kAccelZ,
+        kRotation, kRotationVelocity,
+        kLifeTime, kLifeTimeMax,
+        kSize, kColorR, kColorG, kColorB, kColorA,
+        // 補間の始点・終点など（読み取りのみ）
+        kInvLifeTimeMax,
+        kStartSize, kEndSize,
+        kStartColorR, kStartColorG, kStartColorB, kStartColorA,
+        kEndColorR, kEndColorG, kEndColorB, kEndColorA,
+        kCurve, // 寿命に対する変化の表の番号（整数をfloatで保持）
+        // 発生時の座標・回転（Analyticのみ使う、速度の配列は発生時の速度のまま変わらない）
+        kStartPositionX, kStartPositionY, kStartPositionZ,
+        kStartRotation,
+        kStreamCount
+    };
+
+    // 容量の切り上げ単位（SIMDでまとめて処理できるよう各配列の長さをこの倍数にする）
+    static constexpr uint32_t kLaneCount = 8;
+
+    // 積分・補間の処理方式
+    enum class Kernel {
+        Scalar, // 1粒ずつ処理する（比較の基準）
+        Avx2,   // AVX2とFMAで8粒ずつ処理する
+    };
+
+    // 容量を超えて追加しようとしたときの動作
+    enum class OverflowPolicy {
+        DropNew,      // 追加しない
+        KillOldest,   // 最も古いものを削除して追加する
+        KillSmallest, // 小さいものを削除して追加する（ランダムに選んだkSmallestSampleCount個の中で最小のもの）
+    };
+
+    // KillSmallestで比較する数（全体を探さず一定数だけ調べる）
+    static constexpr uint32_t kSmallestSampleCount = 8;
+
+    // 動きの求め方
+    enum class Simulation {
+        Integrate, // 毎フレーム速度に加速度を、位置に速度を加算する（半陰的オイラー法）
+        Analytic,  // 発生時の状態と経過時間tから p = p0 + v0 * t + a * t^2 / 2 で求める（積分の誤差がたまらない）
+    };
+
+    // AVX2とFMAが使えるCPUかどうか
+    static bool IsAvx2Supported();
+    // このCPUで最も速い処理方式
+    static Kernel GetDefaultKernel() { return IsAvx2Supported() ? Kernel::Avx2 : Kernel::Scalar; }
+
+    // 容量の確保（既存のパーティクルは破棄される）
+    // 以降の追加・削除・更新では確保しない
+    void Reserve(uint32_t capacity, OverflowPolicy policy = OverflowPolicy::DropNew);
+
+    // パーティクル数・容量
+    uint32_t GetCount() const { return count_; }
+    uint32_t GetCapacity() const { return capacity_; }
+    bool Empty() const { return count_ == 0; }
+    bool IsFull() const { return count_ >= capacity_; }
+
+    // 容量超過時の動作
+    OverflowPolicy GetOverflowPolicy() const { return policy_; }
+    void SetOverflowPolicy(OverflowPolicy policy) { policy_ = policy; }
+
+    // 容量超過で追加しなかった数・削除した数（Reserveからの合計）
+    uint64_t GetOverflowCount() const { return overflowCount_; }
+
+    // 動きの求め方（空のときのみ変更できる、Reserveでは変わらない）
+    Simulation GetSimulation() const { return simulation_; }
+    void SetSimulation(Simulation simulation);
+
+    // 更新を省き、経過時間だけをためる（Analyticのみ）
+    // 次の更新でためた時間をまとめて進める。各粒は経過時間だけで決まるので、毎フレーム更新した場合と同じ状態になる
+    // ためている間に追加した粒は、まとめて進める分だけ経過時間を戻して保存する
+    void Defer(float deltaTime);
+    // ためている時間
+    float GetDeferredTime() const { return deferredTime_; }
+
+    // 全粒の寿命が尽きるまでの中心の軌跡を囲む境界ボックスと、その間の最大サイズ（Analyticのみ）
+    // 初回は全粒から求め、以降は追加した粒の分だけ広げる（更新後の最初の呼び出しで求め直す）
+    // 粒は軌跡から外れないので、求めた後に更新・削除しても結果は全粒を囲んだまま
+    void GetTrajectoryBounds(Vector3& min, Vector3& max, float& maxSize);
+
+    // 追加（容量が足りなければ容量超過時の動作に従い、追加しなかった場合はfalse）
+    // Analyticでは座標・速度・回転を発生時（経過時間0）の状態として扱う
+    bool Add(const Particle& particle);
+
+    // 寿命に対する変化の表の登録（同じ内容の表が登録済みならその番号を返す）
+    // 戻り値をParticle::curveに指定すると、更新でサイズと色の補間結果に表の値を掛ける
+    // 0番は全て1の表で、最初の登録時に作る（表が1つもなければ更新で表を読まない）
+    // Reserveでは消えない。更新中に呼ばないこと
+    uint32_t AddCurveTable(const ParticleCurveTable& table);
+    // 登録済みの表の数（0番を含む）
+    uint32_t GetCurveTableCount() const { return static_cast<uint32_t>(curves_.size() / kCurveTableSize); }
+
+    // 最も古いパーティクルの番号（空なら0）
+    uint32_t GetOldestIndex() const { return count_ > 0 ? indexOf_[head_] : 0; }
+
+    // 配列の番号ごとのスロット（粒が生きている間は移動しても変わらない番号、GetCount個が有効）
+    const uint32_t* GetSlots() const { return slotOf_.data(); }
+
+    // 1粒分の読み出し
+    Particle Get(uint32_t index) const;
+
+    // 削除（末尾の要素を移動して詰める）
+    void RemoveSwap(uint32_t index);
+    // UpdateRangeの後の範囲[.., end)からの削除（範囲の末尾と入れ替え、新しい終端を返す）
+    // 寿命で削除したものと同様に、スロットはCompactChunksで外す
+    uint32_t RemoveInRange(uint32_t index, uint32_t end);
+
+    // 全削除（容量は維持する）
+    void Clear();
+
+    // 属性の配列の先頭（GetCount個が有効、GetCapacity個まで書き込める）
+    float* GetStream(Stream stream) { return data_.data() + static_cast<size_t>(stream) * stride_; }
+    const float* GetStream(Stream stream) const { return data_.data() + static_cast<size_t>(stream) * stride_; }
+
+    // 更新（経過時間を進めて寿命が尽きたものを削除し、残りを積分・補間する）
+    // Analyticでは積分せず、発生時の状態と経過時間から座標と回転を求める
+    // 処理方式を省略した場合はCPUが対応していればAVX2を使う
+    void Update(float deltaTime);
+    void Update(float deltaTime, Kernel kernel);
+
+    // 範囲[begin, end)だけの更新（複数スレッドで別々の範囲を同時に更新できる）
+    // 寿命が尽きたものは範囲の末尾と入れ替え、生き残った数を返す（[begin, begin + 戻り値)が生存）
+    // [begin + 戻り値, end)には寿命が尽きたものが積分前の属性のまま残る（CompactChunksまで読める）
+    // パーティクル数は変わらないので、全範囲の更新後にCompactChunksで詰める
+    uint32_t UpdateRange(uint32_t begin, uint32_t end, float deltaTime, Kernel kernel);
+
+    // chunkSize個ずつに区切った範囲をUpdateRangeで更新した後、範囲ごとの隙間を詰める
+    // 後ろの範囲の生存分で前の隙間を埋めるので、移動するのは削除された数以下で済む
+    // 削除されたもののスロットもここで発生順のリストから外す
+    void CompactChunks(const uint32_t* aliveCounts, uint32_t chunkCount, uint32_t chunkSize);
+
+private:
+    // リストの終端を表すスロット番号
+    static constexpr uint32_t kInvalidSlot = 0xFFFFFFFF;
+
+    // 表1チャンネルの区間数と、表1つ分の要素数（区間ごとに始点の値と終点との差の2つ）
+    static constexpr uint32_t kCurveSegmentCount = ParticleCurveTable::kResolution - 1;
+    static constexpr uint32_t kCurveTableSize = ParticleCurveTable::kChannelCount * kCurveSegmentCount * 2;
+
+    // 全属性の配列（属性ごとにstride_個ずつ連続して並ぶ）
+    std::vector<float> data_;
+    // 更新中の一時配列（補間係数、範囲ごとに同じ位置を使うので複数スレッドでも重ならない）
+    std::vector<float> scratch_;
+    // 容量（パーティクル数の上限）
+    uint32_t capacity_ = 0;
+    // 属性ごとの配列の長さ（容量をkLaneCountの倍数に切り上げたもの）
+    uint32_t stride_ = 0;
+    // パーティクル数
+    uint32_t count_ = 0;
+
+    // 容量超過時の動作
+    OverflowPolicy policy_ = OverflowPolicy::DropNew;
+    // 容量超過で追加しなかった数・削除した数
+    uint64_t overflowCount_ = 0;
+    // KillSmallestで調べる番号を選ぶ乱数の状態（xorshift32）
+    uint32_t sampleState_ = 0x9E3779B9u;
+
+    // 動きの求め方
+    Simulation simulation_ = Simulation::Integrate;
+    // Deferでためている時間
+    float deferredTime_ = 0.0f;
+    // 軌跡の境界ボックス（trajectoryValid_がfalseなら次のGetTrajectoryBoundsで求め直す）
+    Vector3 trajectoryMin_ = {};
+    Vector3 trajectoryMax_ = {};
+    float trajectoryMaxSize_ = 0.0f;
+    bool trajectoryValid_ = false;
+
+    // 寿命に対する変化の表（表ごとにkCurveTableSize個ずつ、表の中はチャンネルごとに区間の数だけ並ぶ）
+    // 区間ごとに（始点の値, 終点との差）の組で持ち、AVX2では1粒分の組を64ビットのgather1要素で読む
+    std::vector<float> curves_;
+    // 表ごとのサイズの倍率の最大値（絶対値、軌跡の境界ボックス用）
+    std::vector<float> curveMaxSizes_;
+
+    // 配列の番号ごとのスロット（[count_, 範囲の終端)には削除されたもののスロットが残る）
+    std::vector<uint32_t> slotOf_;
+    // スロットごとの配列の番号
+    std::vector<uint32_t> indexOf_;
+    // 発生順の双方向リスト（head_が最も古く、tail_が最も新しい）
+    std::vector<uint32_t> prev_;
+    std::vector<uint32_t> next_;
+    uint32_t head_ = kInvalidSlot;
+    uint32_t tail_ = kInvalidSlot;
+    // 未使用のスロット（スタック）
+    std::vector<uint32_t> freeSlots_;
+    uint32_t freeCount_ = 0;
+
+    // 容量超過時に削除するパーティクルの番号
+    uint32_t SelectVictim();
+    // スロットを発生順のリストから外して未使用に戻す
+    void ReleaseSlot(uint32_t slot);
+
+    // 1粒分の全属性のコピー（スロットは入れ替え、移動先にあったスロットを移動元に残す）
+    void Move(uint32_t from, uint32_t to);
+    // 2粒分の全属性とスロットの入れ替え
+    void Swap(uint32_t a, uint32_t b);
+    // 範囲内の寿命の尽きたものを範囲の末尾と入れ替えて削除し、新しい終端を返す
+    uint32_t RemoveExpired(uint32_t begin, uint32_t end, float deltaTime);
+    // 軌跡の境界ボックスをindex番目の粒の分だけ広げる
+    void ExpandTrajectory(uint32_t index);
+    // 範囲[begin, end)の積分（Analyticでは経過時間からの計算）・補間
+    void IntegrateScalar(uint32_t begin, uint32_t end, float deltaTime);
+    void IntegrateAvx2(uint32_t begin, uint32_t end, float deltaTime);
+};
@@ -0,0 +1,81 @@
+#include "ParticleSubEmitter.h"
+#include <algorithm>
+
+void AppendDeathEvents(const ParticleStorage& particles, uint32_t begin, uint32_t end, std::vector<ParticleEvent>& events) {
+    const bool analytic = particles.GetSimulation() == ParticleStorage::Simulation::Analytic;
+    const float* x = particles.GetStream(ParticleStorage::kPositionX);
+    const float* y = particles.GetStream(ParticleStorage::kPositionY);
+    const float* z = particles.GetStream(ParticleStorage::kPositionZ);
+    const float* vx = particles.GetStream(ParticleStorage::kVelocityX);
+    const float* vy = particles.GetStream(ParticleStorage::kVelocityY);
+    const float* vz = particles.GetStream(ParticleStorage::kVelocityZ);
+    const float* ax = particles.GetStream(ParticleStorage::kAccelX);
+    const float* ay = particles.GetStream(ParticleStorage::kAccelY);
+    const float* az = particles.GetStream(ParticleStorage::kAccelZ);
+    const float* age = particles.GetStream(ParticleStorage::kLifeTime);
+    for (uint32_t i = begin; i < end; ++i) {
+        // 座標は最後に描画した位置、Analyticでは速度の配列が発生時の速度なので経過時間分の加速度を足す
+        float t = analytic ? age[i] : 0.0f;
+        events.push_back({ { x[i], y[i], z[i] }, { vx[i] + ax[i] * t, vy[i] + ay[i] * t, vz[i] + az[i] * t }, ParticleEventType::Death });
+    }
+}
+
+uint32_t SpawnParticles(ParticleStorage& particles, const ParticleEvent* events, uint32_t eventCount, uint32_t countPerEvent,
+    float inheritVelocity, const EmitterDesc& desc, ParticleRandom& random) {
+    // kParticleSpawnBlockSize個ずつ、属性ごとにまとめて乱数を作ってからパーティクルを追加する
+    // 出来事をまたいで同じブロックに詰めるので、出来事ごとの発生数が少なくても乱数はまとめて作れる
+    const uint32_t count = eventCount * countPerEvent;
+    float values[EmitterDesc::kAttributeCount][kParticleSpawnBlockSize];
+    for (uint32_t begin = 0; begin < count; begin += kParticleSpawnBlockSize) {
+        uint32_t blockCount = std::min(count - begin, kParticleSpawnBlockSize);
+        for (uint32_t attribute = 0; attribute < EmitterDesc::kAttributeCount; ++attribute) {
+            random.Fill(values[attribute], blockCount, desc.minimum[attribute], desc.maximum[attribute]);
+        }
+
+        for (uint32_t i = 0; i < blockCount; ++i) {
+            const ParticleEvent& event = events[(begin + i) / countPerEvent];
+            Particle particle;
+
+            // 座標
+            particle.position = event.position;
+
+            // 速度（ランダム、元の粒の速度を引き継ぐ分を足す）・加速度（ランダム）
+            particle.velocity = {
+                values[EmitterDesc::kVelocityX][i] + event.velocity.x * inheritVelocity,
+                values[EmitterDesc::kVelocityY][i] + event.velocity.y * inheritVelocity,
+                values[EmitterDesc::kVelocityZ][i] + event.velocity.z * inheritVelocity };
+            particle.accel = { values[EmitterDesc::kAccelX][i], values[EmitterDesc::kAccelY][i], values[EmitterDesc::kAccelZ][i] };
+
+            // サイズ（ランダム）
+            particle.startSize = values[EmitterDesc::kStartSize][i];
+            particle.endSize = values[EmitterDesc::kEndSize][i];
+            particle.size = particle.startSize;
+
+            // 色（ランダム）
+            particle.startColor = {
+                values[EmitterDesc::kStartColorR][i], values[EmitterDesc::kStartColorG][i],
+                values[EmitterDesc::kStartColorB][i], values[EmitterDesc::kStartColorA][i] };
+            particle.endColor = {
+                values[EmitterDesc::kEndColorR][i], values[EmitterDesc::kEndColorG][i],
+                values[EmitterDesc::kEndColorB][i], values[EmitterDesc::kEndColorA][i] };
+            particle.color = particle.startColor;
+
+            // 回転（ランダム）
+            particle.rotation = values[EmitterDesc::kRotation][i];
+            particle.rotationVelocity = values[EmitterDesc::kRotationVelocity][i];
+
+            // 寿命（ランダム）
+            particle.lifeTimeMax = values[EmitterDesc::kLifeTime][i];
+            particle.lifeTime = 0.0f;
+
+            // 寿命に対する変化の表
+            particle.curve = desc.lifetimeCurve;
+
+            // パーティクルの配列に追加（最大数に達していればグループの容量超過時の動作に従う）
+            if (!particles.Add(particle)) {
+                return begin + i;
+            }
+        }
+    }
+    return count;
+}
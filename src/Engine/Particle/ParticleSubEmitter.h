@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EmitterDesc.h"
+#include "ParticleRandom.h"
+#include "ParticleStorage.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+// 発生時にまとめて乱数を作るパーティクル数
+constexpr uint32_t kParticleSpawnBlockSize = 64;
+
+// サブエミッターを発生させるきっかけ
+enum class ParticleEventType : uint32_t {
+    Death,     // 寿命が尽きた（衝突で削除した粒は含まない）
+    Collision, // 平面・衝突形状に当たった（BounceとKillの両方）
+};
+
+// 粒に起きた出来事
+// 更新中はチャンクごとのバッファに追加するだけにし、全グループの更新後にまとめてサブエミッターを発生させる
+struct ParticleEvent {
+    // 出来事が起きた座標（衝突のBounceでは押し戻した後の座標）
+    Vector3 position;
+    // その時点の粒の速度（衝突のBounceでは反射した後の速度）
+    Vector3 velocity;
+    // きっかけ
+    ParticleEventType type;
+};
+
+// サブエミッター（出来事の起きた位置から別のグループに発生させる）
+struct ParticleSubEmitterDesc {
+    // きっかけ
+    ParticleEventType trigger = ParticleEventType::Death;
+    // 発生先のグループ（同じグループでもよい）
+    ParticleGroupHandle target = kInvalidParticleGroup;
+    // 1回の出来事で発生させる数
+    uint32_t count = 1;
+    // 発生時の設定（EmitterDesc::lifetimeCurveは発生先のグループに登録したもの）
+    EmitterDesc emitter;
+    // 元の粒の速度を引き継ぐ割合（発生時の速度の乱数に足す、0なら引き継がない）
+    float inheritVelocity = 0.0f;
+};
+
+// 寿命が尽きた粒の出来事をeventsに追加する
+// [begin, end)はParticleStorage::UpdateRangeで範囲の末尾に残った、寿命が尽きた粒
+void AppendDeathEvents(const ParticleStorage& particles, uint32_t begin, uint32_t end, std::vector<ParticleEvent>& events);
+
+// 出来事ごとにcountPerEvent個ずつ、全出来事の分をまとめて発生させ、追加した数を返す
+// 属性ごとにkParticleSpawnBlockSize個ずつまとめて乱数を作る（ParticleManager::Emitは速度0の出来事1つとして呼ぶ）
+// 最大数に達していればparticlesの容量超過時の動作に従い、追加できなくなった時点で止める
+uint32_t SpawnParticles(ParticleStorage& particles, const ParticleEvent* events, uint32_t eventCount, uint32_t countPerEvent,
+    float inheritVelocity, const EmitterDesc& desc, ParticleRandom& random);
@@ -0,0 +1,193 @@
+#include "ParticleUpdater.h"
+#include <algorithm>
+
+namespace {
+    // ワーカー数の決定（0ならハードウェアのスレッド数）
+    uint32_t ResolveWorkerCount(uint32_t workerCount) {
+        if (workerCount == 0) {
+            workerCount = std::thread::hardware_concurrency();
+        }
+        return std::max(1u, workerCount);
+    }
+}
+
+ParticleUpdater::ParticleUpdater(uint32_t workerCount)
+    : workerCount_(ResolveWorkerCount(workerCount)) {
+    StartWorkers();
+}
+
+ParticleUpdater::~ParticleUpdater() {
+    StopWorkers();
+}
+
+void ParticleUpdater::SetWorkerCount(uint32_t workerCount) {
+    workerCount = ResolveWorkerCount(workerCount);
+    if (workerCount == workerCount_) {
+        return;
+    }
+    StopWorkers();
+    workerCount_ = workerCount;
+    StartWorkers();
+}
+
+void ParticleUpdater::Update(const std::vector<ParticleStorage*>& groups, float deltaTime, const WriteFunction& write) {
+    Update(groups, deltaTime, nullptr, write);
+}
+
+void ParticleUpdater::Update(const std::vector<ParticleStorage*>& groups, float deltaTime, const SelectFunction& select, const WriteFunction& write) {
+    Update(groups, deltaTime, nullptr, select, write);
+}
+
+void ParticleUpdater::Update(const std::vector<ParticleStorage*>& groups, float deltaTime,
+    const ResolveFunction& resolve, const SelectFunction& select, const WriteFunction& write) {
+    // 全グループをチャンクに分割
+    chunks_.clear();
+    groupChunks_.clear();
+    for (uint32_t group = 0; group < groups.size(); ++group) {
+        groupChunks_.push_back(static_cast<uint32_t>(chunks_.size()));
+        uint32_t count = groups[group]->GetCount();
+        for (uint32_t begin = 0; begin < count; begin += kChunkSize) {
+            chunks_.push_back({ group, begin, std::min(begin + kChunkSize, count), 0 });
+        }
+    }
+    groupChunks_.push_back(static_cast<uint32_t>(chunks_.size()));
+    aliveCounts_.assign(chunks_.size(), 0);
+    selectCounts_.assign(chunks_.size(), 0);
+    writeCounts_.assign(groups.size(), 0);
+
+    // 1. チャンクごとの更新（各チャンクは自分の範囲だけを読み書きする）
+    // 後処理と選別は更新直後のキャッシュに載っている間に続けて行う
+    const ParticleStorage::Kernel kernel = ParticleStorage::GetDefaultKernel();
+    ParallelFor(static_cast<uint32_t>(chunks_.size()), [&](uint32_t index) {
+        const Chunk& chunk = chunks_[index];
+        ParticleStorage& storage = *groups[chunk.group];
+        uint32_t alive = storage.UpdateRange(chunk.begin, chunk.end, deltaTime, kernel);
+        if (resolve) {
+            alive = resolve(chunk.group, storage, chunk.begin, alive, chunk.end);
+        }
+        aliveCounts_[index] = alive;
+        selectCounts_[index] = select ? select(chunk.group, storage, chunk.begin, alive) : alive;
+    });
+
+    // 2. グループごとに書き込む数の累積和を取り、書き込み先を決める
+    for (uint32_t group = 0; group < groups.size(); ++group) {
+        uint32_t offset = 0;
+        for (uint32_t index = groupChunks_[group]; index < groupChunks_[group + 1]; ++index) {
+            chunks_[index].offset = offset;
+            offset += selectCounts_[index];
+        }
+        writeCounts_[group] = offset;
+    }
+
+    // 3. インスタンスデータの書き込み（書き込み先の区間はチャンクごとに重ならない）
+    if (write) {
+        ParallelFor(static_cast<uint32_t>(chunks_.size()), [&](uint32_t index) {
+            const Chunk& chunk = chunks_[index];
+            if (selectCounts_[index] > 0) {
+                write(chunk.group, *groups[chunk.group], chunk.begin, selectCounts_[index], chunk.offset);
+            }
+        });
+    }
+
+    // 4. チャンク間の隙間を詰める（書き込み後なので、インスタンス配列と並び順が変わっても問題ない）
+    for (uint32_t group = 0; group < groups.size(); ++group) {
+        uint32_t first = groupChunks_[group];
+        uint32_t chunkCount = groupChunks_[group + 1] - first;
+        if (chunkCount > 0) {
+            groups[group]->CompactChunks(aliveCounts_.data() + first, chunkCount, kChunkSize);
+        }
+    }
+}
+
+void ParticleUpdater::StartWorkers() {
+    // 起こした回数はワーカーを作り直しても戻さないので、作成時点の値から数えさせる
+    // （0から数えると処理がないのに起き、スレッド側で読むと作成直後の処理を見逃して終わらなくなる）
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+        generation = generation_;
+    }
+    threads_.reserve(workerCount_ - 1);
+    for (uint32_t i = 1; i < workerCount_; ++i) {
+        threads_.emplace_back([this, generation]() { WorkerLoop(generation); });
+    }
+}
+
+void ParticleUpdater::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+}
+
+void ParticleUpdater::WorkerLoop(uint64_t generation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wakeCondition_.wait(lock, [&]() { return stopping_ || generation_ != generation; });
+        if (stopping_) {
+            return;
+        }
+        generation = generation_;
+
+        // 実行する処理はロック中に受け取る（処理がなければ何もせず、終了数にも数えない）
+        const std::function<void(uint32_t)>* job = job_;
+        const uint32_t jobCount = jobCount_;
+        if (!job) {
+            continue;
+        }
+
+        lock.unlock();
+        RunJobs(job, jobCount);
+        lock.lock();
+
+        // 最後に終えたワーカーが呼び出し元を起こす
+        if (--runningWorkers_ == 0) {
+            doneCondition_.notify_one();
+        }
+    }
+}
+
+void ParticleUpdater::RunJobs(const std::function<void(uint32_t)>* job, uint32_t jobCount) {
+    if (!job) {
+        return;
+    }
+
+    // 各スレッドは次のチャンク番号をアトミックに取り出して処理する
+    for (uint32_t index = nextJob_.fetch_add(1); index < jobCount; index = nextJob_.fetch_add(1)) {
+        (*job)(index);
+    }
+}
+
+void ParticleUpdater::ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& job) {
+    if (threads_.empty() || jobCount <= 1) {
+        for (uint32_t index = 0; index < jobCount; ++index) {
+            job(index);
+        }
+        return;
+    }
+
+    // 常駐しているワーカーを起こす（処理がワーカー数より少なくても、余ったワーカーはすぐに終わる）
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        jobCount_ = jobCount;
+        nextJob_.store(0);
+        runningWorkers_ = static_cast<uint32_t>(threads_.size());
+        ++generation_;
+    }
+    wakeCondition_.notify_all();
+
+    // 呼び出し元のスレッドも処理する
+    RunJobs(&job, jobCount);
+
+    // 全ワーカーが終えるまで待つ（jobはこの関数の引数なので、戻る前に参照されなくなっている必要がある）
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [&]() { return runningWorkers_ == 0; });
+    job_ = nullptr;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "ParticleStorage.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 複数グループのパーティクル更新を一定数ごとの範囲（チャンク）に分けてワーカースレッドで実行する
+// 1. 全グループのチャンクを並列に更新し、チャンクごとの生存数を求める
+//    （後処理関数・選別関数があれば同じ処理の中で続けて呼び、生存数と描画する数を求める）
+// 2. グループごとに描画する数の累積和を取り、各チャンクの書き込み先（インスタンス配列の区間）を決める
+// 3. 各チャンクが自分の区間にインスタンスデータを並列に書き込む
+// 4. グループごとにチャンク間の隙間を詰める（移動は削除された数以下）
+// チャンクの割り当てはアトミックなカウンタで行い、ロックは使わない
+// ワーカースレッドはワーカー数の設定時に作成して使い回し、段階ごとに起こす（毎回スレッドを作らない）
+class ParticleUpdater {
+public:
+    // 1チャンクのパーティクル数（AVX2で端数が出ないようkLaneCountの倍数にする）
+    static constexpr uint32_t kChunkSize = 4096;
+    static_assert(kChunkSize % ParticleStorage::kLaneCount == 0, "kChunkSize must be a multiple of kLaneCount");
+
+    // インスタンスデータの書き込み
+    // groupのstorageの[begin, begin + count)を、グループのインスタンス配列の[offset, offset + count)に書き込む
+    // 別々のチャンクに対して複数スレッドから同時に呼ばれる
+    using WriteFunction = std::function<void(uint32_t group, const ParticleStorage& storage, uint32_t begin, uint32_t count, uint32_t offset)>;
+
+    // 更新直後の後処理（衝突、サブエミッターの出来事の記録など）
+    // 更新直後のgroupのstorageの[begin, begin + count)（生存しているもの）を書き換え、生存数を返す
+    // [begin + count, end)はチャンク内で寿命が尽きた粒（読み取りのみ）
+    // 削除する粒はParticleStorage::RemoveInRangeで生存している範囲の末尾と入れ替える
+    // 別々のチャンクに対して複数スレッドから同時に呼ばれる
+    using ResolveFunction = std::function<uint32_t(uint32_t group, ParticleStorage& storage, uint32_t begin, uint32_t count, uint32_t end)>;
+
+    // 描画する粒の選別（視錐台カリングなど）
+    // 更新直後のgroupのstorageの[begin, begin + count)（生存しているもの）から描画する数を返す
+    // 選別関数を使う場合、書き込み関数のcountはこの戻り値になる
+    // 別々のチャンクに対して複数スレッドから同時に呼ばれる
+    using SelectFunction = std::function<uint32_t(uint32_t group, const ParticleStorage& storage, uint32_t begin, uint32_t count)>;
+
+    // コンストラクタ（workerCountが0ならハードウェアのスレッド数）
+    explicit ParticleUpdater(uint32_t workerCount = 0);
+    // デストラクタ（ワーカースレッドを終了する）
+    ~ParticleUpdater();
+
+    // ワーカースレッドを持つのでコピー禁止
+    ParticleUpdater(const ParticleUpdater&) = delete;
+    ParticleUpdater& operator=(const ParticleUpdater&) = delete;
+
+    // ワーカー数（呼び出し元のスレッドを含む、0ならハードウェアのスレッド数）
+    // 変更するとワーカースレッドを作り直す（更新中に呼んではいけない）
+    void SetWorkerCount(uint32_t workerCount);
+    uint32_t GetWorkerCount() const { return workerCount_; }
+
+    // 全グループの更新とインスタンスデータの書き込み（書き込みが不要ならwriteは空でよい）
+    void Update(const std::vector<ParticleStorage*>& groups, float deltaTime, const WriteFunction& write);
+
+    // 全グループの更新と描画する粒の選別、インスタンスデータの書き込み
+    void Update(const std::vector<ParticleStorage*>& groups, float deltaTime, const SelectFunction& select, const WriteFunction& write);
+
+    // 全グループの更新と後処理、描画する粒の選別、インスタンスデータの書き込み
+    void Update(const std::vector<ParticleStorage*>& groups, float deltaTime,
+        const ResolveFunction& resolve, const SelectFunction& select, const WriteFunction& write);
+
+    // 直前の更新でグループのインスタンス配列に書き込んだ数
+    uint32_t GetWriteCount(uint32_t group) const { return writeCounts_[group]; }
+
+    // 直前の更新のチャンク数
+    uint32_t GetChunkCount() const { return static_cast<uint32_t>(chunks_.size()); }
+
+private:
+    // チャンク
+    struct Chunk {
+        uint32_t group;  // グループ番号
+        uint32_t begin;  // グループ内の開始位置
+        uint32_t end;    // グループ内の終了位置
+        uint32_t offset; // インスタンス配列の書き込み先（生存数の累積和）
+    };
+
+    // ワーカー数
+    uint32_t workerCount_ = 1;
+
+    // 全グループのチャンク（グループ順、グループ内は先頭から順）
+    std::vector<Chunk> chunks_;
+    // チャンクごとの生存数（chunks_と同じ並び）
+    std::vector<uint32_t> aliveCounts_;
+    // チャンクごとの書き込む数（選別関数がなければ生存数と同じ）
+    std::vector<uint32_t> selectCounts_;
+    // グループごとの書き込んだ数
+    std::vector<uint32_t> writeCounts_;
+    // グループごとの先頭チャンク番号（末尾に全チャンク数）
+    std::vector<uint32_t> groupChunks_;
+
+    // 常駐するワーカースレッド（workerCount_ - 1個、呼び出し元のスレッドは含まない）
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    // ワーカーを起こす（generation_の更新またはstopping_）
+    std::condition_variable wakeCondition_;
+    // 全ワーカーが処理を終えたことを呼び出し元に知らせる
+    std::condition_variable doneCondition_;
+    // 実行中の処理（mutex_で保護し、起こしてから全ワーカーが終わるまで書き換えない）
+    const std::function<void(uint32_t)>* job_ = nullptr;
+    uint32_t jobCount_ = 0;
+    // 次に処理する番号
+    std::atomic<uint32_t> nextJob_ = 0;
+    // 起こした回数（ワーカーは前回から変わったら処理を始める）
+    uint64_t generation_ = 0;
+    // 処理を終えていないワーカー数
+    uint32_t runningWorkers_ = 0;
+    bool stopping_ = false;
+
+    // ワーカースレッドの作成・終了
+    void StartWorkers();
+    void StopWorkers();
+    // ワーカースレッドの処理（generationは作成時点の起こした回数）
+    void WorkerLoop(uint64_t generation);
+    // 処理の番号を取り出して実行（呼び出し元とワーカーで共通、jobがnullptrなら何もしない）
+    void RunJobs(const std::function<void(uint32_t)>* job, uint32_t jobCount);
+
+    // jobCount個の処理をワーカーに分配して実行（呼び出し元のスレッドも処理する）
+    void ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& job);
+};
@@ -1,11 +1,7 @@
 #include "BulletCollisionTest.h"
-#include "../../Engine/Graphics/GraphicsManager.h"
-#include "../../Engine/Input/InputManager.h"
-#include "../../Engine/Core/SceneManager.h"
-#include "../../Engine/Core/Time.h"
 
 // コンストラクタ
-BulletCollisionTest::BulletCollisionTest() : camera(nullptr), collisionManager(nullptr) {
+BulletCollisionTest::BulletCollisionTest() {
 }
 
 // デストラクタ
@@ -14,237 +10,236 @@ BulletCollisionTest::~BulletCollisionTest() {
 
 // 初期化
 void BulletCollisionTest::Initialize() {
-    // カメラの初期化
-    camera = std::make_shared<Camera>();
-    camera->SetPosition({0.0f, 5.0f, -15.0f});
-    camera->SetTarget({0.0f, 0.0f, 0.0f});
-    
-    // Bullet衝突マネージャを初期化
+    // 必要なリソースの取得確認
+    assert(dxCommon_);
+    assert(input_);
+    assert(spriteCommon_);
+    assert(camera_);
+
+    // カメラの初期設定（上から見下ろす）
+    camera_->SetTranslate({ 0.0f, 15.0f, -25.0f });
+    camera_->SetRotate({ 0.5f, 0.0f, 0.0f });
+    camera_->Update();
+
+    // 3Dモデルの初期化
+    sphereModel_ = std::make_unique<Model>();
+    sphereModel_->Initialize(dxCommon_);
+    sphereModel_->LoadFromObj("Resources/models", "sphere.obj");
+
+    cubeModel_ = std::make_unique<Model>();
+    cubeModel_->Initialize(dxCommon_);
+    cubeModel_->LoadFromObj("Resources/models/cube", "cube.obj");
+
+    // 衝突マネージャを初期化
     Collision::BulletCollisionManager::Create();
-    collisionManager = Collision::BulletCollisionManager::GetInstance();
-    
+    collisionManager_ = Collision::BulletCollisionManager::GetInstance();
+
     // いくつかのテストオブジェクトを作成
-    CreateSphereObject({-5.0f, 5.0f, 0.0f}, 1.0f, {5.0f, 0.0f, 0.0f});
-    CreateSphereObject({5.0f, 5.0f, 0.0f}, 1.0f, {-5.0f, 0.0f, 0.0f});
-    CreateSphereObject({0.0f, 5.0f, -5.0f}, 1.0f, {0.0f, 0.0f, 5.0f});
-    
+    CreateSphereObject({ -5.0f, 5.0f, 0.0f }, 1.0f, { 5.0f, 0.0f, 0.0f });
+    CreateSphereObject({ 5.0f, 5.0f, 0.0f }, 1.0f, { -5.0f, 0.0f, 0.0f });
+    CreateSphereObject({ 0.0f, 5.0f, -5.0f }, 1.0f, { 0.0f, 0.0f, 5.0f });
+
     // 静的なオブジェクト（床と壁）を作成
-    CreateStaticBox({0.0f, -1.0f, 0.0f}, {10.0f, 1.0f, 10.0f});   // 床
-    CreateStaticBox({-10.0f, 5.0f, 0.0f}, {1.0f, 5.0f, 10.0f});    // 左壁
-    CreateStaticBox({10.0f, 5.0f, 0.0f}, {1.0f, 5.0f, 10.0f});     // 右壁
-    CreateStaticBox({0.0f, 5.0f, 10.0f}, {10.0f, 5.0f, 1.0f});     // 奥壁
-    CreateStaticBox({0.0f, 5.0f, -10.0f}, {10.0f, 5.0f, 1.0f});    // 手前壁
-    
+    CreateStaticBox({ 0.0f, -1.0f, 0.0f }, { 10.0f, 1.0f, 10.0f });   // 床
+    CreateStaticBox({ -10.0f, 5.0f, 0.0f }, { 1.0f, 5.0f, 10.0f });   // 左壁
+    CreateStaticBox({ 10.0f, 5.0f, 0.0f }, { 1.0f, 5.0f, 10.0f });    // 右壁
+    CreateStaticBox({ 0.0f, 5.0f, 10.0f }, { 10.0f, 5.0f, 1.0f });    // 奥壁
+    CreateStaticBox({ 0.0f, 5.0f, -10.0f }, { 10.0f, 5.0f, 1.0f });   // 手前壁
+
     // 静的な球を追加
-    CreateStaticSphere({0.0f, 0.0f, 0.0f}, 2.0f);
+    CreateStaticSphere({ 0.0f, 2.0f, 0.0f }, 2.0f);
+
+    // 初期化完了
+    initialized_ = true;
 }
 
 // 更新処理
 void BulletCollisionTest::Update() {
+    // 初期化されていない場合はスキップ
+    if (!initialized_) return;
+
     // カメラの更新
-    camera->Update();
-    
+    camera_->Update();
+
     // 物理シミュレーションの更新
-    UpdatePhysics(Time::DeltaTime());
-    
-    // 衝突検出の更新
-    collisionManager->Update();
-    
-    // 入力処理（例: ESCキーでシーン終了）
-    if (Input::InputManager::GetKeyDown(Input::Keys::Escape)) {
-        SceneManager::GetInstance()->ChangeScene("Title");
+    UpdatePhysics(kDeltaTime);
+
+    // 衝突検出の更新（この中でOnCollisionが呼ばれる）
+    collisionManager_->Update();
+
+    // 衝突中なら赤、それ以外は緑で表示
+    for (auto& obj : sphereObjects_) {
+        obj->object->SetColor(obj->isColliding ? Vector4{ 1.0f, 0.0f, 0.0f, 1.0f } : Vector4{ 0.0f, 1.0f, 0.0f, 1.0f });
+        obj->object->SetPosition(obj->sphere.center);
+        obj->object->Update();
+    }
+    for (auto& obj : staticObjects_) {
+        obj->object->Update();
+    }
+
+    // ESCキーでタイトルシーンに戻る
+    if (input_->TriggerKey(DIK_ESCAPE)) {
+        sceneManager_->ChangeScene("Title");
     }
 }
 
 // 描画処理
 void BulletCollisionTest::Draw() {
-    // カメラの設定
-    Graphics::GraphicsManager::SetCamera(camera);
-    
+    // 初期化されていない場合はスキップ
+    if (!initialized_) return;
+
     // 動的な球オブジェクトの描画
-    for (const auto& obj : sphereObjects) {
-        // 衝突中なら色を変える
-        if (obj.isColliding) {
-            obj.model->SetColor({1.0f, 0.0f, 0.0f, 1.0f}); // 赤色
-        } else {
-            obj.model->SetColor({0.0f, 1.0f, 0.0f, 1.0f}); // 緑色
-        }
-        
-        obj.model->Draw();
+    for (const auto& obj : sphereObjects_) {
+        obj->object->Draw();
     }
-    
+
     // 静的なオブジェクトの描画
-    for (const auto& obj : staticObjects) {
-        obj.model->Draw();
+    for (const auto& obj : staticObjects_) {
+        obj->object->Draw();
     }
 }
 
 // 終了処理
 void BulletCollisionTest::Finalize() {
-    // すべてのオブジェクトのコリジョンを削除
-    for (auto& obj : sphereObjects) {
-        if (obj.collisionObject) {
-            collisionManager->UnregisterCollisionObject(obj.collisionObject);
-            obj.collisionObject = nullptr;
-        }
+    if (!collisionManager_) return;
+
+    // すべてのオブジェクトのコリジョンを削除（ハンドラーも一緒に削除される）
+    for (auto& obj : sphereObjects_) {
+        collisionManager_->UnregisterCollisionObject(obj->collisionObject);
     }
-    
-    for (auto& obj : staticObjects) {
-        if (obj.collisionObject) {
-            collisionManager->UnregisterCollisionObject(obj.collisionObject);
-            obj.collisionObject = nullptr;
-        }
+    for (auto& obj : staticObjects_) {
+        collisionManager_->UnregisterCollisionObject(obj->collisionObject);
     }
-    
-    // 球オブジェクトとモデルをクリア
-    sphereObjects.clear();
-    staticObjects.clear();
-    
-    // Bullet衝突マネージャを破棄
+
+    // オブジェクトをクリア
+    sphereObjects_.clear();
+    staticObjects_.clear();
+
+    // 衝突マネージャを破棄
     Collision::BulletCollisionManager::Destroy();
-    collisionManager = nullptr;
+    collisionManager_ = nullptr;
 }
 
 // 衝突判定コールバック
-void BulletCollisionTest::OnCollision(const Collision::CollisionInfo& info) {
-    // 衝突したオブジェクトを探して衝突フラグを設定
-    for (auto& obj : sphereObjects) {
-        if (obj.collisionObject == info.objectA || obj.collisionObject == info.objectB) {
-            obj.isColliding = true;
-            
-            // 衝突応答（簡易的な跳ね返り）
-            Vector3 normal = info.normal;
-            if (obj.collisionObject == info.objectB) {
-                normal.x = -normal.x;
-                normal.y = -normal.y;
-                normal.z = -normal.z;
-            }
-            
-            // 反射ベクトルを計算（簡易版）
-            float dotProduct = Collision::Utility::Dot(obj.velocity, normal);
-            if (dotProduct < 0) {
-                // 反射方向に速度を変更
-                Vector3 reflectionVelocity;
-                Vector3 doubleNormalDotProduct = {
-                    normal.x * 2.0f * dotProduct,
-                    normal.y * 2.0f * dotProduct,
-                    normal.z * 2.0f * dotProduct
-                };
-                reflectionVelocity.x = obj.velocity.x - doubleNormalDotProduct.x;
-                reflectionVelocity.y = obj.velocity.y - doubleNormalDotProduct.y;
-                reflectionVelocity.z = obj.velocity.z - doubleNormalDotProduct.z;
-                
-                // 若干の速度減衰
-                obj.velocity.x = reflectionVelocity.x * 0.8f;
-                obj.velocity.y = reflectionVelocity.y * 0.8f;
-                obj.velocity.z = reflectionVelocity.z * 0.8f;
-            }
-        }
+void BulletCollisionTest::OnCollision(PhysicsObject& obj, const Collision::CollisionInfo& info) {
+    obj.isColliding = true;
+
+    // 法線はBからAへ向かうので、objがBのときは反転してobjを押し出す向きにする
+    Vector3 normal = info.normal;
+    if (info.objectB == &obj) {
+        normal = Collision::Utility::Multiply(normal, -1.0f);
+    }
+
+    // めり込みを解消
+    obj.sphere.center = Collision::Utility::Add(obj.sphere.center, Collision::Utility::Multiply(normal, info.penetration));
+
+    // 近づく向きの速度なら反射させ、若干減衰させる（簡易的な跳ね返り）
+    float dotProduct = Collision::Utility::Dot(obj.velocity, normal);
+    if (dotProduct < 0.0f) {
+        Vector3 reflection = Collision::Utility::Subtract(obj.velocity, Collision::Utility::Multiply(normal, 2.0f * dotProduct));
+        obj.velocity = Collision::Utility::Multiply(reflection, 0.8f);
     }
 }
 
 // 物理シミュレーション更新
 void BulletCollisionTest::UpdatePhysics(float deltaTime) {
     // 重力の設定
-    const Vector3 gravity = {0.0f, -9.8f, 0.0f};
-    
+    const Vector3 gravity = { 0.0f, -9.8f, 0.0f };
+
     // 球オブジェクトの更新
-    for (auto& obj : sphereObjects) {
+    for (auto& obj : sphereObjects_) {
         // 前回の衝突フラグをリセット
-        obj.isColliding = false;
-        
-        // 重力を適用
-        obj.velocity.x += gravity.x * deltaTime;
-        obj.velocity.y += gravity.y * deltaTime;
-        obj.velocity.z += gravity.z * deltaTime;
-        
-        // 位置を更新
-        obj.sphere.center.x += obj.velocity.x * deltaTime;
-        obj.sphere.center.y += obj.velocity.y * deltaTime;
-        obj.sphere.center.z += obj.velocity.z * deltaTime;
-        
-        // モデルの位置を更新
-        obj.model->SetPosition(obj.sphere.center);
-        
-        // Bulletのコリジョンオブジェクトの位置を更新
-        // 注: 実際にはBulletCollisionManagerに位置更新メソッドを追加する必要があります
-        collisionManager->UnregisterCollisionObject(obj.collisionObject);
-        obj.collisionObject = collisionManager->RegisterSphere(obj.sphere, &obj);
+        obj->isColliding = false;
+
+        // 重力を適用して位置を更新
+        obj->velocity = Collision::Utility::Add(obj->velocity, Collision::Utility::Multiply(gravity, deltaTime));
+        obj->sphere.center = Collision::Utility::Add(obj->sphere.center, Collision::Utility::Multiply(obj->velocity, deltaTime));
+
+        // 登録し直さずにコリジョンの位置を更新
+        collisionManager_->UpdateSphere(obj->collisionObject, obj->sphere);
     }
 }
 
 // 動的な球オブジェクト生成
 void BulletCollisionTest::CreateSphereObject(const Vector3& position, float radius, const Vector3& velocity) {
-    PhysicsObject obj;
-    
+    auto obj = std::make_unique<PhysicsObject>();
+    PhysicsObject* physicsObject = obj.get();
+
     // 球の設定
-    obj.sphere.center = position;
-    obj.sphere.radius = radius;
-    obj.velocity = velocity;
-    obj.isColliding = false;
-    
-    // モデルの作成
-    obj.model = std::make_shared<Graphics::Model>();
-    obj.model->CreateSphere(radius, 16, 16);
-    obj.model->SetPosition(position);
-    obj.model->SetColor({0.0f, 1.0f, 0.0f, 1.0f}); // 緑色
-    
-    // Bulletのコリジョンオブジェクト登録
-    obj.collisionObject = collisionManager->RegisterSphere(obj.sphere, &obj);
-    
-    // コリジョンハンドラー登録
-    collisionManager->RegisterCollisionHandler(&obj, nullptr, 
-        [this](const Collision::CollisionInfo& info) {
-            this->OnCollision(info);
+    obj->sphere.center = position;
+    obj->sphere.radius = radius;
+    obj->velocity = velocity;
+
+    // 描画用オブジェクトの作成
+    float scale = radius / kSphereModelRadius;
+    obj->object = std::make_unique<Object3d>();
+    obj->object->Initialize(dxCommon_, spriteCommon_);
+    obj->object->SetModel(sphereModel_.get());
+    obj->object->SetScale({ scale, scale, scale });
+    obj->object->SetPosition(position);
+    obj->object->SetColor({ 0.0f, 1.0f, 0.0f, 1.0f }); // 緑色
+    obj->object->SetEnableLighting(true);
+
+    // コリジョンオブジェクト登録（ユーザーデータはPhysicsObjectのアドレス）
+    obj->collisionObject = collisionManager_->RegisterSphere(obj->sphere, physicsObject);
+
+    // 任意の相手との衝突ハンドラー登録
+    collisionManager_->RegisterCollisionHandler(physicsObject, nullptr,
+        [this, physicsObject](const Collision::CollisionInfo& info) {
+            OnCollision(*physicsObject, info);
         });
-    
+
     // リストに追加
-    sphereObjects.push_back(obj);
+    sphereObjects_.push_back(std::move(obj));
 }
 
 // 静的な球オブジェクト生成
 void BulletCollisionTest::CreateStaticSphere(const Vector3& position, float radius) {
-    PhysicsObject obj;
-    
+    auto obj = std::make_unique<PhysicsObject>();
+
     // 球の設定
-    obj.sphere.center = position;
-    obj.sphere.radius = radius;
-    obj.velocity = {0.0f, 0.0f, 0.0f};
-    obj.isColliding = false;
-    
-    // モデルの作成
-    obj.model = std::make_shared<Graphics::Model>();
-    obj.model->CreateSphere(radius, 16, 16);
-    obj.model->SetPosition(position);
-    obj.model->SetColor({0.5f, 0.5f, 1.0f, 1.0f}); // 青っぽい色
-    
-    // Bulletのコリジョンオブジェクト登録
-    obj.collisionObject = collisionManager->RegisterSphere(obj.sphere, &obj);
-    
+    obj->sphere.center = position;
+    obj->sphere.radius = radius;
+    obj->velocity = { 0.0f, 0.0f, 0.0f };
+
+    // 描画用オブジェクトの作成
+    float scale = radius / kSphereModelRadius;
+    obj->object = std::make_unique<Object3d>();
+    obj->object->Initialize(dxCommon_, spriteCommon_);
+    obj->object->SetModel(sphereModel_.get());
+    obj->object->SetScale({ scale, scale, scale });
+    obj->object->SetPosition(position);
+    obj->object->SetColor({ 0.5f, 0.5f, 1.0f, 1.0f }); // 青っぽい色
+    obj->object->SetEnableLighting(true);
+
+    // コリジョンオブジェクト登録
+    obj->collisionObject = collisionManager_->RegisterSphere(obj->sphere, obj.get());
+
     // リストに追加
-    staticObjects.push_back(obj);
+    staticObjects_.push_back(std::move(obj));
 }
 
 // 静的なボックスオブジェクト生成
 void BulletCollisionTest::CreateStaticBox(const Vector3& position, const Vector3& halfExtents) {
-    PhysicsObject obj;
-    
-    // 簡易的に球としてコライダーを設定（本来はボックスコライダーが必要）
-    float maxExtent = std::max(std::max(halfExtents.x, halfExtents.y), halfExtents.z);
-    obj.sphere.center = position;
-    obj.sphere.radius = maxExtent;
-    obj.velocity = {0.0f, 0.0f, 0.0f};
-    obj.isColliding = false;
-    
-    // モデルの作成
-    obj.model = std::make_shared<Graphics::Model>();
-    obj.model->CreateBox(halfExtents.x * 2.0f, halfExtents.y * 2.0f, halfExtents.z * 2.0f);
-    obj.model->SetPosition(position);
-    obj.model->SetColor({0.8f, 0.8f, 0.8f, 1.0f}); // 灰色
-    
-    // Bulletのボックスコリジョンオブジェクト登録
-    obj.collisionObject = collisionManager->RegisterBox(halfExtents, position, &obj);
-    
+    auto obj = std::make_unique<PhysicsObject>();
+
+    // ボックスは衝突判定に球を使わないので位置のみ設定
+    obj->sphere.center = position;
+    obj->sphere.radius = 0.0f;
+    obj->velocity = { 0.0f, 0.0f, 0.0f };
+
+    // 描画用オブジェクトの作成（cube.objは1辺2の立方体なので半分の大きさをそのままスケールにする）
+    obj->object = std::make_unique<Object3d>();
+    obj->object->Initialize(dxCommon_, spriteCommon_);
+    obj->object->SetModel(cubeModel_.get());
+    obj->object->SetScale(halfExtents);
+    obj->object->SetPosition(position);
+    obj->object->SetColor({ 0.8f, 0.8f, 0.8f, 1.0f }); // 灰色
+    obj->object->SetEnableLighting(true);
+
+    // ボックスのコリジョンオブジェクト登録
+    obj->collisionObject = collisionManager_->RegisterBox(halfExtents, position, obj.get());
+
     // リストに追加
-    staticObjects.push_back(obj);
+    staticObjects_.push_back(std::move(obj));
 }
@@ -1,46 +1,54 @@
 #pragma once
-#include "../../Engine/Collision/BulletCollisionManager.h"
-#include "../../Engine/Graphics/Model.h"
-#include "../../Engine/Camera/Camera.h"
-#include "../../Engine/Core/Scene.h"
+#include "UnoEngine.h"
+#include "BulletCollisionManager.h"
 #include <vector>
-#include <memory>
 
-// Bullet3による当たり判定テストシーン
-class BulletCollisionTest : public Scene {
+// BulletCollisionManagerによる当たり判定テストシーン
+class BulletCollisionTest : public IScene {
+public:
+    // コンストラクタ・デストラクタ
+    BulletCollisionTest();
+    ~BulletCollisionTest() override;
+
+    // ISceneの実装
+    void Initialize() override;
+    void Update() override;
+    void Draw() override;
+    void Finalize() override;
+
 private:
     // テスト用物理オブジェクト構造体
     struct PhysicsObject {
-        std::shared_ptr<Graphics::Model> model;  // 描画用モデル
-        Collision::Sphere sphere;                // 衝突判定用球
-        Vector3 velocity;                        // 速度
-        void* collisionObject;                   // Bulletのコリジョンオブジェクト
-        bool isColliding;                        // 衝突中フラグ
+        std::unique_ptr<Object3d> object;  // 描画用オブジェクト
+        Collision::Sphere sphere;          // 衝突判定用球
+        Vector3 velocity;                  // 速度
+        void* collisionObject = nullptr;   // コリジョンオブジェクトのハンドル
+        bool isColliding = false;          // 衝突中フラグ
     };
 
-    // テスト用のオブジェクト
-    std::vector<PhysicsObject> sphereObjects;
-    std::vector<PhysicsObject> staticObjects;
+    // sphere.objの半径（スケールの計算用）
+    static constexpr float kSphereModelRadius = 10.0f;
 
-    // カメラ
-    std::shared_ptr<Camera> camera;
+    // 1フレームの経過時間（固定）
+    static constexpr float kDeltaTime = 1.0f / 60.0f;
 
-    // Bullet衝突マネージャ
-    Collision::BulletCollisionManager* collisionManager;
+    // 初期化済みフラグ
+    bool initialized_ = false;
 
-public:
-    BulletCollisionTest();
-    ~BulletCollisionTest();
+    // 描画用モデル
+    std::unique_ptr<Model> sphereModel_;
+    std::unique_ptr<Model> cubeModel_;
 
-    // シーン管理
-    void Initialize() override;
-    void Update() override;
-    void Draw() override;
-    void Finalize() override;
+    // テスト用のオブジェクト
+    // アドレスを衝突判定のユーザーデータとして渡すので、要素はunique_ptrで保持して移動させない
+    std::vector<std::unique_ptr<PhysicsObject>> sphereObjects_;
+    std::vector<std::unique_ptr<PhysicsObject>> staticObjects_;
+
+    // 衝突マネージャ
+    Collision::BulletCollisionManager* collisionManager_ = nullptr;
 
-private:
     // 衝突判定コールバック
-    void OnCollision(const Collision::CollisionInfo& info);
+    void OnCollision(PhysicsObject& obj, const Collision::CollisionInfo& info);
 
     // 物理シミュレーション更新
     void UpdatePhysics(float deltaTime);
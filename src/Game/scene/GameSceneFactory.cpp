@@ -3,6 +3,7 @@
 #include "GameSceneFactory.h"
 #include "TitleScene.h"
 #include "GamePlayScene.h"
+#include "BulletCollisionTest.h"
 #include <cassert>
 
 std::unique_ptr<IScene> GameSceneFactory::CreateScene(const std::string& sceneName) {
@@ -13,6 +14,9 @@ std::unique_ptr<IScene> GameSceneFactory::CreateScene(const std::string& sceneNa
     else if (sceneName == "GamePlay") {
         return std::make_unique<GamePlayScene>();
     }
+    else if (sceneName == "BulletCollisionTest") {
+        return std::make_unique<BulletCollisionTest>();
+    }
 
     // 対応するシーンが見つからない場合はエラー
     assert(0 && "指定されたシーンが存在しません");
@@ -0,0 +1,1099 @@
+#include "ParticleBenchmark.h"
+
+// STLのインクルード
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+namespace {
+    // 経過時間（ミリ秒）
+    using Clock = std::chrono::steady_clock;
+    double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // 1フレームの経過時間（60FPS想定）
+    const float kDeltaTime = 1.0f / 60.0f;
+
+    // 従来のインスタンスデータ（ParticleManagerの行列方式）
+    struct MatrixInstance {
+        Matrix4x4 WVP;
+        Matrix4x4 World;
+        Vector4 color;
+    };
+
+    // 4x4行列の乗算（Mymathと同じ行ベクトル形式）
+    Matrix4x4 Multiply(const Matrix4x4& a, const Matrix4x4& b) {
+        Matrix4x4 result = {};
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                for (int k = 0; k < 4; ++k) {
+                    result.m[row][column] += a.m[row][k] * b.m[k][column];
+                }
+            }
+        }
+        return result;
+    }
+
+    // 適当なカメラ（ビルボード行列とビュープロジェクション行列）
+    void MakeCamera(Matrix4x4& billboard, Matrix4x4& viewProjection) {
+        // Y軸回りに0.5ラジアン、X軸回りに0.3ラジアン回したカメラの回転
+        float cy = std::cos(0.5f), sy = std::sin(0.5f), cx = std::cos(0.3f), sx = std::sin(0.3f);
+        Matrix4x4 rotateY = { cy, 0, -sy, 0, 0, 1, 0, 0, sy, 0, cy, 0, 0, 0, 0, 1 };
+        Matrix4x4 rotateX = { 1, 0, 0, 0, 0, cx, sx, 0, 0, -sx, cx, 0, 0, 0, 0, 1 };
+        billboard = Multiply(rotateX, rotateY);
+        viewProjection = { 1.2f, 0, 0, 0, 0, 2.1f, 0, 0, 0, 0, 1.0f, 1, 0, 0, -0.1f, 0 };
+    }
+
+    // 計測用の曲線（炎・煙・火花・光のような4種類）
+    void MakeCurves(ParticleCurve sizes[4], ParticleGradient colors[4]) {
+        sizes[0].AddKey(0.0f, 0.2f).AddKey(0.15f, 1.0f).AddKey(0.6f, 0.8f).AddKey(1.0f, 0.0f);
+        colors[0].AddKey(0.0f, { 1.0f, 1.0f, 0.8f, 1.0f }).AddKey(0.3f, { 1.0f, 0.6f, 0.1f, 1.0f }).AddKey(0.7f, { 0.6f, 0.1f, 0.0f, 0.6f }).AddKey(1.0f, { 0.1f, 0.1f, 0.1f, 0.0f });
+        sizes[1].AddKey(0.0f, 0.5f).AddKey(1.0f, 3.0f);
+        colors[1].AddKey(0.0f, { 0.3f, 0.3f, 0.3f, 0.0f }).AddKey(0.2f, { 0.5f, 0.5f, 0.5f, 0.8f }).AddKey(1.0f, { 0.7f, 0.7f, 0.7f, 0.0f });
+        sizes[2].AddKey(0.0f, 1.0f).AddKey(0.1f, 0.4f).AddKey(1.0f, 0.1f);
+        sizes[2].SetInterpolation(ParticleCurve::Interpolation::Linear);
+        colors[2].AddKey(0.0f, { 1.0f, 0.9f, 0.5f, 1.0f }).AddKey(1.0f, { 1.0f, 0.3f, 0.0f, 0.0f });
+        sizes[3].AddKey(0.0f, 1.0f).AddKey(0.25f, 1.4f).AddKey(0.5f, 1.0f).AddKey(0.75f, 1.4f).AddKey(1.0f, 1.0f);
+        colors[3].AddKey(0.0f, { 0.6f, 0.8f, 1.0f, 0.0f }).AddKey(0.1f, { 0.6f, 0.8f, 1.0f, 1.0f }).AddKey(0.9f, { 0.6f, 0.8f, 1.0f, 1.0f }).AddKey(1.0f, { 0.6f, 0.8f, 1.0f, 0.0f });
+    }
+
+    // 計測用の衝突形状（発生範囲の上に並べた球と、その間に渡したカプセル）
+    std::vector<Collision::Capsule> MakeColliders() {
+        std::vector<Collision::Capsule> colliders;
+        for (int32_t x = -3; x <= 3; ++x) {
+            for (int32_t z = -3; z <= 3; ++z) {
+                Vector3 center = { x * 3.0f, 1.0f + static_cast<float>((x + z + 6) % 3), z * 3.0f };
+                colliders.emplace_back(center, center, 0.6f);
+            }
+        }
+        for (int32_t i = -3; i <= 3; ++i) {
+            colliders.emplace_back(Vector3{ -9.0f, 3.5f, i * 3.0f + 1.5f }, Vector3{ 9.0f, 3.5f, i * 3.0f + 1.5f }, 0.2f);
+        }
+        return colliders;
+    }
+
+    // 計測用の曲線を表にして登録
+    void AddCurveTables(ParticleStorage& storage) {
+        ParticleCurve sizes[4];
+        ParticleGradient colors[4];
+        MakeCurves(sizes, colors);
+        for (uint32_t curve = 0; curve < 4; ++curve) {
+            storage.AddCurveTable(ParticleCurveTable::Bake(sizes[curve], colors[curve]));
+        }
+    }
+    // 2つの方式の属性[first, last]の最大誤差（|差| / max(1, |基準値|)、削除数や並び順が違えば無限大）
+    double MaxRelativeError(const ParticleStorage& expected, const ParticleStorage& actual, uint32_t first, uint32_t last) {
+        if (expected.GetCount() != actual.GetCount()) {
+            return std::numeric_limits<double>::infinity();
+        }
+        double maxError = 0.0;
+        for (uint32_t stream = first; stream <= last; ++stream) {
+            const float* e = expected.GetStream(static_cast<ParticleStorage::Stream>(stream));
+            const float* a = actual.GetStream(static_cast<ParticleStorage::Stream>(stream));
+            for (uint32_t i = 0; i < expected.GetCount(); ++i) {
+                double error = std::abs(static_cast<double>(a[i]) - e[i]) / std::max(1.0, std::abs(static_cast<double>(e[i])));
+                maxError = std::max(maxError, error);
+            }
+        }
+        return maxError;
+    }
+}
+
+ParticleBenchmark::ParticleBenchmark(const Settings& settings)
+    : settings_(settings) {
+}
+
+float ParticleBenchmark::Random(float min, float max) {
+    std::uniform_real_distribution<float> dist(min, max);
+    return dist(randomEngine_);
+}
+
+Particle ParticleBenchmark::MakeParticle() {
+    Particle particle;
+    particle.position = { Random(-10.0f, 10.0f), Random(0.0f, 5.0f), Random(-10.0f, 10.0f) };
+    particle.velocity = { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+    particle.accel = { 0.0f, Random(-9.8f, 0.0f), 0.0f };
+    particle.startSize = Random(0.5f, 1.0f);
+    particle.endSize = 0.0f;
+    particle.size = particle.startSize;
+    particle.startColor = { 1.0f, 1.0f, 1.0f, 1.0f };
+    particle.endColor = { 1.0f, 1.0f, 1.0f, 0.0f };
+    particle.color = particle.startColor;
+    particle.rotation = Random(0.0f, 3.14f);
+    particle.rotationVelocity = Random(-1.0f, 1.0f);
+    particle.lifeTime = 0.0f;
+    particle.lifeTimeMax = Random(1.0f, 3.0f);
+    return particle;
+}
+
+Particle ParticleBenchmark::MakeShortLivedParticle() {
+    Particle particle = MakeParticle();
+    particle.lifeTimeMax = Random(kDeltaTime, kDeltaTime * settings_.frames);
+    return particle;
+}
+
+void ParticleBenchmark::UpdateList(std::list<Particle>& particles, float deltaTime) {
+    for (auto it = particles.begin(); it != particles.end(); ) {
+        // 寿命チェック
+        it->lifeTime += deltaTime;
+        if (it->lifeTime >= it->lifeTimeMax) {
+            it = particles.erase(it);
+            continue;
+        }
+
+        // 速度に加速度を加算
+        it->velocity.x += it->accel.x * deltaTime;
+        it->velocity.y += it->accel.y * deltaTime;
+        it->velocity.z += it->accel.z * deltaTime;
+
+        // 位置に速度を加算
+        it->position.x += it->velocity.x * deltaTime;
+        it->position.y += it->velocity.y * deltaTime;
+        it->position.z += it->velocity.z * deltaTime;
+
+        // 回転を更新
+        it->rotation += it->rotationVelocity * deltaTime;
+
+        // 線形補間でサイズと色を更新
+        float t = it->lifeTime / it->lifeTimeMax;
+        it->size = (1.0f - t) * it->startSize + t * it->endSize;
+        it->color.x = (1.0f - t) * it->startColor.x + t * it->endColor.x;
+        it->color.y = (1.0f - t) * it->startColor.y + t * it->endColor.y;
+        it->color.z = (1.0f - t) * it->startColor.z + t * it->endColor.z;
+        it->color.w = (1.0f - t) * it->startColor.w + t * it->endColor.w;
+
+        ++it;
+    }
+}
+
+ParticleBenchmark::Result ParticleBenchmark::Run(uint32_t particleCount) {
+    Result result;
+    result.particles = particleCount;
+    result.frames = settings_.frames;
+
+    // 従来の方式：寿命で減った分を毎フレーム補充しながら計測
+    // 寿命は計測するフレーム数の間に収め、どのパーティクル数でも削除と補充の分まで計測する
+    randomEngine_.seed(settings_.seed + particleCount);
+    std::list<Particle> list;
+    for (uint32_t i = 0; i < particleCount; ++i) {
+        list.push_back(MakeShortLivedParticle());
+    }
+    double listMs = 0.0;
+    uint64_t listRemoved = 0;
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        Clock::time_point start = Clock::now();
+        UpdateList(list, kDeltaTime);
+        listMs += ElapsedMs(start, Clock::now());
+
+        listRemoved += particleCount - list.size();
+        while (list.size() < particleCount) {
+            list.push_back(MakeShortLivedParticle());
+        }
+    }
+
+    // 属性ごとの配列：同じシードで同じ内容を発生させて計測
+    ParticleStorage storage;
+    uint64_t storageRemoved = 0;
+    double storageMs = RunStorage(storage, particleCount, ParticleStorage::Kernel::Scalar, storageRemoved, true);
+
+    // AVX2：同じ内容を発生させ、計測後に基準の方式と全属性を比較する
+    double avx2Ms = 0.0;
+    if (ParticleStorage::IsAvx2Supported()) {
+        ParticleStorage avx2;
+        uint64_t avx2Removed = 0;
+        avx2Ms = RunStorage(avx2, particleCount, ParticleStorage::Kernel::Avx2, avx2Removed, true);
+
+        // 寿命の判定は共通なので、削除数と並び順は一致する
+        result.avx2MaxError = avx2Removed != storageRemoved ? std::numeric_limits<double>::infinity()
+            : MaxRelativeError(storage, avx2, 0, ParticleStorage::kStreamCount - 1);
+    }
+
+    // 削除数が一致しなければ同じ処理をしていないので0にする
+    result.removed = listRemoved == storageRemoved ? storageRemoved : 0;
+    result.listMs = listMs / settings_.frames;
+    result.storageMs = storageMs / settings_.frames;
+    result.avx2Ms = avx2Ms / settings_.frames;
+    double fastestMs = avx2Ms > 0.0 ? avx2Ms : storageMs;
+    result.speedup = fastestMs > 0.0 ? listMs / fastestMs : 0.0;
+    result.passed = result.removed > 0 && result.avx2MaxError <= kKernelTolerance;
+    return result;
+}
+
+double ParticleBenchmark::RunStorage(ParticleStorage& storage, uint32_t particleCount, ParticleStorage::Kernel kernel, uint64_t& removed, bool shortLived) {
+    randomEngine_.seed(settings_.seed + particleCount);
+    storage.Reserve(particleCount);
+
+    // 表が登録されていれば1番から順に割り当てる（0番は表なし）
+    const uint32_t tableCount = storage.GetCurveTableCount();
+    uint32_t nextCurve = 0;
+    auto add = [&]() {
+        Particle particle = shortLived ? MakeShortLivedParticle() : MakeParticle();
+        if (tableCount > 1) {
+            particle.curve = 1 + nextCurve++ % (tableCount - 1);
+        }
+        storage.Add(particle);
+    };
+
+    for (uint32_t i = 0; i < particleCount; ++i) {
+        add();
+    }
+    double totalMs = 0.0;
+    removed = 0;
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        Clock::time_point start = Clock::now();
+        storage.Update(kDeltaTime, kernel);
+        totalMs += ElapsedMs(start, Clock::now());
+
+        removed += particleCount - storage.GetCount();
+        while (!storage.IsFull() && storage.GetCount() < particleCount) {
+            add();
+        }
+    }
+    return totalMs;
+}
+
+ParticleBenchmark::KernelCheckResult ParticleBenchmark::CheckKernels(uint32_t particleCount, ParticleStorage::Simulation simulation, bool curves) {
+    KernelCheckResult result;
+    result.particles = particleCount;
+    result.simulation = simulation;
+    result.curves = curves;
+    if (!ParticleStorage::IsAvx2Supported()) {
+        return result;
+    }
+
+    // 同じシードで同じ内容を発生させ、処理方式だけを変えて更新する
+    ParticleStorage storages[2];
+    uint64_t removed[2] = {};
+    const ParticleStorage::Kernel kernels[2] = { ParticleStorage::Kernel::Scalar, ParticleStorage::Kernel::Avx2 };
+    for (uint32_t i = 0; i < 2; ++i) {
+        storages[i].SetSimulation(simulation);
+        if (curves) {
+            AddCurveTables(storages[i]);
+        }
+        RunStorage(storages[i], particleCount, kernels[i], removed[i]);
+    }
+
+    // 寿命の判定は共通なので、削除数と並び順は一致する
+    result.maxError = removed[0] != removed[1] ? std::numeric_limits<double>::infinity()
+        : MaxRelativeError(storages[0], storages[1], 0, ParticleStorage::kStreamCount - 1);
+    result.passed = result.maxError <= kKernelTolerance;
+    return result;
+}
+
+ParticleBenchmark::ScalingResult ParticleBenchmark::RunScaling(uint32_t particleCount, uint32_t threadCount) {
+    ScalingResult result;
+    result.particles = particleCount;
+    result.groups = settings_.groups;
+    result.threads = threadCount;
+
+    // グループごとに均等に分けて発生
+    randomEngine_.seed(settings_.seed + particleCount);
+    std::vector<ParticleStorage> groups(settings_.groups);
+    std::vector<ParticleStorage*> storages;
+    std::vector<uint32_t> groupCounts;
+    for (uint32_t group = 0; group < settings_.groups; ++group) {
+        uint32_t count = particleCount / settings_.groups + (group < particleCount % settings_.groups ? 1 : 0);
+        groups[group].Reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            groups[group].Add(MakeParticle());
+        }
+        storages.push_back(&groups[group]);
+        groupCounts.push_back(count);
+    }
+
+    // インスタンスデータの代わりに座標・サイズ・色を8要素ずつ書き込む
+    std::vector<std::vector<float>> instances(settings_.groups);
+    for (uint32_t group = 0; group < settings_.groups; ++group) {
+        instances[group].resize(static_cast<size_t>(groupCounts[group]) * 8);
+    }
+    auto write = [&](uint32_t group, const ParticleStorage& storage, uint32_t begin, uint32_t count, uint32_t offset) {
+        float* out = instances[group].data() + static_cast<size_t>(offset) * 8;
+        const ParticleStorage::Stream streams[8] = {
+            ParticleStorage::kPositionX, ParticleStorage::kPositionY, ParticleStorage::kPositionZ, ParticleStorage::kSize,
+            ParticleStorage::kColorR, ParticleStorage::kColorG, ParticleStorage::kColorB, ParticleStorage::kColorA,
+        };
+        for (uint32_t element = 0; element < 8; ++element) {
+            const float* values = storage.GetStream(streams[element]) + begin;
+            for (uint32_t i = 0; i < count; ++i) {
+                out[i * 8 + element] = values[i];
+            }
+        }
+    };
+
+    ParticleUpdater updater(threadCount);
+    double totalMs = 0.0;
+    uint64_t chunks = 0;
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        Clock::time_point start = Clock::now();
+        updater.Update(storages, kDeltaTime, write);
+        totalMs += ElapsedMs(start, Clock::now());
+        chunks += updater.GetChunkCount();
+
+        for (uint32_t group = 0; group < settings_.groups; ++group) {
+            while (groups[group].GetCount() < groupCounts[group]) {
+                groups[group].Add(MakeParticle());
+            }
+        }
+    }
+
+    result.chunks = static_cast<uint32_t>(chunks / settings_.frames);
+    result.ms = totalMs / settings_.frames;
+    return result;
+}
+
+ParticleBenchmark::WorkerCheckResult ParticleBenchmark::CheckWorkerChanges(uint32_t particleCount, uint32_t frames) {
+    WorkerCheckResult result;
+    result.particles = particleCount;
+    result.frames = frames;
+
+    // 両方に同じ粒を発生させる（寿命が尽きる粒を含め、削除と詰め直しも比べる）
+    randomEngine_.seed(settings_.seed + particleCount);
+    std::vector<ParticleStorage> expectedGroups(settings_.groups);
+    std::vector<ParticleStorage> actualGroups(settings_.groups);
+    std::vector<ParticleStorage*> expectedStorages;
+    std::vector<ParticleStorage*> actualStorages;
+    std::vector<uint32_t> groupCounts;
+    for (uint32_t group = 0; group < settings_.groups; ++group) {
+        uint32_t count = particleCount / settings_.groups + (group < particleCount % settings_.groups ? 1 : 0);
+        expectedGroups[group].Reserve(count);
+        actualGroups[group].Reserve(count);
+        expectedStorages.push_back(&expectedGroups[group]);
+        actualStorages.push_back(&actualGroups[group]);
+        groupCounts.push_back(count);
+    }
+    auto refill = [&]() {
+        for (uint32_t group = 0; group < settings_.groups; ++group) {
+            while (expectedGroups[group].GetCount() < groupCounts[group]) {
+                Particle particle = MakeShortLivedParticle();
+                expectedGroups[group].Add(particle);
+                actualGroups[group].Add(particle);
+            }
+        }
+    };
+    refill();
+
+    // インスタンスデータの代わりに座標のXを書き込む
+    std::vector<std::vector<float>> expectedInstances(settings_.groups);
+    std::vector<std::vector<float>> actualInstances(settings_.groups);
+    for (uint32_t group = 0; group < settings_.groups; ++group) {
+        expectedInstances[group].resize(groupCounts[group]);
+        actualInstances[group].resize(groupCounts[group]);
+    }
+    auto makeWrite = [](std::vector<std::vector<float>>& instances) {
+        return [&instances](uint32_t group, const ParticleStorage& storage, uint32_t begin, uint32_t count, uint32_t offset) {
+            const float* x = storage.GetStream(ParticleStorage::kPositionX) + begin;
+            std::copy(x, x + count, instances[group].data() + offset);
+        };
+    };
+    const ParticleUpdater::WriteFunction expectedWrite = makeWrite(expectedInstances);
+    const ParticleUpdater::WriteFunction actualWrite = makeWrite(actualInstances);
+
+    // 最初の更新の後は毎回ワーカー数を変える（作り直したワーカーが処理のないまま起きないことも確かめる）
+    const uint32_t workerCounts[] = { 4, 1, 3, 2, 8 };
+    ParticleUpdater expectedUpdater(1);
+    ParticleUpdater actualUpdater(2);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        if (frame > 0) {
+            actualUpdater.SetWorkerCount(workerCounts[frame % std::size(workerCounts)]);
+        }
+        expectedUpdater.Update(expectedStorages, kDeltaTime, expectedWrite);
+        actualUpdater.Update(actualStorages, kDeltaTime, actualWrite);
+
+        for (uint32_t group = 0; group < settings_.groups; ++group) {
+            const uint32_t count = expectedGroups[group].GetCount();
+            const uint32_t written = expectedUpdater.GetWriteCount(group);
+            if (actualGroups[group].GetCount() != count || actualUpdater.GetWriteCount(group) != written ||
+                std::memcmp(expectedInstances[group].data(), actualInstances[group].data(), sizeof(float) * written) != 0) {
+                result.passed = false;
+                continue;
+            }
+            for (uint32_t stream = 0; stream < ParticleStorage::kStreamCount; ++stream) {
+                const float* expected = expectedGroups[group].GetStream(static_cast<ParticleStorage::Stream>(stream));
+                const float* actual = actualGroups[group].GetStream(static_cast<ParticleStorage::Stream>(stream));
+                if (std::memcmp(expected, actual, sizeof(float) * count) != 0) {
+                    result.passed = false;
+                }
+            }
+        }
+        refill();
+    }
+    return result;
+}
+
+ParticleBenchmark::PackingResult ParticleBenchmark::RunPacking(uint32_t particleCount) {
+    PackingResult result;
+    result.particles = particleCount;
+    result.matrixBytes = sizeof(MatrixInstance);
+    result.packBytes = sizeof(ParticleInstance);
+
+    randomEngine_.seed(settings_.seed + particleCount);
+    ParticleStorage storage;
+    storage.Reserve(particleCount);
+    for (uint32_t i = 0; i < particleCount; ++i) {
+        Particle particle = MakeParticle();
+        particle.color = { Random(0.0f, 1.0f), Random(0.0f, 1.0f), Random(0.0f, 1.0f), Random(0.0f, 1.0f) };
+        storage.Add(particle);
+    }
+    storage.Update(kDeltaTime);
+    const uint32_t count = storage.GetCount();
+
+    Matrix4x4 billboard;
+    Matrix4x4 viewProjection;
+    MakeCamera(billboard, viewProjection);
+    ParticleFrameConstants frame = {};
+    frame.viewProjection = viewProjection;
+    frame.cameraRight = { billboard.m[0][0], billboard.m[0][1], billboard.m[0][2] };
+    frame.cameraUp = { billboard.m[1][0], billboard.m[1][1], billboard.m[1][2] };
+
+    std::vector<MatrixInstance> matrices(count);
+    std::vector<ParticleInstance> instances(count);
+    double matrixMs = 0.0;
+    double packMs = 0.0;
+    for (uint32_t frameIndex = 0; frameIndex < settings_.frames; ++frameIndex) {
+        // 行列方式（ParticleManagerの従来の書き込み処理）
+        Clock::time_point start = Clock::now();
+        const float* positionX = storage.GetStream(ParticleStorage::kPositionX);
+        const float* positionY = storage.GetStream(ParticleStorage::kPositionY);
+        const float* positionZ = storage.GetStream(ParticleStorage::kPositionZ);
+        const float* rotation = storage.GetStream(ParticleStorage::kRotation);
+        const float* size = storage.GetStream(ParticleStorage::kSize);
+        const float* colorR = storage.GetStream(ParticleStorage::kColorR);
+        const float* colorG = storage.GetStream(ParticleStorage::kColorG);
+        const float* colorB = storage.GetStream(ParticleStorage::kColorB);
+        const float* colorA = storage.GetStream(ParticleStorage::kColorA);
+        for (uint32_t i = 0; i < count; ++i) {
+            float c = std::cos(rotation[i]);
+            float s = std::sin(rotation[i]);
+            Matrix4x4 scale = { size[i], 0, 0, 0, 0, size[i], 0, 0, 0, 0, size[i], 0, 0, 0, 0, 1 };
+            Matrix4x4 rotateZ = { c, s, 0, 0, -s, c, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+            Matrix4x4 world = Multiply(Multiply(scale, rotateZ), billboard);
+            world.m[3][0] = positionX[i];
+            world.m[3][1] = positionY[i];
+            world.m[3][2] = positionZ[i];
+            matrices[i].WVP = Multiply(world, viewProjection);
+            matrices[i].World = world;
+            matrices[i].color = { colorR[i], colorG[i], colorB[i], colorA[i] };
+        }
+        matrixMs += ElapsedMs(start, Clock::now());
+
+        // 詰めた方式
+        start = Clock::now();
+        PackParticleInstances(storage, 0, count, instances.data());
+        packMs += ElapsedMs(start, Clock::now());
+    }
+
+    // 四角形の4頂点を両方式で求めて比較（行列方式は頂点 * World）
+    const Vector2 corners[4] = { { -0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f } };
+    for (uint32_t i = 0; i < count; ++i) {
+        const Matrix4x4& world = matrices[i].World;
+        for (const Vector2& corner : corners) {
+            Vector3 expected = {
+                corner.x * world.m[0][0] + corner.y * world.m[1][0] + world.m[3][0],
+                corner.x * world.m[0][1] + corner.y * world.m[1][1] + world.m[3][1],
+                corner.x * world.m[0][2] + corner.y * world.m[1][2] + world.m[3][2],
+            };
+            Vector3 actual = ExpandParticleVertex(instances[i], frame, corner);
+            result.maxVertexError = std::max({ result.maxVertexError,
+                static_cast<double>(std::abs(actual.x - expected.x)),
+                static_cast<double>(std::abs(actual.y - expected.y)),
+                static_cast<double>(std::abs(actual.z - expected.z)) });
+        }
+        Vector4 color = UnpackParticleColor(instances[i].color);
+        result.maxColorError = std::max({ result.maxColorError,
+            static_cast<double>(std::abs(color.x - matrices[i].color.x)),
+            static_cast<double>(std::abs(color.y - matrices[i].color.y)),
+            static_cast<double>(std::abs(color.z - matrices[i].color.z)),
+            static_cast<double>(std::abs(color.w - matrices[i].color.w)) });
+    }
+
+    // 色の往復を0～1の全域で確認（チャンネルごとに値をずらして詰める位置の違いも調べる）
+    for (uint32_t step = 0; step <= 4096; ++step) {
+        float value = static_cast<float>(step) / 4096.0f;
+        Vector4 expected = { value, 1.0f - value, std::fmod(value + 0.25f, 1.0f), std::fmod(value + 0.5f, 1.0f) };
+        Vector4 color = UnpackParticleColor(PackParticleColor(expected));
+        result.maxColorError = std::max({ result.maxColorError,
+            static_cast<double>(std::abs(color.x - expected.x)),
+            static_cast<double>(std::abs(color.y - expected.y)),
+            static_cast<double>(std::abs(color.z - expected.z)),
+            static_cast<double>(std::abs(color.w - expected.w)) });
+    }
+    result.passed = result.maxVertexError <= kVertexTolerance && result.maxColorError <= kColorTolerance;
+
+    result.matrixMs = matrixMs / settings_.frames;
+    result.packMs = packMs / settings_.frames;
+    result.speedup = packMs > 0.0 ? matrixMs / packMs : 0.0;
+    return result;
+}
+
+ParticleBenchmark::SortResult ParticleBenchmark::RunSort(uint32_t particleCount) {
+    SortResult result;
+    result.particles = particleCount;
+
+    randomEngine_.seed(settings_.seed + particleCount);
+    ParticleStorage storage;
+    storage.Reserve(particleCount);
+    for (uint32_t i = 0; i < particleCount; ++i) {
+        storage.Add(MakeParticle());
+    }
+    storage.Update(kDeltaTime);
+    const uint32_t count = storage.GetCount();
+
+    // 視線方向（ビルボード行列の3行目）
+    Matrix4x4 billboard;
+    Matrix4x4 viewProjection;
+    MakeCamera(billboard, viewProjection);
+    const Vector3 forward = { billboard.m[2][0], billboard.m[2][1], billboard.m[2][2] };
+    const float* positionX = storage.GetStream(ParticleStorage::kPositionX);
+    const float* positionY = storage.GetStream(ParticleStorage::kPositionY);
+    const float* positionZ = storage.GetStream(ParticleStorage::kPositionZ);
+
+    // 一部だけを並べ替える対象（格納順に飛び飛びの番号になる）
+    std::vector<uint32_t> subset;
+    subset.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (positionX[i] >= 0.0f) {
+            subset.push_back(i);
+        }
+    }
+    result.subsetCount = static_cast<uint32_t>(subset.size());
+
+    ParticleSorter sorter;
+    sorter.Reserve(particleCount);
+    ParticleSorter subsetSorter;
+    subsetSorter.Reserve(particleCount);
+    std::vector<float> depths(count);
+    std::vector<uint32_t> indices(count);
+    double radixMs = 0.0;
+    double stdSortMs = 0.0;
+    double subsetMs = 0.0;
+    for (uint32_t frameIndex = 0; frameIndex < settings_.frames; ++frameIndex) {
+        // 基数ソート
+        Clock::time_point start = Clock::now();
+        sorter.SortBackToFront(storage, forward);
+        radixMs += ElapsedMs(start, Clock::now());
+
+        // 一部だけの基数ソート
+        start = Clock::now();
+        subsetSorter.SortBackToFront(storage, subset.data(), result.subsetCount, forward);
+        subsetMs += ElapsedMs(start, Clock::now());
+
+        // std::sort（深度を計算して添字を深度の降順に並べる）
+        start = Clock::now();
+        for (uint32_t i = 0; i < count; ++i) {
+            depths[i] = positionX[i] * forward.x + positionY[i] * forward.y + positionZ[i] * forward.z;
+            indices[i] = i;
+        }
+        std::sort(indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) { return depths[a] > depths[b]; });
+        stdSortMs += ElapsedMs(start, Clock::now());
+    }
+
+    // 基数ソートの結果が量子化の幅の範囲で奥から手前の順になっているか確認
+    if (count > 1) {
+        auto [nearest, farthest] = std::minmax_element(depths.begin(), depths.end());
+        double quantum = (*farthest - *nearest) / 65535.0;
+        const uint32_t* sorted = sorter.GetIndices();
+        for (uint32_t i = 1; i < count; ++i) {
+            double inversion = depths[sorted[i]] - depths[sorted[i - 1]];
+            if (quantum > 0.0) {
+                result.maxInversion = std::max(result.maxInversion, inversion / quantum);
+            }
+        }
+    }
+    if (result.subsetCount > 1) {
+        float nearest = depths[subset[0]];
+        float farthest = depths[subset[0]];
+        for (uint32_t index : subset) {
+            nearest = std::min(nearest, depths[index]);
+            farthest = std::max(farthest, depths[index]);
+        }
+        double quantum = (farthest - nearest) / 65535.0;
+        const uint32_t* sorted = subsetSorter.GetIndices();
+        for (uint32_t i = 1; i < subsetSorter.GetCount(); ++i) {
+            double inversion = depths[sorted[i]] - depths[sorted[i - 1]];
+            if (quantum > 0.0) {
+                result.maxInversion = std::max(result.maxInversion, inversion / quantum);
+            }
+        }
+    }
+
+    result.radixMs = radixMs / settings_.frames;
+    result.stdSortMs = stdSortMs / settings_.frames;
+    result.speedup = radixMs > 0.0 ? stdSortMs / radixMs : 0.0;
+    result.subsetMs = subsetMs / settings_.frames;
+    result.passed = result.maxInversion <= 1.0;
+    return result;
+}
+
+ParticleBenchmark::CurveResult ParticleBenchmark::RunCurves(uint32_t particleCount) {
+    CurveResult result;
+    result.particles = particleCount;
+    const ParticleStorage::Kernel kernel = ParticleStorage::GetDefaultKernel();
+
+    // 直線補間のみ：表を登録しない
+    ParticleStorage linear;
+    uint64_t linearRemoved = 0;
+    double linearMs = RunStorage(linear, particleCount, kernel, linearRemoved);
+
+    // 表あり：同じシードで同じ内容を発生させ、粒ごとに表を割り当てる
+    ParticleStorage curved;
+    AddCurveTables(curved);
+    result.tables = curved.GetCurveTableCount() - 1;
+    uint64_t curvedRemoved = 0;
+    double curveMs = RunStorage(curved, particleCount, kernel, curvedRemoved);
+
+    // 表の値と曲線の値の比較（表の点の間を細かく調べる）
+    ParticleCurve sizes[4];
+    ParticleGradient colors[4];
+    MakeCurves(sizes, colors);
+    for (uint32_t curve = 0; curve < 4; ++curve) {
+        ParticleCurveTable table = ParticleCurveTable::Bake(sizes[curve], colors[curve]);
+        for (uint32_t step = 0; step <= 1000; ++step) {
+            float time = static_cast<float>(step) / 1000.0f;
+            Vector4 color = colors[curve].Evaluate(time);
+            float expected[ParticleCurveTable::kChannelCount] = { sizes[curve].Evaluate(time), color.x, color.y, color.z, color.w };
+            for (uint32_t channel = 0; channel < ParticleCurveTable::kChannelCount; ++channel) {
+                double error = std::abs(table.Sample(static_cast<ParticleCurveTable::Channel>(channel), time) - expected[channel]);
+                result.maxTableError = std::max(result.maxTableError, error);
+            }
+        }
+    }
+
+    // AVX2のgatherと1粒ずつの方式の比較（サイズと色）
+    if (kernel == ParticleStorage::Kernel::Avx2) {
+        ParticleStorage scalar;
+        AddCurveTables(scalar);
+        uint64_t scalarRemoved = 0;
+        RunStorage(scalar, particleCount, ParticleStorage::Kernel::Scalar, scalarRemoved);
+        result.avx2MaxError = scalarRemoved != curvedRemoved ? std::numeric_limits<double>::infinity()
+            : MaxRelativeError(scalar, curved, ParticleStorage::kSize, ParticleStorage::kColorA);
+    }
+    result.passed = result.maxTableError <= kTableTolerance && result.avx2MaxError <= kCurveKernelTolerance;
+
+    result.linearMs = linearMs / settings_.frames;
+    result.curveMs = curveMs / settings_.frames;
+    result.overhead = linearMs > 0.0 ? curveMs / linearMs : 0.0;
+    return result;
+}
+
+ParticleBenchmark::SimulationResult ParticleBenchmark::RunSimulation(uint32_t particleCount) {
+    SimulationResult result;
+    result.particles = particleCount;
+    const ParticleStorage::Kernel kernel = ParticleStorage::GetDefaultKernel();
+
+    // 同じシードで同じ内容を発生させ、動きの求め方だけを変えて計測
+    ParticleStorage integrate;
+    uint64_t integrateRemoved = 0;
+    double integrateMs = RunStorage(integrate, particleCount, kernel, integrateRemoved);
+
+    ParticleStorage analytic;
+    analytic.SetSimulation(ParticleStorage::Simulation::Analytic);
+    uint64_t analyticRemoved = 0;
+    double analyticMs = RunStorage(analytic, particleCount, kernel, analyticRemoved);
+
+    // 発生時の状態（Analyticでは速度の配列が発生時の速度のまま）から倍精度で求めた座標と比較
+    if (integrateRemoved != analyticRemoved || integrate.GetCount() != analytic.GetCount()) {
+        result.integrateMaxError = std::numeric_limits<double>::infinity();
+        result.analyticMaxError = std::numeric_limits<double>::infinity();
+    }
+    else {
+        const ParticleStorage::Stream axes[3][4] = {
+            { ParticleStorage::kPositionX, ParticleStorage::kStartPositionX, ParticleStorage::kVelocityX, ParticleStorage::kAccelX },
+            { ParticleStorage::kPositionY, ParticleStorage::kStartPositionY, ParticleStorage::kVelocityY, ParticleStorage::kAccelY },
+            { ParticleStorage::kPositionZ, ParticleStorage::kStartPositionZ, ParticleStorage::kVelocityZ, ParticleStorage::kAccelZ },
+        };
+        const float* age = analytic.GetStream(ParticleStorage::kLifeTime);
+        for (const auto& axis : axes) {
+            for (uint32_t i = 0; i < analytic.GetCount(); ++i) {
+                double t = age[i];
+                double expected = analytic.GetStream(axis[1])[i] + analytic.GetStream(axis[2])[i] * t + 0.5 * analytic.GetStream(axis[3])[i] * t * t;
+                result.integrateMaxError = std::max(result.integrateMaxError, std::abs(integrate.GetStream(axis[0])[i] - expected));
+                result.analyticMaxError = std::max(result.analyticMaxError, std::abs(analytic.GetStream(axis[0])[i] - expected));
+            }
+        }
+    }
+
+    result.passed = result.analyticMaxError <= kAnalyticTolerance;
+
+    result.integrateMs = integrateMs / settings_.frames;
+    result.analyticMs = analyticMs / settings_.frames;
+    result.overhead = integrateMs > 0.0 ? analyticMs / integrateMs : 0.0;
+    return result;
+}
+
+ParticleBenchmark::DeferCheckResult ParticleBenchmark::CheckDefer(uint32_t particleCount, uint32_t frames) {
+    DeferCheckResult result;
+    result.particles = particleCount;
+    result.frames = frames;
+    const ParticleStorage::Kernel kernel = ParticleStorage::GetDefaultKernel();
+
+    // 両方に同じ粒を発生させ、毎フレーム少しずつ同じ粒を追加する
+    const uint32_t addPerFrame = 8;
+    randomEngine_.seed(settings_.seed + particleCount);
+    ParticleStorage everyFrame;
+    ParticleStorage deferred;
+    for (ParticleStorage* storage : { &everyFrame, &deferred }) {
+        storage->SetSimulation(ParticleStorage::Simulation::Analytic);
+        storage->Reserve(particleCount + addPerFrame * frames);
+    }
+    auto add = [&](uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            Particle particle = MakeParticle();
+            everyFrame.Add(particle);
+            deferred.Add(particle);
+        }
+    };
+    add(particleCount);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        everyFrame.Update(kDeltaTime, kernel);
+        if (frame + 1 < frames) {
+            deferred.Defer(kDeltaTime);
+        }
+        else {
+            deferred.Update(kDeltaTime, kernel);
+        }
+        add(addPerFrame);
+    }
+    result.survivors = deferred.GetCount();
+
+    // 削除の回数が違うので並び順は一致しない。発生時の座標で並べて同じ粒どうしを比べる
+    if (everyFrame.GetCount() != deferred.GetCount()) {
+        result.maxError = std::numeric_limits<double>::infinity();
+    }
+    else {
+        auto sortedIndices = [](const ParticleStorage& storage) {
+            const float* x = storage.GetStream(ParticleStorage::kStartPositionX);
+            const float* y = storage.GetStream(ParticleStorage::kStartPositionY);
+            const float* z = storage.GetStream(ParticleStorage::kStartPositionZ);
+            std::vector<uint32_t> indices(storage.GetCount());
+            for (uint32_t i = 0; i < storage.GetCount(); ++i) {
+                indices[i] = i;
+            }
+            std::sort(indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) {
+                return x[a] != x[b] ? x[a] < x[b] : y[a] != y[b] ? y[a] < y[b] : z[a] < z[b];
+            });
+            return indices;
+        };
+        const std::vector<uint32_t> expectedIndices = sortedIndices(everyFrame);
+        const std::vector<uint32_t> actualIndices = sortedIndices(deferred);
+        for (uint32_t stream = 0; stream < ParticleStorage::kStreamCount; ++stream) {
+            const float* expected = everyFrame.GetStream(static_cast<ParticleStorage::Stream>(stream));
+            const float* actual = deferred.GetStream(static_cast<ParticleStorage::Stream>(stream));
+            for (uint32_t i = 0; i < deferred.GetCount(); ++i) {
+                double e = expected[expectedIndices[i]];
+                double error = std::abs(actual[actualIndices[i]] - e) / std::max(1.0, std::abs(e));
+                result.maxError = std::max(result.maxError, error);
+            }
+        }
+    }
+    result.passed = result.maxError <= kDeferTolerance;
+    return result;
+}
+
+double ParticleBenchmark::RunColliding(ParticleStorage& storage, ParticleCollision& collision, uint32_t particleCount,
+    const ParticleCollision::QueryFunction& query, ParticleCollisionStats& total) {
+    randomEngine_.seed(settings_.seed + particleCount);
+    storage.Reserve(particleCount);
+    collision.Reserve(particleCount);
+    for (uint32_t i = 0; i < particleCount; ++i) {
+        storage.Add(MakeParticle());
+    }
+
+    const ParticleStorage::Kernel kernel = ParticleStorage::GetDefaultKernel();
+    double totalMs = 0.0;
+    total = ParticleCollisionStats();
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        ParticleCollisionStats stats;
+        Clock::time_point start = Clock::now();
+        collision.Prepare(storage, kDeltaTime, query, stats);
+        totalMs += ElapsedMs(start, Clock::now());
+        total.cellCount += stats.cellCount;
+        total.shapeCount += stats.shapeCount;
+
+        // 更新は計測しない（全体を1つの範囲として更新し、続けて判定する）
+        uint32_t alive = storage.UpdateRange(0, storage.GetCount(), kDeltaTime, kernel);
+        start = Clock::now();
+        alive = collision.CollideRange(storage, 0, alive, stats);
+        totalMs += ElapsedMs(start, Clock::now());
+        storage.CompactChunks(&alive, 1, storage.GetCapacity());
+        total.Merge(stats);
+
+        while (!storage.IsFull() && storage.GetCount() < particleCount) {
+            storage.Add(MakeParticle());
+        }
+    }
+    return totalMs;
+}
+
+ParticleBenchmark::CollisionResult ParticleBenchmark::RunCollision(uint32_t particleCount) {
+    CollisionResult result;
+    result.particles = particleCount;
+
+    // 境界ボックスが重なる形状を集める（CollisionManager::QueryCollidersと同じく全形状を調べる）
+    const std::vector<Collision::Capsule> colliders = MakeColliders();
+    result.colliders = static_cast<uint32_t>(colliders.size());
+    auto query = [&](const Collision::AABB& bounds, std::vector<Collision::Capsule>& out) {
+        for (const Collision::Capsule& capsule : colliders) {
+            const Vector3& a = capsule.segment.start;
+            const Vector3& b = capsule.segment.end;
+            float r = capsule.radius;
+            if (std::min(a.x, b.x) - r > bounds.max.x || std::max(a.x, b.x) + r < bounds.min.x ||
+                std::min(a.y, b.y) - r > bounds.max.y || std::max(a.y, b.y) + r < bounds.min.y ||
+                std::min(a.z, b.z) - r > bounds.max.z || std::max(a.z, b.z) + r < bounds.min.z) {
+                continue;
+            }
+            out.push_back(capsule);
+        }
+    };
+
+    // 地面で跳ね返る設定で、格子の大きさだけを変えて計測（十分大きい格子は1セルで全形状と判定する）
+    ParticleCollisionDesc desc;
+    desc.planes.push_back({ 0.0f, 1.0f, 0.0f, 0.0f });
+    desc.cellSize = 2.0f;
+    ParticleStorage gridStorage;
+    ParticleCollision grid;
+    grid.SetDesc(desc);
+    ParticleCollisionStats gridStats;
+    double gridMs = RunColliding(gridStorage, grid, particleCount, query, gridStats);
+
+    desc.cellSize = 1.0e6f;
+    ParticleStorage allStorage;
+    ParticleCollision all;
+    all.SetDesc(desc);
+    ParticleCollisionStats allStats;
+    double allMs = RunColliding(allStorage, all, particleCount, query, allStats);
+
+    // 両方式で同じ形状と判定していれば座標は一致する
+    if (gridStorage.GetCount() != allStorage.GetCount()) {
+        result.maxDifference = std::numeric_limits<double>::infinity();
+    }
+    else {
+        for (uint32_t stream = ParticleStorage::kPositionX; stream <= ParticleStorage::kPositionZ; ++stream) {
+            const float* expected = allStorage.GetStream(static_cast<ParticleStorage::Stream>(stream));
+            const float* actual = gridStorage.GetStream(static_cast<ParticleStorage::Stream>(stream));
+            for (uint32_t i = 0; i < gridStorage.GetCount(); ++i) {
+                result.maxDifference = std::max(result.maxDifference, std::abs(static_cast<double>(actual[i]) - expected[i]));
+            }
+        }
+    }
+
+    result.cells = gridStats.cellCount / settings_.frames;
+    result.gridMs = gridMs / settings_.frames;
+    result.allMs = allMs / settings_.frames;
+    result.speedup = gridMs > 0.0 ? allMs / gridMs : 0.0;
+    result.testsPerParticle = static_cast<double>(gridStats.testCount) / (static_cast<double>(particleCount) * settings_.frames);
+    return result;
+}
+
+ParticleBenchmark::SubEmitterResult ParticleBenchmark::RunSubEmitters(uint32_t particleCount) {
+    SubEmitterResult result;
+    result.particles = particleCount;
+    result.countPerEvent = 4;
+
+    randomEngine_.seed(settings_.seed + particleCount);
+    ParticleStorage storage;
+    storage.Reserve(particleCount);
+    // 発生元は計測するフレーム数の間に寿命が尽きるようにする（尽きなければ出来事が記録されない）
+    for (uint32_t i = 0; i < particleCount; ++i) {
+        storage.Add(MakeShortLivedParticle());
+    }
+
+    // 火花のような短い寿命の粒を、両方式で同じシードの乱数から発生させる
+    // 発生先は毎フレーム空にするので、容量は全粒が一度に尽きても足りる数にする
+    EmitterDesc desc;
+    desc.SetLifeTime(0.2f, 0.5f);
+    ParticleStorage batched;
+    ParticleStorage perEvent;
+    batched.Reserve(particleCount * result.countPerEvent);
+    perEvent.Reserve(particleCount * result.countPerEvent);
+    ParticleRandom batchedRandom(settings_.seed);
+    ParticleRandom perEventRandom(settings_.seed);
+    std::vector<ParticleEvent> events;
+    events.reserve(particleCount);
+
+    const ParticleStorage::Kernel kernel = ParticleStorage::GetDefaultKernel();
+    double recordMs = 0.0;
+    double batchedMs = 0.0;
+    double perEventMs = 0.0;
+    uint64_t eventCount = 0;
+    for (uint32_t frame = 0; frame < settings_.frames; ++frame) {
+        // 更新は計測しない（全体を1つの範囲として更新し、末尾に残った寿命の尽きた粒を記録する）
+        uint32_t alive = storage.UpdateRange(0, storage.GetCount(), kDeltaTime, kernel);
+        events.clear();
+        Clock::time_point start = Clock::now();
+        AppendDeathEvents(storage, alive, storage.GetCount(), events);
+        recordMs += ElapsedMs(start, Clock::now());
+        storage.CompactChunks(&alive, 1, storage.GetCapacity());
+        eventCount += events.size();
+
+        batched.Clear();
+        start = Clock::now();
+        SpawnParticles(batched, events.data(), static_cast<uint32_t>(events.size()), result.countPerEvent, 0.5f, desc, batchedRandom);
+        batchedMs += ElapsedMs(start, Clock::now());
+
+        perEvent.Clear();
+        start = Clock::now();
+        for (const ParticleEvent& event : events) {
+            SpawnParticles(perEvent, &event, 1, result.countPerEvent, 0.5f, desc, perEventRandom);
+        }
+        perEventMs += ElapsedMs(start, Clock::now());
+
+        // 乱数の消費の仕方が違うので速度などは一致しないが、座標は出来事の座標なので一致する
+        if (batched.GetCount() != perEvent.GetCount()) {
+            result.maxDifference = std::numeric_limits<double>::infinity();
+        }
+        else {
+            for (uint32_t stream = ParticleStorage::kPositionX; stream <= ParticleStorage::kPositionZ; ++stream) {
+                const float* expected = perEvent.GetStream(static_cast<ParticleStorage::Stream>(stream));
+                const float* actual = batched.GetStream(static_cast<ParticleStorage::Stream>(stream));
+                for (uint32_t i = 0; i < batched.GetCount(); ++i) {
+                    result.maxDifference = std::max(result.maxDifference, std::abs(static_cast<double>(actual[i]) - expected[i]));
+                }
+            }
+        }
+
+        while (!storage.IsFull()) {
+            storage.Add(MakeShortLivedParticle());
+        }
+    }
+
+    result.events = static_cast<uint32_t>(eventCount / settings_.frames);
+    result.recordMs = recordMs / settings_.frames;
+    result.batchedMs = batchedMs / settings_.frames;
+    result.perEventMs = perEventMs / settings_.frames;
+    result.speedup = batchedMs > 0.0 ? perEventMs / batchedMs : 0.0;
+    result.passed = eventCount > 0 && result.maxDifference == 0.0;
+    return result;
+}
+
+std::string ParticleBenchmark::ToJson(const std::vector<Result>& results, const std::vector<ScalingResult>& scaling,
+    const std::vector<PackingResult>& packing, const std::vector<SortResult>& sorting,
+    const std::vector<CurveResult>& curves, const std::vector<SimulationResult>& simulation,
+    const std::vector<CollisionResult>& collision, const std::vector<SubEmitterResult>& subEmitters, const Settings& settings) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"benchmark\": \"particle\",\n";
+    json << "  \"frames\": " << settings.frames << ",\n";
+    json << "  \"seed\": " << settings.seed << ",\n";
+    json << "  \"groups\": " << settings.groups << ",\n";
+    json << "  \"avx2\": " << (ParticleStorage::IsAvx2Supported() ? "true" : "false") << ",\n";
+    json << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"removed\": " << r.removed << ", "
+             << "\"list_ms\": " << r.listMs << ", "
+             << "\"storage_ms\": " << r.storageMs << ", "
+             << "\"avx2_ms\": " << r.avx2Ms << ", "
+             << "\"avx2_max_error\": " << r.avx2MaxError << ", "
+             << "\"speedup\": " << r.speedup
+             << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"scaling\": [\n";
+    for (size_t i = 0; i < scaling.size(); ++i) {
+        const ScalingResult& r = scaling[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"groups\": " << r.groups << ", "
+             << "\"threads\": " << r.threads << ", "
+             << "\"chunks\": " << r.chunks << ", "
+             << "\"ms\": " << r.ms << ", "
+             << "\"speedup\": " << r.speedup
+             << "}" << (i + 1 < scaling.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"packing\": [\n";
+    for (size_t i = 0; i < packing.size(); ++i) {
+        const PackingResult& r = packing[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"matrix_ms\": " << r.matrixMs << ", "
+             << "\"matrix_bytes\": " << r.matrixBytes << ", "
+             << "\"pack_ms\": " << r.packMs << ", "
+             << "\"pack_bytes\": " << r.packBytes << ", "
+             << "\"speedup\": " << r.speedup << ", "
+             << "\"max_vertex_error\": " << r.maxVertexError << ", "
+             << "\"max_color_error\": " << r.maxColorError
+             << "}" << (i + 1 < packing.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"sorting\": [\n";
+    for (size_t i = 0; i < sorting.size(); ++i) {
+        const SortResult& r = sorting[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"radix_ms\": " << r.radixMs << ", "
+             << "\"std_sort_ms\": " << r.stdSortMs << ", "
+             << "\"speedup\": " << r.speedup << ", "
+             << "\"subset_ms\": " << r.subsetMs << ", "
+             << "\"subset_count\": " << r.subsetCount << ", "
+             << "\"max_inversion\": " << r.maxInversion
+             << "}" << (i + 1 < sorting.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"curves\": [\n";
+    for (size_t i = 0; i < curves.size(); ++i) {
+        const CurveResult& r = curves[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"tables\": " << r.tables << ", "
+             << "\"linear_ms\": " << r.linearMs << ", "
+             << "\"curve_ms\": " << r.curveMs << ", "
+             << "\"overhead\": " << r.overhead << ", "
+             << "\"max_table_error\": " << r.maxTableError << ", "
+             << "\"avx2_max_error\": " << r.avx2MaxError
+             << "}" << (i + 1 < curves.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"simulation\": [\n";
+    for (size_t i = 0; i < simulation.size(); ++i) {
+        const SimulationResult& r = simulation[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"integrate_ms\": " << r.integrateMs << ", "
+             << "\"analytic_ms\": " << r.analyticMs << ", "
+             << "\"overhead\": " << r.overhead << ", "
+             << "\"integrate_max_error\": " << r.integrateMaxError << ", "
+             << "\"analytic_max_error\": " << r.analyticMaxError
+             << "}" << (i + 1 < simulation.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"collision\": [\n";
+    for (size_t i = 0; i < collision.size(); ++i) {
+        const CollisionResult& r = collision[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"colliders\": " << r.colliders << ", "
+             << "\"cells\": " << r.cells << ", "
+             << "\"grid_ms\": " << r.gridMs << ", "
+             << "\"all_ms\": " << r.allMs << ", "
+             << "\"speedup\": " << r.speedup << ", "
+             << "\"tests_per_particle\": " << r.testsPerParticle << ", "
+             << "\"max_difference\": " << r.maxDifference
+             << "}" << (i + 1 < collision.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"sub_emitters\": [\n";
+    for (size_t i = 0; i < subEmitters.size(); ++i) {
+        const SubEmitterResult& r = subEmitters[i];
+        json << "    {"
+             << "\"particles\": " << r.particles << ", "
+             << "\"events\": " << r.events << ", "
+             << "\"count_per_event\": " << r.countPerEvent << ", "
+             << "\"record_ms\": " << r.recordMs << ", "
+             << "\"batched_ms\": " << r.batchedMs << ", "
+             << "\"per_event_ms\": " << r.perEventMs << ", "
+             << "\"speedup\": " << r.speedup << ", "
+             << "\"max_difference\": " << r.maxDifference
+             << "}" << (i + 1 < subEmitters.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n";
+    json << "}\n";
+    return json.str();
+}
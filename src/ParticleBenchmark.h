@@ -0,0 +1,302 @@
+#pragma once
+
+// パーティクル更新ベンチマーク
+// ParticleStorageのみに依存するため、DirectXのないLinux環境でもビルドできる
+// ビルド例（リポジトリのルートで実行）:
+//   g++ -std=c++20 -O3 -Isrc/Engine/Math -Isrc/Engine/Particle
+//       src/ParticleBenchmark.cpp src/ParticleBenchmarkMain.cpp
+//       src/Engine/Particle/ParticleStorage.cpp src/Engine/Particle/ParticleUpdater.cpp
+//       src/Engine/Particle/ParticleInstance.cpp src/Engine/Particle/ParticleSorter.cpp
+//       src/Engine/Particle/ParticleCurve.cpp src/Engine/Particle/ParticleCollision.cpp
+//       src/Engine/Particle/ParticleSubEmitter.cpp src/Engine/Particle/ParticleRandom.cpp
+//       -Isrc/Engine/Collision -pthread -o particle_benchmark
+// 実行例:
+//   ./particle_benchmark --sizes 1000,10000,100000 --threads 1,2,4,8 --frames 120 --json result.json
+
+#include "ParticleCollision.h"
+#include "ParticleInstance.h"
+#include "ParticleSorter.h"
+#include "ParticleStorage.h"
+#include "ParticleSubEmitter.h"
+#include "ParticleUpdater.h"
+
+// STLのインクルード
+#include <cstdint>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+// パーティクル更新ベンチマーククラス
+class ParticleBenchmark {
+public:
+    // 実行設定
+    struct Settings {
+        uint32_t frames = 120;   // 計測フレーム数
+        uint32_t seed = 12345;   // 乱数シード（同じ値なら同じ発生内容になる）
+        uint32_t groups = 8;     // スレッド数ごとの計測でパーティクルを分けるグループ数
+    };
+
+    // 計測結果（時間は1フレームあたりの平均）
+    struct Result {
+        uint32_t particles = 0;  // 維持するパーティクル数
+        uint32_t frames = 0;
+        uint64_t removed = 0;    // 寿命で削除された数（全フレーム合計、両方式で一致する）
+
+        // std::list<Particle>（1粒ずつ確保した構造体を順にたどる従来の方式）
+        double listMs = 0.0;
+        // ParticleStorage（属性ごとの配列、1粒ずつ処理する基準の方式）
+        double storageMs = 0.0;
+        // ParticleStorage（AVX2で8粒ずつ処理、非対応のCPUでは0）
+        double avx2Ms = 0.0;
+        // 計測後の両方式の全属性の最大誤差（|差| / max(1, |基準値|)）
+        double avx2MaxError = 0.0;
+
+        // 従来の方式に対する速度比（AVX2が使えればAVX2）
+        double speedup = 0.0;
+        // 計測中に削除が起きて両方式の削除数が一致し、AVX2の誤差が許容誤差以内か
+        bool passed = true;
+    };
+
+    // AVX2と1粒ずつの方式の全属性の許容誤差（FMAによる丸めの違いのみ）
+    // Integrateでは毎フレームの丸めの違いがたまり、既定の120フレームで1.4e-5程度になる（Analyticは1e-6未満）
+    static constexpr double kKernelTolerance = 1.0e-4;
+
+    // 処理方式の一致の確認結果
+    struct KernelCheckResult {
+        uint32_t particles = 0;
+        ParticleStorage::Simulation simulation = ParticleStorage::Simulation::Integrate;
+        bool curves = false;     // 寿命に対する変化の表を使うか
+        // 全属性の最大誤差（|差| / max(1, |基準値|)、削除数や並び順が違えば無限大、AVX2非対応のCPUでは0）
+        double maxError = 0.0;
+        bool passed = true;
+    };
+
+    // スレッド数ごとの計測結果（時間は1フレームあたりの平均）
+    struct ScalingResult {
+        uint32_t particles = 0;  // 全グループの合計
+        uint32_t groups = 0;
+        uint32_t threads = 0;
+        uint32_t chunks = 0;     // 1フレームあたりのチャンク数
+        // ParticleUpdaterの更新とインスタンスデータの書き込み
+        double ms = 0.0;
+        // 1スレッドに対する速度比（呼び出し側で設定する）
+        double speedup = 0.0;
+    };
+
+    // 四角形の頂点のワールド座標の許容誤差（座標は±10程度なのでfloatの丸めの数倍）
+    static constexpr double kVertexTolerance = 1.0e-5;
+    // 色の許容誤差（RGBA8への四捨五入なので量子化の幅の半分1/510、戻すときのfloatの丸めの分だけ余裕を持たせる）
+    static constexpr double kColorTolerance = 1.0 / 510.0 + 1.0e-6;
+
+    // インスタンスデータ作成の計測結果（時間は1フレームあたりの平均）
+    struct PackingResult {
+        uint32_t particles = 0;
+        // 行列方式（WVP・World・色の144バイト、1粒あたり4x4行列の乗算3回）
+        double matrixMs = 0.0;
+        uint32_t matrixBytes = 0;
+        // 詰めた方式（ParticleInstanceの32バイト、ビルボードは頂点シェーダー）
+        double packMs = 0.0;
+        uint32_t packBytes = 0;
+        // 行列方式に対する速度比
+        double speedup = 0.0;
+        // 四角形の頂点のワールド座標の両方式の最大誤差
+        double maxVertexError = 0.0;
+        // 色の量子化の最大誤差（計測した粒の色と、0～1を細かく調べたPackParticleColor・UnpackParticleColorの往復）
+        double maxColorError = 0.0;
+        // 両方の誤差が許容誤差以内か
+        bool passed = true;
+    };
+
+    // 更新の間にワーカー数を変えた場合の確認結果
+    struct WorkerCheckResult {
+        uint32_t particles = 0;
+        uint32_t frames = 0;
+        // 1スレッドで更新した場合と全属性・書き込んだインスタンスデータがビット単位で一致したか
+        bool passed = true;
+    };
+
+    // 描画順の並べ替えの計測結果（時間は1フレームあたりの平均、深度の計算を含む）
+    struct SortResult {
+        uint32_t particles = 0;
+        // ParticleSorter（16ビットに量子化して8ビットずつ2回の基数ソート）
+        double radixMs = 0.0;
+        // std::sort（深度のfloatを比較）
+        double stdSortMs = 0.0;
+        // std::sortに対する速度比
+        double speedup = 0.0;
+        // ParticleSorterで一部（x >= 0の約半数、視錐台カリングの後を想定）だけを並べ替えた時間と数
+        double subsetMs = 0.0;
+        uint32_t subsetCount = 0;
+        // 基数ソートの結果で隣り合う粒の深度の逆転の最大値（量子化の幅に対する比、1以下なら正しい、一部の並べ替えも含む）
+        double maxInversion = 0.0;
+        // 逆転が量子化の幅以内か
+        bool passed = true;
+    };
+
+    // 表の値と曲線の値の許容誤差
+    // 表の点の間隔h = 1/63の直線補間による誤差で、滑らかな曲線ではh^2/8 * |f''|、折れ線の角では傾きの変化をΔとして最大Δ * h / 4になる
+    // 計測用の曲線ではsizes[2]のt = 0.1の角（Δ = 6 - 1/3）が最も大きく、上限は約2.2e-2（計測値は1.9e-2）
+    static constexpr double kTableTolerance = 2.5e-2;
+    // 表を使った更新のAVX2と1粒ずつの方式の許容誤差（サイズと色は経過時間から毎回求めるので誤差はたまらない）
+    static constexpr double kCurveKernelTolerance = 1.0e-6;
+
+    // 寿命に対する変化の表の計測結果（時間は1フレームあたりの平均、CPUで最も速い処理方式）
+    struct CurveResult {
+        uint32_t particles = 0;
+        uint32_t tables = 0;     // 登録した表の数（粒ごとに順番に割り当てる）
+        // 開始～終了の直線補間のみ
+        double linearMs = 0.0;
+        // 表を読んで補間結果に掛ける
+        double curveMs = 0.0;
+        // 直線補間のみに対する時間の比
+        double overhead = 0.0;
+        // 表の値と曲線の値の最大誤差（表の点の間の補間による）
+        double maxTableError = 0.0;
+        // 表を使った更新のAVX2と1粒ずつの方式の最大誤差（AVX2非対応のCPUでは0）
+        double avx2MaxError = 0.0;
+        // 両方の誤差が許容誤差以内か
+        bool passed = true;
+    };
+
+    // 動きの求め方ごとの計測結果（時間は1フレームあたりの平均、CPUで最も速い処理方式）
+    struct SimulationResult {
+        uint32_t particles = 0;
+        // 毎フレームの積分（Integrate）
+        double integrateMs = 0.0;
+        // 発生時の状態と経過時間からの計算（Analytic）
+        double analyticMs = 0.0;
+        // 積分に対する時間の比
+        double overhead = 0.0;
+        // 計測後の座標と、倍精度で求めた p0 + v0 * t + a * t^2 / 2 との最大誤差
+        double integrateMaxError = 0.0;
+        double analyticMaxError = 0.0;
+        // Analyticの誤差が許容誤差以内か（Integrateは積分の誤差がたまるので判定しない）
+        bool passed = true;
+    };
+
+    // Analyticの座標と倍精度で求めた p0 + v0 * t + a * t^2 / 2 との許容誤差（座標は最大60程度なのでfloatの丸め4e-6の数倍）
+    static constexpr double kAnalyticTolerance = 2.0e-5;
+    // 更新を省いてまとめて進めた場合と毎フレーム更新した場合の全属性の許容誤差
+    // 毎フレーム更新では経過時間にフレームごとの丸めがたまるので、その分だけ違う（150フレームで7e-6程度）
+    static constexpr double kDeferTolerance = 1.0e-4;
+
+    // 更新を省いた場合の確認結果
+    struct DeferCheckResult {
+        uint32_t particles = 0;  // 最初に発生させた数（他に毎フレーム少しずつ追加する）
+        uint32_t frames = 0;     // 更新を省いたフレーム数（最後のフレームだけ更新する）
+        uint32_t survivors = 0;  // 最後の更新後の数
+        // 同じ粒どうしの全属性の最大誤差（|差| / max(1, |基準値|)、生き残った粒が違えば無限大）
+        double maxError = 0.0;
+        bool passed = true;
+    };
+
+    // 衝突の計測結果（時間は1フレームあたりの平均、格子への振り分けと判定・応答）
+    struct CollisionResult {
+        uint32_t particles = 0;
+        uint32_t colliders = 0;  // 球・カプセルの数（他に地面の平面が1枚）
+        uint32_t cells = 0;      // 1フレームあたりの粒のあるセルの数（衝突形状を集めた回数）
+        // 格子のセルごとに集めた形状とだけ判定
+        double gridMs = 0.0;
+        // 全粒を全形状と判定（格子を使わない）
+        double allMs = 0.0;
+        // 全形状との判定に対する速度比
+        double speedup = 0.0;
+        // 1粒あたりの判定数（格子、平面を含む）
+        double testsPerParticle = 0.0;
+        // 両方式の計測後の座標の最大差（同じ形状と判定していれば0）
+        double maxDifference = 0.0;
+    };
+
+    // サブエミッターの計測結果（時間は1フレームあたりの平均）
+    struct SubEmitterResult {
+        uint32_t particles = 0;
+        uint32_t events = 0;        // 1フレームあたりの寿命が尽きた粒の数（出来事の数）
+        uint32_t countPerEvent = 0; // 1回の出来事で発生させる数
+        // 寿命が尽きた粒の出来事の記録
+        double recordMs = 0.0;
+        // 全出来事の分をまとめて発生
+        double batchedMs = 0.0;
+        // 出来事ごとに発生（更新中に出来事のたびにEmitを呼ぶ場合と同じ呼び方）
+        double perEventMs = 0.0;
+        // 出来事ごとの発生に対する速度比
+        double speedup = 0.0;
+        // 両方式で発生させた粒の座標の最大差（同じ順に発生していれば0）
+        double maxDifference = 0.0;
+        // 出来事が1つ以上あり、両方式の座標が一致したか
+        bool passed = true;
+    };
+
+    // コンストラクタ
+    explicit ParticleBenchmark(const Settings& settings);
+
+    // 指定数のパーティクルを維持しながら更新を計測
+    Result Run(uint32_t particleCount);
+
+    // 指定数のパーティクルを指定の動きの求め方で更新し、AVX2と1粒ずつの方式の結果を比較
+    // 8の倍数でない数では、AVX2の最後の端数を1粒ずつ処理する部分も確かめられる
+    KernelCheckResult CheckKernels(uint32_t particleCount, ParticleStorage::Simulation simulation, bool curves);
+
+    // 指定数のパーティクルをグループに分けて維持しながら、指定のスレッド数で更新を計測
+    ScalingResult RunScaling(uint32_t particleCount, uint32_t threadCount);
+
+    // 指定数のパーティクルのインスタンスデータ作成を計測
+    PackingResult RunPacking(uint32_t particleCount);
+
+    // 指定数のパーティクルの奥から手前への並べ替えを計測
+    SortResult RunSort(uint32_t particleCount);
+
+    // 指定数のパーティクルを、更新のたびにSetWorkerCountでワーカー数を変えながら更新し、1スレッドの場合と比較
+    // （ワーカーを作り直した直後の更新も含めて、結果がスレッド数によらないことを確認する）
+    WorkerCheckResult CheckWorkerChanges(uint32_t particleCount, uint32_t frames);
+
+    // 指定数のパーティクルの寿命に対する変化の表を使った更新を計測
+    CurveResult RunCurves(uint32_t particleCount);
+
+    // 指定数のパーティクルの積分と経過時間からの計算を計測
+    SimulationResult RunSimulation(uint32_t particleCount);
+
+    // 指定数のパーティクルをAnalyticで、Deferで指定フレーム数の更新を省いて最後にまとめて進めた場合と
+    // 毎フレーム更新した場合を比較（途中で寿命が尽きる粒と、省いている間に追加した粒を含む）
+    DeferCheckResult CheckDefer(uint32_t particleCount, uint32_t frames);
+
+    // 指定数のパーティクルの平面・球・カプセルとの衝突を計測
+    CollisionResult RunCollision(uint32_t particleCount);
+
+    // 指定数のパーティクルの寿命が尽きたときのサブエミッターの発生を計測
+    SubEmitterResult RunSubEmitters(uint32_t particleCount);
+
+    // 結果をJSON文字列に変換
+    static std::string ToJson(const std::vector<Result>& results, const std::vector<ScalingResult>& scaling,
+        const std::vector<PackingResult>& packing, const std::vector<SortResult>& sorting,
+        const std::vector<CurveResult>& curves, const std::vector<SimulationResult>& simulation,
+        const std::vector<CollisionResult>& collision, const std::vector<SubEmitterResult>& subEmitters, const Settings& settings);
+
+private:
+    // 設定
+    Settings settings_;
+
+    // 乱数生成器
+    std::mt19937 randomEngine_;
+
+    // 乱数
+    float Random(float min, float max);
+
+    // ParticleManager::Emitの既定値と同じ範囲でランダムなパーティクルを作成
+    Particle MakeParticle();
+    // MakeParticleと同じだが、寿命を計測するフレーム数の間に収めたパーティクルを作成
+    // （フレーム数が少なくても計測中に寿命が尽きる粒が出るようにする）
+    Particle MakeShortLivedParticle();
+
+    // ParticleStorageを指定の処理方式で更新して計測（戻り値は1フレームあたりではなく合計）
+    // storageに寿命に対する変化の表が登録されていれば、発生させる粒に順番に割り当てる
+    // shortLivedがtrueならMakeShortLivedParticleで発生させる
+    double RunStorage(ParticleStorage& storage, uint32_t particleCount, ParticleStorage::Kernel kernel, uint64_t& removed, bool shortLived = false);
+
+    // 寿命で減った分を補充しながら更新と衝突を繰り返し、衝突の準備と判定の時間を計測（戻り値は合計）
+    double RunColliding(ParticleStorage& storage, ParticleCollision& collision, uint32_t particleCount,
+        const ParticleCollision::QueryFunction& query, ParticleCollisionStats& total);
+
+    // 従来の更新処理（ParticleManager::Updateのリスト版からシミュレーション部分を抜き出したもの）
+    static void UpdateList(std::list<Particle>& particles, float deltaTime);
+};
@@ -0,0 +1,343 @@
+#include "ParticleBenchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 使い方の表示
+void PrintUsage() {
+    std::cout << "Usage: particle_benchmark [options]\n"
+              << "  --sizes 1000,10000,100000   パーティクル数のリスト\n"
+              << "  --threads 1,2,4,8           スレッド数のリスト（最大のパーティクル数で計測）\n"
+              << "  --groups N                  スレッド数ごとの計測のグループ数\n"
+              << "  --frames N                  計測フレーム数\n"
+              << "  --seed N                    乱数シード\n"
+              << "  --json PATH                 JSONの出力先（-で標準出力）\n";
+}
+
+// カンマ区切りの文字列を分割
+std::vector<std::string> Split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// メイン関数
+int main(int argc, char** argv) {
+    ParticleBenchmark::Settings settings;
+    std::vector<uint32_t> sizes = { 1000, 10000, 100000 };
+    std::vector<uint32_t> threads = { 1, 2, 4 };
+    if (std::thread::hardware_concurrency() > 4) {
+        threads.push_back(std::thread::hardware_concurrency());
+    }
+    std::string jsonPath = "particle_benchmark.json";
+
+    // 引数の解析
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            sizes.clear();
+            for (const std::string& size : Split(argv[++i])) {
+                sizes.push_back(static_cast<uint32_t>(std::strtoul(size.c_str(), nullptr, 10)));
+            }
+        }
+        else if (arg == "--threads" && hasValue) {
+            threads.clear();
+            for (const std::string& thread : Split(argv[++i])) {
+                threads.push_back(std::max(1u, static_cast<uint32_t>(std::strtoul(thread.c_str(), nullptr, 10))));
+            }
+        }
+        else if (arg == "--groups" && hasValue) {
+            settings.groups = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (arg == "--frames" && hasValue) {
+            settings.frames = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        }
+        else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    // ベンチマークの実行（確認に失敗した項目があれば最後に1を返す）
+    ParticleBenchmark benchmark(settings);
+    std::vector<ParticleBenchmark::Result> results;
+    bool failed = false;
+
+    std::cerr << std::right << std::setw(10) << "particles" << std::setw(12) << "removed/f"
+              << std::setw(11) << "list ms" << std::setw(12) << "storage ms" << std::setw(10) << "avx2 ms"
+              << std::setw(12) << "avx2 error" << std::setw(10) << "speedup" << std::endl;
+
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::Result r = benchmark.Run(size);
+        results.push_back(r);
+        failed |= !r.passed;
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::setw(12) << r.removed / r.frames
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(11) << r.listMs
+                  << std::setw(12) << r.storageMs
+                  << std::setw(10) << r.avx2Ms
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(12) << r.avx2MaxError
+                  << std::fixed
+                  << std::setprecision(2)
+                  << std::setw(9) << r.speedup << "x"
+                  << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+    }
+
+    // AVX2と1粒ずつの方式の一致の確認
+    // 指定のパーティクル数・シード・フレーム数によらず、既定の設定と8の倍数でない数で両方の動きの求め方と表の有無を調べる
+    if (ParticleStorage::IsAvx2Supported()) {
+        ParticleBenchmark checker{ ParticleBenchmark::Settings() };
+        std::cerr << std::endl << std::setw(10) << "particles" << std::setw(12) << "simulation" << std::setw(8) << "curves"
+                  << std::setw(12) << "avx2 error" << "  (tolerance " << std::scientific << std::setprecision(1)
+                  << ParticleBenchmark::kKernelTolerance << std::defaultfloat << ")" << std::endl;
+        for (uint32_t particleCount : { 1u, 13u, 1001u, 10007u }) {
+            for (ParticleStorage::Simulation mode : { ParticleStorage::Simulation::Integrate, ParticleStorage::Simulation::Analytic }) {
+                for (bool curves : { false, true }) {
+                    ParticleBenchmark::KernelCheckResult r = checker.CheckKernels(particleCount, mode, curves);
+                    failed |= !r.passed;
+
+                    std::cerr << std::setw(10) << r.particles
+                              << std::setw(12) << (mode == ParticleStorage::Simulation::Analytic ? "analytic" : "integrate")
+                              << std::setw(8) << (curves ? "on" : "off")
+                              << std::scientific << std::setprecision(1)
+                              << std::setw(12) << r.maxError
+                              << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+                }
+            }
+        }
+    }
+
+    // スレッド数ごとの計測（最大のパーティクル数で行い、1スレッドの時間を基準にする）
+    std::vector<ParticleBenchmark::ScalingResult> scaling;
+    if (!sizes.empty() && !threads.empty()) {
+        uint32_t particleCount = *std::max_element(sizes.begin(), sizes.end());
+        std::cerr << std::endl << std::setw(10) << "threads" << std::setw(10) << "chunks"
+                  << std::setw(11) << "update ms" << std::setw(10) << "speedup"
+                  << "  (" << particleCount << " particles, " << settings.groups << " groups, "
+                  << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+
+        double baseMs = benchmark.RunScaling(particleCount, 1).ms;
+        for (uint32_t threadCount : threads) {
+            ParticleBenchmark::ScalingResult r = benchmark.RunScaling(particleCount, threadCount);
+            r.speedup = r.ms > 0.0 ? baseMs / r.ms : 0.0;
+            scaling.push_back(r);
+
+            std::cerr << std::setw(10) << r.threads << std::setw(10) << r.chunks
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(11) << r.ms
+                      << std::setprecision(2)
+                      << std::setw(9) << r.speedup << "x"
+                      << std::defaultfloat << std::endl;
+        }
+    }
+
+    // 更新の間にワーカー数を変えた場合の一致の確認（既定の設定で行う）
+    {
+        ParticleBenchmark checker{ ParticleBenchmark::Settings() };
+        ParticleBenchmark::WorkerCheckResult r = checker.CheckWorkerChanges(40007, 30);
+        failed |= !r.passed;
+        std::cerr << std::endl << "worker count changes: " << r.particles << " particles, " << r.frames << " frames"
+                  << (r.passed ? "  ok" : "  FAILED") << std::endl;
+    }
+
+    // インスタンスデータ作成の計測
+    std::vector<ParticleBenchmark::PackingResult> packing;
+    std::cerr << std::endl << std::setw(10) << "particles" << std::setw(11) << "matrix ms" << std::setw(10) << "pack ms"
+              << std::setw(10) << "speedup" << std::setw(12) << "bytes" << std::setw(14) << "vertex error"
+              << std::setw(13) << "color error" << "  (tolerance " << std::scientific << std::setprecision(1)
+              << ParticleBenchmark::kVertexTolerance << ", " << ParticleBenchmark::kColorTolerance << std::defaultfloat << ")" << std::endl;
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::PackingResult r = benchmark.RunPacking(size);
+        packing.push_back(r);
+        failed |= !r.passed;
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(11) << r.matrixMs
+                  << std::setw(10) << r.packMs
+                  << std::setprecision(2)
+                  << std::setw(9) << r.speedup << "x"
+                  << std::setw(7) << r.matrixBytes << " -> " << std::setw(2) << r.packBytes
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(14) << r.maxVertexError
+                  << std::setw(13) << r.maxColorError
+                  << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+    }
+
+    // 描画順の並べ替えの計測
+    std::vector<ParticleBenchmark::SortResult> sorting;
+    std::cerr << std::endl << std::setw(10) << "particles" << std::setw(11) << "radix ms" << std::setw(13) << "std::sort ms"
+              << std::setw(10) << "speedup" << std::setw(10) << "subset" << std::setw(11) << "subset ms"
+              << std::setw(11) << "inversion" << std::endl;
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::SortResult r = benchmark.RunSort(size);
+        sorting.push_back(r);
+        failed |= !r.passed;
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(11) << r.radixMs
+                  << std::setw(13) << r.stdSortMs
+                  << std::setprecision(2)
+                  << std::setw(9) << r.speedup << "x"
+                  << std::setw(10) << r.subsetCount
+                  << std::setprecision(3)
+                  << std::setw(11) << r.subsetMs
+                  << std::setprecision(2)
+                  << std::setw(11) << r.maxInversion
+                  << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+    }
+
+    // 寿命に対する変化の表の計測
+    std::vector<ParticleBenchmark::CurveResult> curves;
+    std::cerr << std::endl << std::setw(10) << "particles" << std::setw(12) << "linear ms" << std::setw(11) << "curve ms"
+              << std::setw(11) << "overhead" << std::setw(13) << "table error" << std::setw(12) << "avx2 error"
+              << "  (tolerance " << std::scientific << std::setprecision(1) << ParticleBenchmark::kTableTolerance << ", "
+              << ParticleBenchmark::kCurveKernelTolerance << std::defaultfloat << ")" << std::endl;
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::CurveResult r = benchmark.RunCurves(size);
+        curves.push_back(r);
+        failed |= !r.passed;
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << r.linearMs
+                  << std::setw(11) << r.curveMs
+                  << std::setprecision(2)
+                  << std::setw(10) << r.overhead << "x"
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(13) << r.maxTableError
+                  << std::setw(12) << r.avx2MaxError
+                  << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+    }
+
+    // 動きの求め方ごとの計測
+    std::vector<ParticleBenchmark::SimulationResult> simulation;
+    std::cerr << std::endl << std::setw(10) << "particles" << std::setw(14) << "integrate ms" << std::setw(13) << "analytic ms"
+              << std::setw(11) << "overhead" << std::setw(17) << "integrate error" << std::setw(16) << "analytic error"
+              << "  (tolerance " << std::scientific << std::setprecision(1) << ParticleBenchmark::kAnalyticTolerance
+              << std::defaultfloat << ")" << std::endl;
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::SimulationResult r = benchmark.RunSimulation(size);
+        simulation.push_back(r);
+        failed |= !r.passed;
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(14) << r.integrateMs
+                  << std::setw(13) << r.analyticMs
+                  << std::setprecision(2)
+                  << std::setw(10) << r.overhead << "x"
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(17) << r.integrateMaxError
+                  << std::setw(16) << r.analyticMaxError
+                  << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+    }
+
+    // 更新を省いてまとめて進めた場合と毎フレーム更新した場合の一致の確認（既定の設定で行う）
+    {
+        ParticleBenchmark checker{ ParticleBenchmark::Settings() };
+        std::cerr << std::endl << std::setw(10) << "particles" << std::setw(10) << "deferred" << std::setw(11) << "survivors"
+                  << std::setw(13) << "defer error" << "  (tolerance " << std::scientific << std::setprecision(1)
+                  << ParticleBenchmark::kDeferTolerance << std::defaultfloat << ")" << std::endl;
+        for (uint32_t frames : { 1u, 30u, 150u }) {
+            ParticleBenchmark::DeferCheckResult r = checker.CheckDefer(10007, frames);
+            failed |= !r.passed;
+
+            std::cerr << std::setw(10) << r.particles
+                      << std::setw(10) << r.frames
+                      << std::setw(11) << r.survivors
+                      << std::scientific << std::setprecision(1)
+                      << std::setw(13) << r.maxError
+                      << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+        }
+    }
+
+    // 衝突の計測
+    std::vector<ParticleBenchmark::CollisionResult> collision;
+    std::cerr << std::endl << std::setw(10) << "particles" << std::setw(11) << "colliders" << std::setw(8) << "cells"
+              << std::setw(10) << "grid ms" << std::setw(9) << "all ms" << std::setw(10) << "speedup"
+              << std::setw(9) << "tests/p" << std::setw(13) << "difference" << std::endl;
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::CollisionResult r = benchmark.RunCollision(size);
+        collision.push_back(r);
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::setw(11) << r.colliders
+                  << std::setw(8) << r.cells
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(10) << r.gridMs
+                  << std::setw(9) << r.allMs
+                  << std::setprecision(2)
+                  << std::setw(9) << r.speedup << "x"
+                  << std::setw(9) << r.testsPerParticle
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(13) << r.maxDifference
+                  << std::defaultfloat << std::endl;
+    }
+
+    // サブエミッターの計測
+    std::vector<ParticleBenchmark::SubEmitterResult> subEmitters;
+    std::cerr << std::endl << std::setw(10) << "particles" << std::setw(9) << "events" << std::setw(12) << "record ms"
+              << std::setw(13) << "batched ms" << std::setw(14) << "per event ms" << std::setw(10) << "speedup"
+              << std::setw(13) << "difference" << std::endl;
+    for (uint32_t size : sizes) {
+        ParticleBenchmark::SubEmitterResult r = benchmark.RunSubEmitters(size);
+        subEmitters.push_back(r);
+        failed |= !r.passed;
+
+        std::cerr << std::setw(10) << r.particles
+                  << std::setw(9) << r.events
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << r.recordMs
+                  << std::setw(13) << r.batchedMs
+                  << std::setw(14) << r.perEventMs
+                  << std::setprecision(2)
+                  << std::setw(9) << r.speedup << "x"
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(13) << r.maxDifference
+                  << std::defaultfloat << (r.passed ? "" : "  FAILED") << std::endl;
+    }
+
+    // JSONの出力
+    std::string json = ParticleBenchmark::ToJson(results, scaling, packing, sorting, curves, simulation, collision, subEmitters, settings);
+    if (jsonPath == "-") {
+        std::cout << json;
+    }
+    else {
+        std::ofstream file(jsonPath);
+        if (!file) {
+            std::cerr << "Failed to open " << jsonPath << std::endl;
+            return 1;
+        }
+        file << json;
+        std::cerr << "Wrote " << jsonPath << std::endl;
+    }
+
+    // 確認のいずれかが許容誤差を超えていれば失敗
+    if (failed) {
+        std::cerr << "Verification FAILED" << std::endl;
+        return 1;
+    }
+    return 0;
+}